@@ -0,0 +1,111 @@
+// Host-side generator of the ASRC polyphase filters, generates drivers/dsp/audio_asrc_coef.c
+//
+// Kaiser windowed sinc, TAPS input samples long, sampled at PHASES + 1 fractional positions : phase p is the filter
+// for an output sample p/PHASES of an input sample after the centre of the window, phase PHASES is phase 0 one sample
+// later, so the firmware interpolates between phase p and p + 1 without a wrap. Each phase is normalized to unity
+// DC gain, so the gain does not depend on the position. Q30 coefficients, unity fits.
+//
+// The cutoff is the input Nyquist frequency when upsampling, else the output Nyquist frequency : one table for all
+// the rates up to the output rate, one per rate above it. The tables of the 48kHz output decimating 88.2kHz and 96kHz
+// are only compiled for AUDIO_ASRC_OUT_FREQ 48000.
+//
+// Usage : make, or ./build/asrcgen > ../drivers/dsp/audio_asrc_coef.c
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+// Must match AUDIO_ASRC_TAPS and AUDIO_ASRC_PHASES_LOG2 in audio_asrc.h
+#define TAPS            32
+#define PHASES_LOG2     7
+#define PHASES          (1 << PHASES_LOG2)
+
+// Stopband attenuation ~100dB
+#define KAISER_BETA     10.0
+
+typedef struct {
+	uint32_t freq_in;
+	uint32_t freq_out;
+	const char* name;
+} TABLE;
+
+// decimating tables, see AUDIO_ASRC_Tables[] in the generated file
+static const TABLE Decim[] = {
+	{88200, 48000, "AUDIO_ASRC_Coef_88k2_48k"},
+	{96000, 48000, "AUDIO_ASRC_Coef_96k_48k"},
+	};
+#define DECIM_NUM       (sizeof(Decim)/sizeof(Decim[0]))
+
+
+/**
+ * @brief  Modified Bessel function of the first kind, order 0
+ */
+static double bessel_i0(double x){
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50; k++) {
+		term *= (x/(2.0*k))*(x/(2.0*k));
+		sum += term;
+		if (term < 1.0e-12*sum) {
+			break;
+			}
+		}
+	return sum;
+	}
+
+
+/**
+ * @brief  Print one polyphase table
+ * @param  cutoff: cutoff frequency relative to the input Nyquist frequency
+ */
+static void table(const char* name, double cutoff){
+	printf("static const int32_t %s[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS] = {\n", name);
+	for (int p = 0; p <= PHASES; p++) {
+		double h[TAPS];
+		double sum = 0.0;
+		for (int k = 0; k < TAPS; k++) {
+			// distance of the output sample to input sample k, the output is after tap TAPS/2 - 1
+			double u = (double)(TAPS/2 - 1) + (double)p/PHASES - k;
+			double x = M_PI*cutoff*u;
+			double sinc = fabs(x) < 1.0e-12 ? 1.0 : sin(x)/x;
+			double r = u/(TAPS/2);
+			double w = fabs(r) < 1.0 ? bessel_i0(KAISER_BETA*sqrt(1.0 - r*r))/bessel_i0(KAISER_BETA) : 0.0;
+			h[k] = cutoff*sinc*w;
+			sum += h[k];
+			}
+		printf("{");
+		for (int k = 0; k < TAPS; k++) {
+			printf("%ld%s", lround(h[k]/sum*(double)(1 << 30)), k + 1 < TAPS ? ", " : "");
+			}
+		printf("}%s\n", p < PHASES ? "," : "");
+		}
+	printf("};\n\n");
+	}
+
+
+int main(void){
+	printf("// Generated by asrc/asrcgen.c, do not edit : run make -C asrc to regenerate.\n");
+	printf("// Polyphase filters of the ASRC, Kaiser windowed sinc, beta %.1f, see audio_asrc.h\n\n", KAISER_BETA);
+	printf("#include \"audio_asrc.h\"\n\n");
+	printf("#if AUDIO_ASRC_TAPS != %d || AUDIO_ASRC_PHASES_LOG2 != %d\n", TAPS, PHASES_LOG2);
+	printf("#error \"the ASRC filter tables do not match audio_asrc.h, run make -C asrc\"\n");
+	printf("#endif\n\n");
+	printf("// up to the output rate, cut at the input Nyquist frequency\n");
+	table("AUDIO_ASRC_Coef_Full", 1.0);
+	printf("#if AUDIO_ASRC_OUT_FREQ == 48000\n\n");
+	for (uint32_t i = 0; i < DECIM_NUM; i++) {
+		printf("// %u Hz to %u Hz, cut at the output Nyquist frequency\n", Decim[i].freq_in, Decim[i].freq_out);
+		table(Decim[i].name, (double)Decim[i].freq_out/Decim[i].freq_in);
+		}
+	printf("#endif\n\n");
+	printf("// The first table is the default, the list ends with a NULL table\n");
+	printf("const AUDIO_ASRC_TableTypeDef AUDIO_ASRC_Tables[] = {\n");
+	printf("{0, 0, AUDIO_ASRC_Coef_Full},\n");
+	printf("#if AUDIO_ASRC_OUT_FREQ == 48000\n");
+	for (uint32_t i = 0; i < DECIM_NUM; i++) {
+		printf("{%u, %u, %s},\n", Decim[i].freq_in, Decim[i].freq_out, Decim[i].name);
+		}
+	printf("#endif\n");
+	printf("{0, 0, NULL}\n");
+	printf("};\n");
+	return 0;
+	}
@@ -2,33 +2,29 @@
 #include "bsp_audio.h"
 																										#include "stm32f4xx_ll_dma.h"
 
-const uint32_t I2SFreq[3] = {44100, 48000, 96000};
-
-#if defined(STM32F411xE) && defined(USE_MCLK_OUT) // Makefile compile flag
-
-const I2S_CLK_CONFIG I2S_Clk_Config24[3]  = {
-{271, 2, 6, 0, 0x0B06EAB0}, // 44.1081
-{258, 3, 3, 1, 0x0BFF6DB2}, // 47.9911
-{344, 2, 3, 1, 0x17FEDB64}  // 95.9821
-};
-
-#else
-
-const I2S_CLK_CONFIG I2S_Clk_Config24[3]  = {
-{429, 4, 19, 0, 0x0B065E56}, // 44.0995  
-{384, 5, 12, 1, 0x0C000000}, // 48.0000  
-{424, 3, 11, 1, 0x1800ED70}  // 96.0144  
-};
-
-#endif
+// I2S_Clk_Config24[] is generated in bsp_audio_clk.c
 
 I2S_HandleTypeDef  haudio_i2s;
 DMA_HandleTypeDef hdma_i2sTx;
+#ifdef USE_AUDIO_CROSSOVER
+// second output, see bsp_audio.h
+I2S_HandleTypeDef  haudio_i2sy;
+DMA_HandleTypeDef hdma_i2syTx;
+#endif
 
 
 static void I2Sx_Init(uint32_t AudioFreq);
 static void I2Sx_DeInit(void);
-static HAL_StatusTypeDef I2S_Config_I2SPR(uint32_t regVal);
+static const I2S_CLK_CONFIG* I2Sx_GetClkConfig(uint32_t AudioFreq);
+static HAL_StatusTypeDef I2S_Config_PLLI2S(const I2S_CLK_CONFIG* cfg);
+#ifdef USE_I2S_DOUBLE_BUFFER
+static uint8_t I2Sx_StartDoubleBuffer(uint16_t* pBuffer0, uint16_t* pBuffer1, uint32_t Size);
+static void I2Sx_DMA_M0Cplt(DMA_HandleTypeDef *hdma);
+static void I2Sx_DMA_M1Cplt(DMA_HandleTypeDef *hdma);
+static void I2Sx_DMA_Error(DMA_HandleTypeDef *hdma);
+// halfwords in each period buffer
+static uint32_t dbuf_size = 0;
+#endif
 void BSP_AUDIO_OUT_ChangeAudioConfig(uint32_t AudioOutOption);
 
 /**
@@ -71,13 +67,13 @@ void BSP_AUDIO_OUT_DeInit(void) {
 
 /**
   * @brief  Starts playing audio stream from a data buffer for a determined size.
+  *         The DAC mute output is left as it is, the caller releases it with BSP_AUDIO_OUT_SetMute().
   * @param  pBuffer: Pointer to PCM samples buffer
   * @param  Size: number of bytes.
   * @retval AUDIO_OK if correct communication, else wrong communication
   */
 uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t Size) {
 	uint8_t ret = AUDIO_OK;
-	AUDIO_MUTE_OFF();
 	// I2s transmit of 24bit data requires number of words
 	if (HAL_I2S_Transmit_DMA(&haudio_i2s, pBuffer, Size/4) != HAL_OK)    {
 		ret = AUDIO_ERROR;
@@ -86,14 +82,132 @@ uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t Size) {
 	}
 
 
+#ifdef USE_I2S_DOUBLE_BUFFER
+/**
+  * @brief  Starts playing audio stream with the DMA in double buffer mode, see bsp_audio.h
+  *         The DAC mute output is left as it is, like BSP_AUDIO_OUT_Play().
+  * @param  pBuffer0: first period buffer, played first
+  * @param  pBuffer1: second period buffer
+  * @param  Size: number of bytes of each period buffer
+  * @retval AUDIO_OK if correct communication, else wrong communication
+  */
+uint8_t BSP_AUDIO_OUT_PlayDoubleBuffer(uint16_t* pBuffer0, uint16_t* pBuffer1, uint32_t Size) {
+	if (I2Sx_StartDoubleBuffer(pBuffer0, pBuffer1, Size) != AUDIO_OK) {
+		return AUDIO_ERROR;
+		}
+	if (HAL_IS_BIT_CLR(haudio_i2s.Instance->I2SCFGR, SPI_I2SCFGR_I2SE)) {
+		__HAL_I2S_ENABLE(&haudio_i2s);
+		}
+	return AUDIO_OK;
+	}
+
+
+/**
+  * @brief  Start the I2S2 DMA in double buffer mode, the I2S is enabled by the caller
+  * @param  pBuffer0: first period buffer, played first
+  * @param  pBuffer1: second period buffer
+  * @param  Size: number of bytes of each period buffer
+  * @retval AUDIO_OK if correct communication, else wrong communication
+  */
+static uint8_t I2Sx_StartDoubleBuffer(uint16_t* pBuffer0, uint16_t* pBuffer1, uint32_t Size) {
+	if (Size/2 > DMA_MAX_SZE || haudio_i2s.State != HAL_I2S_STATE_READY) {
+		return AUDIO_ERROR;
+		}
+	// HAL_I2S_Transmit_DMA() has no double buffer mode, the stream is started here and the I2S handle state
+	// is set as if it had been, so that HAL_I2S_DMAPause(), HAL_I2S_DMAResume() and HAL_I2S_DMAStop() still apply
+	haudio_i2s.State = HAL_I2S_STATE_BUSY_TX;
+	haudio_i2s.ErrorCode = HAL_I2S_ERROR_NONE;
+	haudio_i2s.hdmatx->XferCpltCallback = I2Sx_DMA_M0Cplt;
+	haudio_i2s.hdmatx->XferM1CpltCallback = I2Sx_DMA_M1Cplt;
+	haudio_i2s.hdmatx->XferHalfCpltCallback = NULL;
+	haudio_i2s.hdmatx->XferM1HalfCpltCallback = NULL;
+	haudio_i2s.hdmatx->XferErrorCallback = I2Sx_DMA_Error;
+	dbuf_size = Size/2;
+	// the I2S data register is 16bits, the DMA transfers halfwords
+	if (HAL_DMAEx_MultiBufferStart_IT(haudio_i2s.hdmatx, (uint32_t)pBuffer0, (uint32_t)&haudio_i2s.Instance->DR, (uint32_t)pBuffer1, Size/2) != HAL_OK) {
+		haudio_i2s.State = HAL_I2S_STATE_READY;
+		return AUDIO_ERROR;
+		}
+	SET_BIT(haudio_i2s.Instance->CR2, SPI_CR2_TXDMAEN);
+	return AUDIO_OK;
+	}
+
+
+#ifdef USE_AUDIO_CROSSOVER
+/**
+  * @brief  Starts playing the two outputs with their DMA in double buffer mode, see bsp_audio.h
+  *         The DAC mute output is left as it is, like BSP_AUDIO_OUT_Play().
+  * @param  pBuffer0: first period buffer of I2S2, played first
+  * @param  pBuffer1: second period buffer of I2S2
+  * @param  pBufferY0: first period buffer of the second output
+  * @param  pBufferY1: second period buffer of the second output
+  * @param  Size: number of bytes of each period buffer
+  * @retval AUDIO_OK if correct communication, else wrong communication
+  */
+uint8_t BSP_AUDIO_OUT_PlayDoubleBufferDual(uint16_t* pBuffer0, uint16_t* pBuffer1, uint16_t* pBufferY0, uint16_t* pBufferY1, uint32_t Size) {
+	if (haudio_i2sy.State != HAL_I2S_STATE_READY) {
+		return AUDIO_ERROR;
+		}
+	// no interrupt, the I2S2 DMA interrupt refills both outputs
+	haudio_i2sy.State = HAL_I2S_STATE_BUSY_TX;
+	haudio_i2sy.ErrorCode = HAL_I2S_ERROR_NONE;
+	if (HAL_DMAEx_MultiBufferStart(haudio_i2sy.hdmatx, (uint32_t)pBufferY0, (uint32_t)&haudio_i2sy.Instance->DR, (uint32_t)pBufferY1, Size/2) != HAL_OK) {
+		haudio_i2sy.State = HAL_I2S_STATE_READY;
+		return AUDIO_ERROR;
+		}
+	SET_BIT(haudio_i2sy.Instance->CR2, SPI_CR2_TXDMAEN);
+	if (I2Sx_StartDoubleBuffer(pBuffer0, pBuffer1, Size) != AUDIO_OK) {
+		HAL_I2S_DMAStop(&haudio_i2sy);
+		return AUDIO_ERROR;
+		}
+	// Both DMA have loaded their first halfword. The two masters start within a few bus cycles of each other, their
+	// frame clocks divide the same I2S clock by the same prescaler so the offset never changes.
+	__disable_irq();
+	__HAL_I2S_ENABLE(&haudio_i2sy);
+	__HAL_I2S_ENABLE(&haudio_i2s);
+	__enable_irq();
+	return AUDIO_OK;
+	}
+#endif
+
+
+/**
+  * @brief  Position in the period being played
+  * @param  pTarget: set to the period buffer being played, 0 or 1
+  * @retval halfwords left in this period buffer
+  */
+uint32_t BSP_AUDIO_OUT_GetRemainingPeriodSize(uint8_t* pTarget){
+	uint32_t ct, remaining;
+	// NDTR is reloaded when CT toggles, read again if the DMA switched buffers in between
+	do {
+		ct = AUDIO_I2Sx_DMAx_STREAM->CR & DMA_SxCR_CT;
+		remaining = LL_DMA_ReadReg(AUDIO_I2Sx_DMAx_STREAM, NDTR) & 0xFFFF;
+		} while (ct != (AUDIO_I2Sx_DMAx_STREAM->CR & DMA_SxCR_CT));
+	*pTarget = ct ? 1U : 0U;
+	return remaining;
+	}
+#endif
+
+
 /**
   * @brief  Transmit buffer via I2S interface
   * @param  pData: pointer to PCM samples buffer 
   * @param  Size: number of bytes to be written
+  * @note   In double buffer mode this replaces the period buffer that is not being played, without stopping
+  *         the stream. Size is ignored, it must be the period size given to BSP_AUDIO_OUT_PlayDoubleBuffer().
   */
 void BSP_AUDIO_OUT_ChangeBuffer(uint16_t *pData, uint16_t Size){
+#ifdef USE_I2S_DOUBLE_BUFFER
+	if (AUDIO_I2Sx_DMAx_STREAM->CR & DMA_SxCR_CT) {
+		HAL_DMAEx_ChangeMemory(haudio_i2s.hdmatx, (uint32_t)pData, MEMORY0);
+		}
+	else {
+		HAL_DMAEx_ChangeMemory(haudio_i2s.hdmatx, (uint32_t)pData, MEMORY1);
+		}
+#else
 	// I2s transmit of 24bit data requires number of words
 	HAL_I2S_Transmit_DMA(&haudio_i2s, pData, Size/4 );
+#endif
 	}
 
 
@@ -110,6 +224,11 @@ uint8_t BSP_AUDIO_OUT_Pause(void) {
 	if (HAL_I2S_DMAPause(&haudio_i2s) != HAL_OK)    {
 		ret =  AUDIO_ERROR;
     	}
+#ifdef USE_AUDIO_CROSSOVER
+	if (HAL_I2S_DMAPause(&haudio_i2sy) != HAL_OK)    {
+		ret =  AUDIO_ERROR;
+    	}
+#endif
 	AUDIO_MUTE_ON();
 	return ret;
 	}
@@ -125,6 +244,11 @@ uint8_t BSP_AUDIO_OUT_Pause(void) {
   */
 uint8_t BSP_AUDIO_OUT_Resume(void) {
 	uint8_t ret = AUDIO_OK;
+#ifdef USE_AUDIO_CROSSOVER
+	if (HAL_I2S_DMAResume(&haudio_i2sy)!= HAL_OK)    {
+		ret =  AUDIO_ERROR;
+    	}
+#endif
 	if (HAL_I2S_DMAResume(&haudio_i2s)!= HAL_OK)    {
 		ret =  AUDIO_ERROR;
     	}
@@ -142,6 +266,11 @@ uint8_t BSP_AUDIO_OUT_Stop(void) {
 	if (HAL_I2S_DMAStop(&haudio_i2s) != HAL_OK)    {
 		ret = AUDIO_ERROR;
     	}
+#ifdef USE_AUDIO_CROSSOVER
+	if (HAL_I2S_DMAStop(&haudio_i2sy) != HAL_OK)    {
+		ret = AUDIO_ERROR;
+    	}
+#endif
 	AUDIO_MUTE_ON();
 	return ret;
 	}
@@ -217,6 +346,35 @@ uint32_t BSP_AUDIO_OUT_GetRemainingDataSize(void){
 }
 
 
+/**
+  * @brief  Interrupt latency of the DMA event being serviced, from the halfwords transferred since the transfer
+  *         complete (or half transfer) event. Call at the start of the DMA interrupt, before the flags are cleared.
+  * @retval core clock cycles, to a quarter of a stereo sample. 0 if no event is pending.
+  */
+uint32_t BSP_AUDIO_OUT_GetEventLatency(void){
+  uint32_t remaining = LL_DMA_ReadReg(AUDIO_I2Sx_DMAx_STREAM, NDTR) & 0xFFFF;
+  uint32_t elapsed = 0U;
+#ifdef USE_I2S_DOUBLE_BUFFER
+  // NDTR is reloaded with the period size at each buffer switch, there is no half transfer event
+  if (LL_DMA_IsActiveFlag_TC4(DMA1) && remaining <= dbuf_size) {
+    elapsed = dbuf_size - remaining;
+  }
+#else
+  // circular mode over the whole buffer of haudio_i2s.TxXferSize halfwords
+  uint32_t size = haudio_i2s.TxXferSize;
+  if (LL_DMA_IsActiveFlag_TC4(DMA1)) {
+    elapsed = remaining <= size ? size - remaining : 0U;
+  }
+  else
+  if (LL_DMA_IsActiveFlag_HT4(DMA1)) {
+    elapsed = remaining <= size/2U ? size/2U - remaining : 0U;
+  }
+#endif
+  // 24bit data format, a stereo sample is 4 halfwords
+  return elapsed * (SystemCoreClock / (haudio_i2s.Init.AudioFreq * 4U));
+}
+
+
 /**
   * @brief Tx Transfer completed callbacks
   * @param hi2s: I2S handle
@@ -248,6 +406,36 @@ void HAL_I2S_ErrorCallback(I2S_HandleTypeDef *hi2s) {
 }
 
 
+#ifdef USE_I2S_DOUBLE_BUFFER
+/**
+  * @brief DMA double buffer mode, period buffer 0 played, the DMA now reads buffer 1
+  * @param hdma: DMA handle
+  */
+static void I2Sx_DMA_M0Cplt(DMA_HandleTypeDef *hdma){
+	BSP_AUDIO_OUT_HalfTransfer_CallBack();
+	}
+
+
+/**
+  * @brief DMA double buffer mode, period buffer 1 played, the DMA now reads buffer 0
+  * @param hdma: DMA handle
+  */
+static void I2Sx_DMA_M1Cplt(DMA_HandleTypeDef *hdma){
+	BSP_AUDIO_OUT_TransferComplete_CallBack();
+	}
+
+
+/**
+  * @brief DMA double buffer mode, transfer error
+  * @param hdma: DMA handle
+  */
+static void I2Sx_DMA_Error(DMA_HandleTypeDef *hdma){
+	SET_BIT(haudio_i2s.ErrorCode, HAL_I2S_ERROR_DMA);
+	BSP_AUDIO_OUT_Error_CallBack();
+	}
+#endif
+
+
 /**
   * @brief  Manages the DMA full Transfer complete event.
   */
@@ -335,6 +523,29 @@ __weak void BSP_AUDIO_OUT_MspInit(I2S_HandleTypeDef *hi2s, void *Params)
   
   HAL_NVIC_SetPriority(DMA1_Stream4_IRQn, 5, 0);
   HAL_NVIC_EnableIRQ(DMA1_Stream4_IRQn); 
+
+#ifdef USE_AUDIO_CROSSOVER
+  // second output, the DMA stream has no interrupt, see bsp_audio.h
+  AUDIO_I2Sy_CLK_ENABLE();
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+
+  GPIO_InitStruct.Pin = AUDIO_I2Sy_WS_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = AUDIO_I2Sy_AF;
+  HAL_GPIO_Init(AUDIO_I2Sy_WS_GPIO_PORT, &GPIO_InitStruct);
+  GPIO_InitStruct.Pin = AUDIO_I2Sy_SCK_PIN|AUDIO_I2Sy_SD_PIN;
+  HAL_GPIO_Init(AUDIO_I2Sy_SCK_SD_GPIO_PORT, &GPIO_InitStruct);
+
+  haudio_i2sy.Instance = AUDIO_I2Sy;
+  hdma_i2syTx.Instance = AUDIO_I2Sy_DMAx_STREAM;
+  hdma_i2syTx.Init = hdma_i2sTx.Init;
+  hdma_i2syTx.Init.Channel = AUDIO_I2Sy_DMAx_CHANNEL;
+  __HAL_LINKDMA(&haudio_i2sy, hdmatx, hdma_i2syTx);
+  HAL_DMA_DeInit(&hdma_i2syTx);
+  HAL_DMA_Init(&hdma_i2syTx);
+#endif
 }
 
 
@@ -358,6 +569,11 @@ __weak void BSP_AUDIO_OUT_MspDeInit(I2S_HandleTypeDef *hi2s, void *Params)
   //I2S pins configuration: MCK pin
   GPIO_InitStruct.Pin = GPIO_PIN_6;
   HAL_GPIO_DeInit(GPIOA, GPIO_InitStruct.Pin); 
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+  AUDIO_I2Sy_CLK_DISABLE();
+  HAL_GPIO_DeInit(AUDIO_I2Sy_WS_GPIO_PORT, AUDIO_I2Sy_WS_PIN);
+  HAL_GPIO_DeInit(AUDIO_I2Sy_SCK_SD_GPIO_PORT, AUDIO_I2Sy_SCK_PIN|AUDIO_I2Sy_SD_PIN);
 #endif
 	AUDIO_MUTE_ON();
 	GPIO_InitTypeDef  gpio_init_structure = {0};
@@ -367,82 +583,53 @@ __weak void BSP_AUDIO_OUT_MspDeInit(I2S_HandleTypeDef *hi2s, void *Params)
 
 
 /**
-  * @brief  Clock Config, assumes input to PLL I2S Block = 1MHz
+  * @brief  PLLI2S settings of a sampling frequency
+  * @param  AudioFreq: Audio frequency used to play the audio stream.
+  */
+static const I2S_CLK_CONFIG* I2Sx_GetClkConfig(uint32_t AudioFreq) {
+#ifdef USE_AUDIO_ASRC
+  // The I2S clock does not follow the stream, AudioFreq is AUDIO_ASRC_OUT_FREQ
+  return BSP_AUDIO_OUT_GetAsrcClkConfig(AudioFreq);
+#else
+  // Default PLL I2S configuration for 96000 Hz 24bit if the frequency is not supported
+  return BSP_AUDIO_OUT_GetClkConfig(AudioFreq);
+#endif
+}
+
+
+/**
+  * @brief  Clock Config, see the PLLI2S settings in bsp_audio_clk.c
   * @param 
   * @param  AudioFreq: Audio frequency used to play the audio stream.
   * @note   This API is called by BSP_AUDIO_OUT_Init() and BSP_AUDIO_OUT_SetFrequency()
   *         Being __weak it can be overwritten by the application     
   * @param  Params : pointer on additional configuration parameters, can be NULL.
   */
+// The register images of the table are written directly with one PLLI2S stop, and the lock is not waited for here :
+// the caller polls BSP_AUDIO_OUT_ClockReady() before starting the DMA. This runs in the OTG interrupt on a rate change.
 __weak void BSP_AUDIO_OUT_ClockConfig(I2S_HandleTypeDef *hi2s, uint32_t AudioFreq, void *Params) {
-  RCC_PeriphCLKInitTypeDef RCC_ExCLKInitStruct;
-  int index = 0, freqindex = -1;
-  
-  for(index = 0; index < 3; index++)  {
-	  if (I2SFreq[index] == AudioFreq) {
-		  freqindex = index;
-		  break;
-	  	  }
-  	  }
-  uint32_t N, R, I2SDIV, ODD, I2S_PR;
-#ifdef STM32F411xE
-  uint32_t MCKOE;
-#ifdef USE_MCLK_OUT
-    MCKOE = 1;
-#else        
-    MCKOE = 0;
-#endif
-#endif
-    // PLLI2S_VCO = f(VCO clock) = f(PLLI2S clock input)  (PLLI2SN/PLLM)
-    // I2SCLK = f(PLLI2S clock output) = f(VCO clock) / PLLI2SR
-
-  HAL_RCCEx_GetPeriphCLKConfig(&RCC_ExCLKInitStruct); 
-  if (freqindex != -1)  {
-    N = I2S_Clk_Config24[freqindex].N;
-    R = I2S_Clk_Config24[freqindex].R;
-    I2SDIV = I2S_Clk_Config24[freqindex].I2SDIV;
-    ODD = I2S_Clk_Config24[freqindex].ODD;
-
-    RCC_ExCLKInitStruct.PeriphClockSelection = RCC_PERIPHCLK_I2S;
-#ifdef STM32F411xE
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SM = 25;
-#endif
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SN = N;  
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SR = R;  
-    HAL_RCCEx_PeriphCLKConfig(&RCC_ExCLKInitStruct);     
-#ifdef STM32F411xE
-    I2S_PR = (MCKOE<<9) | (ODD<<8) | I2SDIV;
-#else
-    I2S_PR = (ODD<<8) | I2SDIV;
-#endif
-    I2S_Config_I2SPR(I2S_PR);
-    } 
-  else { // Default PLL I2S configuration for 96000 Hz 24bit
-    N = I2S_Clk_Config24[2].N;
-    R = I2S_Clk_Config24[2].R;
-    I2SDIV = I2S_Clk_Config24[2].I2SDIV;
-    ODD = I2S_Clk_Config24[2].ODD;
-
-    RCC_ExCLKInitStruct.PeriphClockSelection = RCC_PERIPHCLK_I2S;
-#ifdef STM32F411xE
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SM = 25;
-#endif
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SN = N;
-    RCC_ExCLKInitStruct.PLLI2S.PLLI2SR = R;
-    HAL_RCCEx_PeriphCLKConfig(&RCC_ExCLKInitStruct); 
-#ifdef STM32F411xE
-    I2S_PR = (MCKOE<<9) | (ODD<<8) | I2SDIV;
-#else
-    I2S_PR = (ODD<<8) | I2SDIV;
-#endif
-    I2S_Config_I2SPR(I2S_PR);
-  }
+  const I2S_CLK_CONFIG* cfg = I2Sx_GetClkConfig(AudioFreq);
+  // The PLLI2S is only stopped and relocked when its settings change, e.g. not on a restart at the same rate
+  static const I2S_CLK_CONFIG* cfg_locked = NULL;
+  if (cfg == cfg_locked && __HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY) != RESET) {
+    return;
+    }
+  // PLLI2S_VCO = f(VCO clock) = f(PLLI2S clock input)  (PLLI2SN/PLLM)
+  // I2SCLK = f(PLLI2S clock output) = f(VCO clock) / PLLI2SR
+  if (I2S_Config_PLLI2S(cfg) == HAL_OK) {
+    cfg_locked = cfg;
+    }
 }
 
 
-static HAL_StatusTypeDef I2S_Config_I2SPR(uint32_t regVal) {
+/**
+  * @brief  Write the PLLI2S and I2S prescaler register images and restart the PLLI2S, without waiting for the lock
+  * @param  cfg: settings from bsp_audio_clk.c
+  */
+static HAL_StatusTypeDef I2S_Config_PLLI2S(const I2S_CLK_CONFIG* cfg) {
 uint32_t tickstart = 0U;
     __HAL_RCC_PLLI2S_DISABLE();
+    // the PLL stops within a few cycles of its input clock
     tickstart = HAL_GetTick();
     while(__HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY)  != RESET) {
       if((HAL_GetTick() - tickstart ) > PLLI2S_TIMEOUT_VALUE) { 
@@ -450,17 +637,25 @@ uint32_t tickstart = 0U;
          }
       }
 
-    SPI2->I2SPR = regVal;
+    RCC->PLLI2SCFGR = cfg->plli2scfgr;
+    SPI2->I2SPR = cfg->i2spr;
+#ifdef USE_AUDIO_CROSSOVER
+    // the same prescaler, MCKOE included, so both outputs run at the same rate
+    AUDIO_I2Sy->I2SPR = cfg->i2spr;
+#endif
       
     __HAL_RCC_PLLI2S_ENABLE();
-    tickstart = HAL_GetTick();
-    while(__HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY)  == RESET)    {
-      if((HAL_GetTick() - tickstart ) > PLLI2S_TIMEOUT_VALUE)      {
-        return HAL_TIMEOUT;
-      }
-    }      
    return HAL_OK;
    }
+
+
+/**
+  * @brief  PLLI2S lock after BSP_AUDIO_OUT_Init()
+  * @retval 1 once the I2S clock is stable and the DMA can be started
+  */
+uint8_t BSP_AUDIO_OUT_ClockReady(void) {
+	return __HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY) != RESET ? 1U : 0U;
+	}
    
    
 /**
@@ -485,6 +680,16 @@ static void I2Sx_Init(uint32_t AudioFreq) {
   haudio_i2s.Init.FullDuplexMode = I2S_FULLDUPLEXMODE_DISABLE;  
 
   HAL_I2S_Init(&haudio_i2s); 
+  // HAL_I2S_Init() computes its own prescaler from the PLLI2S settings, the table entry is the one the feedback uses
+  haudio_i2s.Instance->I2SPR = I2Sx_GetClkConfig(AudioFreq)->i2spr;
+
+#ifdef USE_AUDIO_CROSSOVER
+  haudio_i2sy.Instance = AUDIO_I2Sy;
+  __HAL_I2S_DISABLE(&haudio_i2sy);
+  haudio_i2sy.Init = haudio_i2s.Init;
+  HAL_I2S_Init(&haudio_i2sy);
+  haudio_i2sy.Instance->I2SPR = haudio_i2s.Instance->I2SPR;
+#endif
 }
 
 
@@ -495,5 +700,10 @@ static void I2Sx_DeInit(void) {
   haudio_i2s.Instance = SPI2;
   __HAL_I2S_DISABLE(&haudio_i2s);
   HAL_I2S_DeInit(&haudio_i2s);
+#ifdef USE_AUDIO_CROSSOVER
+  haudio_i2sy.Instance = AUDIO_I2Sy;
+  __HAL_I2S_DISABLE(&haudio_i2sy);
+  HAL_I2S_DeInit(&haudio_i2sy);
+#endif
 }
 
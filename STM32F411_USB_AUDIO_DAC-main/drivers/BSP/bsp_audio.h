@@ -11,15 +11,29 @@
 #include "bsp_misc.h"
 
 
+// Sampling frequencies 32kHz, 44.1kHz, 48kHz, 88.2kHz, 96kHz
+#define AUDIO_FREQ_NUM						5
+// Fixed I2S sampling frequencies of the ASRC output 48kHz, 96kHz, see USE_AUDIO_ASRC
+#define AUDIO_ASRC_FREQ_NUM					2
+
+// PLLI2S settings, generated by plli2s/plli2s.c in bsp_audio_clk.c
 typedef struct I2S_CLK_CONFIG_ {
+	uint32_t freq;
+	uint32_t M; // F411 PLLI2SM, on F401 the main PLL M = 25 is used
 	uint32_t N;
 	uint32_t R;
 	uint32_t I2SDIV;
 	uint32_t ODD;
-	uint32_t nominal_fdbk;
+	uint32_t nominal_fdbk; // Fs/1000 in 10.22 format
+	uint32_t plli2scfgr; // RCC_PLLI2SCFGR register image
+	uint32_t i2spr; // SPI_I2SPR register image, with MCKOE for the MCLK output
 } I2S_CLK_CONFIG;
 
-extern const I2S_CLK_CONFIG I2S_Clk_Config24[];
+extern const I2S_CLK_CONFIG I2S_Clk_Config24[AUDIO_FREQ_NUM];
+extern const I2S_CLK_CONFIG I2S_Clk_ConfigAsrc[AUDIO_ASRC_FREQ_NUM];
+
+const I2S_CLK_CONFIG* BSP_AUDIO_OUT_GetClkConfig(uint32_t freq);
+const I2S_CLK_CONFIG* BSP_AUDIO_OUT_GetAsrcClkConfig(uint32_t freq);
 
 #define BSP_AUDIO_OUT_CIRCULARMODE      ((uint32_t)0x00000001) /* BUFFER CIRCULAR MODE */
 #define BSP_AUDIO_OUT_NORMALMODE        ((uint32_t)0x00000002) /* BUFFER NORMAL MODE   */
@@ -64,6 +78,28 @@ extern const I2S_CLK_CONFIG I2S_Clk_Config24[];
    
 #define AUDIO_I2Sx_DMAx_IRQHandler          DMA1_Stream4_IRQHandler
 
+#ifdef USE_AUDIO_CROSSOVER
+// Second stereo output for the tweeters of the crossover (see drivers/dsp/audio_crossover.h), on a second I2S DAC.
+// I2S3 is a master transmitter with the same settings and prescaler as I2S2, clocked by the same PLLI2S, and both are
+// enabled together so their frame clocks stay in lockstep. Its DMA runs in double buffer mode on its own period
+// buffers, without interrupts : both DMA streams switch buffers on the same frame and the I2S2 DMA interrupt refills
+// both. The DAC mute output drives both DACs.
+// PA15 - I2S3_WS, PB3 - I2S3_CK, PB5 - I2S3_SD. The red LED moves from PB3 to PB7, see bsp_misc.h.
+#define AUDIO_I2Sy                          SPI3
+#define AUDIO_I2Sy_CLK_ENABLE()             __HAL_RCC_SPI3_CLK_ENABLE()
+#define AUDIO_I2Sy_CLK_DISABLE()            __HAL_RCC_SPI3_CLK_DISABLE()
+#define AUDIO_I2Sy_AF                       GPIO_AF6_SPI3
+#define AUDIO_I2Sy_WS_PIN                   GPIO_PIN_15
+#define AUDIO_I2Sy_WS_GPIO_PORT             GPIOA
+#define AUDIO_I2Sy_SCK_PIN                  GPIO_PIN_3
+#define AUDIO_I2Sy_SD_PIN                   GPIO_PIN_5
+#define AUDIO_I2Sy_SCK_SD_GPIO_PORT         GPIOB
+
+// I2S3 transmit DMA : DMA1 stream 5, channel 0
+#define AUDIO_I2Sy_DMAx_STREAM              DMA1_Stream5
+#define AUDIO_I2Sy_DMAx_CHANNEL             DMA_CHANNEL_0
+#endif
+
 #define AUDIO_IRQ_PREPRIO           	5   // DMA int preemption priority level(0 is the highest)
 
 #define AUDIODATA_SIZE                      4   // 24-bit audio sample in 32-bit frame
@@ -77,6 +113,17 @@ extern const I2S_CLK_CONFIG I2S_Clk_Config24[];
 uint8_t BSP_AUDIO_OUT_Init(int16_t volume, uint32_t audioFreq, uint8_t options);
 uint8_t BSP_AUDIO_OUT_Play(uint16_t* pBuffer, uint32_t size);
 void    BSP_AUDIO_OUT_ChangeBuffer(uint16_t *pData, uint16_t size);
+#ifdef USE_I2S_DOUBLE_BUFFER
+// DMA double buffer mode : the DMA alternates between two period buffers (M0AR, M1AR) without stopping.
+// The half transfer callback reports the end of buffer 0 and the transfer complete callback the end of buffer 1,
+// the buffer that just completed can then be refilled or replaced with BSP_AUDIO_OUT_ChangeBuffer().
+uint8_t BSP_AUDIO_OUT_PlayDoubleBuffer(uint16_t* pBuffer0, uint16_t* pBuffer1, uint32_t size);
+uint32_t BSP_AUDIO_OUT_GetRemainingPeriodSize(uint8_t* pTarget);
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+// Like BSP_AUDIO_OUT_PlayDoubleBuffer(), the second output plays pBufferY0 and pBufferY1 in lockstep
+uint8_t BSP_AUDIO_OUT_PlayDoubleBufferDual(uint16_t* pBuffer0, uint16_t* pBuffer1, uint16_t* pBufferY0, uint16_t* pBufferY1, uint32_t size);
+#endif
 uint8_t BSP_AUDIO_OUT_Pause(void);
 uint8_t BSP_AUDIO_OUT_Resume(void);
 uint8_t BSP_AUDIO_OUT_Stop(void);
@@ -85,6 +132,8 @@ void    BSP_AUDIO_OUT_SetFrequency(uint32_t audioFreq);
 uint8_t BSP_AUDIO_OUT_SetMute(uint8_t mute);
 void    BSP_AUDIO_OUT_DeInit(void);
 uint32_t BSP_AUDIO_OUT_GetRemainingDataSize(void);
+uint32_t BSP_AUDIO_OUT_GetEventLatency(void);
+uint8_t BSP_AUDIO_OUT_ClockReady(void);
 
 /* User Callbacks: user has to implement these functions in his code if they are needed. */
 /* This function is called when the requested data has been completely transferred.*/
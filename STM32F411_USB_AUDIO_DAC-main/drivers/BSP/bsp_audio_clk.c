@@ -0,0 +1,88 @@
+// Generated by plli2s/plli2s.c, do not edit : run make -C plli2s to regenerate.
+// PLLI2S and I2S prescaler settings for each sampling frequency, see BSP_AUDIO_OUT_ClockConfig().
+// HSE 25MHz, I2SCLK = HSE / M * N / R
+
+#include "bsp_audio.h"
+
+#if defined(STM32F411xE) && defined(USE_MCLK_OUT) // Makefile compile flag
+
+// STM32F411, MCLK output : Fs = I2SCLK / (256 * (2*I2SDIV + ODD))
+const I2S_CLK_CONFIG I2S_Clk_Config24[AUDIO_FREQ_NUM] = {
+{32000, 25, 213, 2, 6, 1, 0x080013B1, 0x20003559, 0x306},  // 32.0012 kHz, +37.6 ppm
+{44100, 20, 289, 2, 8, 0, 0x0B064400, 0x20004854, 0x208},  // 44.0979 kHz, -47.6 ppm
+{48000, 16, 173, 2, 5, 1, 0x0BFFBBA3, 0x20002B50, 0x305},  // 47.9958 kHz, -86.9 ppm
+{88200, 20, 289, 2, 4, 0, 0x160C8800, 0x20004854, 0x204},  // 88.1958 kHz, -47.6 ppm
+{96000, 25, 344, 2, 3, 1, 0x17FEDB6E, 0x20005619, 0x303}   // 95.9821 kHz, -186.0 ppm
+};
+
+// Fixed I2S clocks of the ASRC output, highest VCO input frequency first
+const I2S_CLK_CONFIG I2S_Clk_ConfigAsrc[AUDIO_ASRC_FREQ_NUM] = {
+{48000, 16, 173, 2, 5, 1, 0x0BFFBBA3, 0x20002B50, 0x305},  // 47.9958 kHz, -86.9 ppm
+{96000, 16, 236, 3, 2, 1, 0x1801D555, 0x30003B10, 0x302}   // 96.0286 kHz, +298.4 ppm
+};
+
+#elif defined(STM32F411xE)
+
+// STM32F411, no MCLK output : Fs = I2SCLK / (64 * (2*I2SDIV + ODD))
+const I2S_CLK_CONFIG I2S_Clk_Config24[AUDIO_FREQ_NUM] = {
+{32000, 25, 256, 5, 12, 1, 0x08000000, 0x50004019, 0x10C},  // 32.0000 kHz, +0.0 ppm
+{44100, 25, 429, 4, 19, 0, 0x0B065E51, 0x40006B59, 0x013},  // 44.0995 kHz, -11.2 ppm
+{48000, 25, 384, 5, 12, 1, 0x0C000000, 0x50006019, 0x10C},  // 48.0000 kHz, +0.0 ppm
+{88200, 25, 429, 4, 9, 1, 0x160CBCA2, 0x40006B59, 0x109},  // 88.1990 kHz, -11.2 ppm
+{96000, 16, 173, 2, 11, 0, 0x17FF7746, 0x20002B50, 0x00B}   // 95.9917 kHz, -86.9 ppm
+};
+
+// Fixed I2S clocks of the ASRC output, highest VCO input frequency first
+const I2S_CLK_CONFIG I2S_Clk_ConfigAsrc[AUDIO_ASRC_FREQ_NUM] = {
+{48000, 16, 232, 2, 29, 1, 0x0C0008AE, 0x20003A10, 0x11D},  // 48.0005 kHz, +11.0 ppm
+{96000, 16, 173, 2, 11, 0, 0x17FF7746, 0x20002B50, 0x00B}   // 95.9917 kHz, -86.9 ppm
+};
+
+#else
+
+// STM32F401, no MCLK output, M = 25 is set by the main PLL : Fs = I2SCLK / (64 * (2*I2SDIV + ODD))
+const I2S_CLK_CONFIG I2S_Clk_Config24[AUDIO_FREQ_NUM] = {
+{32000, 25, 256, 5, 12, 1, 0x08000000, 0x50004000, 0x10C},  // 32.0000 kHz, +0.0 ppm
+{44100, 25, 429, 4, 19, 0, 0x0B065E51, 0x40006B40, 0x013},  // 44.0995 kHz, -11.2 ppm
+{48000, 25, 384, 5, 12, 1, 0x0C000000, 0x50006000, 0x10C},  // 48.0000 kHz, +0.0 ppm
+{88200, 25, 429, 4, 9, 1, 0x160CBCA2, 0x40006B40, 0x109},  // 88.1990 kHz, -11.2 ppm
+{96000, 25, 424, 3, 11, 1, 0x1800ED73, 0x30006A00, 0x10B}   // 96.0145 kHz, +151.0 ppm
+};
+
+// Fixed I2S clocks of the ASRC output, highest VCO input frequency first
+const I2S_CLK_CONFIG I2S_Clk_ConfigAsrc[AUDIO_ASRC_FREQ_NUM] = {
+{48000, 25, 384, 5, 12, 1, 0x0C000000, 0x50006000, 0x10C},  // 48.0000 kHz, +0.0 ppm
+{96000, 25, 424, 3, 11, 1, 0x1800ED73, 0x30006A00, 0x10B}   // 96.0145 kHz, +151.0 ppm
+};
+
+#endif
+
+
+/**
+ * @brief  PLLI2S settings for a sampling frequency
+ * @param  freq: sampling frequency [Hz]
+ * @retval settings, the 96kHz settings if the frequency is not supported
+ */
+const I2S_CLK_CONFIG* BSP_AUDIO_OUT_GetClkConfig(uint32_t freq) {
+	for (int index = 0; index < AUDIO_FREQ_NUM; index++) {
+		if (I2S_Clk_Config24[index].freq == freq) {
+			return &I2S_Clk_Config24[index];
+			}
+		}
+	return &I2S_Clk_Config24[AUDIO_FREQ_NUM - 1];
+	}
+
+
+/**
+ * @brief  Fixed PLLI2S settings of the ASRC output (USE_AUDIO_ASRC)
+ * @param  freq: I2S sampling frequency [Hz], AUDIO_ASRC_OUT_FREQ
+ * @retval settings, the 48kHz settings if the frequency is not supported
+ */
+const I2S_CLK_CONFIG* BSP_AUDIO_OUT_GetAsrcClkConfig(uint32_t freq) {
+	for (int index = 0; index < AUDIO_ASRC_FREQ_NUM; index++) {
+		if (I2S_Clk_ConfigAsrc[index].freq == freq) {
+			return &I2S_Clk_ConfigAsrc[index];
+			}
+		}
+	return &I2S_Clk_ConfigAsrc[0];
+	}
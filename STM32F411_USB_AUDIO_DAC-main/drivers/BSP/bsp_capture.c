@@ -0,0 +1,286 @@
+#include "main.h"
+#include "bsp_capture.h"
+
+static uint8_t  I2Sext_Start(uint16_t* ring, uint32_t size);
+static void     I2Sext_Stop(void);
+static uint32_t I2Sext_GetRemaining(void);
+static uint8_t  Adc_Start(uint16_t* ring, uint32_t size);
+static void     Adc_Stop(void);
+static uint32_t Adc_GetRemaining(void);
+
+const BSP_CAPTURE_SourceTypeDef BSP_CAPTURE_I2Sext = {
+	"I2S2ext",
+	BSP_CAPTURE_FORMAT_I2S24,
+	4U,
+	I2Sext_Start,
+	I2Sext_Stop,
+	I2Sext_GetRemaining,
+	};
+
+const BSP_CAPTURE_SourceTypeDef BSP_CAPTURE_Adc = {
+	"ADC1",
+	BSP_CAPTURE_FORMAT_ADC12,
+	2U,
+	Adc_Start,
+	Adc_Stop,
+	Adc_GetRemaining,
+	};
+
+// sized for the I2S format, the ADC format only uses half of it
+static uint16_t capture_ring[BSP_CAPTURE_RING_SAMPLES * 4U];
+static const BSP_CAPTURE_SourceTypeDef* capture_source = NULL;
+static uint8_t capture_running = 0;
+// next stereo sample to read from the ring
+static uint32_t capture_rd = 0;
+
+
+/**
+ * @brief  Select the capture source, call before the USB device is started
+ * @param  source: BSP_CAPTURE_I2Sext or BSP_CAPTURE_Adc
+ */
+void BSP_CAPTURE_SetSource(const BSP_CAPTURE_SourceTypeDef* source){
+	BSP_CAPTURE_Stop();
+	capture_source = source;
+	}
+
+
+const BSP_CAPTURE_SourceTypeDef* BSP_CAPTURE_GetSource(void){
+	return capture_source;
+	}
+
+
+/**
+ * @brief  Restart the capture at the beginning of the ring. The I2S2 master must be running, the sample rate
+ *         is the I2S2 frame rate.
+ * @retval AUDIO_OK, AUDIO_TIMEOUT if there is no I2S2 frame clock, AUDIO_ERROR if no source is selected
+ */
+uint8_t BSP_CAPTURE_Start(void){
+	BSP_CAPTURE_Stop();
+	if (capture_source == NULL) {
+		return AUDIO_ERROR;
+		}
+	capture_rd = 0U;
+	uint8_t ret = capture_source->Start(capture_ring, BSP_CAPTURE_RING_SAMPLES * capture_source->sample_halfwords);
+	capture_running = ret == AUDIO_OK ? 1U : 0U;
+	return ret;
+	}
+
+
+void BSP_CAPTURE_Stop(void){
+	if (capture_source != NULL && capture_running) {
+		capture_source->Stop();
+		}
+	capture_running = 0U;
+	}
+
+
+/**
+ * @brief  Stereo samples captured and not read yet. The ring is overwritten after BSP_CAPTURE_RING_SAMPLES,
+ *         the caller keeps this well below.
+ */
+uint32_t BSP_CAPTURE_GetAvailable(void){
+	if (capture_running == 0U) {
+		return 0U;
+		}
+	uint32_t hw = capture_source->sample_halfwords;
+	// complete stereo samples written by the DMA
+	uint32_t wr = ((BSP_CAPTURE_RING_SAMPLES * hw - capture_source->GetRemaining()) / hw) % BSP_CAPTURE_RING_SAMPLES;
+	return (wr + BSP_CAPTURE_RING_SAMPLES - capture_rd) % BSP_CAPTURE_RING_SAMPLES;
+	}
+
+
+/**
+ * @brief  Read stereo samples as 16bit signed, left then right, the USB 16bit packet format
+ * @param  pDst: 2 x samples halfwords
+ * @param  samples: stereo samples to read
+ * @retval stereo samples read, less than requested if fewer are available
+ */
+uint32_t BSP_CAPTURE_Read(int16_t* pDst, uint32_t samples){
+	uint32_t avail = BSP_CAPTURE_GetAvailable();
+	if (samples > avail) {
+		samples = avail;
+		}
+	uint32_t hw = capture_source->sample_halfwords;
+	uint32_t rd = capture_rd;
+	for (uint32_t i = 0; i < samples; i++) {
+		const uint16_t* p = &capture_ring[rd * hw];
+		if (capture_source->format == BSP_CAPTURE_FORMAT_I2S24) {
+			// the 16 MSbits of each 24bit sample
+			pDst[0] = (int16_t)p[0];
+			pDst[1] = (int16_t)p[2];
+			}
+		else {
+			// left aligned unsigned to signed
+			pDst[0] = (int16_t)(p[0] ^ 0x8000U);
+			pDst[1] = (int16_t)(p[1] ^ 0x8000U);
+			}
+		pDst += 2;
+		if (++rd == BSP_CAPTURE_RING_SAMPLES) {
+			rd = 0U;
+			}
+		}
+	capture_rd = rd;
+	return samples;
+	}
+
+
+/**
+ * @brief  Drop stereo samples, e.g. to recentre the read position after an overrun
+ */
+void BSP_CAPTURE_Skip(uint32_t samples){
+	capture_rd = (capture_rd + samples) % BSP_CAPTURE_RING_SAMPLES;
+	}
+
+
+// Circular peripheral to memory halfword transfers, direct mode so that each halfword is in the ring as soon as
+// it is received
+static void Capture_DMA_Start(DMA_TypeDef* dma, uint32_t stream, uint32_t channel, uint32_t periph, uint16_t* ring, uint32_t size){
+	LL_DMA_DisableStream(dma, stream);
+	while (LL_DMA_IsEnabledStream(dma, stream)) {
+		}
+	LL_DMA_SetChannelSelection(dma, stream, channel);
+	LL_DMA_ConfigTransfer(dma, stream, LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_PRIORITY_HIGH | LL_DMA_MODE_CIRCULAR |
+		LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD);
+	LL_DMA_DisableFifoMode(dma, stream);
+	LL_DMA_SetPeriphAddress(dma, stream, periph);
+	LL_DMA_SetMemoryAddress(dma, stream, (uint32_t)ring);
+	LL_DMA_SetDataLength(dma, stream, size);
+	LL_DMA_EnableStream(dma, stream);
+	}
+
+
+static void Capture_DMA_Stop(DMA_TypeDef* dma, uint32_t stream){
+	LL_DMA_DisableStream(dma, stream);
+	while (LL_DMA_IsEnabledStream(dma, stream)) {
+		}
+	}
+
+
+/**
+ * @brief  I2S2ext slave receiver, clocked by the I2S2 master BCK and WS
+ */
+static uint8_t I2Sext_Start(uint16_t* ring, uint32_t size){
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIO_InitStruct.Pin = CAPTURE_I2S_SD_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF6_I2S2ext;
+	HAL_GPIO_Init(CAPTURE_I2S_SD_PORT, &GPIO_InitStruct);
+
+	// I2S2ext shares the SPI2 clock enabled by BSP_AUDIO_OUT_MspInit(). Slave receiver, Philips standard,
+	// 24bit data in a 32bit frame, the format of the I2S2 master. I2SPR is not used in slave mode.
+	I2S2ext->I2SCFGR = 0U;
+	I2S2ext->CR2 = 0U;
+	I2S2ext->I2SPR = 2U;
+	I2S2ext->I2SCFGR = SPI_I2SCFGR_I2SMOD | SPI_I2SCFGR_I2SCFG_0 | SPI_I2SCFGR_DATLEN_0 | SPI_I2SCFGR_CHLEN;
+	// clear RXNE and OVR
+	(void)I2S2ext->DR;
+	(void)I2S2ext->SR;
+
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	LL_DMA_ClearFlag_TC3(CAPTURE_I2S_DMA);
+	LL_DMA_ClearFlag_HT3(CAPTURE_I2S_DMA);
+	LL_DMA_ClearFlag_TE3(CAPTURE_I2S_DMA);
+	LL_DMA_ClearFlag_DME3(CAPTURE_I2S_DMA);
+	LL_DMA_ClearFlag_FE3(CAPTURE_I2S_DMA);
+	Capture_DMA_Start(CAPTURE_I2S_DMA, CAPTURE_I2S_DMA_STREAM, CAPTURE_I2S_DMA_CHANNEL, (uint32_t)&I2S2ext->DR, ring, size);
+	I2S2ext->CR2 = SPI_CR2_RXDMAEN;
+
+	// With the Philips standard the slave is enabled while WS is high and starts with the next left channel, so the
+	// ring starts with a left sample. Wait for a rising edge, the enable is then well before the falling edge.
+	// Half a frame is 16us at 32kHz, the timeout is at least 100us.
+	uint32_t timeout = SystemCoreClock / 10000U;
+	while ((AUDIO_I2Sx_SCK_SD_WS_GPIO_PORT->IDR & AUDIO_I2Sx_WS_PIN) != 0U && --timeout) {
+		}
+	while ((AUDIO_I2Sx_SCK_SD_WS_GPIO_PORT->IDR & AUDIO_I2Sx_WS_PIN) == 0U && timeout && --timeout) {
+		}
+	if (timeout == 0U) {
+		I2Sext_Stop();
+		return AUDIO_TIMEOUT;
+		}
+	I2S2ext->I2SCFGR |= SPI_I2SCFGR_I2SE;
+	return AUDIO_OK;
+	}
+
+
+static void I2Sext_Stop(void){
+	I2S2ext->I2SCFGR &= ~SPI_I2SCFGR_I2SE;
+	I2S2ext->CR2 = 0U;
+	Capture_DMA_Stop(CAPTURE_I2S_DMA, CAPTURE_I2S_DMA_STREAM);
+	}
+
+
+static uint32_t I2Sext_GetRemaining(void){
+	return LL_DMA_GetDataLength(CAPTURE_I2S_DMA, CAPTURE_I2S_DMA_STREAM);
+	}
+
+
+/**
+ * @brief  ADC1 scan of the two channels on each rising edge of the I2S2 WS, through TIM3
+ */
+static uint8_t Adc_Start(uint16_t* ring, uint32_t size){
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	GPIO_InitStruct.Pin = CAPTURE_ADC_PINS;
+	GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	HAL_GPIO_Init(CAPTURE_ADC_PORT, &GPIO_InitStruct);
+	// no conversions if the WS wire is missing
+	GPIO_InitStruct.Pin = CAPTURE_ADC_WS_PIN;
+	GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	GPIO_InitStruct.Alternate = GPIO_AF2_TIM3;
+	HAL_GPIO_Init(CAPTURE_ADC_WS_PORT, &GPIO_InitStruct);
+
+	// TIM3 in slave reset mode on the rising edges of TI1 (TS = TI1FP1, SMS = reset). The reset is the TRGO
+	// (MMS = reset) that triggers ADC1.
+	__HAL_RCC_TIM3_CLK_ENABLE();
+	CAPTURE_ADC_TIM->CR1 = 0U;
+	CAPTURE_ADC_TIM->CR2 = 0U;
+	CAPTURE_ADC_TIM->PSC = 0U;
+	CAPTURE_ADC_TIM->ARR = 0xFFFFU;
+	CAPTURE_ADC_TIM->CCMR1 = TIM_CCMR1_CC1S_0; // IC1 mapped on TI1
+	CAPTURE_ADC_TIM->CCER = 0U; // rising edge
+	CAPTURE_ADC_TIM->SMCR = TIM_SMCR_TS_2 | TIM_SMCR_TS_0 | TIM_SMCR_SMS_2;
+	CAPTURE_ADC_TIM->EGR = TIM_EGR_UG;
+	CAPTURE_ADC_TIM->CR1 = TIM_CR1_CEN;
+
+	// ADCCLK = PCLK2/4, 24MHz on F411. Each conversion takes 56 + 12 cycles, the scan of both channels 5.7us,
+	// within the 10.4us frame at 96kHz. Left aligned 12bit, the DMA requests continue in circular mode (DDS).
+	__HAL_RCC_ADC1_CLK_ENABLE();
+	ADC1->CR2 = 0U;
+	ADC->CCR = (ADC->CCR & ~ADC_CCR_ADCPRE) | ADC_CCR_ADCPRE_0;
+	ADC1->CR1 = ADC_CR1_SCAN;
+	ADC1->SMPR2 = (3U << ADC_SMPR2_SMP4_Pos) | (3U << ADC_SMPR2_SMP5_Pos);
+	ADC1->SQR1 = 1U << ADC_SQR1_L_Pos; // 2 conversions
+	ADC1->SQR3 = (CAPTURE_ADC_CHANNEL_L << ADC_SQR3_SQ1_Pos) | (CAPTURE_ADC_CHANNEL_R << ADC_SQR3_SQ2_Pos);
+	ADC1->SR = 0U;
+
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	LL_DMA_ClearFlag_TC0(CAPTURE_ADC_DMA);
+	LL_DMA_ClearFlag_HT0(CAPTURE_ADC_DMA);
+	LL_DMA_ClearFlag_TE0(CAPTURE_ADC_DMA);
+	LL_DMA_ClearFlag_DME0(CAPTURE_ADC_DMA);
+	LL_DMA_ClearFlag_FE0(CAPTURE_ADC_DMA);
+	Capture_DMA_Start(CAPTURE_ADC_DMA, CAPTURE_ADC_DMA_STREAM, CAPTURE_ADC_DMA_CHANNEL, (uint32_t)&ADC1->DR, ring, size);
+
+	// external trigger on the rising edge of TIM3 TRGO (EXTSEL = 8)
+	ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_ALIGN | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_EXTEN_0 | (8U << ADC_CR2_EXTSEL_Pos);
+	return AUDIO_OK;
+	}
+
+
+static void Adc_Stop(void){
+	ADC1->CR2 = 0U;
+	CAPTURE_ADC_TIM->CR1 = 0U;
+	Capture_DMA_Stop(CAPTURE_ADC_DMA, CAPTURE_ADC_DMA_STREAM);
+	}
+
+
+static uint32_t Adc_GetRemaining(void){
+	return LL_DMA_GetDataLength(CAPTURE_ADC_DMA, CAPTURE_ADC_DMA_STREAM);
+	}
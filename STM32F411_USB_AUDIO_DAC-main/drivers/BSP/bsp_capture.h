@@ -0,0 +1,78 @@
+#ifndef __BSP_CAPTURE_H
+#define __BSP_CAPTURE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "main.h"
+
+// Audio capture for the isochronous IN endpoint (USE_AUDIO_CAPTURE, see Makefile C_DEFS).
+//
+// A capture source fills a ring buffer with a circular DMA, the write position is read from the DMA NDTR register.
+// The sources are clocked by the I2S2 frame clock (WS), so the captured samples are locked to the playback samples
+// and to the PLLI2S crystal. The I2S2 master must be running, usbd_audio.c plays silence when there is no playback.
+//
+// BSP_CAPTURE_I2Sext : I2S2ext full duplex slave receiver, data on PB14. An I2S ADC (e.g. PCM1808) is connected to
+//   the I2S2 BCK and WS pins as a slave. 24bit Philips standard, the same frame format as the DAC.
+// BSP_CAPTURE_Adc : internal ADC1, PA4 = left, PA5 = right. ADC1 is triggered by TIM3 TRGO, TIM3 is reset on each
+//   rising edge of TI1 = PB4 which must be wired to the I2S2 WS pin PB12. 12bit, both channels are sampled 3us apart.
+//
+// Select the source with -DAUDIO_CAPTURE_SOURCE=BSP_CAPTURE_Adc, the default is the I2S2ext receiver.
+
+// Stereo samples in the ring buffer, 5ms at 96kHz
+#define BSP_CAPTURE_RING_SAMPLES            512U
+
+typedef enum {
+	BSP_CAPTURE_FORMAT_I2S24 = 0,  // {hi_L:mid_L}, {lo_L:0x00}, {hi_R:mid_R}, {lo_R:0x00}, like the I2S output buffer
+	BSP_CAPTURE_FORMAT_ADC12,      // {L}, {R}, left aligned unsigned 12bit
+	} BSP_CAPTURE_FormatTypeDef;
+
+typedef struct {
+	const char* name;
+	BSP_CAPTURE_FormatTypeDef format;
+	uint32_t sample_halfwords;                         // halfwords of a stereo sample in the ring
+	uint8_t  (*Start)(uint16_t* ring, uint32_t size);  // start the circular DMA, size in halfwords
+	void     (*Stop)(void);
+	uint32_t (*GetRemaining)(void);                    // DMA NDTR, halfwords left to the end of the ring
+	} BSP_CAPTURE_SourceTypeDef;
+
+extern const BSP_CAPTURE_SourceTypeDef BSP_CAPTURE_I2Sext;
+extern const BSP_CAPTURE_SourceTypeDef BSP_CAPTURE_Adc;
+
+#ifndef AUDIO_CAPTURE_SOURCE
+#define AUDIO_CAPTURE_SOURCE                BSP_CAPTURE_I2Sext
+#endif
+
+// I2S2ext receive DMA : DMA1 stream 3, channel 3
+#define CAPTURE_I2S_DMA                     DMA1
+#define CAPTURE_I2S_DMA_STREAM              LL_DMA_STREAM_3
+#define CAPTURE_I2S_DMA_CHANNEL             LL_DMA_CHANNEL_3
+#define CAPTURE_I2S_SD_PIN                  GPIO_PIN_14
+#define CAPTURE_I2S_SD_PORT                 GPIOB
+
+// ADC1 DMA : DMA2 stream 0, channel 0
+#define CAPTURE_ADC_DMA                     DMA2
+#define CAPTURE_ADC_DMA_STREAM              LL_DMA_STREAM_0
+#define CAPTURE_ADC_DMA_CHANNEL             LL_DMA_CHANNEL_0
+#define CAPTURE_ADC_CHANNEL_L               4U  // PA4
+#define CAPTURE_ADC_CHANNEL_R               5U  // PA5
+#define CAPTURE_ADC_PINS                    (GPIO_PIN_4 | GPIO_PIN_5)
+#define CAPTURE_ADC_PORT                    GPIOA
+#define CAPTURE_ADC_TIM                     TIM3
+#define CAPTURE_ADC_WS_PIN                  GPIO_PIN_4  // PB4, TIM3_CH1
+#define CAPTURE_ADC_WS_PORT                 GPIOB
+
+void     BSP_CAPTURE_SetSource(const BSP_CAPTURE_SourceTypeDef* source);
+const BSP_CAPTURE_SourceTypeDef* BSP_CAPTURE_GetSource(void);
+uint8_t  BSP_CAPTURE_Start(void);
+void     BSP_CAPTURE_Stop(void);
+uint32_t BSP_CAPTURE_GetAvailable(void);
+uint32_t BSP_CAPTURE_Read(int16_t* pDst, uint32_t samples);
+void     BSP_CAPTURE_Skip(uint32_t samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -114,3 +114,18 @@ void HAL_GPIO_EXTI_Callback(uint16_t gpioPin) {
 		}
 	}
 
+
+
+// RTC backup registers RTC_BKP0R..RTC_BKP19R keep their contents across a reset, and across a power cycle
+// only if VBAT is powered. The RTC itself does not need to be running.
+uint32_t BSP_BKP_Read(uint32_t index) {
+	return (&RTC->BKP0R)[index];
+	}
+
+
+void BSP_BKP_Write(uint32_t index, uint32_t value) {
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	(&RTC->BKP0R)[index] = value;
+	HAL_PWR_DisableBkUpAccess();
+	}
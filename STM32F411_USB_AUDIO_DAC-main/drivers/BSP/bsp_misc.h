@@ -21,7 +21,12 @@ extern volatile uint32_t BtnPressed; // PA0
 
 #define LED_GPIO_CLK_ENABLE()           __HAL_RCC_GPIOB_CLK_ENABLE()
 
+#ifdef USE_AUDIO_CROSSOVER
+// PB3 is the I2S3 bit clock of the second output, see bsp_audio.h
+#define LED_RED_PIN                      GPIO_PIN_7
+#else
 #define LED_RED_PIN                      GPIO_PIN_3
+#endif
 #define LED_GREEN_PIN                    GPIO_PIN_6
 #define LED_BLUE_PIN                     GPIO_PIN_9
 
@@ -43,6 +48,8 @@ void BSP_OnboardLED_On(void);
 void BSP_OnboardLED_Off(void);
 void BSP_OnboardLED_Toggle(void);
 uint32_t BSP_PB_GetState(void);
+uint32_t BSP_BKP_Read(uint32_t index);
+void BSP_BKP_Write(uint32_t index, uint32_t value);
 
 #ifdef __cplusplus
 }
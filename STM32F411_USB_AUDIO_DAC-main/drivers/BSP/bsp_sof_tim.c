@@ -0,0 +1,53 @@
+#include "main.h"
+#include "bsp_sof_tim.h"
+
+// nominal timer ticks per 1mS USB frame, assuming a 0ppm HSE crystal
+static uint32_t TicksPerFrame = 0;
+
+/**
+ * @brief  Configure TIM2 to capture the USB OTG FS SOF.
+ *         Call after the USB core is initialized, USB_CoreInit() overwrites GCCFG.
+ */
+void BSP_SOF_TIM_Init(void) {
+	uint32_t tim_clk = HAL_RCC_GetPCLK1Freq();
+	// APB1 timer clock is twice PCLK1 when the APB1 prescaler is not 1
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		tim_clk *= 2U;
+		}
+	TicksPerFrame = tim_clk / 1000U;
+
+	SOF_TIM_CLK_ENABLE();
+	SOF_TIM->CR1 = 0;
+	SOF_TIM->PSC = 0;
+	SOF_TIM->ARR = 0xFFFFFFFFU;
+	SOF_TIM->OR = TIM_OR_ITR1_RMP_1; // ITR1 = OTG FS SOF
+	SOF_TIM->SMCR = TIM_SMCR_TS_0; // TRGI = ITR1, slave mode disabled
+	SOF_TIM->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC1S_1; // IC1 mapped on TRC
+	SOF_TIM->CCER = TIM_CCER_CC1E; // capture on rising edge
+	SOF_TIM->EGR = TIM_EGR_UG;
+	SOF_TIM->CR1 = TIM_CR1_CEN;
+
+	// Enable the SOF pulse output, the GPIO (PA8) is not configured for OTG_FS_SOF so it stays internal
+	USB_OTG_FS->GCCFG |= USB_OTG_GCCFG_SOFOUTEN;
+	}
+
+/**
+ * @brief  Timer count latched at the last SOF
+ */
+uint32_t BSP_SOF_TIM_GetCapture(void) {
+	return SOF_TIM->CCR1;
+	}
+
+/**
+ * @brief  Timer ticks elapsed since the last SOF
+ */
+uint32_t BSP_SOF_TIM_GetElapsed(void) {
+	return SOF_TIM->CNT - SOF_TIM->CCR1;
+	}
+
+/**
+ * @brief  Nominal timer ticks per USB frame, 0 if the timer is not initialized
+ */
+uint32_t BSP_SOF_TIM_GetTicksPerFrame(void) {
+	return TicksPerFrame;
+	}
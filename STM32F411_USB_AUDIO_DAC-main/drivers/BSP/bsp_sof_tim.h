@@ -0,0 +1,29 @@
+#ifndef __BSP_SOF_TIM_H
+#define __BSP_SOF_TIM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+
+// TIM2 is a free-running 32bit counter clocked by the APB1 timer clock. The USB OTG FS SOF pulse is internally
+// connected to TIM2 ITR1, and is captured on channel 1 (IC1 mapped on TRC), so every SOF latches the counter
+// in hardware independent of interrupt latency.
+// The timer clock and the I2S PLL are both derived from the HSE crystal. The number of timer ticks between SOFs
+// therefore measures the crystal error with respect to the host USB frame clock, which is also the error
+// of the I2S Fs generated by PLLI2S.
+
+#define SOF_TIM                             TIM2
+#define SOF_TIM_CLK_ENABLE()                __HAL_RCC_TIM2_CLK_ENABLE()
+
+void     BSP_SOF_TIM_Init(void);
+uint32_t BSP_SOF_TIM_GetCapture(void);
+uint32_t BSP_SOF_TIM_GetElapsed(void);
+uint32_t BSP_SOF_TIM_GetTicksPerFrame(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
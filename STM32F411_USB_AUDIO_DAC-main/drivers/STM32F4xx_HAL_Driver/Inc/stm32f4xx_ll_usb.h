@@ -152,6 +152,12 @@ typedef struct
   uint32_t  xfer_len;             /*!< Current transfer length                                                  */
 
   uint32_t  xfer_count;           /*!< Partial transfer length in case of multi packet transfer                 */
+
+  uint8_t   *ring_buff;           /*!< Circular receive buffer used instead of xfer_buff, NULL if not used      */
+
+  uint32_t  ring_size;            /*!< Circular receive buffer size in bytes                                    */
+
+  uint32_t  ring_pos;             /*!< Circular receive buffer write position                                   */
 } USB_OTG_EPTypeDef;
 
 typedef struct
@@ -447,6 +453,8 @@ HAL_StatusTypeDef USB_WritePacket(USB_OTG_GlobalTypeDef *USBx, uint8_t *src,
                                   uint8_t ch_ep_num, uint16_t len, uint8_t dma);
 
 void             *USB_ReadPacket(USB_OTG_GlobalTypeDef *USBx, uint8_t *dest, uint16_t len);
+uint32_t          USB_ReadPacketRing(USB_OTG_GlobalTypeDef *USBx, uint8_t *ring, uint32_t ring_size,
+                                     uint32_t pos, uint16_t len);
 HAL_StatusTypeDef USB_EPSetStall(USB_OTG_GlobalTypeDef *USBx, USB_OTG_EPTypeDef *ep);
 HAL_StatusTypeDef USB_EPClearStall(USB_OTG_GlobalTypeDef *USBx, USB_OTG_EPTypeDef *ep);
 HAL_StatusTypeDef USB_SetDevAddress(USB_OTG_GlobalTypeDef *USBx, uint8_t address);
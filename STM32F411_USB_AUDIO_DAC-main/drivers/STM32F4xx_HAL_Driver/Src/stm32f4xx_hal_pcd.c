@@ -213,6 +213,7 @@ HAL_StatusTypeDef HAL_PCD_Init(PCD_HandleTypeDef *hpcd)
     hpcd->OUT_ep[i].maxpacket = 0U;
     hpcd->OUT_ep[i].xfer_buff = 0U;
     hpcd->OUT_ep[i].xfer_len = 0U;
+    hpcd->OUT_ep[i].ring_buff = NULL;
   }
 
   /* Init Device */
@@ -1326,10 +1327,18 @@ void HAL_PCD_IRQHandler(PCD_HandleTypeDef *hpcd)
       {
         if ((temp & USB_OTG_GRXSTSP_BCNT) != 0U)
         {
-          (void)USB_ReadPacket(USBx, ep->xfer_buff,
-                               (uint16_t)((temp & USB_OTG_GRXSTSP_BCNT) >> 4));
+          if (ep->ring_buff != NULL)
+          {
+            ep->ring_pos = USB_ReadPacketRing(USBx, ep->ring_buff, ep->ring_size, ep->ring_pos,
+                                              (uint16_t)((temp & USB_OTG_GRXSTSP_BCNT) >> 4));
+          }
+          else
+          {
+            (void)USB_ReadPacket(USBx, ep->xfer_buff,
+                                 (uint16_t)((temp & USB_OTG_GRXSTSP_BCNT) >> 4));
 
-          ep->xfer_buff += (temp & USB_OTG_GRXSTSP_BCNT) >> 4;
+            ep->xfer_buff += (temp & USB_OTG_GRXSTSP_BCNT) >> 4;
+          }
           ep->xfer_count += (temp & USB_OTG_GRXSTSP_BCNT) >> 4;
         }
       }
@@ -1759,6 +1768,7 @@ HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, u
   ep->xfer_count = 0U;
   ep->is_in = 0U;
   ep->num = ep_addr & EP_ADDR_MSK;
+  ep->ring_buff = NULL;
 
   if (hpcd->Init.dma_enable == 1U)
   {
@@ -1777,6 +1787,45 @@ HAL_StatusTypeDef HAL_PCD_EP_Receive(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, u
   return HAL_OK;
 }
 
+/**
+  * @brief  Receive an amount of data into a circular buffer.
+  *         The RX FIFO is drained directly into the buffer at ring_pos, wrapping at
+  *         ring_size. Not available for endpoint 0 or with the internal DMA.
+  * @param  hpcd PCD handle
+  * @param  ep_addr endpoint address
+  * @param  pRing pointer to the circular buffer
+  * @param  ring_size circular buffer size in bytes
+  * @param  ring_pos write position in the circular buffer
+  * @param  len amount of data to be received
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_PCD_EP_ReceiveRing(PCD_HandleTypeDef *hpcd, uint8_t ep_addr, uint8_t *pRing,
+                                         uint32_t ring_size, uint32_t ring_pos, uint32_t len)
+{
+  PCD_EPTypeDef *ep;
+
+  if (((ep_addr & EP_ADDR_MSK) == 0U) || (hpcd->Init.dma_enable == 1U))
+  {
+    return HAL_ERROR;
+  }
+
+  ep = &hpcd->OUT_ep[ep_addr & EP_ADDR_MSK];
+
+  /*setup and start the Xfer */
+  ep->ring_buff = pRing;
+  ep->ring_size = ring_size;
+  ep->ring_pos = ring_pos;
+  ep->xfer_buff = pRing;
+  ep->xfer_len = len;
+  ep->xfer_count = 0U;
+  ep->is_in = 0U;
+  ep->num = ep_addr & EP_ADDR_MSK;
+
+  (void)USB_EPStartXfer(hpcd->Instance, ep, 0U);
+
+  return HAL_OK;
+}
+
 /**
   * @brief  Get Received Data Size
   * @param  hpcd PCD handle
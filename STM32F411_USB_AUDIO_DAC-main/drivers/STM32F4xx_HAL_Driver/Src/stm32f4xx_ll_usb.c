@@ -996,6 +996,84 @@ void *USB_ReadPacket(USB_OTG_GlobalTypeDef *USBx, uint8_t *dest, uint16_t len)
   return ((void *)pDest);
 }
 
+/**
+  * @brief  USB_ReadPacketRing : read a packet from the RX FIFO into a circular buffer
+  *         The FIFO is read 4 words at a time up to the end of the buffer, and the
+  *         word straddling the end of the buffer is split. Exactly len bytes are written.
+  * @param  USBx  Selected device
+  * @param  ring  circular buffer
+  * @param  ring_size  circular buffer size in bytes
+  * @param  pos  write position in the circular buffer
+  * @param  len  Number of bytes to read
+  * @retval write position following the packet
+  */
+uint32_t USB_ReadPacketRing(USB_OTG_GlobalTypeDef *USBx, uint8_t *ring, uint32_t ring_size,
+                            uint32_t pos, uint16_t len)
+{
+  uint32_t USBx_BASE = (uint32_t)USBx;
+  uint32_t remaining = len;
+  uint32_t count32b;
+  uint32_t word;
+  uint32_t i;
+  uint8_t *pDest;
+
+  while (remaining > 0U)
+  {
+    count32b = ring_size - pos;
+    if (count32b > remaining)
+    {
+      count32b = remaining;
+    }
+    count32b /= 4U;
+
+    if (count32b > 0U)
+    {
+      pDest = &ring[pos];
+      pos += count32b * 4U;
+      remaining -= count32b * 4U;
+
+      while (count32b >= 4U)
+      {
+        __UNALIGNED_UINT32_WRITE(pDest, USBx_DFIFO(0U));
+        __UNALIGNED_UINT32_WRITE(pDest + 4U, USBx_DFIFO(0U));
+        __UNALIGNED_UINT32_WRITE(pDest + 8U, USBx_DFIFO(0U));
+        __UNALIGNED_UINT32_WRITE(pDest + 12U, USBx_DFIFO(0U));
+        pDest += 16U;
+        count32b -= 4U;
+      }
+      while (count32b > 0U)
+      {
+        __UNALIGNED_UINT32_WRITE(pDest, USBx_DFIFO(0U));
+        pDest += 4U;
+        count32b--;
+      }
+    }
+    else
+    {
+      /* last partial word of the packet, or word straddling the end of the buffer */
+      word = USBx_DFIFO(0U);
+      for (i = 0U; (i < 4U) && (remaining > 0U); i++)
+      {
+        ring[pos] = (uint8_t)word;
+        word >>= 8;
+        remaining--;
+        pos++;
+        if (pos == ring_size)
+        {
+          pos = 0U;
+        }
+      }
+    }
+
+    if (pos == ring_size)
+    {
+      pos = 0U;
+    }
+  }
+
+  return pos;
+}
+
 /**
   * @brief  USB_EPSetStall : set a stall condition over an EP
   * @param  USBx  Selected device
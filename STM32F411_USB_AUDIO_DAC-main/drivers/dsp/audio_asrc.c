@@ -0,0 +1,118 @@
+#include "stm32f4xx.h"
+#include "audio_asrc.h"
+
+// 24bit sample range, the outputs of the filter overshoot a full scale input
+#define AUDIO_ASRC_24B_MAX          0x007FFFFF
+#define AUDIO_ASRC_24B_MIN          (-0x00800000)
+
+#define AUDIO_ASRC_FRAC_MASK        ((1UL << AUDIO_ASRC_FRAC_BITS) - 1U)
+// low bits of the position, between two phases of the table
+#define AUDIO_ASRC_WEIGHT_BITS      (AUDIO_ASRC_FRAC_BITS - AUDIO_ASRC_PHASES_LOG2)
+
+
+/**
+ * @brief  Select the filter table and the nominal ratio, and clear the history. Call before the processing is started.
+ * @param  freq_in: sampling frequency of the stream [Hz]
+ * @param  freq_out: I2S sampling frequency [Hz]
+ */
+void AUDIO_ASRC_Init(AUDIO_ASRC_TypeDef* asrc, uint32_t freq_in, uint32_t freq_out){
+	const AUDIO_ASRC_TableTypeDef* t = &AUDIO_ASRC_Tables[0];
+	for (const AUDIO_ASRC_TableTypeDef* s = t; s->coef != NULL; s++) {
+		if (s->freq_in == freq_in && s->freq_out == freq_out) {
+			t = s;
+			break;
+			}
+		}
+	asrc->coef = t->coef;
+	AUDIO_ASRC_SetRatio(asrc, freq_in, freq_out);
+	AUDIO_ASRC_Reset(asrc);
+	}
+
+
+/**
+ * @brief  Set the conversion ratio
+ * @param  rate_in: rate at which the input samples are consumed, any unit, e.g. samples per frame in 10.22 format
+ * @param  rate_out: I2S rate in the same unit
+ */
+void AUDIO_ASRC_SetRatio(AUDIO_ASRC_TypeDef* asrc, uint32_t rate_in, uint32_t rate_out){
+	if (rate_out == 0U) {
+		return;
+		}
+	asrc->step = (uint32_t)((((uint64_t)rate_in << AUDIO_ASRC_FRAC_BITS) + rate_out/2U) / rate_out);
+	}
+
+
+/**
+ * @brief  Clear the history, the next output samples fade in from silence as the window fills.
+ *         Called when the playback starts.
+ */
+void AUDIO_ASRC_Reset(AUDIO_ASRC_TypeDef* asrc){
+	for (uint32_t i = 0; i < 2U*AUDIO_ASRC_TAPS; i++) {
+		asrc->hist[i][0] = 0;
+		asrc->hist[i][1] = 0;
+		}
+	asrc->frac = 0U;
+	asrc->wr = 0U;
+	}
+
+
+/**
+ * @brief  Resample stereo samples of the I2S circular buffer into an I2S buffer
+ * @param  dst: output buffer, I2S format
+ * @param  num_samples: stereo samples to write to dst
+ * @param  buffer: I2S circular buffer, input samples at the stream rate
+ * @param  ptr: index of the next input sample in halfwords, multiple of 4
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ * @retval index of the next input sample, the samples before it are in the history
+ */
+uint32_t AUDIO_ASRC_Process(AUDIO_ASRC_TypeDef* asrc, uint16_t* dst, uint32_t num_samples, const uint16_t* buffer, uint32_t ptr, uint32_t buffer_size){
+	const int32_t (*coef)[AUDIO_ASRC_TAPS] = asrc->coef;
+	uint32_t step = asrc->step;
+	uint32_t frac = asrc->frac;
+	uint32_t wr = asrc->wr;
+
+	while (num_samples--) {
+		const int32_t* h0 = coef[frac >> AUDIO_ASRC_WEIGHT_BITS];
+		const int32_t* h1 = h0 + AUDIO_ASRC_TAPS;
+		// Q31 weight of the next phase
+		int32_t w = (int32_t)((frac << (31U - AUDIO_ASRC_WEIGHT_BITS)) & 0x7FFFFFFFUL);
+		const int32_t (*x)[2] = &asrc->hist[wr];
+		int64_t acc_l = 0, acc_r = 0;
+		for (uint32_t k = 0; k < AUDIO_ASRC_TAPS; k++) {
+			// SMULL + shift : the coefficient at the exact position, for both channels
+			int32_t c = h0[k] + (int32_t)(((int64_t)(h1[k] - h0[k]) * w) >> 31);
+			acc_l += (int64_t)c * x[k][0];
+			acc_r += (int64_t)c * x[k][1];
+			}
+		// Q30, rounded to 24bit
+		int32_t l = (int32_t)((acc_l + (1 << 29)) >> 30);
+		int32_t r = (int32_t)((acc_r + (1 << 29)) >> 30);
+		l = l > AUDIO_ASRC_24B_MAX ? AUDIO_ASRC_24B_MAX : (l < AUDIO_ASRC_24B_MIN ? AUDIO_ASRC_24B_MIN : l);
+		r = r > AUDIO_ASRC_24B_MAX ? AUDIO_ASRC_24B_MAX : (r < AUDIO_ASRC_24B_MIN ? AUDIO_ASRC_24B_MIN : r);
+		__UNALIGNED_UINT32_WRITE(dst, __ROR((uint32_t)l << 8, 16U));
+		__UNALIGNED_UINT32_WRITE(dst + 2, __ROR((uint32_t)r << 8, 16U));
+		dst += 4;
+
+		// the input samples passed by the next output sample enter the window
+		frac += step;
+		uint32_t adv = frac >> AUDIO_ASRC_FRAC_BITS;
+		frac &= AUDIO_ASRC_FRAC_MASK;
+		while (adv--) {
+			int32_t in_l = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&buffer[ptr]), 16U) >> 8;
+			int32_t in_r = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&buffer[ptr + 2]), 16U) >> 8;
+			asrc->hist[wr][0] = asrc->hist[wr + AUDIO_ASRC_TAPS][0] = in_l;
+			asrc->hist[wr][1] = asrc->hist[wr + AUDIO_ASRC_TAPS][1] = in_r;
+			if (++wr >= AUDIO_ASRC_TAPS) {
+				wr = 0U;
+				}
+			ptr += 4U;
+			if (ptr >= buffer_size) {
+				ptr = 0U;
+				}
+			}
+		}
+
+	asrc->frac = frac;
+	asrc->wr = wr;
+	return ptr;
+	}
@@ -0,0 +1,65 @@
+#ifndef __AUDIO_ASRC_H
+#define __AUDIO_ASRC_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Asynchronous sample rate converter (USE_AUDIO_ASRC, see Makefile C_DEFS). The I2S clock runs at the fixed
+// AUDIO_ASRC_OUT_FREQ whatever the stream rate, and the resampler reads the audio transfer buffer at the rate of the
+// host, see AUDIO_OUT_CopyPeriod() in usbd_audio.c.
+//
+// Polyphase windowed sinc interpolation : each output sample is AUDIO_ASRC_TAPS input samples through the filter
+// phase of its fractional position. The AUDIO_ASRC_PHASES + 1 phases are tabulated in audio_asrc_coef.c, generated by
+// asrc/asrcgen.c, and the coefficients of the exact position are linearly interpolated between the two nearest
+// phases, once per stereo sample. Q30 coefficients and 24bit samples, 64bit accumulators (SMULL/SMLAL).
+// The filter cuts at the lower of the input and output Nyquist frequencies, a table per cutoff (AUDIO_ASRC_Tables[]).
+//
+// The ratio, input samples per output sample, is set by AUDIO_ASRC_SetRatio() from the rates in samples per USB frame,
+// as measured on the USB SOF. It is steered by the fill of the audio transfer buffer, see USBD_AUDIO_SOF(), so the
+// host does not have to follow the feedback endpoint.
+// asrc/asrcbench.c measures the THD+N and the host time per output sample, the DWT cycles on the target are
+// the PROFILE_ASRC point (USE_IRQ_PROFILE).
+
+#define AUDIO_ASRC_TAPS             32U
+#define AUDIO_ASRC_PHASES_LOG2      7U
+#define AUDIO_ASRC_PHASES           (1U << AUDIO_ASRC_PHASES_LOG2)
+
+// Fixed I2S sampling frequency, 48000 or 96000, see I2S_Clk_ConfigAsrc[] in bsp_audio_clk.c
+#ifndef AUDIO_ASRC_OUT_FREQ
+#define AUDIO_ASRC_OUT_FREQ         48000U
+#endif
+
+// Fractional bits of the ratio and of the position
+#define AUDIO_ASRC_FRAC_BITS        24U
+
+// Polyphase table of a rate pair, [phase][tap], tap 0 is the oldest input sample
+typedef struct {
+	uint32_t freq_in;           // 0 = any rate up to the output rate
+	uint32_t freq_out;
+	const int32_t (*coef)[AUDIO_ASRC_TAPS];
+	} AUDIO_ASRC_TableTypeDef;
+
+extern const AUDIO_ASRC_TableTypeDef AUDIO_ASRC_Tables[];
+
+typedef struct {
+	const int32_t (*coef)[AUDIO_ASRC_TAPS]; // table of the input and output rates
+	volatile uint32_t step;     // input samples per output sample, 8.24, written by the SOF interrupt
+	uint32_t frac;              // position of the next output sample after the centre of the window, 0.24
+	uint32_t wr;                // next index of the history
+	int32_t  hist[2*AUDIO_ASRC_TAPS][2]; // last AUDIO_ASRC_TAPS input samples, written twice, the window is contiguous
+	} AUDIO_ASRC_TypeDef;
+
+void     AUDIO_ASRC_Init(AUDIO_ASRC_TypeDef* asrc, uint32_t freq_in, uint32_t freq_out);
+void     AUDIO_ASRC_SetRatio(AUDIO_ASRC_TypeDef* asrc, uint32_t rate_in, uint32_t rate_out);
+void     AUDIO_ASRC_Reset(AUDIO_ASRC_TypeDef* asrc);
+uint32_t AUDIO_ASRC_Process(AUDIO_ASRC_TypeDef* asrc, uint16_t* dst, uint32_t num_samples, const uint16_t* buffer, uint32_t ptr, uint32_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,421 @@
+// Generated by asrc/asrcgen.c, do not edit : run make -C asrc to regenerate.
+// Polyphase filters of the ASRC, Kaiser windowed sinc, beta 10.0, see audio_asrc.h
+
+#include "audio_asrc.h"
+
+#if AUDIO_ASRC_TAPS != 32 || AUDIO_ASRC_PHASES_LOG2 != 7
+#error "the ASRC filter tables do not match audio_asrc.h, run make -C asrc"
+#endif
+
+// up to the output rate, cut at the input Nyquist frequency
+static const int32_t AUDIO_ASRC_Coef_Full[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS] = {
+{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1073741824, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+{-1424, 4989, -13102, 29147, -57909, 105805, -181158, 294660, -460422, 698437, -1040668, 1547107, -2354959, 3875828, -8167449, 1073632993, 8300884, -3910786, 2371442, -1556875, 1047102, -702876, 463522, -296806, 182606, -106747, 58491, -29484, 13281, -5074, 1457, -191},
+{-2814, 9891, -26019, 57942, -115204, 210610, -360765, 587007, -917480, 1392036, -2074307, 3083571, -4692139, 7714759, -16199611, 1073306170, 16733286, -7854556, 4758052, -3122630, 2100035, -1409785, 929877, -595587, 366557, -214376, 117532, -59290, 26735, -10229, 2948, -391},
+{-4170, 14704, -38743, 86369, -171856, 314358, -538722, 876877, -1370915, 2080400, -3100328, 4608525, -7010262, 11514888, -24094698, 1072761474, 25295222, -11829296, 7158497, -4696367, 3158188, -2120316, 1398795, -896172, 551749, -322827, 177091, -89401, 40355, -15465, 4470, -601},
+{-5492, 19427, -51270, 114416, -227833, 416992, -714931, 1164107, -1820472, 2763141, -4118152, 6121117, -9308072, 15274349, -31850984, 1071999109, 33984647, -15832960, 9571425, -6277174, 4220944, -2834053, 1870002, -1198385, 738073, -432038, 237135, -119802, 54133, -20779, 6025, -820},
+{-6779, 24057, -63594, 142067, -283108, 518457, -889295, 1448539, -2265899, 3439874, -5127208, 7620507, -11584330, 18991315, -39466815, 1071019357, 42799449, -19863467, 11995470, -7864133, 5287679, -3550576, 2343221, -1502050, 925422, -541946, 297629, -150475, 68063, -26167, 7610, -1048},
+{-8030, 28592, -75708, 169309, -337652, 618700, -1061720, 1730016, -2706949, 4110222, -6126933, 9105869, -13837822, 22663996, -46940598, 1069822581, 51737456, -23918705, 14429248, -9456314, 6357761, -4269460, 2818171, -1806987, 1113687, -652487, 358539, -181404, 82137, -31628, 9227, -1286},
+{-9246, 33031, -87608, 196129, -391437, 717668, -1232114, 2008384, -3143379, 4773814, -7116775, 10576389, -16067352, 26290644, -54270811, 1068409225, 60796434, -27996527, 16871359, -11052780, 7430554, -4990276, 3294569, -2113016, 1302755, -763597, 419830, -212571, 96347, -37158, 10873, -1533},
+{-10427, 37373, -99289, 222515, -444436, 815311, -1400386, 2283493, -3574950, 5430286, -8096189, 12031267, -18271749, 29869548, -61455999, 1066779814, 69974090, -32094758, 19320390, -12652583, 8505417, -5712591, 3772128, -2419952, 1492515, -875211, 481466, -243958, 110686, -42755, 12548, -1790},
+{-11572, 41615, -110744, 248454, -496624, 911577, -1566447, 2555197, -4001429, 6079278, -9064641, 13469720, -20449864, 33399041, -68494773, 1064934950, 79268067, -36211189, 21774915, -14254770, 9581702, -6435969, 4250561, -2727611, 1682851, -987260, 543411, -275548, 125146, -48416, 14252, -2056},
+{-12680, 45757, -121971, 273934, -547974, 1006419, -1730213, 2823351, -4422587, 6720441, -10021608, 14890976, -22600570, 36877496, -75385814, 1062875318, 88675953, -40343585, 24233491, -15858379, 10658757, -7159969, 4729576, -3035805, 1873650, -1099679, 605628, -307321, 139718, -54138, 15984, -2332},
+{-13753, 49797, -132964, 298945, -598463, 1099789, -1891597, 3087815, -4838199, 7353430, -10966575, 16294281, -24722765, 40303328, -82127873, 1060601682, 98195274, -44489680, 26694666, -17462440, 11735926, -7884150, 5208880, -3344346, 2064794, -1212399, 668080, -339260, 154394, -59918, 17743, -2617},
+{-14789, 53733, -143720, 323474, -648068, 1191641, -2050520, 3348450, -5248047, 7977908, -11899038, 17678896, -26815372, 43674995, -88719766, 1058114882, 107823502, -48647183, 29156976, -19065978, 12812549, -8608064, 5688177, -3653045, 2256167, -1325350, 730728, -371344, 169165, -65752, 19527, -2911},
+{-15790, 57566, -154233, 347512, -696764, 1281931, -2206900, 3605124, -5651915, 8593545, -12818505, 19044096, -28877337, 46990996, -95160380, 1055415840, 117558048, -52813773, 31618946, -20668014, 13887960, -9331265, 6167169, -3961708, 2447649, -1438464, 793535, -403555, 184024, -71637, 21337, -3215},
+{-16754, 61293, -164501, 371049, -744529, 1370616, -2360660, 3857705, -6049595, 9200019, -13724494, 20389175, -30907633, 50249877, -101448673, 1052505556, 127396272, -56987108, 34079089, -22267559, 14961492, -10053299, 6645558, -4270144, 2639120, -1551670, 856462, -435872, 198960, -77570, 23171, -3528},
+{-17681, 64915, -174519, 394075, -791344, 1457653, -2511725, 4106066, -6440883, 9797016, -14616535, 21713442, -32905256, 53450225, -107583670, 1049385106, 137335475, -61164817, 36535911, -23863625, 16032476, -10773716, 7123042, -4578158, 2830461, -1664896, 919468, -468277, 213965, -83548, 25029, -3849},
+{-18573, 68429, -184285, 416580, -837187, 1543004, -2660022, 4350084, -6825580, 10384229, -15494167, 23016222, -34869232, 56590672, -113564467, 1046055644, 147372908, -65344509, 38987908, -25455215, 17100237, -11492059, 7599320, -4885554, 3021550, -1778071, 982515, -500748, 229029, -89566, 26909, -4180},
+{-19428, 71835, -193795, 438557, -882038, 1626627, -2805481, 4589639, -7203493, 10961360, -16356944, 24296859, -36798609, 59669895, -119390227, 1042518402, 157505765, -69523768, 41433570, -27041331, 18164101, -12207873, 8074086, -5192137, 3212265, -1891123, 1045562, -533265, 244144, -95622, 28809, -4520},
+{-20247, 75134, -203046, 459996, -925879, 1708488, -2948033, 4824615, -7574434, 11528118, -17204430, 25554713, -38692466, 62686617, -125060187, 1038774687, 167731193, -73700159, 43871380, -28620972, 19223390, -12920700, 8547038, -5497708, 3402482, -2003979, 1108569, -565806, 259299, -101711, 30731, -4869},
+{-21031, 78323, -212035, 480891, -968693, 1788548, -3087611, 5054899, -7938222, 12084220, -18036200, 26789162, -40549905, 65639605, -130573649, 1034825882, 178046283, -77871224, 46299812, -30193134, 20277427, -13630080, 9017869, -5802071, 3592079, -2116565, 1171495, -598352, 274486, -107830, 32671, -5226},
+{-21778, 81403, -220761, 501233, -1010461, 1866774, -3224153, 5280382, -8294680, 12629393, -18851843, 27999604, -42370061, 68527673, -135929989, 1030673446, 188448082, -82034487, 48717339, -31756811, 21325531, -14335556, 9486274, -6105027, 3780930, -2228807, 1234298, -630881, 289693, -113974, 34629, -5591},
+{-22490, 84373, -229220, 521016, -1051168, 1943132, -3357598, 5500959, -8643636, 13163372, -19650959, 29185451, -44152090, 71349679, -141128649, 1026318911, 198933583, -86187455, 51122428, -33310997, 22367025, -15036666, 9951945, -6406375, 3968913, -2340632, 1296937, -663371, 304911, -120141, 36603, -5965},
+{-23167, 87234, -237411, 540234, -1090798, 2017592, -3487887, 5716529, -8984927, 13685898, -20433162, 30346137, -45895183, 74104530, -146169144, 1021763884, 209499735, -90327617, 53513541, -34854684, 23401227, -15732951, 10414575, -6705918, 4155901, -2451965, 1359370, -695801, 320131, -126325, 38593, -6347},
+{-23808, 89984, -245332, 558880, -1129337, 2090122, -3614963, 5926995, -9318393, 14196724, -21198078, 31481113, -47598555, 76791179, -151051055, 1017010044, 220143440, -94452445, 55889139, -36386865, 24427458, -16423950, 10873858, -7003454, 4341769, -2562730, 1421555, -728148, 335341, -132523, 40598, -6737},
+{-24415, 92624, -252981, 576949, -1166770, 2160695, -3738773, 6132263, -9643882, 14695611, -21945345, 32589851, -49261451, 79408624, -155774036, 1012059143, 230861555, -98559400, 58247682, -37906534, 25445039, -17109205, 11329486, -7298784, 4526392, -2672853, 1483449, -760391, 350531, -138730, 42615, -7135},
+{-24987, 95153, -260356, 594435, -1203087, 2229283, -3859266, 6332243, -9961245, 15182328, -22674616, 33671840, -50883145, 81955912, -160337806, 1006913004, 241650892, -102645925, 60587628, -39412684, 26453293, -17788256, 11781153, -7591707, 4709644, -2782257, 1545010, -792507, 365691, -144943, 44644, -7540},
+{-25525, 97572, -267457, 611334, -1238273, 2295861, -3976393, 6526851, -10270342, 15656652, -23385554, 34726589, -52462942, 84432136, -164742157, 1001573520, 252508222, -106709454, 62907435, -40904312, 27451544, -18460646, 12228551, -7882025, 4891399, -2890868, 1606195, -824474, 380810, -151156, 46683, -7953},
+{-26028, 99881, -274282, 627643, -1272319, 2360404, -4090107, 6716005, -10571038, 16118372, -24077839, 35753626, -54000173, 86836437, -168986946, 996042656, 263430274, -110747407, 65205563, -42380417, 28439118, -19125918, 12671376, -8169537, 5071530, -2998610, 1666960, -856269, 395878, -157366, 48731, -8373},
+{-26498, 102080, -280831, 643356, -1305214, 2422891, -4200366, 6899626, -10863203, 16567284, -24751162, 36752499, -55494201, 89168003, -173072103, 990322444, 274413737, -114757198, 67480472, -43840001, 29415343, -19783616, 13109322, -8454043, 5249913, -3105407, 1727264, -887869, 410883, -163568, 50786, -8799},
+{-26935, 104169, -287103, 658471, -1336948, 2483299, -4307127, 7077642, -11146716, 17003193, -25405227, 37722777, -56944419, 91426071, -176997622, 984414986, 285455259, -118736228, 69730626, -45282069, 30379550, -20433288, 13542086, -8735346, 5426422, -3211182, 1787063, -919252, 425815, -169758, 52847, -9232},
+{-27339, 106149, -293097, 672985, -1367513, 2541611, -4410353, 7249983, -11421460, 17425915, -26039754, 38664047, -58350249, 93609923, -180763566, 978322448, 296551455, -122681894, 71954494, -46705632, 31331073, -21074483, 13969365, -9013245, 5600930, -3315861, 1846313, -950395, 440663, -175931, 54912, -9671},
+{-27711, 108020, -298814, 686895, -1396901, 2597806, -4510007, 7416584, -11687324, 17835274, -26654474, 39575918, -59711144, 95718891, -184370067, 972047065, 307698900, -126591585, 74150547, -48109703, 32269252, -21706751, 14390858, -9287545, 5773313, -3419366, 1904970, -981275, 455416, -182082, 56980, -10116},
+{-28051, 109783, -304253, 700200, -1425106, 2651870, -4606055, 7577383, -11944204, 18231103, -27249134, 40458017, -61026586, 97752353, -187817323, 965591135, 318894136, -130462685, 76317263, -49493304, 33193428, -22329647, 14806264, -9558049, 5943446, -3521623, 1962993, -1011868, 470062, -188206, 59050, -10567},
+{-28359, 111437, -309415, 712897, -1452121, 2703787, -4698468, 7732323, -12192003, 18613244, -27823493, 41309994, -62296090, 99709735, -191105598, 958957023, 330133671, -134292574, 78453125, -50855461, 34102949, -22942728, 15215288, -9824559, 6111205, -3622555, 2020336, -1042152, 484590, -194300, 61119, -11022},
+{-28636, 112985, -314299, 724985, -1477942, 2753543, -4787215, 7881351, -12430628, 18981552, -28377325, 42131516, -63519198, 101590512, -194235224, 952147155, 341413981, -138078631, 80556626, -52195208, 34997165, -23545554, 15617632, -10086883, 6276465, -3722088, 2076958, -1072103, 498990, -200358, 63186, -11483},
+{-28882, 114426, -318906, 736465, -1502563, 2801127, -4872272, 8024417, -12659996, 19335887, -28910418, 42922274, -64695486, 103394205, -197206597, 945164019, 352731511, -141818234, 82626264, -53511584, 35875435, -24137690, 16013003, -10344827, 6439104, -3820147, 2132813, -1101697, 513249, -206375, 65249, -11949},
+{-29099, 115762, -323238, 747334, -1525981, 2846528, -4953614, 8161477, -12880026, 19676120, -29422574, 43681977, -65824557, 105120383, -200020179, 938010163, 364082677, -145508758, 84660548, -54803640, 36737121, -24718703, 16401110, -10598199, 6598999, -3916655, 2187860, -1130913, 527356, -212346, 67307, -12418},
+{-29286, 116993, -327295, 757595, -1548194, 2889738, -5031222, 8292490, -13090648, 20002134, -29913607, 44410356, -66906049, 106768663, -202676496, 930688198, 375463869, -149147582, 86657996, -56070432, 37581593, -25288165, 16781666, -10846808, 6756028, -4011540, 2242056, -1159726, 541301, -218268, 69358, -12892},
+{-29444, 118120, -331077, 767246, -1569200, 2930748, -5105077, 8417418, -13291793, 20313817, -30383349, 45107162, -67939627, 108338707, -205176141, 923200792, 386871449, -152732088, 88617139, -57311027, 38408227, -25845653, 17154383, -11090466, 6910071, -4104726, 2295356, -1188113, 555070, -224133, 71401, -13369},
+{-29573, 119144, -334587, 776288, -1588997, 2969552, -5175162, 8536230, -13483403, 20611070, -30831642, 45772167, -68924988, 109830227, -207519766, 915550668, 398301753, -156259660, 90536518, -58524502, 39216407, -26390748, 17518980, -11328985, 7061008, -4196141, 2347719, -1216052, 568654, -229939, 73432, -13848},
+{-29675, 120066, -337826, 784724, -1607585, 3006147, -5241466, 8648896, -13665424, 20893802, -31258344, 46405162, -69861861, 111242980, -209708090, 907740608, 409751097, -159727689, 92414687, -59709944, 40005522, -26923036, 17875178, -11562182, 7208720, -4285711, 2399101, -1243518, 582040, -235678, 75452, -14331},
+{-29749, 120888, -340795, 792554, -1624965, 3040528, -5303976, 8755392, -13837809, 21161933, -31663327, 47005962, -70750002, 112576770, -211741892, 899773450, 421215772, -163133571, 94250214, -60866451, 40774971, -27442110, 18222699, -11789872, 7353089, -4373364, 2449461, -1270489, 595218, -241348, 77457, -14816},
+{-29797, 121610, -343496, 799782, -1641137, 3072695, -5362685, 8855698, -14000517, 21415391, -32046479, 47574400, -71589202, 113831448, -213622013, 891652082, 432692051, -166474712, 96041683, -61993134, 41524162, -27947566, 18561272, -12011875, 7493999, -4459027, 2498756, -1296942, 608174, -246942, 79446, -15302},
+{-29818, 122233, -345931, 806408, -1656105, 3102647, -5417588, 8949796, -14153514, 21654114, -32407697, 48110331, -72379280, 115006912, -215349355, 883379447, 444176187, -169748526, 97787690, -63089115, 42252511, -28439007, 18890629, -12228013, 7631335, -4542631, 2546945, -1322853, 620899, -252455, 81418, -15790},
+{-29814, 122760, -348103, 812436, -1669870, 3130385, -5468679, 9037674, -14296771, 21878049, -32746898, 48613628, -73120085, 116103102, -216924882, 874958540, 455664417, -172952436, 99486852, -64153528, 42959441, -28916044, 19210504, -12438109, 7764984, -4624103, 2593985, -1348201, 633380, -257882, 83370, -16278},
+{-29785, 123191, -350012, 817869, -1682437, 3155912, -5515960, 9119324, -14430265, 22087153, -33064008, 49084189, -73811498, 117120009, -218349613, 866392403, 467152961, -176083880, 101137799, -65185524, 43644389, -29378293, 19520637, -12641989, 7894832, -4703374, 2639837, -1372962, 645606, -263219, 85300, -16767},
+{-29732, 123527, -351663, 822710, -1693809, 3179232, -5559430, 9194741, -14553982, 22281393, -33358970, 49521928, -74453429, 118057665, -219624630, 857684128, 478638025, -179140306, 102739183, -66184264, 44306798, -29825374, 19820772, -12839484, 8020769, -4780376, 2684459, -1397114, 657566, -268460, 87206, -17255},
+{-29655, 123770, -353057, 826965, -1703992, 3200350, -5599095, 9263924, -14667912, 22460745, -33631740, 49926782, -75045819, 118916150, -220751072, 848836855, 490115804, -182119179, 104289673, -67148927, 44946123, -30256920, 20110658, -13030425, 8142686, -4855040, 2727810, -1420634, 669248, -273599, 89088, -17743},
+{-29556, 123922, -354197, 830635, -1712991, 3219273, -5634960, 9326877, -14772050, 22625194, -33882288, 50298708, -75588637, 119695586, -221730132, 839853769, 501582481, -185017979, 105787959, -68078706, 45561830, -30672566, 20390048, -13214646, 8260476, -4927299, 2769851, -1443501, 680641, -278633, 90941, -18229},
+{-29434, 123984, -355085, 833727, -1720813, 3236009, -5667033, 9383606, -14866401, 22774733, -34110597, 50637683, -76081885, 120396142, -222563064, 830738099, 513034230, -187834201, 107232750, -68972809, 46153396, -31071956, 20658700, -13391986, 8374033, -4997088, 2810543, -1465692, 691734, -283555, 92766, -18714},
+{-29290, 123958, -355726, 836245, -1727465, 3250567, -5695327, 9434124, -14950971, 22909368, -34316666, 50943704, -76525591, 121018027, -223251172, 821493117, 524467217, -190565362, 108622780, -69830463, 46720309, -31454745, 20916377, -13562286, 8483254, -5064340, 2849847, -1487185, 702515, -288360, 94559, -19197},
+{-29125, 123844, -356121, 838194, -1732954, 3262959, -5719854, 9478444, -15025777, 23029109, -34500504, 51216788, -76919814, 121561498, -223795819, 812122137, 535877602, -193208996, 109956803, -70650909, 47262070, -31820591, 21162848, -13725391, 8588036, -5128992, 2887724, -1507959, 712974, -293044, 96319, -19676},
+{-28940, 123646, -356274, 839580, -1737290, 3273195, -5740630, 9516585, -15090838, 23133981, -34662137, 51456972, -77264642, 122026851, -224198419, 802628513, 547261541, -195762658, 111233598, -71433407, 47778192, -32169163, 21397887, -13881148, 8688280, -5190980, 2924136, -1527993, 723099, -297601, 98043, -20152},
+{-28735, 123364, -356189, 840409, -1740482, 3281290, -5757672, 9548570, -15146182, 23224013, -34801603, 51664312, -77560193, 122414427, -224460439, 793015637, 558615187, -198223928, 112451968, -72177235, 48268200, -32500140, 21621274, -14029409, 8783888, -5250244, 2959046, -1547266, 732879, -302026, 99730, -20624},
+{-28512, 122999, -355868, 840686, -1742539, 3287258, -5771000, 9574424, -15191840, 23299245, -34918953, 51838885, -77806612, 122724607, -224583397, 783286938, 569934691, -200590407, 113610741, -72881691, 48731633, -32813208, 21832793, -14170028, 8874765, -5306722, 2992419, -1565756, 742304, -306315, 101378, -21092},
+{-28270, 122555, -355317, 840419, -1743472, 3291114, -5780638, 9594177, -15227852, 23359727, -35014251, 51980786, -78004073, 122957815, -224568863, 773445882, 581216205, -202859721, 114708772, -73546090, 49168042, -33108062, 22032237, -14302866, 8960818, -5360356, 3024216, -1583444, 751362, -310461, 102985, -21554},
+{-28010, 122033, -354537, 839613, -1743292, 3292876, -5786608, 9607863, -15254260, 23405516, -35087576, 52090131, -78152777, 123114515, -224418455, 763495967, 592455883, -205029524, 115744942, -74169769, 49576993, -33384406, 22219404, -14427783, 9041956, -5411087, 3054405, -1600309, 760043, -314461, 104548, -22011},
+{-27734, 121434, -353533, 838277, -1742010, 3292561, -5788938, 9615518, -15271115, 23436678, -35139018, 52167053, -78252955, 123195212, -224133841, 753440726, 603649884, -207097496, 116718160, -74752082, 49958066, -33641955, 22394096, -14544649, 9118091, -5458859, 3082949, -1616332, 768338, -318308, 106066, -22461},
+{-27441, 120760, -352309, 836417, -1739640, 3290190, -5787655, 9617183, -15278472, 23453288, -35168681, 52211706, -78304864, 123200450, -223716735, 743283721, 614794369, -209061345, 117627364, -75292407, 50310856, -33880434, 22556126, -14653332, 9189136, -5503617, 3109816, -1631492, 776234, -321999, 107536, -22904},
+{-27132, 120013, -350869, 834041, -1736193, 3285783, -5782792, 9612901, -15276392, 23455430, -35176680, 52224259, -78308789, 123130813, -223168899, 733028544, 625885509, -210918811, 118471521, -75790142, 50634971, -34099577, 22705309, -14753709, 9255009, -5545306, 3134972, -1645772, 783722, -325527, 108958, -23340},
+{-26809, 119195, -349217, 831156, -1731684, 3279360, -5774379, 9602719, -15264940, 23443196, -35163146, 52204904, -78265039, 122986924, -222492138, 722678815, 636919482, -212667664, 119249628, -76244707, 50930037, -34299127, 22841470, -14845659, 9315629, -5583875, 3158384, -1659151, 790793, -328889, 110327, -23767},
+{-26472, 118308, -347358, 827771, -1726126, 3270945, -5762453, 9586689, -15244190, 23416685, -35128219, 52153849, -78173954, 122769442, -221688305, 712238181, 647892478, -214305707, 119960713, -76655544, 51195691, -34478841, 22964440, -14929066, 9370917, -5619274, 3180023, -1671613, 797435, -332080, 111644, -24185},
+{-26121, 117354, -345294, 823894, -1719535, 3260562, -5747048, 9564863, -15214217, 23376006, -35072053, 52071319, -78035898, 122479066, -220759293, 701710312, 658800696, -215830776, 120603837, -77022118, 51431591, -34638485, 23074056, -15003818, 9420799, -5651453, 3199856, -1683138, 803640, -335094, 112904, -24594},
+{-25757, 116335, -343032, 819534, -1711924, 3248235, -5728205, 9537300, -15175103, 23321275, -34994813, 51957558, -77851258, 122116529, -219707037, 691098904, 669640351, -217240743, 121178091, -77343916, 51637408, -34777834, 23170165, -15069809, 9465203, -5680364, 3217855, -1693709, 809397, -337927, 114108, -24993},
+{-25380, 115252, -340575, 814698, -1703310, 3233991, -5705963, 9504059, -15126936, 23252618, -34896677, 51812828, -77620451, 121682602, -218533515, 680407672, 680407672, -218533515, 121682602, -77620451, 51812828, -34896677, 23252618, -15126936, 9504059, -5705963, 3233991, -1703310, 814698, -340575, 115252, -25380},
+{-24993, 114108, -337927, 809397, -1693709, 3217855, -5680364, 9465203, -15069809, 23170165, -34777834, 51637408, -77343916, 121178091, -217240743, 669640351, 691098904, -219707037, 122116529, -77851258, 51957558, -34994813, 23321275, -15175103, 9537300, -5728205, 3248235, -1711924, 819534, -343032, 116335, -25757},
+{-24594, 112904, -335094, 803640, -1683138, 3199856, -5651453, 9420799, -15003818, 23074056, -34638485, 51431591, -77022118, 120603837, -215830776, 658800696, 701710312, -220759293, 122479066, -78035898, 52071319, -35072053, 23376006, -15214217, 9564863, -5747048, 3260562, -1719535, 823894, -345294, 117354, -26121},
+{-24185, 111644, -332080, 797435, -1671613, 3180023, -5619274, 9370917, -14929066, 22964440, -34478841, 51195691, -76655544, 119960713, -214305707, 647892478, 712238181, -221688305, 122769442, -78173954, 52153849, -35128219, 23416685, -15244190, 9586689, -5762453, 3270945, -1726126, 827771, -347358, 118308, -26472},
+{-23767, 110327, -328889, 790793, -1659151, 3158384, -5583875, 9315629, -14845659, 22841470, -34299127, 50930037, -76244707, 119249628, -212667664, 636919482, 722678815, -222492138, 122986924, -78265039, 52204904, -35163146, 23443196, -15264940, 9602719, -5774379, 3279360, -1731684, 831156, -349217, 119195, -26809},
+{-23340, 108958, -325527, 783722, -1645772, 3134972, -5545306, 9255009, -14753709, 22705309, -34099577, 50634971, -75790142, 118471521, -210918811, 625885509, 733028544, -223168899, 123130813, -78308789, 52224259, -35176680, 23455430, -15276392, 9612901, -5782792, 3285783, -1736193, 834041, -350869, 120013, -27132},
+{-22904, 107536, -321999, 776234, -1631492, 3109816, -5503617, 9189136, -14653332, 22556126, -33880434, 50310856, -75292407, 117627364, -209061345, 614794369, 743283721, -223716735, 123200450, -78304864, 52211706, -35168681, 23453288, -15278472, 9617183, -5787655, 3290190, -1739640, 836417, -352309, 120760, -27441},
+{-22461, 106066, -318308, 768338, -1616332, 3082949, -5458859, 9118091, -14544649, 22394096, -33641955, 49958066, -74752082, 116718160, -207097496, 603649884, 753440726, -224133841, 123195212, -78252955, 52167053, -35139018, 23436678, -15271115, 9615518, -5788938, 3292561, -1742010, 838277, -353533, 121434, -27734},
+{-22011, 104548, -314461, 760043, -1600309, 3054405, -5411087, 9041956, -14427783, 22219404, -33384406, 49576993, -74169769, 115744942, -205029524, 592455883, 763495967, -224418455, 123114515, -78152777, 52090131, -35087576, 23405516, -15254260, 9607863, -5786608, 3292876, -1743292, 839613, -354537, 122033, -28010},
+{-21554, 102985, -310461, 751362, -1583444, 3024216, -5360356, 8960818, -14302866, 22032237, -33108062, 49168042, -73546090, 114708772, -202859721, 581216205, 773445882, -224568863, 122957815, -78004073, 51980786, -35014251, 23359727, -15227852, 9594177, -5780638, 3291114, -1743472, 840419, -355317, 122555, -28270},
+{-21092, 101378, -306315, 742304, -1565756, 2992419, -5306722, 8874765, -14170028, 21832793, -32813208, 48731633, -72881691, 113610741, -200590407, 569934691, 783286938, -224583397, 122724607, -77806612, 51838885, -34918953, 23299245, -15191840, 9574424, -5771000, 3287258, -1742539, 840686, -355868, 122999, -28512},
+{-20624, 99730, -302026, 732879, -1547266, 2959046, -5250244, 8783888, -14029409, 21621274, -32500140, 48268200, -72177235, 112451968, -198223928, 558615187, 793015637, -224460439, 122414427, -77560193, 51664312, -34801603, 23224013, -15146182, 9548570, -5757672, 3281290, -1740482, 840409, -356189, 123364, -28735},
+{-20152, 98043, -297601, 723099, -1527993, 2924136, -5190980, 8688280, -13881148, 21397887, -32169163, 47778192, -71433407, 111233598, -195762658, 547261541, 802628513, -224198419, 122026851, -77264642, 51456972, -34662137, 23133981, -15090838, 9516585, -5740630, 3273195, -1737290, 839580, -356274, 123646, -28940},
+{-19676, 96319, -293044, 712974, -1507959, 2887724, -5128992, 8588036, -13725391, 21162848, -31820591, 47262070, -70650909, 109956803, -193208996, 535877602, 812122137, -223795819, 121561498, -76919814, 51216788, -34500504, 23029109, -15025777, 9478444, -5719854, 3262959, -1732954, 838194, -356121, 123844, -29125},
+{-19197, 94559, -288360, 702515, -1487185, 2849847, -5064340, 8483254, -13562286, 20916377, -31454745, 46720309, -69830463, 108622780, -190565362, 524467217, 821493117, -223251172, 121018027, -76525591, 50943704, -34316666, 22909368, -14950971, 9434124, -5695327, 3250567, -1727465, 836245, -355726, 123958, -29290},
+{-18714, 92766, -283555, 691734, -1465692, 2810543, -4997088, 8374033, -13391986, 20658700, -31071956, 46153396, -68972809, 107232750, -187834201, 513034230, 830738099, -222563064, 120396142, -76081885, 50637683, -34110597, 22774733, -14866401, 9383606, -5667033, 3236009, -1720813, 833727, -355085, 123984, -29434},
+{-18229, 90941, -278633, 680641, -1443501, 2769851, -4927299, 8260476, -13214646, 20390048, -30672566, 45561830, -68078706, 105787959, -185017979, 501582481, 839853769, -221730132, 119695586, -75588637, 50298708, -33882288, 22625194, -14772050, 9326877, -5634960, 3219273, -1712991, 830635, -354197, 123922, -29556},
+{-17743, 89088, -273599, 669248, -1420634, 2727810, -4855040, 8142686, -13030425, 20110658, -30256920, 44946123, -67148927, 104289673, -182119179, 490115804, 848836855, -220751072, 118916150, -75045819, 49926782, -33631740, 22460745, -14667912, 9263924, -5599095, 3200350, -1703992, 826965, -353057, 123770, -29655},
+{-17255, 87206, -268460, 657566, -1397114, 2684459, -4780376, 8020769, -12839484, 19820772, -29825374, 44306798, -66184264, 102739183, -179140306, 478638025, 857684128, -219624630, 118057665, -74453429, 49521928, -33358970, 22281393, -14553982, 9194741, -5559430, 3179232, -1693809, 822710, -351663, 123527, -29732},
+{-16767, 85300, -263219, 645606, -1372962, 2639837, -4703374, 7894832, -12641989, 19520637, -29378293, 43644389, -65185524, 101137799, -176083880, 467152961, 866392403, -218349613, 117120009, -73811498, 49084189, -33064008, 22087153, -14430265, 9119324, -5515960, 3155912, -1682437, 817869, -350012, 123191, -29785},
+{-16278, 83370, -257882, 633380, -1348201, 2593985, -4624103, 7764984, -12438109, 19210504, -28916044, 42959441, -64153528, 99486852, -172952436, 455664417, 874958540, -216924882, 116103102, -73120085, 48613628, -32746898, 21878049, -14296771, 9037674, -5468679, 3130385, -1669870, 812436, -348103, 122760, -29814},
+{-15790, 81418, -252455, 620899, -1322853, 2546945, -4542631, 7631335, -12228013, 18890629, -28439007, 42252511, -63089115, 97787690, -169748526, 444176187, 883379447, -215349355, 115006912, -72379280, 48110331, -32407697, 21654114, -14153514, 8949796, -5417588, 3102647, -1656105, 806408, -345931, 122233, -29818},
+{-15302, 79446, -246942, 608174, -1296942, 2498756, -4459027, 7493999, -12011875, 18561272, -27947566, 41524162, -61993134, 96041683, -166474712, 432692051, 891652082, -213622013, 113831448, -71589202, 47574400, -32046479, 21415391, -14000517, 8855698, -5362685, 3072695, -1641137, 799782, -343496, 121610, -29797},
+{-14816, 77457, -241348, 595218, -1270489, 2449461, -4373364, 7353089, -11789872, 18222699, -27442110, 40774971, -60866451, 94250214, -163133571, 421215772, 899773450, -211741892, 112576770, -70750002, 47005962, -31663327, 21161933, -13837809, 8755392, -5303976, 3040528, -1624965, 792554, -340795, 120888, -29749},
+{-14331, 75452, -235678, 582040, -1243518, 2399101, -4285711, 7208720, -11562182, 17875178, -26923036, 40005522, -59709944, 92414687, -159727689, 409751097, 907740608, -209708090, 111242980, -69861861, 46405162, -31258344, 20893802, -13665424, 8648896, -5241466, 3006147, -1607585, 784724, -337826, 120066, -29675},
+{-13848, 73432, -229939, 568654, -1216052, 2347719, -4196141, 7061008, -11328985, 17518980, -26390748, 39216407, -58524502, 90536518, -156259660, 398301753, 915550668, -207519766, 109830227, -68924988, 45772167, -30831642, 20611070, -13483403, 8536230, -5175162, 2969552, -1588997, 776288, -334587, 119144, -29573},
+{-13369, 71401, -224133, 555070, -1188113, 2295356, -4104726, 6910071, -11090466, 17154383, -25845653, 38408227, -57311027, 88617139, -152732088, 386871449, 923200792, -205176141, 108338707, -67939627, 45107162, -30383349, 20313817, -13291793, 8417418, -5105077, 2930748, -1569200, 767246, -331077, 118120, -29444},
+{-12892, 69358, -218268, 541301, -1159726, 2242056, -4011540, 6756028, -10846808, 16781666, -25288165, 37581593, -56070432, 86657996, -149147582, 375463869, 930688198, -202676496, 106768663, -66906049, 44410356, -29913607, 20002134, -13090648, 8292490, -5031222, 2889738, -1548194, 757595, -327295, 116993, -29286},
+{-12418, 67307, -212346, 527356, -1130913, 2187860, -3916655, 6598999, -10598199, 16401110, -24718703, 36737121, -54803640, 84660548, -145508758, 364082677, 938010163, -200020179, 105120383, -65824557, 43681977, -29422574, 19676120, -12880026, 8161477, -4953614, 2846528, -1525981, 747334, -323238, 115762, -29099},
+{-11949, 65249, -206375, 513249, -1101697, 2132813, -3820147, 6439104, -10344827, 16013003, -24137690, 35875435, -53511584, 82626264, -141818234, 352731511, 945164019, -197206597, 103394205, -64695486, 42922274, -28910418, 19335887, -12659996, 8024417, -4872272, 2801127, -1502563, 736465, -318906, 114426, -28882},
+{-11483, 63186, -200358, 498990, -1072103, 2076958, -3722088, 6276465, -10086883, 15617632, -23545554, 34997165, -52195208, 80556626, -138078631, 341413981, 952147155, -194235224, 101590512, -63519198, 42131516, -28377325, 18981552, -12430628, 7881351, -4787215, 2753543, -1477942, 724985, -314299, 112985, -28636},
+{-11022, 61119, -194300, 484590, -1042152, 2020336, -3622555, 6111205, -9824559, 15215288, -22942728, 34102949, -50855461, 78453125, -134292574, 330133671, 958957023, -191105598, 99709735, -62296090, 41309994, -27823493, 18613244, -12192003, 7732323, -4698468, 2703787, -1452121, 712897, -309415, 111437, -28359},
+{-10567, 59050, -188206, 470062, -1011868, 1962993, -3521623, 5943446, -9558049, 14806264, -22329647, 33193428, -49493304, 76317263, -130462685, 318894136, 965591135, -187817323, 97752353, -61026586, 40458017, -27249134, 18231103, -11944204, 7577383, -4606055, 2651870, -1425106, 700200, -304253, 109783, -28051},
+{-10116, 56980, -182082, 455416, -981275, 1904970, -3419366, 5773313, -9287545, 14390858, -21706751, 32269252, -48109703, 74150547, -126591585, 307698900, 972047065, -184370067, 95718891, -59711144, 39575918, -26654474, 17835274, -11687324, 7416584, -4510007, 2597806, -1396901, 686895, -298814, 108020, -27711},
+{-9671, 54912, -175931, 440663, -950395, 1846313, -3315861, 5600930, -9013245, 13969365, -21074483, 31331073, -46705632, 71954494, -122681894, 296551455, 978322448, -180763566, 93609923, -58350249, 38664047, -26039754, 17425915, -11421460, 7249983, -4410353, 2541611, -1367513, 672985, -293097, 106149, -27339},
+{-9232, 52847, -169758, 425815, -919252, 1787063, -3211182, 5426422, -8735346, 13542086, -20433288, 30379550, -45282069, 69730626, -118736228, 285455259, 984414986, -176997622, 91426071, -56944419, 37722777, -25405227, 17003193, -11146716, 7077642, -4307127, 2483299, -1336948, 658471, -287103, 104169, -26935},
+{-8799, 50786, -163568, 410883, -887869, 1727264, -3105407, 5249913, -8454043, 13109322, -19783616, 29415343, -43840001, 67480472, -114757198, 274413737, 990322444, -173072103, 89168003, -55494201, 36752499, -24751162, 16567284, -10863203, 6899626, -4200366, 2422891, -1305214, 643356, -280831, 102080, -26498},
+{-8373, 48731, -157366, 395878, -856269, 1666960, -2998610, 5071530, -8169537, 12671376, -19125918, 28439118, -42380417, 65205563, -110747407, 263430274, 996042656, -168986946, 86836437, -54000173, 35753626, -24077839, 16118372, -10571038, 6716005, -4090107, 2360404, -1272319, 627643, -274282, 99881, -26028},
+{-7953, 46683, -151156, 380810, -824474, 1606195, -2890868, 4891399, -7882025, 12228551, -18460646, 27451544, -40904312, 62907435, -106709454, 252508222, 1001573520, -164742157, 84432136, -52462942, 34726589, -23385554, 15656652, -10270342, 6526851, -3976393, 2295861, -1238273, 611334, -267457, 97572, -25525},
+{-7540, 44644, -144943, 365691, -792507, 1545010, -2782257, 4709644, -7591707, 11781153, -17788256, 26453293, -39412684, 60587628, -102645925, 241650892, 1006913004, -160337806, 81955912, -50883145, 33671840, -22674616, 15182328, -9961245, 6332243, -3859266, 2229283, -1203087, 594435, -260356, 95153, -24987},
+{-7135, 42615, -138730, 350531, -760391, 1483449, -2672853, 4526392, -7298784, 11329486, -17109205, 25445039, -37906534, 58247682, -98559400, 230861555, 1012059143, -155774036, 79408624, -49261451, 32589851, -21945345, 14695611, -9643882, 6132263, -3738773, 2160695, -1166770, 576949, -252981, 92624, -24415},
+{-6737, 40598, -132523, 335341, -728148, 1421555, -2562730, 4341769, -7003454, 10873858, -16423950, 24427458, -36386865, 55889139, -94452445, 220143440, 1017010044, -151051055, 76791179, -47598555, 31481113, -21198078, 14196724, -9318393, 5926995, -3614963, 2090122, -1129337, 558880, -245332, 89984, -23808},
+{-6347, 38593, -126325, 320131, -695801, 1359370, -2451965, 4155901, -6705918, 10414575, -15732951, 23401227, -34854684, 53513541, -90327617, 209499735, 1021763884, -146169144, 74104530, -45895183, 30346137, -20433162, 13685898, -8984927, 5716529, -3487887, 2017592, -1090798, 540234, -237411, 87234, -23167},
+{-5965, 36603, -120141, 304911, -663371, 1296937, -2340632, 3968913, -6406375, 9951945, -15036666, 22367025, -33310997, 51122428, -86187455, 198933583, 1026318911, -141128649, 71349679, -44152090, 29185451, -19650959, 13163372, -8643636, 5500959, -3357598, 1943132, -1051168, 521016, -229220, 84373, -22490},
+{-5591, 34629, -113974, 289693, -630881, 1234298, -2228807, 3780930, -6105027, 9486274, -14335556, 21325531, -31756811, 48717339, -82034487, 188448082, 1030673446, -135929989, 68527673, -42370061, 27999604, -18851843, 12629393, -8294680, 5280382, -3224153, 1866774, -1010461, 501233, -220761, 81403, -21778},
+{-5226, 32671, -107830, 274486, -598352, 1171495, -2116565, 3592079, -5802071, 9017869, -13630080, 20277427, -30193134, 46299812, -77871224, 178046283, 1034825882, -130573649, 65639605, -40549905, 26789162, -18036200, 12084220, -7938222, 5054899, -3087611, 1788548, -968693, 480891, -212035, 78323, -21031},
+{-4869, 30731, -101711, 259299, -565806, 1108569, -2003979, 3402482, -5497708, 8547038, -12920700, 19223390, -28620972, 43871380, -73700159, 167731193, 1038774687, -125060187, 62686617, -38692466, 25554713, -17204430, 11528118, -7574434, 4824615, -2948033, 1708488, -925879, 459996, -203046, 75134, -20247},
+{-4520, 28809, -95622, 244144, -533265, 1045562, -1891123, 3212265, -5192137, 8074086, -12207873, 18164101, -27041331, 41433570, -69523768, 157505765, 1042518402, -119390227, 59669895, -36798609, 24296859, -16356944, 10961360, -7203493, 4589639, -2805481, 1626627, -882038, 438557, -193795, 71835, -19428},
+{-4180, 26909, -89566, 229029, -500748, 982515, -1778071, 3021550, -4885554, 7599320, -11492059, 17100237, -25455215, 38987908, -65344509, 147372908, 1046055644, -113564467, 56590672, -34869232, 23016222, -15494167, 10384229, -6825580, 4350084, -2660022, 1543004, -837187, 416580, -184285, 68429, -18573},
+{-3849, 25029, -83548, 213965, -468277, 919468, -1664896, 2830461, -4578158, 7123042, -10773716, 16032476, -23863625, 36535911, -61164817, 137335475, 1049385106, -107583670, 53450225, -32905256, 21713442, -14616535, 9797016, -6440883, 4106066, -2511725, 1457653, -791344, 394075, -174519, 64915, -17681},
+{-3528, 23171, -77570, 198960, -435872, 856462, -1551670, 2639120, -4270144, 6645558, -10053299, 14961492, -22267559, 34079089, -56987108, 127396272, 1052505556, -101448673, 50249877, -30907633, 20389175, -13724494, 9200019, -6049595, 3857705, -2360660, 1370616, -744529, 371049, -164501, 61293, -16754},
+{-3215, 21337, -71637, 184024, -403555, 793535, -1438464, 2447649, -3961708, 6167169, -9331265, 13887960, -20668014, 31618946, -52813773, 117558048, 1055415840, -95160380, 46990996, -28877337, 19044096, -12818505, 8593545, -5651915, 3605124, -2206900, 1281931, -696764, 347512, -154233, 57566, -15790},
+{-2911, 19527, -65752, 169165, -371344, 730728, -1325350, 2256167, -3653045, 5688177, -8608064, 12812549, -19065978, 29156976, -48647183, 107823502, 1058114882, -88719766, 43674995, -26815372, 17678896, -11899038, 7977908, -5248047, 3348450, -2050520, 1191641, -648068, 323474, -143720, 53733, -14789},
+{-2617, 17743, -59918, 154394, -339260, 668080, -1212399, 2064794, -3344346, 5208880, -7884150, 11735926, -17462440, 26694666, -44489680, 98195274, 1060601682, -82127873, 40303328, -24722765, 16294281, -10966575, 7353430, -4838199, 3087815, -1891597, 1099789, -598463, 298945, -132964, 49797, -13753},
+{-2332, 15984, -54138, 139718, -307321, 605628, -1099679, 1873650, -3035805, 4729576, -7159969, 10658757, -15858379, 24233491, -40343585, 88675953, 1062875318, -75385814, 36877496, -22600570, 14890976, -10021608, 6720441, -4422587, 2823351, -1730213, 1006419, -547974, 273934, -121971, 45757, -12680},
+{-2056, 14252, -48416, 125146, -275548, 543411, -987260, 1682851, -2727611, 4250561, -6435969, 9581702, -14254770, 21774915, -36211189, 79268067, 1064934950, -68494773, 33399041, -20449864, 13469720, -9064641, 6079278, -4001429, 2555197, -1566447, 911577, -496624, 248454, -110744, 41615, -11572},
+{-1790, 12548, -42755, 110686, -243958, 481466, -875211, 1492515, -2419952, 3772128, -5712591, 8505417, -12652583, 19320390, -32094758, 69974090, 1066779814, -61455999, 29869548, -18271749, 12031267, -8096189, 5430286, -3574950, 2283493, -1400386, 815311, -444436, 222515, -99289, 37373, -10427},
+{-1533, 10873, -37158, 96347, -212571, 419830, -763597, 1302755, -2113016, 3294569, -4990276, 7430554, -11052780, 16871359, -27996527, 60796434, 1068409225, -54270811, 26290644, -16067352, 10576389, -7116775, 4773814, -3143379, 2008384, -1232114, 717668, -391437, 196129, -87608, 33031, -9246},
+{-1286, 9227, -31628, 82137, -181404, 358539, -652487, 1113687, -1806987, 2818171, -4269460, 6357761, -9456314, 14429248, -23918705, 51737456, 1069822581, -46940598, 22663996, -13837822, 9105869, -6126933, 4110222, -2706949, 1730016, -1061720, 618700, -337652, 169309, -75708, 28592, -8030},
+{-1048, 7610, -26167, 68063, -150475, 297629, -541946, 925422, -1502050, 2343221, -3550576, 5287679, -7864133, 11995470, -19863467, 42799449, 1071019357, -39466815, 18991315, -11584330, 7620507, -5127208, 3439874, -2265899, 1448539, -889295, 518457, -283108, 142067, -63594, 24057, -6779},
+{-820, 6025, -20779, 54133, -119802, 237135, -432038, 738073, -1198385, 1870002, -2834053, 4220944, -6277174, 9571425, -15832960, 33984647, 1071999109, -31850984, 15274349, -9308072, 6121117, -4118152, 2763141, -1820472, 1164107, -714931, 416992, -227833, 114416, -51270, 19427, -5492},
+{-601, 4470, -15465, 40355, -89401, 177091, -322827, 551749, -896172, 1398795, -2120316, 3158188, -4696367, 7158497, -11829296, 25295222, 1072761474, -24094698, 11514888, -7010262, 4608525, -3100328, 2080400, -1370915, 876877, -538722, 314358, -171856, 86369, -38743, 14704, -4170},
+{-391, 2948, -10229, 26735, -59290, 117532, -214376, 366557, -595587, 929877, -1409785, 2100035, -3122630, 4758052, -7854556, 16733286, 1073306170, -16199611, 7714759, -4692139, 3083571, -2074307, 1392036, -917480, 587007, -360765, 210610, -115204, 57942, -26019, 9891, -2814},
+{-191, 1457, -5074, 13281, -29484, 58491, -106747, 182606, -296806, 463522, -702876, 1047102, -1556875, 2371442, -3910786, 8300884, 1073632993, -8167449, 3875828, -2354959, 1547107, -1040668, 698437, -460422, 294660, -181158, 105805, -57909, 29147, -13102, 4989, -1424},
+{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1073741824, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+};
+
+#if AUDIO_ASRC_OUT_FREQ == 48000
+
+// 88200 Hz to 48000 Hz, cut at the output Nyquist frequency
+static const int32_t AUDIO_ASRC_Coef_88k2_48k[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS] = {
+{28807, -190838, -125205, 1189026, -101335, -4259302, 2335380, 10800725, -10604252, -21135357, 32682051, 33359622, -88054283, -43510812, 332276855, 584359659, 332276855, -43510812, -88054283, 33359622, 32682051, -21135357, -10604252, 10800725, 2335380, -4259302, -101335, 1189026, -125205, -190838, 28807, 0},
+{29148, -188229, -131280, 1180569, -69331, -4250464, 2232300, 10831703, -10360668, -21322067, 32215864, 33967024, -87220773, -45340647, 328958244, 584338226, 335583717, -41655852, -88876150, 32741739, 33144573, -20943195, -10847315, 10767292, 2438794, -4267306, -133639, 1197306, -119016, -193438, 28448, 6245},
+{29471, -185614, -137243, 1171959, -37632, -4240872, 2129612, 10860424, -10116796, -21503687, 31746683, 34564471, -86377359, -47146034, 325633966, 584284005, 338884205, -39776592, -89687671, 32114001, 33603887, -20745949, -11089989, 10731580, 2542565, -4274539, -166239, 1205425, -112715, -196032, 28071, 6462},
+{29776, -182994, -143093, 1163194, -6241, -4230512, 2027321, 10886837, -9872627, -21680095, 31274433, 35151730, -85523767, -48926662, 322302506, 584193721, 342176103, -37872868, -90488131, 31476274, 34059701, -20543507, -11332166, 10693520, 2646660, -4280970, -199132, 1213374, -106301, -198617, 27675, 6683},
+{30064, -180370, -148831, 1154276, 24838, -4219393, 1925445, 10910953, -9628208, -21851291, 30799220, 35728756, -84660219, -50682466, 318964218, 584067385, 345459059, -35944762, -91277313, 30828613, 34511908, -20335874, -11573794, 10653102, 2751062, -4286590, -232313, 1221149, -99776, -201193, 27260, 6908},
+{30334, -177742, -154456, 1145210, 55601, -4207522, 1824001, 10932784, -9383591, -22017274, 30321152, 36295507, -83786934, -52413384, 315619453, 583905010, 348732723, -33992358, -92054995, 30171075, 34960400, -20123058, -11814823, 10610317, 2855751, -4291391, -265777, 1228745, -93138, -203759, 26826, 7137},
+{30588, -175112, -159969, 1135999, 86044, -4194910, 1723006, 10952342, -9138822, -22178045, 29840336, 36851944, -82904136, -54119360, 312268565, 583706616, 351996744, -32015746, -92820961, 29503718, 35405071, -19905067, -12055202, 10565157, 2960708, -4295364, -299521, 1236160, -86388, -206313, 26372, 7370},
+{30824, -172479, -165369, 1126647, 116165, -4181566, 1622477, 10969640, -8893950, -22333607, 29356879, 37398027, -82012046, -55800338, 308911904, 583472227, 355250773, -30015019, -93574991, 28826604, 35845812, -19681910, -12294879, 10517614, 3065914, -4298503, -333539, 1243389, -79526, -208856, 25899, 7606},
+{31045, -169845, -170657, 1117157, 145960, -4167497, 1522431, 10984690, -8649025, -22483962, 28870887, 37933721, -81110885, -57456268, 305549823, 583201869, 358494460, -27990272, -94316868, 28139797, 36282518, -19453598, -12533803, 10467680, 3171350, -4300798, -367827, 1250429, -72553, -211386, 25406, 7846},
+{31249, -167210, -175832, 1107534, 175425, -4152715, 1422883, 10997505, -8404093, -22629114, 28382468, 38458992, -80200875, -59087104, 302182676, 582895573, 361727457, -25941606, -95046375, 27443362, 36715080, -19220141, -12771923, 10415348, 3276996, -4302243, -402380, 1257276, -65468, -213901, 24893, 8089},
+{31437, -164576, -180896, 1097781, 204558, -4137227, 1323851, 11008099, -8159203, -22769069, 27891728, 38973809, -79282239, -60692801, 298810813, 582553376, 364949416, -23869124, -95763296, 26737368, 37143391, -18981554, -13009187, 10360611, 3382832, -4302830, -437193, 1263926, -58273, -216403, 24360, 8336},
+{31609, -161942, -185848, 1087901, 233356, -4121044, 1225349, 11016485, -7914401, -22903831, 27398773, 39478141, -78355197, -62273319, 295434586, 582175317, 368159989, -21772931, -96467415, 26021882, 37567346, -18737849, -13245543, 10303464, 3488839, -4302551, -472261, 1270377, -50966, -218888, 23807, 8587},
+{31766, -159310, -190689, 1077899, 261815, -4104174, 1127395, 11022678, -7669734, -23033407, 26903709, 39971961, -77419972, -63828622, 292054348, 581761441, 371358829, -19653138, -97158517, 25296979, 37986838, -18489041, -13480939, 10243900, 3594996, -4301398, -507579, 1276623, -43550, -221357, 23233, 8841},
+{31907, -156680, -195419, 1067777, 289933, -4086627, 1030003, 11026692, -7425250, -23157806, 26406643, 40455243, -76476786, -65358676, 288670449, 581311795, 374545592, -17509859, -97836387, 24562731, 38401760, -18235145, -13715323, 10181914, 3701283, -4299365, -543142, 1282662, -36023, -223809, 22638, 9099},
+{32034, -154053, -200037, 1057540, 317707, -4068413, 933188, 11028543, -7180993, -23277037, 25907679, 40927964, -75525860, -66863451, 285283241, 580826432, 377719931, -15343211, -98500812, 23819216, 38812005, -17976179, -13948642, 10117502, 3807679, -4296444, -578945, 1288490, -28388, -226242, 22022, 9360},
+{32146, -151430, -204545, 1047191, 345134, -4049541, 836967, 11028244, -6937011, -23391108, 25406923, 41390102, -74567416, -68342922, 281893073, 580305408, 380881502, -13153313, -99151579, 23066511, 39217469, -17712159, -14180844, 10050657, 3914163, -4292628, -614981, 1294103, -20643, -228656, 21385, 9624},
+{32243, -148811, -208942, 1036734, 372212, -4030021, 741352, 11025812, -6693349, -23500030, 24904480, 41841639, -73601675, -69797064, 278500297, 579748783, 384029962, -10940290, -99788476, 22304696, 39618046, -17443107, -14411876, 9981378, 4020716, -4287911, -651247, 1299497, -12790, -231050, 20726, 9892},
+{32326, -146198, -213230, 1026172, 398939, -4009862, 646360, 11021262, -6450052, -23603816, 24400455, 42282556, -72628859, -71225860, 275105261, 579156624, 387164968, -8704270, -100411292, 21533855, 40013629, -17169040, -14641686, 9909660, 4127314, -4282285, -687735, 1304670, -4828, -233422, 20046, 10163},
+{32395, -143590, -217408, 1015509, 425312, -3989076, 552004, 11014611, -6207164, -23702477, 23894952, 42712838, -71649188, -72629292, 271708316, 578528997, 390286180, -6445382, -101019817, 20754073, 40404115, -16889981, -14870221, 9835499, 4233939, -4275744, -724440, 1309617, 3240, -235773, 19344, 10437},
+{32451, -140988, -221477, 1004748, 451328, -3967670, 458298, 11005875, -5964731, -23796026, 23388075, 43132471, -70662882, -74007348, 268309809, 577865978, 393393256, -4163762, -101613841, 19965435, 40789398, -16605952, -15097428, 9758894, 4340567, -4268282, -761357, 1314334, 11416, -238100, 18619, 10714},
+{32493, -138393, -225437, 993893, 476987, -3945655, 365256, 10995071, -5722796, -23884479, 22879928, 43541445, -69670163, -75360019, 264910089, 577167641, 396485858, -1859546, -102193155, 19168031, 41169374, -16316976, -15323254, 9679842, 4447178, -4259892, -798479, 1318819, 19697, -240403, 17873, 10995},
+{32522, -135806, -229289, 982948, 502286, -3923041, 272893, 10982215, -5481403, -23967849, 22370614, 43939750, -68671251, -76687298, 261509503, 576434070, 399563647, 467123, -102757553, 18361953, 41543939, -16023077, -15547646, 9598342, 4553749, -4250568, -835801, 1323068, 28084, -242680, 17105, 11278},
+{32538, -133227, -233033, 971916, 527222, -3899839, 181220, 10967326, -5240596, -24046154, 21860236, 44327378, -67666364, -77989185, 258108397, 575665348, 402626286, 2816103, -103306829, 17547292, 41912989, -15724281, -15770550, 9514393, 4660259, -4240304, -873316, 1327076, 36576, -244932, 16313, 11564},
+{32541, -130656, -236670, 960800, 551794, -3876057, 90251, 10950420, -5000416, -24119410, 21348897, 44704325, -66655723, -79265678, 254707118, 574861565, 405673439, 5187244, -103840776, 16724146, 42276421, -15420614, -15991915, 9427993, 4766687, -4229094, -911018, 1330841, 45172, -247156, 15500, 11853},
+{32532, -128095, -240200, 949605, 576001, -3851706, 0, 10931517, -4760908, -24187634, 20836698, 45070586, -65639547, -80516783, 251306011, 574022815, 408704773, 7580396, -104359191, 15892610, 42634133, -15112105, -16211686, 9339143, 4873008, -4216933, -948901, 1334360, 53871, -249353, 14663, 12145},
+{32511, -125544, -243624, 938333, 599841, -3826796, -89522, 10910632, -4522112, -24250846, 20323742, 45426160, -64618052, -81742508, 247905419, 573149194, 411719954, 9995403, -104861870, 15052784, 42986022, -14798782, -16429810, 9247843, 4979202, -4203814, -986958, 1337628, 62672, -251520, 13803, 12439},
+{32478, -123003, -246942, 926987, 623311, -3801338, -178302, 10887787, -4284071, -24309065, 19810128, 45771049, -63591458, -82942862, 244505686, 572240805, 414718649, 12432109, -105348613, 14204770, 43331986, -14480674, -16646235, 9154094, 5085246, -4189732, -1025183, 1340642, 71575, -253657, 12920, 12736},
+{32433, -120474, -250156, 915572, 646412, -3775341, -266327, 10862998, -4046825, -24362312, 19295959, 46105253, -62559983, -84117862, 241107155, 571297753, 417700530, 14890352, -105819218, 13348672, 43671924, -14157814, -16860906, 9057896, 5191118, -4174683, -1063570, 1343399, 80579, -255762, 12014, 13036},
+{32377, -117956, -253264, 904091, 669141, -3748815, -353587, 10836285, -3810416, -24410606, 18781334, 46428777, -61523841, -85267523, 237710167, 570320147, 420665266, 17369966, -106273485, 12484595, 44005735, -13830233, -17073771, 8959253, 5296794, -4158661, -1102110, 1345895, 89683, -257836, 11085, 13338},
+{32310, -115450, -256269, 892547, 691497, -3721771, -440070, 10807667, -3574884, -24453972, 18266353, 46741628, -60483251, -86391867, 234315062, 569308100, 423612530, 19870785, -106711217, 11612648, 44333319, -13497964, -17284777, 8858166, 5402251, -4141660, -1140799, 1348127, 98886, -259876, 10132, 13642},
+{32231, -112956, -259170, 880943, 713480, -3694218, -525763, 10777164, -3340269, -24492430, 17751115, 47043814, -59438427, -87490919, 230922180, 568261730, 426541998, 22392637, -107132218, 10732939, 44654576, -13161042, -17493870, 8754637, 5507468, -4123677, -1179628, 1350092, 108186, -261881, 9155, 13949},
+{32143, -110476, -261969, 869283, 735087, -3666168, -610657, 10744796, -3106611, -24526005, 17235719, 47335344, -58389585, -88564705, 227531859, 567181159, 429453343, 24935347, -107536291, 9845581, 44969407, -12819502, -17700997, 8648671, 5612419, -4104707, -1218591, 1351786, 117584, -263852, 8155, 14258},
+{32044, -108009, -264666, 857570, 756318, -3637631, -694739, 10710581, -2873948, -24554722, 16720262, 47616231, -57336938, -89613257, 224144436, 566066511, 432346244, 27498737, -107923242, 8950688, 45277714, -12473380, -17906105, 8540271, 5717084, -4084745, -1257681, 1353207, 127077, -265785, 7130, 14569},
+{31934, -105557, -267261, 845807, 777173, -3608616, -778001, 10674542, -2642319, -24578605, 16204842, 47886488, -56280701, -90636608, 220760247, 564917915, 435220381, 30082627, -108292880, 8048376, 45579398, -12122715, -18109140, 8429442, 5821437, -4063786, -1296890, 1354350, 136665, -267682, 6082, 14882},
+{31815, -103119, -269756, 833998, 797650, -3579134, -860430, 10636697, -2411762, -24597680, 15689556, 48146131, -55221086, -91634796, 217379626, 563735505, 438075432, 32686832, -108645012, 7138763, 45874362, -11767545, -18310051, 8316187, 5925456, -4041828, -1336212, 1355212, 146346, -269540, 5009, 15196},
+{31687, -100696, -272152, 822146, 817749, -3549195, -942018, 10597068, -2182315, -24611975, 15174500, 48395177, -54158305, -92607861, 214002907, 562519418, 440911082, 35311165, -108979450, 6221968, 46162509, -11407910, -18508784, 8200514, 6029117, -4018866, -1375638, 1355791, 156120, -271358, 3912, 15513},
+{31549, -98289, -274448, 810254, 837469, -3518809, -1022754, 10555675, -1954015, -24621516, 14659770, 48633646, -53092569, -93555846, 210630423, 561269794, 443727015, 37955435, -109296005, 5298115, 46443745, -11043850, -18705286, 8082427, 6132396, -3994896, -1415162, 1356083, 165985, -273135, 2791, 15831},
+{31402, -95897, -276646, 798325, 856810, -3487988, -1102629, 10512540, -1726899, -24626332, 14145461, 48861558, -52024089, -94478798, 207262503, 559986778, 446522916, 40619447, -109594490, 4367326, 46717973, -10675408, -18899504, 7961933, 6235270, -3969915, -1454775, 1356085, 175941, -274871, 1645, 16150},
+{31246, -93522, -278746, 786362, 875771, -3456741, -1181633, 10467683, -1501003, -24626452, 13631667, 49078937, -50953074, -95376767, 203899477, 558670519, 449298475, 43303005, -109874721, 3429729, 46985100, -10302627, -19091386, 7839040, 6337714, -3943919, -1494471, 1355794, 185985, -276563, 475, 16471},
+{31081, -91163, -280749, 774370, 894352, -3425078, -1259758, 10421127, -1276364, -24621906, 13118482, 49285807, -49879734, -96249807, 200541673, 557321168, 452053381, 46005909, -110136514, 2485451, 47245031, -9925552, -19280880, 7713754, 6439706, -3916905, -1534241, 1355207, 196116, -278212, -720, 16793},
+{30908, -88822, -282657, 762349, 912553, -3393010, -1336994, 10372893, -1053015, -24612723, 12605998, 49482194, -48804275, -97097973, 197189417, 555938881, 454787326, 48727955, -110379689, 1534622, 47497673, -9544226, -19467933, 7586083, 6541220, -3888871, -1574078, 1354321, 206334, -279816, -1939, 17117},
+{30727, -86498, -284469, 750305, 930373, -3360547, -1413333, 10323002, -830993, -24598936, 12094309, 49668127, -47726904, -97921324, 193843034, 554523819, 457500005, 51468937, -110604063, 577374, 47742935, -9158698, -19652492, 7456037, 6642233, -3859813, -1613974, 1353132, 216636, -281373, -3183, 17441},
+{30538, -84193, -286187, 738239, 947813, -3327700, -1488767, 10271477, -610331, -24580576, 11583506, 49843635, -46647828, -98719923, 190502847, 553076145, 460191114, 54228644, -110809461, -386159, 47980726, -8769014, -19834506, 7323624, 6742720, -3829729, -1653921, 1351638, 227021, -282884, -4452, 17767},
+{30342, -81905, -287812, 726155, 964873, -3294478, -1563288, 10218340, -391063, -24557676, 11073680, 50008751, -45567251, -99493835, 187169178, 551596025, 462860351, 57006865, -110995705, -1355840, 48210954, -8375223, -20013923, 7188853, 6842658, -3798616, -1693910, 1349837, 237488, -284346, -5746, 18093},
+{30138, -79637, -289344, 714056, 981552, -3260893, -1636887, 10163613, -173222, -24530268, 10564921, 50163507, -44485377, -100243129, 183842346, 550083631, 465507417, 59803383, -111162620, -2331534, 48433530, -7977375, -20190692, 7051736, 6942021, -3766473, -1733934, 1347724, 248036, -285758, -7064, 18420},
+{29927, -77387, -290784, 701945, 997851, -3226953, -1709558, 10107319, 43158, -24498386, 10057318, 50307938, -43402409, -100967876, 180522670, 548539137, 468132015, 62617980, -111310034, -3313098, 48648366, -7575520, -20364759, 6912283, 7040786, -3733297, -1773984, 1345298, 258662, -287121, -8408, 18747},
+{29709, -75157, -292133, 689824, 1013770, -3192671, -1781293, 10049480, 258045, -24462066, 9550960, 50442082, -42318548, -101668150, 177210467, 546962722, 470733849, 65450435, -111437777, -4300393, 48855374, -7169710, -20536076, 6770504, 7138928, -3699087, -1814052, 1342555, 269366, -288431, -9776, 19074},
+{29484, -72946, -293392, 677697, 1029310, -3158055, -1852084, 9990119, 471408, -24421342, 9045936, 50565975, -41233995, -102344030, 173906051, 545354566, 473312627, 68300521, -111545678, -5293274, 49054467, -6759998, -20704589, 6626413, 7236423, -3663841, -1854130, 1339493, 280145, -289689, -11169, 19402},
+{29253, -70755, -294563, 665566, 1044471, -3123116, -1921926, 9929260, 683215, -24376250, 8542331, 50679660, -40148949, -102995594, 170609735, 543714856, 475868059, 71168012, -111633571, -6291596, 49245559, -6346439, -20870249, 6480020, 7333246, -3627557, -1894209, 1336108, 290998, -290893, -12588, 19730},
+{29015, -68585, -295645, 653435, 1059253, -3087865, -1990811, 9866925, 893435, -24326827, 8040234, 50783176, -39063609, -103622927, 167321830, 542043779, 478399857, 74052677, -111701290, -7295212, 49428565, -5929086, -21033004, 6331340, 7429372, -3590235, -1934281, 1332400, 301923, -292042, -14031, 20058},
+{28772, -66435, -296640, 641306, 1073658, -3052311, -2058734, 9803137, 1102039, -24273109, 7539728, 50876567, -37978171, -104226115, 164042645, 540341529, 480907735, 76954283, -111748674, -8303973, 49603401, -5507997, -21192805, 6180385, 7524777, -3551873, -1974337, 1328364, 312919, -293136, -15499, 20386},
+{28523, -64307, -297548, 629181, 1087685, -3016465, -2125687, 9737921, 1308996, -24215134, 7040899, 50959879, -36892831, -104805246, 160772488, 538608301, 483391410, 79872592, -111775560, -9317727, 49769984, -5083228, -21349601, 6027170, 7619436, -3512470, -2014368, 1323998, 323984, -294172, -16992, 20713},
+{28268, -62199, -298372, 617065, 1101336, -2980337, -2191666, 9671298, 1514277, -24152941, 6543831, 51033157, -35807785, -105360413, 157511664, 536844295, 485850602, 82807367, -111781790, -10336323, 49928233, -4654837, -21503342, 5871709, 7713325, -3472027, -2054366, 1319300, 335115, -295150, -18509, 21040},
+{28008, -60113, -299110, 604959, 1114611, -2943937, -2256666, 9603294, 1717853, -24086568, 6048607, 51096449, -34723224, -105891710, 154260475, 535049713, 488285032, 85758363, -111767206, -11359606, 50078067, -4222884, -21653979, 5714017, 7806418, -3430543, -2094321, 1314267, 346312, -296069, -20052, 21366},
+{27743, -58048, -299766, 592865, 1127512, -2907275, -2320679, 9533932, 1919697, -24016054, 5555309, 51149805, -33639342, -106399235, 151019225, 533224761, 490694425, 88725337, -111731655, -12387419, 50219406, -3787429, -21801462, 5554109, 7898691, -3388018, -2134225, 1308897, 357572, -296927, -21620, 21691},
+{27473, -56006, -300339, 580788, 1140039, -2870361, -2383703, 9463234, 2119781, -23941440, 5064019, 51193276, -32556328, -106883089, 147788210, 531369650, 493078508, 91708041, -111674983, -13419604, 50352170, -3348534, -21945743, 5392003, 7990120, -3344451, -2174069, 1303188, 368894, -297724, -23212, 22016},
+{27199, -53986, -300831, 568729, 1152194, -2833205, -2445731, 9391227, 2318077, -23862766, 4574817, 51226914, -31474373, -107343374, 144567729, 529484590, 495437011, 94706225, -111597041, -14456002, 50476284, -2906260, -22086773, 5227714, 8080679, -3299843, -2213844, 1297137, 380275, -298459, -24829, 22339},
+{26920, -51988, -301242, 556690, 1163976, -2795818, -2506759, 9317933, 2514560, -23780073, 4087782, 51250774, -30393665, -107780196, 141358076, 527569800, 497769667, 97719634, -111497679, -15496450, 50591670, -2460671, -22224503, 5061260, 8170344, -3254196, -2253540, 1290742, 391713, -299130, -26471, 22660},
+{26636, -50012, -301574, 544675, 1175389, -2758208, -2566783, 9243376, 2709202, -23693402, 3602994, 51264910, -29314389, -108193664, 138159545, 525625499, 500076211, 100748014, -111376752, -16540787, 50698253, -2011832, -22358885, 4892659, 8259090, -3207509, -2293149, 1284000, 403207, -299736, -28137, 22980},
+{26349, -48060, -301827, 532687, 1186433, -2720386, -2625799, 9167581, 2901979, -23602795, 3120530, 51269380, -28236731, -108583889, 134972425, 523651908, 502356380, 103791106, -111234117, -17588846, 50795959, -1559807, -22489872, 4721929, 8346893, -3159783, -2332661, 1276911, 414754, -300276, -29828, 23299},
+{26058, -46130, -302003, 520726, 1197109, -2682363, -2683803, 9090572, 3092866, -23508296, 2640467, 51264243, -27160875, -108950985, 131797005, 521649255, 504609916, 106848648, -111069631, -18640462, 50884715, -1104664, -22617417, 4549089, 8433727, -3111020, -2372067, 1269471, 426353, -300750, -31543, 23615},
+{25763, -44224, -302103, 508797, 1207419, -2644147, -2740791, 9012373, 3281838, -23409947, 2162882, 51249557, -26087004, -109295068, 128633570, 519617768, 506836562, 109920376, -110883157, -19695465, 50964450, -646469, -22741472, 4374158, 8519567, -3061222, -2411358, 1261678, 438001, -301156, -33283, 23930},
+{25465, -42341, -302127, 496900, 1217365, -2605749, -2796760, 8933009, 3468871, -23307791, 1687849, 51225384, -25015298, -109616259, 125482405, 517557679, 509036065, 113006025, -110674558, -20753687, 51035093, -185291, -22861991, 4197158, 8604390, -3010389, -2450524, 1253531, 449695, -301492, -35046, 24242},
+{25164, -40482, -302077, 485040, 1226947, -2567177, -2851707, 8852504, 3653942, -23201873, 1215442, 51191786, -23945936, -109914677, 122343790, 515469225, 511208175, 116105325, -110443699, -21814955, 51096575, 278801, -22978928, 4018107, 8688170, -2958524, -2489555, 1245029, 461435, -301759, -36834, 24552},
+{24859, -38646, -301954, 473217, 1236168, -2528443, -2905629, 8770883, 3837028, -23092237, 745735, 51148828, -22879096, -110190448, 119218004, 513352643, 513352643, 119218004, -110190448, -22879096, 51148828, 745735, -23092237, 3837028, 8770883, -2905629, -2528443, 1236168, 473217, -301954, -38646, 24859},
+{24552, -36834, -301759, 461435, 1245029, -2489555, -2958524, 8688170, 4018107, -22978928, 278801, 51096575, -21814955, -110443699, 116105325, 511208175, 515469225, 122343790, -109914677, -23945936, 51191786, 1215442, -23201873, 3653942, 8852504, -2851707, -2567177, 1226947, 485040, -302077, -40482, 25164},
+{24242, -35046, -301492, 449695, 1253531, -2450524, -3010389, 8604390, 4197158, -22861991, -185291, 51035093, -20753687, -110674558, 113006025, 509036065, 517557679, 125482405, -109616259, -25015298, 51225384, 1687849, -23307791, 3468871, 8933009, -2796760, -2605749, 1217365, 496900, -302127, -42341, 25465},
+{23930, -33283, -301156, 438001, 1261678, -2411358, -3061222, 8519567, 4374158, -22741472, -646469, 50964450, -19695465, -110883157, 109920376, 506836562, 519617768, 128633570, -109295068, -26087004, 51249557, 2162882, -23409947, 3281838, 9012373, -2740791, -2644147, 1207419, 508797, -302103, -44224, 25763},
+{23615, -31543, -300750, 426353, 1269471, -2372067, -3111020, 8433727, 4549089, -22617417, -1104664, 50884715, -18640462, -111069631, 106848648, 504609916, 521649255, 131797005, -108950985, -27160875, 51264243, 2640467, -23508296, 3092866, 9090572, -2683803, -2682363, 1197109, 520726, -302003, -46130, 26058},
+{23299, -29828, -300276, 414754, 1276911, -2332661, -3159783, 8346893, 4721929, -22489872, -1559807, 50795959, -17588846, -111234117, 103791106, 502356380, 523651908, 134972425, -108583889, -28236731, 51269380, 3120530, -23602795, 2901979, 9167581, -2625799, -2720386, 1186433, 532687, -301827, -48060, 26349},
+{22980, -28137, -299736, 403207, 1284000, -2293149, -3207509, 8259090, 4892659, -22358885, -2011832, 50698253, -16540787, -111376752, 100748014, 500076211, 525625499, 138159545, -108193664, -29314389, 51264910, 3602994, -23693402, 2709202, 9243376, -2566783, -2758208, 1175389, 544675, -301574, -50012, 26636},
+{22660, -26471, -299130, 391713, 1290742, -2253540, -3254196, 8170344, 5061260, -22224503, -2460671, 50591670, -15496450, -111497679, 97719634, 497769667, 527569800, 141358076, -107780196, -30393665, 51250774, 4087782, -23780073, 2514560, 9317933, -2506759, -2795818, 1163976, 556690, -301242, -51988, 26920},
+{22339, -24829, -298459, 380275, 1297137, -2213844, -3299843, 8080679, 5227714, -22086773, -2906260, 50476284, -14456002, -111597041, 94706225, 495437011, 529484590, 144567729, -107343374, -31474373, 51226914, 4574817, -23862766, 2318077, 9391227, -2445731, -2833205, 1152194, 568729, -300831, -53986, 27199},
+{22016, -23212, -297724, 368894, 1303188, -2174069, -3344451, 7990120, 5392003, -21945743, -3348534, 50352170, -13419604, -111674983, 91708041, 493078508, 531369650, 147788210, -106883089, -32556328, 51193276, 5064019, -23941440, 2119781, 9463234, -2383703, -2870361, 1140039, 580788, -300339, -56006, 27473},
+{21691, -21620, -296927, 357572, 1308897, -2134225, -3388018, 7898691, 5554109, -21801462, -3787429, 50219406, -12387419, -111731655, 88725337, 490694425, 533224761, 151019225, -106399235, -33639342, 51149805, 5555309, -24016054, 1919697, 9533932, -2320679, -2907275, 1127512, 592865, -299766, -58048, 27743},
+{21366, -20052, -296069, 346312, 1314267, -2094321, -3430543, 7806418, 5714017, -21653979, -4222884, 50078067, -11359606, -111767206, 85758363, 488285032, 535049713, 154260475, -105891710, -34723224, 51096449, 6048607, -24086568, 1717853, 9603294, -2256666, -2943937, 1114611, 604959, -299110, -60113, 28008},
+{21040, -18509, -295150, 335115, 1319300, -2054366, -3472027, 7713325, 5871709, -21503342, -4654837, 49928233, -10336323, -111781790, 82807367, 485850602, 536844295, 157511664, -105360413, -35807785, 51033157, 6543831, -24152941, 1514277, 9671298, -2191666, -2980337, 1101336, 617065, -298372, -62199, 28268},
+{20713, -16992, -294172, 323984, 1323998, -2014368, -3512470, 7619436, 6027170, -21349601, -5083228, 49769984, -9317727, -111775560, 79872592, 483391410, 538608301, 160772488, -104805246, -36892831, 50959879, 7040899, -24215134, 1308996, 9737921, -2125687, -3016465, 1087685, 629181, -297548, -64307, 28523},
+{20386, -15499, -293136, 312919, 1328364, -1974337, -3551873, 7524777, 6180385, -21192805, -5507997, 49603401, -8303973, -111748674, 76954283, 480907735, 540341529, 164042645, -104226115, -37978171, 50876567, 7539728, -24273109, 1102039, 9803137, -2058734, -3052311, 1073658, 641306, -296640, -66435, 28772},
+{20058, -14031, -292042, 301923, 1332400, -1934281, -3590235, 7429372, 6331340, -21033004, -5929086, 49428565, -7295212, -111701290, 74052677, 478399857, 542043779, 167321830, -103622927, -39063609, 50783176, 8040234, -24326827, 893435, 9866925, -1990811, -3087865, 1059253, 653435, -295645, -68585, 29015},
+{19730, -12588, -290893, 290998, 1336108, -1894209, -3627557, 7333246, 6480020, -20870249, -6346439, 49245559, -6291596, -111633571, 71168012, 475868059, 543714856, 170609735, -102995594, -40148949, 50679660, 8542331, -24376250, 683215, 9929260, -1921926, -3123116, 1044471, 665566, -294563, -70755, 29253},
+{19402, -11169, -289689, 280145, 1339493, -1854130, -3663841, 7236423, 6626413, -20704589, -6759998, 49054467, -5293274, -111545678, 68300521, 473312627, 545354566, 173906051, -102344030, -41233995, 50565975, 9045936, -24421342, 471408, 9990119, -1852084, -3158055, 1029310, 677697, -293392, -72946, 29484},
+{19074, -9776, -288431, 269366, 1342555, -1814052, -3699087, 7138928, 6770504, -20536076, -7169710, 48855374, -4300393, -111437777, 65450435, 470733849, 546962722, 177210467, -101668150, -42318548, 50442082, 9550960, -24462066, 258045, 10049480, -1781293, -3192671, 1013770, 689824, -292133, -75157, 29709},
+{18747, -8408, -287121, 258662, 1345298, -1773984, -3733297, 7040786, 6912283, -20364759, -7575520, 48648366, -3313098, -111310034, 62617980, 468132015, 548539137, 180522670, -100967876, -43402409, 50307938, 10057318, -24498386, 43158, 10107319, -1709558, -3226953, 997851, 701945, -290784, -77387, 29927},
+{18420, -7064, -285758, 248036, 1347724, -1733934, -3766473, 6942021, 7051736, -20190692, -7977375, 48433530, -2331534, -111162620, 59803383, 465507417, 550083631, 183842346, -100243129, -44485377, 50163507, 10564921, -24530268, -173222, 10163613, -1636887, -3260893, 981552, 714056, -289344, -79637, 30138},
+{18093, -5746, -284346, 237488, 1349837, -1693910, -3798616, 6842658, 7188853, -20013923, -8375223, 48210954, -1355840, -110995705, 57006865, 462860351, 551596025, 187169178, -99493835, -45567251, 50008751, 11073680, -24557676, -391063, 10218340, -1563288, -3294478, 964873, 726155, -287812, -81905, 30342},
+{17767, -4452, -282884, 227021, 1351638, -1653921, -3829729, 6742720, 7323624, -19834506, -8769014, 47980726, -386159, -110809461, 54228644, 460191114, 553076145, 190502847, -98719923, -46647828, 49843635, 11583506, -24580576, -610331, 10271477, -1488767, -3327700, 947813, 738239, -286187, -84193, 30538},
+{17441, -3183, -281373, 216636, 1353132, -1613974, -3859813, 6642233, 7456037, -19652492, -9158698, 47742935, 577374, -110604063, 51468937, 457500005, 554523819, 193843034, -97921324, -47726904, 49668127, 12094309, -24598936, -830993, 10323002, -1413333, -3360547, 930373, 750305, -284469, -86498, 30727},
+{17117, -1939, -279816, 206334, 1354321, -1574078, -3888871, 6541220, 7586083, -19467933, -9544226, 47497673, 1534622, -110379689, 48727955, 454787326, 555938881, 197189417, -97097973, -48804275, 49482194, 12605998, -24612723, -1053015, 10372893, -1336994, -3393010, 912553, 762349, -282657, -88822, 30908},
+{16793, -720, -278212, 196116, 1355207, -1534241, -3916905, 6439706, 7713754, -19280880, -9925552, 47245031, 2485451, -110136514, 46005909, 452053381, 557321168, 200541673, -96249807, -49879734, 49285807, 13118482, -24621906, -1276364, 10421127, -1259758, -3425078, 894352, 774370, -280749, -91163, 31081},
+{16471, 475, -276563, 185985, 1355794, -1494471, -3943919, 6337714, 7839040, -19091386, -10302627, 46985100, 3429729, -109874721, 43303005, 449298475, 558670519, 203899477, -95376767, -50953074, 49078937, 13631667, -24626452, -1501003, 10467683, -1181633, -3456741, 875771, 786362, -278746, -93522, 31246},
+{16150, 1645, -274871, 175941, 1356085, -1454775, -3969915, 6235270, 7961933, -18899504, -10675408, 46717973, 4367326, -109594490, 40619447, 446522916, 559986778, 207262503, -94478798, -52024089, 48861558, 14145461, -24626332, -1726899, 10512540, -1102629, -3487988, 856810, 798325, -276646, -95897, 31402},
+{15831, 2791, -273135, 165985, 1356083, -1415162, -3994896, 6132396, 8082427, -18705286, -11043850, 46443745, 5298115, -109296005, 37955435, 443727015, 561269794, 210630423, -93555846, -53092569, 48633646, 14659770, -24621516, -1954015, 10555675, -1022754, -3518809, 837469, 810254, -274448, -98289, 31549},
+{15513, 3912, -271358, 156120, 1355791, -1375638, -4018866, 6029117, 8200514, -18508784, -11407910, 46162509, 6221968, -108979450, 35311165, 440911082, 562519418, 214002907, -92607861, -54158305, 48395177, 15174500, -24611975, -2182315, 10597068, -942018, -3549195, 817749, 822146, -272152, -100696, 31687},
+{15196, 5009, -269540, 146346, 1355212, -1336212, -4041828, 5925456, 8316187, -18310051, -11767545, 45874362, 7138763, -108645012, 32686832, 438075432, 563735505, 217379626, -91634796, -55221086, 48146131, 15689556, -24597680, -2411762, 10636697, -860430, -3579134, 797650, 833998, -269756, -103119, 31815},
+{14882, 6082, -267682, 136665, 1354350, -1296890, -4063786, 5821437, 8429442, -18109140, -12122715, 45579398, 8048376, -108292880, 30082627, 435220381, 564917915, 220760247, -90636608, -56280701, 47886488, 16204842, -24578605, -2642319, 10674542, -778001, -3608616, 777173, 845807, -267261, -105557, 31934},
+{14569, 7130, -265785, 127077, 1353207, -1257681, -4084745, 5717084, 8540271, -17906105, -12473380, 45277714, 8950688, -107923242, 27498737, 432346244, 566066511, 224144436, -89613257, -57336938, 47616231, 16720262, -24554722, -2873948, 10710581, -694739, -3637631, 756318, 857570, -264666, -108009, 32044},
+{14258, 8155, -263852, 117584, 1351786, -1218591, -4104707, 5612419, 8648671, -17700997, -12819502, 44969407, 9845581, -107536291, 24935347, 429453343, 567181159, 227531859, -88564705, -58389585, 47335344, 17235719, -24526005, -3106611, 10744796, -610657, -3666168, 735087, 869283, -261969, -110476, 32143},
+{13949, 9155, -261881, 108186, 1350092, -1179628, -4123677, 5507468, 8754637, -17493870, -13161042, 44654576, 10732939, -107132218, 22392637, 426541998, 568261730, 230922180, -87490919, -59438427, 47043814, 17751115, -24492430, -3340269, 10777164, -525763, -3694218, 713480, 880943, -259170, -112956, 32231},
+{13642, 10132, -259876, 98886, 1348127, -1140799, -4141660, 5402251, 8858166, -17284777, -13497964, 44333319, 11612648, -106711217, 19870785, 423612530, 569308100, 234315062, -86391867, -60483251, 46741628, 18266353, -24453972, -3574884, 10807667, -440070, -3721771, 691497, 892547, -256269, -115450, 32310},
+{13338, 11085, -257836, 89683, 1345895, -1102110, -4158661, 5296794, 8959253, -17073771, -13830233, 44005735, 12484595, -106273485, 17369966, 420665266, 570320147, 237710167, -85267523, -61523841, 46428777, 18781334, -24410606, -3810416, 10836285, -353587, -3748815, 669141, 904091, -253264, -117956, 32377},
+{13036, 12014, -255762, 80579, 1343399, -1063570, -4174683, 5191118, 9057896, -16860906, -14157814, 43671924, 13348672, -105819218, 14890352, 417700530, 571297753, 241107155, -84117862, -62559983, 46105253, 19295959, -24362312, -4046825, 10862998, -266327, -3775341, 646412, 915572, -250156, -120474, 32433},
+{12736, 12920, -253657, 71575, 1340642, -1025183, -4189732, 5085246, 9154094, -16646235, -14480674, 43331986, 14204770, -105348613, 12432109, 414718649, 572240805, 244505686, -82942862, -63591458, 45771049, 19810128, -24309065, -4284071, 10887787, -178302, -3801338, 623311, 926987, -246942, -123003, 32478},
+{12439, 13803, -251520, 62672, 1337628, -986958, -4203814, 4979202, 9247843, -16429810, -14798782, 42986022, 15052784, -104861870, 9995403, 411719954, 573149194, 247905419, -81742508, -64618052, 45426160, 20323742, -24250846, -4522112, 10910632, -89522, -3826796, 599841, 938333, -243624, -125544, 32511},
+{12145, 14663, -249353, 53871, 1334360, -948901, -4216933, 4873008, 9339143, -16211686, -15112105, 42634133, 15892610, -104359191, 7580396, 408704773, 574022815, 251306011, -80516783, -65639547, 45070586, 20836698, -24187634, -4760908, 10931517, 0, -3851706, 576001, 949605, -240200, -128095, 32532},
+{11853, 15500, -247156, 45172, 1330841, -911018, -4229094, 4766687, 9427993, -15991915, -15420614, 42276421, 16724146, -103840776, 5187244, 405673439, 574861565, 254707118, -79265678, -66655723, 44704325, 21348897, -24119410, -5000416, 10950420, 90251, -3876057, 551794, 960800, -236670, -130656, 32541},
+{11564, 16313, -244932, 36576, 1327076, -873316, -4240304, 4660259, 9514393, -15770550, -15724281, 41912989, 17547292, -103306829, 2816103, 402626286, 575665348, 258108397, -77989185, -67666364, 44327378, 21860236, -24046154, -5240596, 10967326, 181220, -3899839, 527222, 971916, -233033, -133227, 32538},
+{11278, 17105, -242680, 28084, 1323068, -835801, -4250568, 4553749, 9598342, -15547646, -16023077, 41543939, 18361953, -102757553, 467123, 399563647, 576434070, 261509503, -76687298, -68671251, 43939750, 22370614, -23967849, -5481403, 10982215, 272893, -3923041, 502286, 982948, -229289, -135806, 32522},
+{10995, 17873, -240403, 19697, 1318819, -798479, -4259892, 4447178, 9679842, -15323254, -16316976, 41169374, 19168031, -102193155, -1859546, 396485858, 577167641, 264910089, -75360019, -69670163, 43541445, 22879928, -23884479, -5722796, 10995071, 365256, -3945655, 476987, 993893, -225437, -138393, 32493},
+{10714, 18619, -238100, 11416, 1314334, -761357, -4268282, 4340567, 9758894, -15097428, -16605952, 40789398, 19965435, -101613841, -4163762, 393393256, 577865978, 268309809, -74007348, -70662882, 43132471, 23388075, -23796026, -5964731, 11005875, 458298, -3967670, 451328, 1004748, -221477, -140988, 32451},
+{10437, 19344, -235773, 3240, 1309617, -724440, -4275744, 4233939, 9835499, -14870221, -16889981, 40404115, 20754073, -101019817, -6445382, 390286180, 578528997, 271708316, -72629292, -71649188, 42712838, 23894952, -23702477, -6207164, 11014611, 552004, -3989076, 425312, 1015509, -217408, -143590, 32395},
+{10163, 20046, -233422, -4828, 1304670, -687735, -4282285, 4127314, 9909660, -14641686, -17169040, 40013629, 21533855, -100411292, -8704270, 387164968, 579156624, 275105261, -71225860, -72628859, 42282556, 24400455, -23603816, -6450052, 11021262, 646360, -4009862, 398939, 1026172, -213230, -146198, 32326},
+{9892, 20726, -231050, -12790, 1299497, -651247, -4287911, 4020716, 9981378, -14411876, -17443107, 39618046, 22304696, -99788476, -10940290, 384029962, 579748783, 278500297, -69797064, -73601675, 41841639, 24904480, -23500030, -6693349, 11025812, 741352, -4030021, 372212, 1036734, -208942, -148811, 32243},
+{9624, 21385, -228656, -20643, 1294103, -614981, -4292628, 3914163, 10050657, -14180844, -17712159, 39217469, 23066511, -99151579, -13153313, 380881502, 580305408, 281893073, -68342922, -74567416, 41390102, 25406923, -23391108, -6937011, 11028244, 836967, -4049541, 345134, 1047191, -204545, -151430, 32146},
+{9360, 22022, -226242, -28388, 1288490, -578945, -4296444, 3807679, 10117502, -13948642, -17976179, 38812005, 23819216, -98500812, -15343211, 377719931, 580826432, 285283241, -66863451, -75525860, 40927964, 25907679, -23277037, -7180993, 11028543, 933188, -4068413, 317707, 1057540, -200037, -154053, 32034},
+{9099, 22638, -223809, -36023, 1282662, -543142, -4299365, 3701283, 10181914, -13715323, -18235145, 38401760, 24562731, -97836387, -17509859, 374545592, 581311795, 288670449, -65358676, -76476786, 40455243, 26406643, -23157806, -7425250, 11026692, 1030003, -4086627, 289933, 1067777, -195419, -156680, 31907},
+{8841, 23233, -221357, -43550, 1276623, -507579, -4301398, 3594996, 10243900, -13480939, -18489041, 37986838, 25296979, -97158517, -19653138, 371358829, 581761441, 292054348, -63828622, -77419972, 39971961, 26903709, -23033407, -7669734, 11022678, 1127395, -4104174, 261815, 1077899, -190689, -159310, 31766},
+{8587, 23807, -218888, -50966, 1270377, -472261, -4302551, 3488839, 10303464, -13245543, -18737849, 37567346, 26021882, -96467415, -21772931, 368159989, 582175317, 295434586, -62273319, -78355197, 39478141, 27398773, -22903831, -7914401, 11016485, 1225349, -4121044, 233356, 1087901, -185848, -161942, 31609},
+{8336, 24360, -216403, -58273, 1263926, -437193, -4302830, 3382832, 10360611, -13009187, -18981554, 37143391, 26737368, -95763296, -23869124, 364949416, 582553376, 298810813, -60692801, -79282239, 38973809, 27891728, -22769069, -8159203, 11008099, 1323851, -4137227, 204558, 1097781, -180896, -164576, 31437},
+{8089, 24893, -213901, -65468, 1257276, -402380, -4302243, 3276996, 10415348, -12771923, -19220141, 36715080, 27443362, -95046375, -25941606, 361727457, 582895573, 302182676, -59087104, -80200875, 38458992, 28382468, -22629114, -8404093, 10997505, 1422883, -4152715, 175425, 1107534, -175832, -167210, 31249},
+{7846, 25406, -211386, -72553, 1250429, -367827, -4300798, 3171350, 10467680, -12533803, -19453598, 36282518, 28139797, -94316868, -27990272, 358494460, 583201869, 305549823, -57456268, -81110885, 37933721, 28870887, -22483962, -8649025, 10984690, 1522431, -4167497, 145960, 1117157, -170657, -169845, 31045},
+{7606, 25899, -208856, -79526, 1243389, -333539, -4298503, 3065914, 10517614, -12294879, -19681910, 35845812, 28826604, -93574991, -30015019, 355250773, 583472227, 308911904, -55800338, -82012046, 37398027, 29356879, -22333607, -8893950, 10969640, 1622477, -4181566, 116165, 1126647, -165369, -172479, 30824},
+{7370, 26372, -206313, -86388, 1236160, -299521, -4295364, 2960708, 10565157, -12055202, -19905067, 35405071, 29503718, -92820961, -32015746, 351996744, 583706616, 312268565, -54119360, -82904136, 36851944, 29840336, -22178045, -9138822, 10952342, 1723006, -4194910, 86044, 1135999, -159969, -175112, 30588},
+{7137, 26826, -203759, -93138, 1228745, -265777, -4291391, 2855751, 10610317, -11814823, -20123058, 34960400, 30171075, -92054995, -33992358, 348732723, 583905010, 315619453, -52413384, -83786934, 36295507, 30321152, -22017274, -9383591, 10932784, 1824001, -4207522, 55601, 1145210, -154456, -177742, 30334},
+{6908, 27260, -201193, -99776, 1221149, -232313, -4286590, 2751062, 10653102, -11573794, -20335874, 34511908, 30828613, -91277313, -35944762, 345459059, 584067385, 318964218, -50682466, -84660219, 35728756, 30799220, -21851291, -9628208, 10910953, 1925445, -4219393, 24838, 1154276, -148831, -180370, 30064},
+{6683, 27675, -198617, -106301, 1213374, -199132, -4280970, 2646660, 10693520, -11332166, -20543507, 34059701, 31476274, -90488131, -37872868, 342176103, 584193721, 322302506, -48926662, -85523767, 35151730, 31274433, -21680095, -9872627, 10886837, 2027321, -4230512, -6241, 1163194, -143093, -182994, 29776},
+{6462, 28071, -196032, -112715, 1205425, -166239, -4274539, 2542565, 10731580, -11089989, -20745949, 33603887, 32114001, -89687671, -39776592, 338884205, 584284005, 325633966, -47146034, -86377359, 34564471, 31746683, -21503687, -10116796, 10860424, 2129612, -4240872, -37632, 1171959, -137243, -185614, 29471},
+{6245, 28448, -193438, -119016, 1197306, -133639, -4267306, 2438794, 10767292, -10847315, -20943195, 33144573, 32741739, -88876150, -41655852, 335583717, 584338226, 328958244, -45340647, -87220773, 33967024, 32215864, -21322067, -10360668, 10831703, 2232300, -4250464, -69331, 1180569, -131280, -188229, 29148},
+{0, 28807, -190838, -125205, 1189026, -101335, -4259302, 2335380, 10800725, -10604252, -21135357, 32682051, 33359622, -88054283, -43510812, 332276855, 584359659, 332276855, -43510812, -88054283, 33359622, 32682051, -21135357, -10604252, 10800725, 2335380, -4259302, -101335, 1189026, -125205, -190838, 28807}
+};
+
+// 96000 Hz to 48000 Hz, cut at the output Nyquist frequency
+static const int32_t AUDIO_ASRC_Coef_96k_48k[AUDIO_ASRC_PHASES + 1][AUDIO_ASRC_TAPS] = {
+{-58703, 0, 537518, 0, -2371476, 0, 7411183, 0, -18824112, 0, 42535515, 0, -96293720, 0, 335500861, 536867693, 335500861, 0, -96293720, 0, 42535515, 0, -18824112, 0, 7411183, 0, -2371476, 0, 537518, 0, -58703, 0},
+{-58023, -2495, 533838, 14574, -2359461, -52906, 7381163, 147340, -18759627, -349243, 42401439, 773607, -95951481, -1938048, 332778134, 536853656, 338214859, 1955529, -96623069, -778491, 42663589, 351462, -18885944, -148413, 7440183, 53377, -2383182, -14743, 541138, 2537, -59381, -95},
+{-57339, -4947, 530097, 28979, -2347141, -105336, 7350134, 293590, -18692512, -696223, 42261412, 1542240, -95596476, -3858518, 330046871, 536811455, 340919821, 3928437, -96939371, -1561776, 42785596, 705101, -18945091, -297881, 7468148, 107220, -2394573, -29654, 544695, 5116, -60055, -196},
+{-56652, -7357, 526298, 43214, -2334522, -157285, 7318110, 438733, -18622798, -1040899, 42115492, 2305810, -95228844, -5761312, 327307323, 536741094, 343615497, 5918621, -97242490, -2349761, 42901480, 1060870, -19001525, -448387, 7495065, 161522, -2405643, -44731, 548186, 7738, -60725, -300},
+{-55963, -9725, 522442, 57276, -2321608, -208746, 7285104, 582752, -18550511, -1383228, 41963739, 3064230, -94848729, -7646337, 324559741, 536642579, 346301638, 7925977, -97532286, -3142352, 43011185, 1418727, -19055220, -599911, 7520922, 216278, -2416388, -59973, 551612, 10402, -61392, -410},
+{-55272, -12051, 518531, 71167, -2308406, -259716, 7251129, 725630, -18475682, -1723169, 41806211, 3817413, -94456273, -9513500, 321804378, 536515921, 348977995, 9950396, -97808624, -3939455, 43114655, 1778624, -19106147, -752436, 7545705, 271482, -2426803, -75379, 554970, 13108, -62054, -525},
+{-54579, -14335, 514566, 84884, -2294921, -310189, 7216199, 867352, -18398340, -2060681, 41642970, 4565275, -94051619, -11362713, 319041485, 536361132, 351644320, 11991768, -98071367, -4740972, 43211835, 2140516, -19154281, -905943, 7569403, 327128, -2436882, -90948, 558259, 15857, -62711, -645},
+{-53885, -16577, 510549, 98427, -2281157, -360160, 7180327, 1007902, -18318513, -2395725, 41474077, 5307731, -93634912, -13193887, 316271315, 536178228, 354300365, 14049980, -98320382, -5546807, 43302671, 2504356, -19199594, -1060411, 7592001, 383209, -2446620, -106678, 561477, 18648, -63364, -769},
+{-53189, -18777, 506482, 111795, -2267119, -409625, 7143528, 1147264, -18236232, -2728262, 41299592, 6044701, -93206295, -15006938, 313494121, 535967227, 356945884, 16124919, -98555535, -6356860, 43387110, 2870097, -19242060, -1215822, 7613489, 439720, -2456012, -122568, 564622, 21481, -64011, -899},
+{-52492, -20935, 502366, 124988, -2252814, -458580, 7105813, 1285422, -18151527, -3058253, 41119578, 6776102, -92765916, -16801784, 310710156, 535728150, 359580629, 18216468, -98776692, -7171031, 43465100, 3237690, -19281654, -1372157, 7633853, 496653, -2465053, -138618, 567693, 24356, -64652, -1034},
+{-51794, -23052, 498202, 138004, -2238247, -507019, 7067198, 1422363, -18064428, -3385660, 40934097, 7501856, -92313920, -18578343, 307919673, 535461020, 362204357, 20324507, -98983723, -7989219, 43536587, 3607088, -19318350, -1529394, 7653081, 554002, -2473738, -154824, 570688, 27274, -65288, -1175},
+{-51095, -25127, 493992, 150844, -2223422, -554939, 7027696, 1558071, -17974964, -3710445, 40743212, 8221883, -91850455, -20336537, 305122926, 535165865, 364816821, 22448916, -99176497, -8811321, 43601522, 3978240, -19352123, -1687514, 7671161, 611761, -2482061, -171186, 573606, 30234, -65918, -1320},
+{-50396, -27161, 489737, 163506, -2208345, -602336, 6987321, 1692533, -17883168, -4032573, 40546987, 8936108, -91375667, -22076292, 302320168, 534842715, 367417778, 24589571, -99354884, -9637233, 43659853, 4351097, -19382947, -1846495, 7688081, 669922, -2490019, -187702, 576445, 33235, -66541, -1471},
+{-49697, -29153, 485440, 175990, -2193022, -649205, 6946086, 1825734, -17789068, -4352007, 40345485, 9644454, -90889706, -23797533, 299511653, 534491600, 370006984, 26746347, -99518756, -10466850, 43711530, 4725609, -19410799, -2006318, 7703829, 728478, -2497605, -204371, 579203, 36279, -67158, -1628},
+{-48997, -31104, 481100, 188295, -2177457, -695543, 6904006, 1957660, -17692697, -4668712, 40138770, 10346848, -90392720, -25500189, 296697635, 534112557, 372584197, 28919116, -99667987, -11300067, 43756505, 5101725, -19435654, -2166960, 7718393, 787422, -2504815, -221191, 581880, 39364, -67767, -1790},
+{-48298, -33015, 476721, 200422, -2161656, -741346, 6861094, 2088300, -17594084, -4982654, 39926909, 11043216, -89884858, -27184191, 293878367, 533705623, 375149175, 31107748, -99802449, -12136775, 43794730, 5479392, -19457488, -2328400, 7731762, 846748, -2511643, -238160, 584472, 42492, -68369, -1958},
+{-47600, -34884, 472303, 212369, -2145624, -786611, 6817365, 2217638, -17493263, -5293797, 39709965, 11733487, -89366272, -28849474, 291054104, 533270838, 377701678, 33312111, -99922018, -12976866, 43826157, 5858560, -19476278, -2490617, 7743924, 906447, -2518086, -255277, 586979, 45660, -68964, -2131},
+{-46902, -36714, 467848, 224137, -2129367, -831334, 6772833, 2345664, -17390263, -5602110, 39488005, 12417591, -88837110, -30495972, 288225099, 532808247, 380241465, 35532070, -100026570, -13820230, 43850739, 6239176, -19492000, -2653587, 7754867, 966512, -2524137, -272540, 589399, 48870, -69550, -2310},
+{-46205, -38502, 463357, 235724, -2112889, -875511, 6727511, 2472364, -17285118, -5907560, 39261095, 13095459, -88297525, -32123624, 285391607, 532317894, 382768297, 37767491, -100115983, -14666756, 43868431, 6621185, -19504632, -2817289, 7764580, 1026935, -2529793, -289946, 591730, 52122, -70128, -2495},
+{-45509, -40250, 458832, 247131, -2096195, -919140, 6681413, 2597726, -17177857, -6210113, 39029301, 13767023, -87747668, -33732371, 282553881, 531799829, 385281936, 40018233, -100190136, -15516333, 43879187, 7004535, -19514152, -2981700, 7773052, 1087708, -2535048, -307495, 593971, 55414, -70697, -2686},
+{-44814, -41959, 454274, 258358, -2079292, -962217, 6634555, 2721739, -17068514, -6509741, 38792690, 14432218, -87187690, -35322155, 279712175, 531254104, 387782146, 42284157, -100248908, -16368847, 43882964, 7389171, -19520536, -3146797, 7780272, 1148825, -2539897, -325184, 596120, 58747, -71258, -2882},
+{-44121, -43627, 449685, 269403, -2062185, -1004739, 6586950, 2844392, -16957120, -6806411, 38551329, 15090979, -86617746, -36892921, 276866743, 530680773, 390268689, 44565120, -100292181, -17224184, 43879717, 7775039, -19523765, -3312557, 7786229, 1210275, -2544336, -343011, 598176, 62121, -71809, -3085},
+{-43430, -45256, 445066, 280267, -2044878, -1046704, 6538611, 2965672, -16843708, -7100094, 38305286, 15743243, -86037986, -38444617, 274017837, 530079893, 392741332, 46860977, -100319837, -18082228, 43869406, 8162082, -19523815, -3478956, 7790912, 1272052, -2548360, -360974, 600137, 65536, -72350, -3293},
+{-42740, -46845, 440418, 290951, -2027376, -1088110, 6489554, 3085571, -16728310, -7390760, 38054629, 16388947, -85448566, -39977193, 271165713, 529451524, 395199839, 49171580, -100331760, -18942862, 43851987, 8550245, -19520668, -3645971, 7794311, 1334147, -2551964, -379071, 602001, 68991, -72881, -3507},
+{-42053, -48395, 435743, 301453, -2009686, -1128952, 6439793, 3204076, -16610958, -7678382, 37799427, 17028031, -84849638, -41490600, 268310622, 528795728, 397643978, 51496783, -100327835, -19805970, 43827421, 8939472, -19514301, -3813577, 7796415, 1396552, -2555144, -397300, 603766, 72486, -73402, -3728},
+{-41368, -49906, 431042, 311773, -1991812, -1169230, 6389342, 3321178, -16491685, -7962930, 37539747, 17660435, -84241357, -42984793, 265452817, 528112571, 400073518, 53836432, -100307949, -20671432, 43795668, 9329706, -19504696, -3981750, 7797214, 1459257, -2557894, -415659, 605432, 76021, -73912, -3955},
+{-40685, -51379, 426316, 321913, -1973759, -1208940, 6338215, 3436867, -16370523, -8244379, 37275659, 18286103, -83623876, -44459729, 262592552, 527402120, 402488227, 56190375, -100271990, -21539129, 43756688, 9720888, -19491832, -4150466, 7796698, 1522255, -2560211, -434146, 606996, 79595, -74411, -4188},
+{-40005, -52813, 421567, 331870, -1955533, -1248080, 6286426, 3551134, -16247506, -8522701, 37007232, 18904977, -82997352, -45915367, 259730079, 526664447, 404887876, 58558458, -100219847, -22408939, 43710443, 10112961, -19475691, -4319699, 7794856, 1585536, -2562090, -452758, 608458, 83208, -74898, -4427},
+{-39328, -54208, 416797, 341647, -1937138, -1286649, 6233990, 3663969, -16122667, -8797870, 36734535, 19517002, -82361939, -47351668, 256865649, 525899625, 407272237, 60940523, -100151410, -23280741, 43656898, 10505867, -19456253, -4489425, 7791680, 1649091, -2563526, -471493, 609814, 86861, -75374, -4673},
+{-38653, -55566, 412006, 351242, -1918580, -1324644, 6180921, 3775364, -15996037, -9069862, 36457639, 20122125, -81717791, -48768596, 253999514, 525107729, 409641082, 63336410, -100066572, -24154411, 43596014, 10899547, -19433500, -4659618, 7787158, 1712912, -2564515, -490349, 611064, 90553, -75837, -4924},
+{-37982, -56886, 407196, 360657, -1899864, -1362064, 6127233, 3885309, -15867651, -9338652, 36176613, 20720294, -81065066, -50166117, 251131927, 524288838, 411994186, 65745959, -99965226, -25029827, 43527758, 11293941, -19407415, -4830252, 7781282, 1776989, -2565052, -509322, 612206, 94282, -76288, -5183},
+{-37314, -58168, 402368, 369890, -1880995, -1398907, 6072941, 3993798, -15737542, -9604216, 35891528, 21311456, -80403919, -51544198, 248263137, 523443035, 414331325, 68169007, -99847268, -25906862, 43452095, 11688989, -19377980, -5001302, 7774043, 1841313, -2565134, -528412, 613239, 98050, -76726, -5447},
+{-36650, -59413, 397523, 378943, -1861978, -1435171, 6018058, 4100821, -15605742, -9866531, 35602453, 21895564, -79734505, -52902812, 245393396, 522570402, 416652275, 70605389, -99712593, -26785391, 43368992, 12084631, -19345178, -5172741, 7765431, 1905875, -2564755, -547615, 614161, 101856, -77151, -5719},
+{-35989, -60622, 392663, 387815, -1842818, -1470856, 5962600, 4206371, -15472286, -10125574, 35309461, 22472568, -79056981, -54241930, 242522952, 521671027, 418956813, 73054937, -99561100, -27665286, 43278417, 12480806, -19308992, -5344544, 7755437, 1970664, -2563912, -566929, 614970, 105699, -77563, -5996},
+{-35332, -61793, 387789, 396506, -1823520, -1505958, 5906580, 4310441, -15337206, -10381324, 35012622, 23042422, -78371503, -55561528, 239652057, 520744999, 421244721, 75517483, -99392688, -28546421, 43180338, 12877452, -19269407, -5516683, 7744052, 2035672, -2562600, -586351, 615666, 109579, -77960, -6280},
+{-34678, -62929, 382903, 405018, -1804089, -1540478, 5850013, 4413023, -15200536, -10633760, 34712006, 23605080, -77678229, -56861584, 236780959, 519792409, 423515778, 77992856, -99207259, -29428665, 43074725, 13274509, -19226406, -5689132, 7731269, 2100887, -2560815, -605878, 616245, 113496, -78343, -6571},
+{-34029, -64028, 378005, 413351, -1784531, -1574415, 5792913, 4514112, -15062309, -10882861, 34407686, 24160498, -76977314, -58142076, 233909906, 518813353, 425769767, 80480883, -99004715, -30311889, 42961548, 13671913, -19179976, -5861863, 7717077, 2166302, -2558553, -625508, 616707, 117449, -78711, -6869},
+{-33384, -65091, 373096, 421504, -1764849, -1607766, 5735294, 4613701, -14922559, -11128607, 34099733, 24708634, -76268915, -59402988, 231039147, 517807927, 428006471, 82981390, -98784960, -31195962, 42840780, 14069602, -19130100, -6034849, 7701470, 2231904, -2555810, -645238, 617051, 121438, -79064, -7173},
+{-32743, -66119, 368179, 429478, -1745050, -1640532, 5677170, 4711783, -14781320, -11370980, 33788218, 25249447, -75553190, -60644303, 228168929, 516776231, 430225676, 85494199, -98547899, -32080753, 42712394, 14467512, -19076766, -6208063, 7684439, 2297685, -2552582, -665065, 617274, 125462, -79402, -7483},
+{-32107, -67112, 363254, 437274, -1725138, -1672712, 5618556, 4808353, -14638625, -11609961, 33473213, 25782895, -74830295, -61866009, 225299498, 515718368, 432427169, 88019134, -98293442, -32966128, 42576362, 14865582, -19019959, -6381477, 7665976, 2363634, -2548865, -684987, 617375, 129522, -79724, -7801},
+{-31475, -68070, 358322, 444891, -1705117, -1704305, 5559466, 4903405, -14494507, -11845532, 33154791, 26308942, -74100387, -63068093, 222431101, 514634442, 434610737, 90556013, -98021495, -33851954, 42432661, 15263745, -18959666, -6555063, 7646074, 2429741, -2544655, -705000, 617353, 133615, -80029, -8125},
+{-30848, -68994, 353385, 452332, -1684994, -1735310, 5499914, 4996935, -14349001, -12077676, 32833022, 26827549, -73363623, -64250547, 219563983, 513524561, 436776170, 93104654, -97731971, -34738097, 42281265, 15661939, -18895875, -6728793, 7624724, 2495995, -2539948, -725102, 617206, 137744, -80318, -8456},
+{-30226, -69883, 348443, 459595, -1664771, -1765728, 5439914, 5088936, -14202139, -12306378, 32507981, 27338681, -72620160, -65413365, 216698389, 512388834, 438923260, 95664874, -97424781, -35624422, 42122153, 16060099, -18828574, -6902637, 7601921, 2562385, -2534741, -745289, 616933, 141905, -80590, -8793},
+{-29608, -70739, 343498, 466682, -1644456, -1795557, 5379480, 5179406, -14053956, -12531620, 32179738, 27842303, -71870156, -66556542, 213834563, 511227374, 441051800, 98236486, -97099840, -36510791, 41955302, 16458159, -18757750, -7076568, 7577656, 2628901, -2529029, -765559, 616531, 146100, -80845, -9138},
+{-28996, -71561, 338551, 473594, -1624051, -1824798, 5318626, 5268339, -13904486, -12753389, 31848366, 28338382, -71113766, -67680076, 210972747, 510040297, 443161583, 100819305, -96757063, -37397069, 41780691, 16856053, -18683393, -7250557, 7551923, 2695532, -2522810, -785908, 616001, 150328, -81082, -9489},
+{-28389, -72349, 333604, 480330, -1603563, -1853451, 5257366, 5355731, -13753761, -12971669, 31513937, 28826887, -70351148, -68783968, 208113186, 508827718, 445252407, 103413140, -96396368, -38283116, 41598300, 17253717, -18605492, -7424574, 7524715, 2762267, -2516079, -806333, 615340, 154587, -81301, -9847},
+{-27787, -73105, 328656, 486892, -1582995, -1881515, 5195715, 5441579, -13601816, -13186448, 31176525, 29307787, -69582460, -69868218, 205256119, 507589759, 447324070, 106017801, -96017673, -39168796, 41408112, 17651084, -18524037, -7598591, 7496026, 2829095, -2508833, -826832, 614546, 158878, -81501, -10212},
+{-27190, -73828, 323710, 493280, -1562353, -1908991, 5133686, 5525880, -13448685, -13397712, 30836200, 29781052, -68807856, -70932833, 202401788, 506326542, 449376369, 108633094, -95620901, -40053968, 41210108, 18048087, -18439019, -7772577, 7465849, 2896005, -2501069, -847400, 613619, 163200, -81682, -10584},
+{-26599, -74520, 318766, 499495, -1541640, -1935880, 5071294, 5608630, -13294400, -13605448, 30493037, 30246657, -68027494, -71977819, 199550433, 505038191, 451409108, 111258827, -95205973, -40938492, 41004273, 18444660, -18350429, -7946504, 7434179, 2962985, -2492783, -868036, 612557, 167553, -81844, -10962},
+{-26013, -75179, 313826, 505537, -1520863, -1962180, 5008551, 5689826, -13138995, -13809646, 30147108, 30704573, -67241531, -73003184, 196702293, 503724834, 453422089, 113894803, -94772814, -41822226, 40790590, 18840735, -18258257, -8120340, 7401010, 3030025, -2483972, -888734, 611358, 171936, -81987, -11347},
+{-25433, -75807, 308890, 511408, -1500024, -1987894, 4945472, 5769467, -12982505, -14010293, 29798485, 31154776, -66450122, -74008941, 193857605, 502386600, 455415117, 116540823, -94321350, -42705031, 40569047, 19236244, -18162497, -8294057, 7366336, 3097112, -2474632, -909492, 610021, 176348, -82109, -11740},
+{-24859, -76403, 303960, 517108, -1479130, -2013022, 4882071, 5847549, -12824962, -14207380, 29447240, 31597243, -65653424, -74995101, 191016607, 501023622, 457387997, 119196690, -93851509, -43586762, 40339629, 19631121, -18063141, -8467624, 7330152, 3164236, -2464761, -930307, 608545, 180788, -82211, -12139},
+{-24291, -76969, 299036, 522638, -1458184, -2037563, 4818362, 5924072, -12666400, -14400897, 29093447, 32031951, -64851593, -75961682, 188179536, 499636034, 459340540, 121862202, -93363222, -44467276, 40102326, 20025296, -17960182, -8641011, 7292453, 3231384, -2454355, -951175, 606928, 185257, -82292, -12545},
+{-23728, -77505, 294120, 527999, -1437191, -2061520, 4754357, 5999032, -12506853, -14590835, 28737178, 32458879, -64044783, -76908700, 185346626, 498223972, 461272555, 124537157, -92856420, -45346431, 39857126, 20418701, -17853614, -8814187, 7253234, 3298545, -2443412, -972093, 605170, 189753, -82352, -12958},
+{-23171, -78011, 289213, 533192, -1416155, -2084892, 4690071, 6072430, -12346353, -14777185, 28378506, 32878008, -63233151, -77836176, 182518111, 496787577, 463183854, 127221351, -92331037, -46224081, 39604021, 20811268, -17743432, -8987120, 7212489, 3365706, -2431928, -993057, 603267, 194275, -82390, -13377},
+{-22621, -78486, 284315, 538217, -1395081, -2107681, 4625517, 6144263, -12184935, -14959939, 28017503, 33289319, -62416852, -78744131, 179694225, 495326989, 465074251, 129914577, -91787007, -47100081, 39343002, 21202927, -17629629, -9159782, 7170216, 3432857, -2419900, -1014063, 601220, 198824, -82406, -13804},
+{-22076, -78933, 279428, 543076, -1373974, -2129889, 4560710, 6214532, -12022631, -15139091, 27654241, 33692795, -61596040, -79632590, 176875200, 493842352, 466943561, 132616630, -91224270, -47974285, 39074062, 21593609, -17512203, -9332139, 7126409, 3499984, -2407326, -1035108, 599028, 203399, -82399, -14237},
+{-21538, -79350, 274552, 547770, -1352837, -2151515, 4495661, 6283234, -11859475, -15314634, 27288793, 34088420, -60770870, -80501579, 174061266, 492333812, 468791604, 135327300, -90642763, -48846547, 38797195, 21983245, -17391148, -9504162, 7081065, 3567077, -2394204, -1056188, 596687, 207998, -82370, -14677},
+{-21006, -79740, 269689, 552299, -1331675, -2172563, 4430385, 6350372, -11695499, -15486562, 26921231, 34476181, -59941496, -81351127, 171252653, 490801518, 470618198, 138046378, -90042429, -49716719, 38512396, 22371765, -17266461, -9675818, 7034181, 3634122, -2380529, -1077299, 594198, 212621, -82318, -15124},
+{-20480, -80100, 264839, 556664, -1310492, -2193032, 4364895, 6415943, -11530737, -15654870, 26551627, 34856064, -59108072, -82181263, 168449591, 489245621, 472423166, 140773651, -89423209, -50584654, 38219663, 22759098, -17138141, -9847076, 6985751, 3701106, -2366301, -1098438, 591560, 217267, -82242, -15578},
+{-19960, -80433, 260003, 560867, -1289293, -2212924, 4299205, 6479950, -11365222, -15819553, 26180054, 35228058, -58270752, -82992020, 165652305, 487666273, 474206331, 143508907, -88785051, -51450204, 37918994, 23145175, -17006184, -10017904, 6935775, 3768019, -2351515, -1119601, 588770, 221936, -82142, -16038},
+{-19447, -80739, 255183, 564908, -1268081, -2232241, 4233326, 6542391, -11198987, -15980607, 25806584, 35592151, -57429688, -83783434, 162861024, 486063629, 475967519, 146251931, -88127899, -52313219, 37610386, 23529925, -16870589, -10188272, 6884248, 3834847, -2336171, -1140784, 585828, 226626, -82018, -16505},
+{-18940, -81018, 250378, 568789, -1246861, -2250985, 4167274, 6603269, -11032063, -16138030, 25431287, 35948335, -56585034, -84555541, 160075972, 484437847, 477706557, 149002508, -87451704, -53173551, 37293841, 23913277, -16731354, -10358145, 6831167, 3901578, -2320265, -1161983, 582732, 231338, -81869, -16979},
+{-18440, -81269, 245591, 572511, -1225637, -2269158, 4101059, 6662584, -10864485, -16291818, 25054237, 36296602, -55736942, -85308379, 157297372, 482789086, 479423276, 151760419, -86756417, -54031049, 36969360, 24295160, -16588481, -10527494, 6776531, 3968199, -2303796, -1183194, 579481, 236070, -81695, -17460},
+{-17947, -81495, 240821, 576075, -1204414, -2286761, 4034697, 6720337, -10696284, -16441968, 24675504, 36636946, -54885563, -86041990, 154525447, 481117507, 481117507, 154525447, -86041990, -54885563, 36636946, 24675504, -16441968, -10696284, 6720337, 4034697, -2286761, -1204414, 576075, 240821, -81495, -17947},
+{-17460, -81695, 236070, 579481, -1183194, -2303796, 3968199, 6776531, -10527494, -16588481, 24295160, 36969360, -54031049, -86756417, 151760419, 479423276, 482789086, 157297372, -85308379, -55736942, 36296602, 25054237, -16291818, -10864485, 6662584, 4101059, -2269158, -1225637, 572511, 245591, -81269, -18440},
+{-16979, -81869, 231338, 582732, -1161983, -2320265, 3901578, 6831167, -10358145, -16731354, 23913277, 37293841, -53173551, -87451704, 149002508, 477706557, 484437847, 160075972, -84555541, -56585034, 35948335, 25431287, -16138030, -11032063, 6603269, 4167274, -2250985, -1246861, 568789, 250378, -81018, -18940},
+{-16505, -82018, 226626, 585828, -1140784, -2336171, 3834847, 6884248, -10188272, -16870589, 23529925, 37610386, -52313219, -88127899, 146251931, 475967519, 486063629, 162861024, -83783434, -57429688, 35592151, 25806584, -15980607, -11198987, 6542391, 4233326, -2232241, -1268081, 564908, 255183, -80739, -19447},
+{-16038, -82142, 221936, 588770, -1119601, -2351515, 3768019, 6935775, -10017904, -17006184, 23145175, 37918994, -51450204, -88785051, 143508907, 474206331, 487666273, 165652305, -82992020, -58270752, 35228058, 26180054, -15819553, -11365222, 6479950, 4299205, -2212924, -1289293, 560867, 260003, -80433, -19960},
+{-15578, -82242, 217267, 591560, -1098438, -2366301, 3701106, 6985751, -9847076, -17138141, 22759098, 38219663, -50584654, -89423209, 140773651, 472423166, 489245621, 168449591, -82181263, -59108072, 34856064, 26551627, -15654870, -11530737, 6415943, 4364895, -2193032, -1310492, 556664, 264839, -80100, -20480},
+{-15124, -82318, 212621, 594198, -1077299, -2380529, 3634122, 7034181, -9675818, -17266461, 22371765, 38512396, -49716719, -90042429, 138046378, 470618198, 490801518, 171252653, -81351127, -59941496, 34476181, 26921231, -15486562, -11695499, 6350372, 4430385, -2172563, -1331675, 552299, 269689, -79740, -21006},
+{-14677, -82370, 207998, 596687, -1056188, -2394204, 3567077, 7081065, -9504162, -17391148, 21983245, 38797195, -48846547, -90642763, 135327300, 468791604, 492333812, 174061266, -80501579, -60770870, 34088420, 27288793, -15314634, -11859475, 6283234, 4495661, -2151515, -1352837, 547770, 274552, -79350, -21538},
+{-14237, -82399, 203399, 599028, -1035108, -2407326, 3499984, 7126409, -9332139, -17512203, 21593609, 39074062, -47974285, -91224270, 132616630, 466943561, 493842352, 176875200, -79632590, -61596040, 33692795, 27654241, -15139091, -12022631, 6214532, 4560710, -2129889, -1373974, 543076, 279428, -78933, -22076},
+{-13804, -82406, 198824, 601220, -1014063, -2419900, 3432857, 7170216, -9159782, -17629629, 21202927, 39343002, -47100081, -91787007, 129914577, 465074251, 495326989, 179694225, -78744131, -62416852, 33289319, 28017503, -14959939, -12184935, 6144263, 4625517, -2107681, -1395081, 538217, 284315, -78486, -22621},
+{-13377, -82390, 194275, 603267, -993057, -2431928, 3365706, 7212489, -8987120, -17743432, 20811268, 39604021, -46224081, -92331037, 127221351, 463183854, 496787577, 182518111, -77836176, -63233151, 32878008, 28378506, -14777185, -12346353, 6072430, 4690071, -2084892, -1416155, 533192, 289213, -78011, -23171},
+{-12958, -82352, 189753, 605170, -972093, -2443412, 3298545, 7253234, -8814187, -17853614, 20418701, 39857126, -45346431, -92856420, 124537157, 461272555, 498223972, 185346626, -76908700, -64044783, 32458879, 28737178, -14590835, -12506853, 5999032, 4754357, -2061520, -1437191, 527999, 294120, -77505, -23728},
+{-12545, -82292, 185257, 606928, -951175, -2454355, 3231384, 7292453, -8641011, -17960182, 20025296, 40102326, -44467276, -93363222, 121862202, 459340540, 499636034, 188179536, -75961682, -64851593, 32031951, 29093447, -14400897, -12666400, 5924072, 4818362, -2037563, -1458184, 522638, 299036, -76969, -24291},
+{-12139, -82211, 180788, 608545, -930307, -2464761, 3164236, 7330152, -8467624, -18063141, 19631121, 40339629, -43586762, -93851509, 119196690, 457387997, 501023622, 191016607, -74995101, -65653424, 31597243, 29447240, -14207380, -12824962, 5847549, 4882071, -2013022, -1479130, 517108, 303960, -76403, -24859},
+{-11740, -82109, 176348, 610021, -909492, -2474632, 3097112, 7366336, -8294057, -18162497, 19236244, 40569047, -42705031, -94321350, 116540823, 455415117, 502386600, 193857605, -74008941, -66450122, 31154776, 29798485, -14010293, -12982505, 5769467, 4945472, -1987894, -1500024, 511408, 308890, -75807, -25433},
+{-11347, -81987, 171936, 611358, -888734, -2483972, 3030025, 7401010, -8120340, -18258257, 18840735, 40790590, -41822226, -94772814, 113894803, 453422089, 503724834, 196702293, -73003184, -67241531, 30704573, 30147108, -13809646, -13138995, 5689826, 5008551, -1962180, -1520863, 505537, 313826, -75179, -26013},
+{-10962, -81844, 167553, 612557, -868036, -2492783, 2962985, 7434179, -7946504, -18350429, 18444660, 41004273, -40938492, -95205973, 111258827, 451409108, 505038191, 199550433, -71977819, -68027494, 30246657, 30493037, -13605448, -13294400, 5608630, 5071294, -1935880, -1541640, 499495, 318766, -74520, -26599},
+{-10584, -81682, 163200, 613619, -847400, -2501069, 2896005, 7465849, -7772577, -18439019, 18048087, 41210108, -40053968, -95620901, 108633094, 449376369, 506326542, 202401788, -70932833, -68807856, 29781052, 30836200, -13397712, -13448685, 5525880, 5133686, -1908991, -1562353, 493280, 323710, -73828, -27190},
+{-10212, -81501, 158878, 614546, -826832, -2508833, 2829095, 7496026, -7598591, -18524037, 17651084, 41408112, -39168796, -96017673, 106017801, 447324070, 507589759, 205256119, -69868218, -69582460, 29307787, 31176525, -13186448, -13601816, 5441579, 5195715, -1881515, -1582995, 486892, 328656, -73105, -27787},
+{-9847, -81301, 154587, 615340, -806333, -2516079, 2762267, 7524715, -7424574, -18605492, 17253717, 41598300, -38283116, -96396368, 103413140, 445252407, 508827718, 208113186, -68783968, -70351148, 28826887, 31513937, -12971669, -13753761, 5355731, 5257366, -1853451, -1603563, 480330, 333604, -72349, -28389},
+{-9489, -81082, 150328, 616001, -785908, -2522810, 2695532, 7551923, -7250557, -18683393, 16856053, 41780691, -37397069, -96757063, 100819305, 443161583, 510040297, 210972747, -67680076, -71113766, 28338382, 31848366, -12753389, -13904486, 5268339, 5318626, -1824798, -1624051, 473594, 338551, -71561, -28996},
+{-9138, -80845, 146100, 616531, -765559, -2529029, 2628901, 7577656, -7076568, -18757750, 16458159, 41955302, -36510791, -97099840, 98236486, 441051800, 511227374, 213834563, -66556542, -71870156, 27842303, 32179738, -12531620, -14053956, 5179406, 5379480, -1795557, -1644456, 466682, 343498, -70739, -29608},
+{-8793, -80590, 141905, 616933, -745289, -2534741, 2562385, 7601921, -6902637, -18828574, 16060099, 42122153, -35624422, -97424781, 95664874, 438923260, 512388834, 216698389, -65413365, -72620160, 27338681, 32507981, -12306378, -14202139, 5088936, 5439914, -1765728, -1664771, 459595, 348443, -69883, -30226},
+{-8456, -80318, 137744, 617206, -725102, -2539948, 2495995, 7624724, -6728793, -18895875, 15661939, 42281265, -34738097, -97731971, 93104654, 436776170, 513524561, 219563983, -64250547, -73363623, 26827549, 32833022, -12077676, -14349001, 4996935, 5499914, -1735310, -1684994, 452332, 353385, -68994, -30848},
+{-8125, -80029, 133615, 617353, -705000, -2544655, 2429741, 7646074, -6555063, -18959666, 15263745, 42432661, -33851954, -98021495, 90556013, 434610737, 514634442, 222431101, -63068093, -74100387, 26308942, 33154791, -11845532, -14494507, 4903405, 5559466, -1704305, -1705117, 444891, 358322, -68070, -31475},
+{-7801, -79724, 129522, 617375, -684987, -2548865, 2363634, 7665976, -6381477, -19019959, 14865582, 42576362, -32966128, -98293442, 88019134, 432427169, 515718368, 225299498, -61866009, -74830295, 25782895, 33473213, -11609961, -14638625, 4808353, 5618556, -1672712, -1725138, 437274, 363254, -67112, -32107},
+{-7483, -79402, 125462, 617274, -665065, -2552582, 2297685, 7684439, -6208063, -19076766, 14467512, 42712394, -32080753, -98547899, 85494199, 430225676, 516776231, 228168929, -60644303, -75553190, 25249447, 33788218, -11370980, -14781320, 4711783, 5677170, -1640532, -1745050, 429478, 368179, -66119, -32743},
+{-7173, -79064, 121438, 617051, -645238, -2555810, 2231904, 7701470, -6034849, -19130100, 14069602, 42840780, -31195962, -98784960, 82981390, 428006471, 517807927, 231039147, -59402988, -76268915, 24708634, 34099733, -11128607, -14922559, 4613701, 5735294, -1607766, -1764849, 421504, 373096, -65091, -33384},
+{-6869, -78711, 117449, 616707, -625508, -2558553, 2166302, 7717077, -5861863, -19179976, 13671913, 42961548, -30311889, -99004715, 80480883, 425769767, 518813353, 233909906, -58142076, -76977314, 24160498, 34407686, -10882861, -15062309, 4514112, 5792913, -1574415, -1784531, 413351, 378005, -64028, -34029},
+{-6571, -78343, 113496, 616245, -605878, -2560815, 2100887, 7731269, -5689132, -19226406, 13274509, 43074725, -29428665, -99207259, 77992856, 423515778, 519792409, 236780959, -56861584, -77678229, 23605080, 34712006, -10633760, -15200536, 4413023, 5850013, -1540478, -1804089, 405018, 382903, -62929, -34678},
+{-6280, -77960, 109579, 615666, -586351, -2562600, 2035672, 7744052, -5516683, -19269407, 12877452, 43180338, -28546421, -99392688, 75517483, 421244721, 520744999, 239652057, -55561528, -78371503, 23042422, 35012622, -10381324, -15337206, 4310441, 5906580, -1505958, -1823520, 396506, 387789, -61793, -35332},
+{-5996, -77563, 105699, 614970, -566929, -2563912, 1970664, 7755437, -5344544, -19308992, 12480806, 43278417, -27665286, -99561100, 73054937, 418956813, 521671027, 242522952, -54241930, -79056981, 22472568, 35309461, -10125574, -15472286, 4206371, 5962600, -1470856, -1842818, 387815, 392663, -60622, -35989},
+{-5719, -77151, 101856, 614161, -547615, -2564755, 1905875, 7765431, -5172741, -19345178, 12084631, 43368992, -26785391, -99712593, 70605389, 416652275, 522570402, 245393396, -52902812, -79734505, 21895564, 35602453, -9866531, -15605742, 4100821, 6018058, -1435171, -1861978, 378943, 397523, -59413, -36650},
+{-5447, -76726, 98050, 613239, -528412, -2565134, 1841313, 7774043, -5001302, -19377980, 11688989, 43452095, -25906862, -99847268, 68169007, 414331325, 523443035, 248263137, -51544198, -80403919, 21311456, 35891528, -9604216, -15737542, 3993798, 6072941, -1398907, -1880995, 369890, 402368, -58168, -37314},
+{-5183, -76288, 94282, 612206, -509322, -2565052, 1776989, 7781282, -4830252, -19407415, 11293941, 43527758, -25029827, -99965226, 65745959, 411994186, 524288838, 251131927, -50166117, -81065066, 20720294, 36176613, -9338652, -15867651, 3885309, 6127233, -1362064, -1899864, 360657, 407196, -56886, -37982},
+{-4924, -75837, 90553, 611064, -490349, -2564515, 1712912, 7787158, -4659618, -19433500, 10899547, 43596014, -24154411, -100066572, 63336410, 409641082, 525107729, 253999514, -48768596, -81717791, 20122125, 36457639, -9069862, -15996037, 3775364, 6180921, -1324644, -1918580, 351242, 412006, -55566, -38653},
+{-4673, -75374, 86861, 609814, -471493, -2563526, 1649091, 7791680, -4489425, -19456253, 10505867, 43656898, -23280741, -100151410, 60940523, 407272237, 525899625, 256865649, -47351668, -82361939, 19517002, 36734535, -8797870, -16122667, 3663969, 6233990, -1286649, -1937138, 341647, 416797, -54208, -39328},
+{-4427, -74898, 83208, 608458, -452758, -2562090, 1585536, 7794856, -4319699, -19475691, 10112961, 43710443, -22408939, -100219847, 58558458, 404887876, 526664447, 259730079, -45915367, -82997352, 18904977, 37007232, -8522701, -16247506, 3551134, 6286426, -1248080, -1955533, 331870, 421567, -52813, -40005},
+{-4188, -74411, 79595, 606996, -434146, -2560211, 1522255, 7796698, -4150466, -19491832, 9720888, 43756688, -21539129, -100271990, 56190375, 402488227, 527402120, 262592552, -44459729, -83623876, 18286103, 37275659, -8244379, -16370523, 3436867, 6338215, -1208940, -1973759, 321913, 426316, -51379, -40685},
+{-3955, -73912, 76021, 605432, -415659, -2557894, 1459257, 7797214, -3981750, -19504696, 9329706, 43795668, -20671432, -100307949, 53836432, 400073518, 528112571, 265452817, -42984793, -84241357, 17660435, 37539747, -7962930, -16491685, 3321178, 6389342, -1169230, -1991812, 311773, 431042, -49906, -41368},
+{-3728, -73402, 72486, 603766, -397300, -2555144, 1396552, 7796415, -3813577, -19514301, 8939472, 43827421, -19805970, -100327835, 51496783, 397643978, 528795728, 268310622, -41490600, -84849638, 17028031, 37799427, -7678382, -16610958, 3204076, 6439793, -1128952, -2009686, 301453, 435743, -48395, -42053},
+{-3507, -72881, 68991, 602001, -379071, -2551964, 1334147, 7794311, -3645971, -19520668, 8550245, 43851987, -18942862, -100331760, 49171580, 395199839, 529451524, 271165713, -39977193, -85448566, 16388947, 38054629, -7390760, -16728310, 3085571, 6489554, -1088110, -2027376, 290951, 440418, -46845, -42740},
+{-3293, -72350, 65536, 600137, -360974, -2548360, 1272052, 7790912, -3478956, -19523815, 8162082, 43869406, -18082228, -100319837, 46860977, 392741332, 530079893, 274017837, -38444617, -86037986, 15743243, 38305286, -7100094, -16843708, 2965672, 6538611, -1046704, -2044878, 280267, 445066, -45256, -43430},
+{-3085, -71809, 62121, 598176, -343011, -2544336, 1210275, 7786229, -3312557, -19523765, 7775039, 43879717, -17224184, -100292181, 44565120, 390268689, 530680773, 276866743, -36892921, -86617746, 15090979, 38551329, -6806411, -16957120, 2844392, 6586950, -1004739, -2062185, 269403, 449685, -43627, -44121},
+{-2882, -71258, 58747, 596120, -325184, -2539897, 1148825, 7780272, -3146797, -19520536, 7389171, 43882964, -16368847, -100248908, 42284157, 387782146, 531254104, 279712175, -35322155, -87187690, 14432218, 38792690, -6509741, -17068514, 2721739, 6634555, -962217, -2079292, 258358, 454274, -41959, -44814},
+{-2686, -70697, 55414, 593971, -307495, -2535048, 1087708, 7773052, -2981700, -19514152, 7004535, 43879187, -15516333, -100190136, 40018233, 385281936, 531799829, 282553881, -33732371, -87747668, 13767023, 39029301, -6210113, -17177857, 2597726, 6681413, -919140, -2096195, 247131, 458832, -40250, -45509},
+{-2495, -70128, 52122, 591730, -289946, -2529793, 1026935, 7764580, -2817289, -19504632, 6621185, 43868431, -14666756, -100115983, 37767491, 382768297, 532317894, 285391607, -32123624, -88297525, 13095459, 39261095, -5907560, -17285118, 2472364, 6727511, -875511, -2112889, 235724, 463357, -38502, -46205},
+{-2310, -69550, 48870, 589399, -272540, -2524137, 966512, 7754867, -2653587, -19492000, 6239176, 43850739, -13820230, -100026570, 35532070, 380241465, 532808247, 288225099, -30495972, -88837110, 12417591, 39488005, -5602110, -17390263, 2345664, 6772833, -831334, -2129367, 224137, 467848, -36714, -46902},
+{-2131, -68964, 45660, 586979, -255277, -2518086, 906447, 7743924, -2490617, -19476278, 5858560, 43826157, -12976866, -99922018, 33312111, 377701678, 533270838, 291054104, -28849474, -89366272, 11733487, 39709965, -5293797, -17493263, 2217638, 6817365, -786611, -2145624, 212369, 472303, -34884, -47600},
+{-1958, -68369, 42492, 584472, -238160, -2511643, 846748, 7731762, -2328400, -19457488, 5479392, 43794730, -12136775, -99802449, 31107748, 375149175, 533705623, 293878367, -27184191, -89884858, 11043216, 39926909, -4982654, -17594084, 2088300, 6861094, -741346, -2161656, 200422, 476721, -33015, -48298},
+{-1790, -67767, 39364, 581880, -221191, -2504815, 787422, 7718393, -2166960, -19435654, 5101725, 43756505, -11300067, -99667987, 28919116, 372584197, 534112557, 296697635, -25500189, -90392720, 10346848, 40138770, -4668712, -17692697, 1957660, 6904006, -695543, -2177457, 188295, 481100, -31104, -48997},
+{-1628, -67158, 36279, 579203, -204371, -2497605, 728478, 7703829, -2006318, -19410799, 4725609, 43711530, -10466850, -99518756, 26746347, 370006984, 534491600, 299511653, -23797533, -90889706, 9644454, 40345485, -4352007, -17789068, 1825734, 6946086, -649205, -2193022, 175990, 485440, -29153, -49697},
+{-1471, -66541, 33235, 576445, -187702, -2490019, 669922, 7688081, -1846495, -19382947, 4351097, 43659853, -9637233, -99354884, 24589571, 367417778, 534842715, 302320168, -22076292, -91375667, 8936108, 40546987, -4032573, -17883168, 1692533, 6987321, -602336, -2208345, 163506, 489737, -27161, -50396},
+{-1320, -65918, 30234, 573606, -171186, -2482061, 611761, 7671161, -1687514, -19352123, 3978240, 43601522, -8811321, -99176497, 22448916, 364816821, 535165865, 305122926, -20336537, -91850455, 8221883, 40743212, -3710445, -17974964, 1558071, 7027696, -554939, -2223422, 150844, 493992, -25127, -51095},
+{-1175, -65288, 27274, 570688, -154824, -2473738, 554002, 7653081, -1529394, -19318350, 3607088, 43536587, -7989219, -98983723, 20324507, 362204357, 535461020, 307919673, -18578343, -92313920, 7501856, 40934097, -3385660, -18064428, 1422363, 7067198, -507019, -2238247, 138004, 498202, -23052, -51794},
+{-1034, -64652, 24356, 567693, -138618, -2465053, 496653, 7633853, -1372157, -19281654, 3237690, 43465100, -7171031, -98776692, 18216468, 359580629, 535728150, 310710156, -16801784, -92765916, 6776102, 41119578, -3058253, -18151527, 1285422, 7105813, -458580, -2252814, 124988, 502366, -20935, -52492},
+{-899, -64011, 21481, 564622, -122568, -2456012, 439720, 7613489, -1215822, -19242060, 2870097, 43387110, -6356860, -98555535, 16124919, 356945884, 535967227, 313494121, -15006938, -93206295, 6044701, 41299592, -2728262, -18236232, 1147264, 7143528, -409625, -2267119, 111795, 506482, -18777, -53189},
+{-769, -63364, 18648, 561477, -106678, -2446620, 383209, 7592001, -1060411, -19199594, 2504356, 43302671, -5546807, -98320382, 14049980, 354300365, 536178228, 316271315, -13193887, -93634912, 5307731, 41474077, -2395725, -18318513, 1007902, 7180327, -360160, -2281157, 98427, 510549, -16577, -53885},
+{-645, -62711, 15857, 558259, -90948, -2436882, 327128, 7569403, -905943, -19154281, 2140516, 43211835, -4740972, -98071367, 11991768, 351644320, 536361132, 319041485, -11362713, -94051619, 4565275, 41642970, -2060681, -18398340, 867352, 7216199, -310189, -2294921, 84884, 514566, -14335, -54579},
+{-525, -62054, 13108, 554970, -75379, -2426803, 271482, 7545705, -752436, -19106147, 1778624, 43114655, -3939455, -97808624, 9950396, 348977995, 536515921, 321804378, -9513500, -94456273, 3817413, 41806211, -1723169, -18475682, 725630, 7251129, -259716, -2308406, 71167, 518531, -12051, -55272},
+{-410, -61392, 10402, 551612, -59973, -2416388, 216278, 7520922, -599911, -19055220, 1418727, 43011185, -3142352, -97532286, 7925977, 346301638, 536642579, 324559741, -7646337, -94848729, 3064230, 41963739, -1383228, -18550511, 582752, 7285104, -208746, -2321608, 57276, 522442, -9725, -55963},
+{-300, -60725, 7738, 548186, -44731, -2405643, 161522, 7495065, -448387, -19001525, 1060870, 42901480, -2349761, -97242490, 5918621, 343615497, 536741094, 327307323, -5761312, -95228844, 2305810, 42115492, -1040899, -18622798, 438733, 7318110, -157285, -2334522, 43214, 526298, -7357, -56652},
+{-196, -60055, 5116, 544695, -29654, -2394573, 107220, 7468148, -297881, -18945091, 705101, 42785596, -1561776, -96939371, 3928437, 340919821, 536811455, 330046871, -3858518, -95596476, 1542240, 42261412, -696223, -18692512, 293590, 7350134, -105336, -2347141, 28979, 530097, -4947, -57339},
+{-95, -59381, 2537, 541138, -14743, -2383182, 53377, 7440183, -148413, -18885944, 351462, 42663589, -778491, -96623069, 1955529, 338214859, 536853656, 332778134, -1938048, -95951481, 773607, 42401439, -349243, -18759627, 147340, 7381163, -52906, -2359461, 14574, 533838, -2495, -58023},
+{0, -58703, 0, 537518, 0, -2371476, 0, 7411183, 0, -18824112, 0, 42535515, 0, -96293720, 0, 335500861, 536867693, 335500861, 0, -96293720, 0, 42535515, 0, -18824112, 0, 7411183, 0, -2371476, 0, 537518, 0, -58703}
+};
+
+#endif
+
+// The first table is the default, the list ends with a NULL table
+const AUDIO_ASRC_TableTypeDef AUDIO_ASRC_Tables[] = {
+{0, 0, AUDIO_ASRC_Coef_Full},
+#if AUDIO_ASRC_OUT_FREQ == 48000
+{88200, 48000, AUDIO_ASRC_Coef_88k2_48k},
+{96000, 48000, AUDIO_ASRC_Coef_96k_48k},
+#endif
+{0, 0, NULL}
+};
@@ -0,0 +1,443 @@
+#include <string.h>
+#include "stm32f4xx.h"
+#include "audio_convert.h"
+
+// The simulator builds this file for the host, without the Cortex-M4 SIMD instructions
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define AUDIO_PKHBT(a, b, sh)    __PKHBT(a, b, sh)
+#else
+#define AUDIO_PKHBT(a, b, sh)    ((((uint32_t)(a)) & 0x0000FFFFUL) | (((uint32_t)(b) << (sh)) & 0xFFFF0000UL))
+#endif
+
+// left-aligned 24bit sample, the low byte is the 0x00 pad of the 32bit I2S channel frame
+#define AUDIO_24B_MASK           0xFFFFFF00UL
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define AUDIO_QADD(a, b)         __QADD(a, b)
+#else
+static inline int32_t AUDIO_QADD(int32_t a, int32_t b){
+	int64_t sum = (int64_t)a + b;
+	return sum > INT32_MAX ? INT32_MAX : (sum < INT32_MIN ? INT32_MIN : (int32_t)sum);
+	}
+#endif
+
+// kernel options, compile time constants
+#define AUDIO_CONVERT_GAIN       1
+#define AUDIO_CONVERT_DITHER     2
+
+
+// Q31 multiply of a left-aligned sample, compiles to SMULL without branches
+static inline int32_t AUDIO_Mul_Q31(int32_t sample, int32_t gain){
+	return (int32_t)((uint32_t)(((int64_t)sample * gain) >> 32) << 1);
+	}
+
+
+// TPDF dither : difference of two uniform 8bit values = triangular +/-1 LSB of the 24bit output,
+// plus 1/2 LSB so that the masking below rounds instead of truncating
+static inline int32_t AUDIO_Dither(uint32_t* seed){
+	uint32_t r = *seed * 1664525U + 1013904223U;
+	*seed = r;
+	return (int32_t)(r >> 24) - (int32_t)((r >> 16) & 0xFFU) + 0x80;
+	}
+
+
+static inline __attribute__((always_inline)) void AUDIO_Convert_Store(uint16_t* dst, uint32_t sample, int32_t gain, uint32_t* seed, const int mode){
+	if (mode & AUDIO_CONVERT_GAIN) {
+		int32_t s = AUDIO_Mul_Q31((int32_t)sample, gain);
+		if (mode & AUDIO_CONVERT_DITHER) {
+			s = AUDIO_QADD(s, AUDIO_Dither(seed));
+			}
+		sample = (uint32_t)s & AUDIO_24B_MASK;
+		}
+	// {hi:mid} in the low halfword, {lo:00} in the high halfword
+	__UNALIGNED_UINT32_WRITE(dst, __ROR(sample, 16U));
+	}
+
+
+/**
+ * @brief  Load one stereo sample, each channel left-aligned in a word with the low byte cleared
+ * @param  src_bytes: compile time constant, 6 for 24bit or 4 for 16bit USB samples
+ */
+static inline __attribute__((always_inline)) void AUDIO_Convert_Load(const uint8_t* src, uint32_t* l, uint32_t* r, const uint32_t src_bytes){
+	if (src_bytes == 4U) {
+		uint32_t w = __UNALIGNED_UINT32_READ(src);                       // R:L
+		*l = w << 16;                                                    // L:00:00
+		*r = w & 0xFFFF0000UL;                                           // R:00:00
+		}
+	else {
+		*l = ((uint32_t)src[0] << 8) | ((uint32_t)src[1] << 16) | ((uint32_t)src[2] << 24);
+		*r = ((uint32_t)src[3] << 8) | ((uint32_t)src[4] << 16) | ((uint32_t)src[5] << 24);
+		}
+	}
+
+
+/**
+ * @brief  Convert a contiguous run of stereo samples at a constant gain, the destination does not wrap
+ * @param  src: USB packet data
+ * @param  dst: I2S buffer
+ * @param  num_samples: stereo samples
+ * @param  gain: Q31 gain, only used with AUDIO_CONVERT_GAIN
+ * @param  seed: dither noise generator state, only used with AUDIO_CONVERT_DITHER
+ * @param  mode: compile time constant, 0 for the unity gain copy or AUDIO_CONVERT_xxx flags
+ * @param  src_bytes: compile time constant, 6 for 24bit or 4 for 16bit USB samples
+ */
+static inline __attribute__((always_inline)) void AUDIO_Convert_Run(const uint8_t* src, uint16_t* dst, uint32_t num_samples, int32_t gain, uint32_t* seed, const int mode, const uint32_t src_bytes){
+	uint32_t rnd = *seed;
+
+	if (src_bytes == 4U) {
+		// one word load per stereo sample
+		while (num_samples--) {
+			uint32_t l, r;
+			AUDIO_Convert_Load(src, &l, &r, 4U);
+			AUDIO_Convert_Store(dst,     l, gain, &rnd, mode);
+			AUDIO_Convert_Store(dst + 2, r, gain, &rnd, mode);
+			src += 4;
+			dst += 4;
+			}
+		*seed = rnd;
+		return;
+		}
+
+	uint32_t num_pairs = num_samples >> 1;
+	while (num_pairs--) {
+		// little-endian loads, MSbyte first : w0 = b3:b2:b1:b0, w1 = b7:b6:b5:b4, w2 = b11:b10:b9:b8
+		uint32_t w0 = __UNALIGNED_UINT32_READ(src);
+		uint32_t w1 = __UNALIGNED_UINT32_READ(src + 4);
+		uint32_t w2 = __UNALIGNED_UINT32_READ(src + 8);
+
+		uint32_t l0 = w0 << 8;                                             // b2:b1:b0:00
+		uint32_t r0 = AUDIO_PKHBT(w0 >> 16, w1, 16) & AUDIO_24B_MASK;      // b5:b4:b3:00
+		uint32_t l1 = ((w1 >> 16) << 8) | (w2 << 24);                      // b8:b7:b6:00
+		uint32_t r1 = w2 & AUDIO_24B_MASK;                                 // b11:b10:b9:00
+
+		AUDIO_Convert_Store(dst,     l0, gain, &rnd, mode);
+		AUDIO_Convert_Store(dst + 2, r0, gain, &rnd, mode);
+		AUDIO_Convert_Store(dst + 4, l1, gain, &rnd, mode);
+		AUDIO_Convert_Store(dst + 6, r1, gain, &rnd, mode);
+
+		src += 12;
+		dst += 8;
+		}
+
+	if (num_samples & 1U) {
+		uint32_t l, r;
+		AUDIO_Convert_Load(src, &l, &r, 6U);
+		AUDIO_Convert_Store(dst,     l, gain, &rnd, mode);
+		AUDIO_Convert_Store(dst + 2, r, gain, &rnd, mode);
+		}
+	*seed = rnd;
+	}
+
+
+/**
+ * @brief  Convert stereo samples while ramping the gain, one gain step per stereo sample.
+ *         Ramps only last a few ms, so the samples are simply converted one at a time.
+ * @param  num_samples: stereo samples, not more than vol->ramp_count
+ */
+static inline __attribute__((always_inline)) void AUDIO_Convert_Ramp(const uint8_t* src, uint16_t* dst, uint32_t num_samples, AUDIO_VOLUME_TypeDef* vol, const uint32_t src_bytes){
+	int32_t gain = vol->gain;
+	int32_t step = vol->step;
+	uint32_t seed = vol->seed;
+
+	while (num_samples--) {
+		uint32_t l, r;
+		gain += step;
+		AUDIO_Convert_Load(src, &l, &r, src_bytes);
+		if (vol->dither) {
+			AUDIO_Convert_Store(dst,     l, gain, &seed, AUDIO_CONVERT_GAIN | AUDIO_CONVERT_DITHER);
+			AUDIO_Convert_Store(dst + 2, r, gain, &seed, AUDIO_CONVERT_GAIN | AUDIO_CONVERT_DITHER);
+			}
+		else {
+			AUDIO_Convert_Store(dst,     l, gain, &seed, AUDIO_CONVERT_GAIN);
+			AUDIO_Convert_Store(dst + 2, r, gain, &seed, AUDIO_CONVERT_GAIN);
+			}
+		src += src_bytes;
+		dst += 4;
+		}
+	vol->gain = gain;
+	vol->seed = seed;
+	}
+
+
+/**
+ * @brief  Convert a contiguous run of stereo samples with the current volume, the destination does not wrap
+ */
+static inline __attribute__((always_inline)) void AUDIO_Convert_Block(const uint8_t* src, uint16_t* dst, uint32_t num_samples, AUDIO_VOLUME_TypeDef* vol, const uint32_t src_bytes){
+	if (vol->ramp_count) {
+		uint32_t n = vol->ramp_count < num_samples ? vol->ramp_count : num_samples;
+		AUDIO_Convert_Ramp(src, dst, n, vol, src_bytes);
+		vol->ramp_count -= n;
+		if (vol->ramp_count == 0U) {
+			// remove the rounding error of the step
+			vol->gain = vol->ramp_target;
+			vol->step = 0;
+			}
+		src += src_bytes*n;
+		dst += 4U*n;
+		num_samples -= n;
+		}
+	if (num_samples == 0U) {
+		return;
+		}
+	if (vol->gain == AUDIO_GAIN_UNITY) {
+		uint32_t seed = 0U;
+		AUDIO_Convert_Run(src, dst, num_samples, AUDIO_GAIN_UNITY, &seed, 0, src_bytes);
+		}
+	else
+	if (vol->dither && vol->gain != 0) {
+		AUDIO_Convert_Run(src, dst, num_samples, vol->gain, &vol->seed, AUDIO_CONVERT_GAIN | AUDIO_CONVERT_DITHER, src_bytes);
+		}
+	else {
+		// muted output stays digital silence
+		uint32_t seed = 0U;
+		AUDIO_Convert_Run(src, dst, num_samples, vol->gain, &seed, AUDIO_CONVERT_GAIN, src_bytes);
+		}
+	}
+
+
+static void AUDIO_Convert_Block24(const uint8_t* src, uint16_t* dst, uint32_t num_samples, AUDIO_VOLUME_TypeDef* vol){
+	AUDIO_Convert_Block(src, dst, num_samples, vol, 6U);
+	}
+
+static void AUDIO_Convert_Block16(const uint8_t* src, uint16_t* dst, uint32_t num_samples, AUDIO_VOLUME_TypeDef* vol){
+	AUDIO_Convert_Block(src, dst, num_samples, vol, 4U);
+	}
+
+
+/**
+ * @brief  Split the conversion at the end of the I2S circular buffer
+ */
+static inline __attribute__((always_inline)) uint32_t AUDIO_Convert_Ring(const uint8_t* src, uint32_t num_samples, uint16_t* buffer, uint32_t wr_ptr, uint32_t buffer_size, AUDIO_VOLUME_TypeDef* vol, const uint32_t src_bytes){
+	AUDIO_Volume_Update(vol);
+	while (num_samples) {
+		// samples up to the end of the buffer
+		uint32_t n = (buffer_size - wr_ptr)/4U;
+		if (n > num_samples) {
+			n = num_samples;
+			}
+		if (src_bytes == 4U) {
+			AUDIO_Convert_Block16(src, &buffer[wr_ptr], n, vol);
+			}
+		else {
+			AUDIO_Convert_Block24(src, &buffer[wr_ptr], n, vol);
+			}
+		src += src_bytes*n;
+		wr_ptr += 4U*n;
+		num_samples -= n;
+		// Rollover at end of buffer
+		if (wr_ptr >= buffer_size) {
+			wr_ptr = 0U;
+			}
+		}
+	return wr_ptr;
+	}
+
+
+/**
+ * @brief  Convert 24bit stereo USB samples and write them to the I2S circular buffer
+ * @param  src: USB packet data, 6 bytes per stereo sample
+ * @param  num_samples: stereo samples in the packet
+ * @param  buffer: I2S circular buffer
+ * @param  wr_ptr: write index in halfwords, multiple of 4
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ * @param  vol: volume control, a new volume/mute target starts a ramp
+ * @retval updated write index
+ */
+uint32_t AUDIO_Convert_24b(const uint8_t* src, uint32_t num_samples, uint16_t* buffer, uint32_t wr_ptr, uint32_t buffer_size, AUDIO_VOLUME_TypeDef* vol){
+	return AUDIO_Convert_Ring(src, num_samples, buffer, wr_ptr, buffer_size, vol, 6U);
+	}
+
+
+/**
+ * @brief  Convert 16bit stereo USB samples and write them to the I2S circular buffer.
+ *         The samples are left-aligned in the 24bit I2S frame, the low byte is zero unless the volume is dithered.
+ * @param  src: USB packet data, 4 bytes per stereo sample
+ * @see    AUDIO_Convert_24b()
+ */
+uint32_t AUDIO_Convert_16b(const uint8_t* src, uint32_t num_samples, uint16_t* buffer, uint32_t wr_ptr, uint32_t buffer_size, AUDIO_VOLUME_TypeDef* vol){
+	return AUDIO_Convert_Ring(src, num_samples, buffer, wr_ptr, buffer_size, vol, 4U);
+	}
+
+
+/**
+ * @brief  Fade out stereo samples already written to the I2S circular buffer, the gain decreases linearly
+ *         down to silence after the last sample. Used to conceal an underrun or an overrun.
+ * @param  buffer: I2S circular buffer
+ * @param  ptr: index of the first sample in halfwords, multiple of 4
+ * @param  num_samples: stereo samples
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ */
+void AUDIO_Convert_FadeOut(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size){
+	if (num_samples == 0U) {
+		return;
+		}
+	int32_t step = AUDIO_GAIN_UNITY / (int32_t)(num_samples + 1U);
+	int32_t gain = AUDIO_GAIN_UNITY;
+	while (num_samples--) {
+		gain -= step;
+		for (uint32_t ch = 0; ch < 4U; ch += 2U) {
+			uint32_t sample = __ROR(__UNALIGNED_UINT32_READ(&buffer[ptr + ch]), 16U);
+			AUDIO_Convert_Store(&buffer[ptr + ch], sample, gain, NULL, AUDIO_CONVERT_GAIN);
+			}
+		ptr += 4U;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+		}
+	}
+
+
+/**
+ * @brief  Write digital silence to the I2S circular buffer
+ * @param  ptr: index of the first sample in halfwords, multiple of 4
+ * @param  num_samples: stereo samples, not more than the buffer size
+ * @see    AUDIO_Convert_FadeOut()
+ */
+void AUDIO_Convert_Silence(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size){
+	uint32_t len = 4U*num_samples;
+	if (ptr + len > buffer_size) {
+		memset(buffer, 0, (ptr + len - buffer_size)*2U);
+		len = buffer_size - ptr;
+		}
+	memset(&buffer[ptr], 0, len*2U);
+	}
+
+
+/**
+ * @brief  Extend the I2S circular buffer by repeating the stereo samples one period back, used to synthesize
+ *         the samples of a lost USB packet. More samples than the period repeat the period again.
+ * @param  ptr: index of the first sample written in halfwords, multiple of 4
+ * @param  num_samples: stereo samples written
+ * @param  period: stereo samples repeated, the ones just before ptr
+ * @see    AUDIO_Convert_FadeOut()
+ */
+void AUDIO_Convert_Repeat(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t period, uint32_t buffer_size){
+	uint32_t src = (ptr + buffer_size - 4U*period) % buffer_size;
+	while (num_samples--) {
+		__UNALIGNED_UINT32_WRITE(&buffer[ptr], __UNALIGNED_UINT32_READ(&buffer[src]));
+		__UNALIGNED_UINT32_WRITE(&buffer[ptr + 2], __UNALIGNED_UINT32_READ(&buffer[src + 2]));
+		ptr += 4U;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+		src += 4U;
+		if (src >= buffer_size) {
+			src = 0U;
+			}
+		}
+	}
+
+
+/**
+ * @brief  Crossfade stereo samples of the I2S circular buffer with the samples one period back, the weights
+ *         change linearly over the crossfade. A crossfade can be applied in several calls.
+ * @param  ptr: index of the first sample in halfwords, multiple of 4
+ * @param  num_samples: stereo samples
+ * @param  period: distance to the samples mixed in, in stereo samples
+ * @param  pos: position of the first sample in the crossfade
+ * @param  len: crossfade length in stereo samples
+ * @param  fade_in: 1 = from the samples one period back to the samples in place, 0 = the other way round
+ * @see    AUDIO_Convert_FadeOut()
+ */
+void AUDIO_Convert_Crossfade(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t period, uint32_t pos, uint32_t len, uint8_t fade_in, uint32_t buffer_size){
+	uint32_t src = (ptr + buffer_size - 4U*period) % buffer_size;
+	int32_t step = AUDIO_GAIN_UNITY / (int32_t)(len + 1U);
+	int32_t gain = step * (int32_t)pos;
+	while (num_samples--) {
+		gain += step;
+		// gain of the samples in place
+		int32_t g = fade_in ? gain : AUDIO_GAIN_UNITY - gain;
+		for (uint32_t ch = 0; ch < 4U; ch += 2U) {
+			int32_t a = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&buffer[ptr + ch]), 16U);
+			int32_t b = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&buffer[src + ch]), 16U);
+			// the gains add up to unity, the sum cannot overflow
+			uint32_t sample = (uint32_t)(AUDIO_Mul_Q31(a, g) + AUDIO_Mul_Q31(b, AUDIO_GAIN_UNITY - g)) & AUDIO_24B_MASK;
+			__UNALIGNED_UINT32_WRITE(&buffer[ptr + ch], __ROR(sample, 16U));
+			}
+		ptr += 4U;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+		src += 4U;
+		if (src >= buffer_size) {
+			src = 0U;
+			}
+		}
+	}
+
+
+#ifdef DEBUG_CONVERT_BENCHMARK // see Makefile C_DEFS
+
+#define BENCHMARK_MAX_SAMPLES    97U
+
+typedef  union UN32_ {
+	uint8_t b[4];
+	int32_t s;
+} UN32;
+
+static uint8_t BenchSrc[6*BENCHMARK_MAX_SAMPLES] __attribute__((aligned(4)));
+static uint16_t BenchDst[4*BENCHMARK_MAX_SAMPLES] __attribute__((aligned(4)));
+
+// Byte by byte conversion loop replaced by AUDIO_Convert_24b(), kept as the benchmark reference
+static void __attribute__((noinline)) AUDIO_Convert_Reference(const uint8_t* src, uint16_t* dst, uint32_t num_samples, int32_t shift_3dB){
+	uint32_t ptr = 0U;
+	for (int i = 0; i < num_samples*2; i++) {
+		UN32 sample;
+		sample.b[0] = src[0]; // lsb
+		sample.b[1] = src[1];
+		sample.b[2] = src[2]; // msb
+		sample.b[3] = sample.b[2] & 0x80 ? 0xFF : 0x00; // sign extend to 32bits
+
+		int32_t shift_6dB = shift_3dB>>1;
+		if (shift_3dB & 1) {
+			shift_6dB++;
+			sample.s >>= shift_6dB;
+			sample.s += (sample.s>>1);
+			}
+		else {
+			sample.s >>= shift_6dB;
+			}
+
+		dst[ptr++] = (((uint16_t)sample.b[2]) << 8) | (uint16_t)sample.b[1];
+		dst[ptr++] = ((uint16_t)sample.b[0]) << 8;
+		src += 3;
+		}
+	}
+
+/**
+ * @brief  Measure the conversion of one USB packet with the DWT cycle counter
+ * @param  num_samples: stereo samples per packet, e.g. 48 for 48kHz
+ * @param  cycles_ref: reference byte by byte loop
+ * @param  cycles_unity: AUDIO_Convert_24b() at 0dB
+ * @param  cycles_gain: AUDIO_Convert_24b() at -3dB with dither
+ */
+void AUDIO_Convert_Benchmark(uint32_t num_samples, uint32_t* cycles_ref, uint32_t* cycles_unity, uint32_t* cycles_gain){
+	if (num_samples > BENCHMARK_MAX_SAMPLES) {
+		num_samples = BENCHMARK_MAX_SAMPLES;
+		}
+	for (int i = 0; i < sizeof(BenchSrc); i++) {
+		BenchSrc[i] = (uint8_t)(i*37 + 11);
+		}
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	uint32_t start = DWT->CYCCNT;
+	AUDIO_Convert_Reference(BenchSrc, BenchDst, num_samples, 0);
+	*cycles_ref = DWT->CYCCNT - start;
+
+	AUDIO_VOLUME_TypeDef vol;
+	AUDIO_Volume_Init(&vol, 0, 0);
+	start = DWT->CYCCNT;
+	AUDIO_Convert_24b(BenchSrc, num_samples, BenchDst, 0, 4U*BENCHMARK_MAX_SAMPLES, &vol);
+	*cycles_unity = DWT->CYCCNT - start;
+
+	AUDIO_Volume_Init(&vol, -0x0300, 0);
+	vol.dither = 1U;
+	start = DWT->CYCCNT;
+	AUDIO_Convert_24b(BenchSrc, num_samples, BenchDst, 0, 4U*BENCHMARK_MAX_SAMPLES, &vol);
+	*cycles_gain = DWT->CYCCNT - start;
+	}
+
+#endif
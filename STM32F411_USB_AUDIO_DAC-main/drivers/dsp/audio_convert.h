@@ -0,0 +1,46 @@
+#ifndef __AUDIO_CONVERT_H
+#define __AUDIO_CONVERT_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include "audio_volume.h"
+
+// Conversion of the USB 24bit or 16bit stereo stream into the I2S DMA transmit buffer.
+//
+// USB packet 24bit : L channel 3bytes + R channel 3bytes per stereo sample, LSbyte first
+// b0:lo_L, b1:mid_L, b2:hi_L, b3:lo_R, b4:mid_R, b5:hi_R
+// USB packet 16bit : L channel 2bytes + R channel 2bytes per stereo sample, LSbyte first
+// b0:mid_L, b1:hi_L, b2:mid_R, b3:hi_R
+//
+// I2S buffer : uint16_t array, left-aligned 24bits in 32bit frame, MSbyte first
+// {hi_L:mid_L}, {lo_L:0x00}, {hi_R:mid_R}, {lo_R:0x00}
+//
+// The kernel loads 3 words = 2 stereo samples at a time. Each channel is assembled left-aligned in a 32bit word
+// (hi:mid:lo:00) with shifts and PKHBT, which also takes care of the sign, and a 16bit rotate gives the
+// halfword-swapped layout expected by the I2S DMA, so a channel is written with a single word store.
+// The 16bit kernel loads 1 word = 1 stereo sample and only needs shifts.
+
+// The volume is applied with a Q31 multiply (SMULL) when it is not 0dB, with optional TPDF dither, see audio_volume.h
+
+// The underrun/overrun and packet loss concealment works in place on the samples already in the I2S buffer :
+// fade out, silence, repetition of the last period and crossfade with the samples one period back.
+
+uint32_t AUDIO_Convert_24b(const uint8_t* src, uint32_t num_samples, uint16_t* buffer, uint32_t wr_ptr, uint32_t buffer_size, AUDIO_VOLUME_TypeDef* vol);
+uint32_t AUDIO_Convert_16b(const uint8_t* src, uint32_t num_samples, uint16_t* buffer, uint32_t wr_ptr, uint32_t buffer_size, AUDIO_VOLUME_TypeDef* vol);
+void     AUDIO_Convert_FadeOut(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size);
+void     AUDIO_Convert_Silence(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size);
+void     AUDIO_Convert_Repeat(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t period, uint32_t buffer_size);
+void     AUDIO_Convert_Crossfade(uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t period, uint32_t pos, uint32_t len, uint8_t fade_in, uint32_t buffer_size);
+
+#ifdef DEBUG_CONVERT_BENCHMARK
+void AUDIO_Convert_Benchmark(uint32_t num_samples, uint32_t* cycles_ref, uint32_t* cycles_unity, uint32_t* cycles_gain);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
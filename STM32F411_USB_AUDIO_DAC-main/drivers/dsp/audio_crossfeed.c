@@ -0,0 +1,209 @@
+#include <math.h>
+#include "stm32f4xx.h"
+#include "audio_crossfeed.h"
+
+// Orders the coefficients before their publication, see AUDIO_Crossfeed_Design()
+#if defined(__arm__)
+#define AUDIO_CROSSFEED_BARRIER()   __DMB()
+#else
+#define AUDIO_CROSSFEED_BARRIER()   __sync_synchronize() // simulator host build
+#endif
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define AUDIO_CROSSFEED_QADD(a, b)  __QADD(a, b)
+#else
+static inline int32_t AUDIO_CROSSFEED_QADD(int32_t a, int32_t b){
+	int64_t sum = (int64_t)a + b;
+	return sum > INT32_MAX ? INT32_MAX : (sum < INT32_MIN ? INT32_MIN : (int32_t)sum);
+	}
+#endif
+
+#define AUDIO_CROSSFEED_PI          3.14159265f
+
+// left-aligned 24bit sample, the low byte is the 0x00 pad of the 32bit I2S channel frame
+#define AUDIO_CROSSFEED_24B_MASK    0xFFFFFF00UL
+
+// low pass cut frequency [Hz] and crossfeed level [0.1dB] of each level, see audio_crossfeed.h
+static const uint16_t AUDIO_CrossfeedLevels[AUDIO_CROSSFEED_LEVELS][2] = {
+	{  0U,  0U},
+	{650U, 95U},
+	{700U, 60U},
+	{700U, 45U},
+	};
+
+
+static int32_t AUDIO_Crossfeed_Q31(float x){
+	return (int32_t)(x*2147483648.0f + (x < 0.0f ? -0.5f : 0.5f));
+	}
+
+
+/**
+ * @brief  Compute the coefficients of the current level and sampling frequency into the set not used by the
+ *         processing, and publish them. Called by the OTG interrupt, the processing cannot preempt it.
+ */
+static void AUDIO_Crossfeed_Design(AUDIO_CROSSFEED_TypeDef* xf){
+	uint32_t b = xf->active ^ 1U;
+	AUDIO_CROSSFEED_CoefTypeDef* c = &xf->coef[b];
+
+	if (xf->level == AUDIO_CROSSFEED_OFF || xf->level >= AUDIO_CROSSFEED_LEVELS || xf->freq == 0U) {
+		c->on = 0U;
+		}
+	else {
+		float fc_lo = (float)AUDIO_CrossfeedLevels[xf->level][0];
+		float feed = (float)AUDIO_CrossfeedLevels[xf->level][1]/10.0f;
+		// bs2b : gains of the cross low pass and of the direct high shelf, in dB, and the shelf frequency
+		float gb_lo = feed*-5.0f/6.0f - 3.0f;
+		float gb_hi = feed/6.0f - 3.0f;
+		float g_lo = powf(10.0f, gb_lo/20.0f);
+		float g_hi = 1.0f - powf(10.0f, gb_hi/20.0f);
+		float fc_hi = fc_lo*powf(2.0f, (gb_lo - 20.0f*log10f(g_hi))/12.0f);
+		float gain = 1.0f/(1.0f - g_hi + g_lo);
+
+		float x = expf(-2.0f*AUDIO_CROSSFEED_PI*fc_lo/(float)xf->freq);
+		c->b1_lo = AUDIO_Crossfeed_Q31(x);
+		c->a0_lo = AUDIO_Crossfeed_Q31(g_lo*(1.0f - x)*gain);
+		x = expf(-2.0f*AUDIO_CROSSFEED_PI*fc_hi/(float)xf->freq);
+		c->b1_hi = AUDIO_Crossfeed_Q31(x);
+		c->a0_hi = AUDIO_Crossfeed_Q31((1.0f - g_hi*(1.0f - x))*gain);
+		c->a1_hi = AUDIO_Crossfeed_Q31(-x*gain);
+		c->on = 1U;
+		}
+
+	xf->next = b;
+	// the coefficients are complete before they are published
+	AUDIO_CROSSFEED_BARRIER();
+	xf->seq++;
+	}
+
+
+/**
+ * @brief  Clear the filter state. Called by the processing, e.g. when the stream is flushed.
+ */
+void AUDIO_Crossfeed_Reset(AUDIO_CROSSFEED_TypeDef* xf){
+	for (uint32_t ch = 0; ch < 2U; ch++) {
+		xf->lo[ch] = 0;
+		xf->hi[ch] = 0;
+		xf->prev[ch] = 0;
+		}
+	}
+
+
+/**
+ * @brief  Set the level and compute the coefficients. Call before the processing is started.
+ * @param  level: AUDIO_CROSSFEED_LevelTypeDef
+ * @param  freq: sampling frequency [Hz]
+ */
+void AUDIO_Crossfeed_Init(AUDIO_CROSSFEED_TypeDef* xf, uint32_t level, uint32_t freq){
+	xf->level = level < AUDIO_CROSSFEED_LEVELS ? level : AUDIO_CROSSFEED_OFF;
+	xf->freq = freq;
+	xf->coef[0].on = 0U;
+	xf->coef[1].on = 0U;
+	xf->next = 0U;
+	xf->seq = 0U;
+	xf->seq_seen = 0U;
+	xf->active = 0U;
+	AUDIO_Crossfeed_Reset(xf);
+	AUDIO_Crossfeed_Design(xf);
+	}
+
+
+/**
+ * @brief  Select the crossfeed level
+ * @param  level: AUDIO_CROSSFEED_LevelTypeDef
+ * @retval 0 if the level was set, 1 if it is out of range
+ */
+uint8_t AUDIO_Crossfeed_SetLevel(AUDIO_CROSSFEED_TypeDef* xf, uint32_t level){
+	if (level >= AUDIO_CROSSFEED_LEVELS) {
+		return 1U;
+		}
+	xf->level = level;
+	AUDIO_Crossfeed_Design(xf);
+	return 0U;
+	}
+
+
+/**
+ * @brief  Recompute the coefficients for a new sampling frequency
+ * @param  freq: sampling frequency [Hz]
+ */
+void AUDIO_Crossfeed_SetFrequency(AUDIO_CROSSFEED_TypeDef* xf, uint32_t freq){
+	xf->freq = freq;
+	AUDIO_Crossfeed_Design(xf);
+	}
+
+
+/**
+ * @brief  Crossfeed a contiguous run of stereo samples, the destination does not wrap
+ * @param  dst: I2S buffer
+ * @param  num_samples: stereo samples
+ */
+static void AUDIO_Crossfeed_Run(AUDIO_CROSSFEED_TypeDef* xf, const AUDIO_CROSSFEED_CoefTypeDef* c, uint16_t* dst, uint32_t num_samples){
+	int32_t a0_lo = c->a0_lo, b1_lo = c->b1_lo;
+	int32_t a0_hi = c->a0_hi, a1_hi = c->a1_hi, b1_hi = c->b1_hi;
+	int32_t lo_l = xf->lo[0], lo_r = xf->lo[1];
+	int32_t hi_l = xf->hi[0], hi_r = xf->hi[1];
+	int32_t prev_l = xf->prev[0], prev_r = xf->prev[1];
+
+	while (num_samples--) {
+		int32_t l = (int32_t)__ROR(__UNALIGNED_UINT32_READ(dst), 16U);
+		int32_t r = (int32_t)__ROR(__UNALIGNED_UINT32_READ(dst + 2), 16U);
+		// SMULL + SMLAL, the gains are below unity so the states do not overflow
+		lo_l = (int32_t)(((int64_t)a0_lo*l + (int64_t)b1_lo*lo_l) >> 31);
+		lo_r = (int32_t)(((int64_t)a0_lo*r + (int64_t)b1_lo*lo_r) >> 31);
+		hi_l = (int32_t)(((int64_t)a0_hi*l + (int64_t)a1_hi*prev_l + (int64_t)b1_hi*hi_l) >> 31);
+		hi_r = (int32_t)(((int64_t)a0_hi*r + (int64_t)a1_hi*prev_r + (int64_t)b1_hi*hi_r) >> 31);
+		prev_l = l;
+		prev_r = r;
+		// rounded to 24bit
+		uint32_t out_l = (uint32_t)AUDIO_CROSSFEED_QADD(AUDIO_CROSSFEED_QADD(hi_l, lo_r), 0x80) & AUDIO_CROSSFEED_24B_MASK;
+		uint32_t out_r = (uint32_t)AUDIO_CROSSFEED_QADD(AUDIO_CROSSFEED_QADD(hi_r, lo_l), 0x80) & AUDIO_CROSSFEED_24B_MASK;
+		__UNALIGNED_UINT32_WRITE(dst, __ROR(out_l, 16U));
+		__UNALIGNED_UINT32_WRITE(dst + 2, __ROR(out_r, 16U));
+		dst += 4;
+		}
+
+	xf->lo[0] = lo_l;
+	xf->lo[1] = lo_r;
+	xf->hi[0] = hi_l;
+	xf->hi[1] = hi_r;
+	xf->prev[0] = prev_l;
+	xf->prev[1] = prev_r;
+	}
+
+
+/**
+ * @brief  Crossfeed stereo samples already written to the I2S circular buffer, in place
+ * @param  buffer: I2S circular buffer
+ * @param  ptr: index of the first sample in halfwords, multiple of 4
+ * @param  num_samples: stereo samples
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ */
+void AUDIO_Crossfeed_Process(AUDIO_CROSSFEED_TypeDef* xf, uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size){
+	uint32_t seq = xf->seq;
+	if (seq != xf->seq_seen) {
+		uint32_t next = xf->next;
+		// from off, start from a cleared state
+		if (!xf->coef[xf->active].on) {
+			AUDIO_Crossfeed_Reset(xf);
+			}
+		xf->active = next;
+		xf->seq_seen = seq;
+		}
+	const AUDIO_CROSSFEED_CoefTypeDef* c = &xf->coef[xf->active];
+	if (!c->on) {
+		return;
+		}
+	while (num_samples) {
+		// samples up to the end of the buffer
+		uint32_t n = (buffer_size - ptr)/4U;
+		if (n > num_samples) {
+			n = num_samples;
+			}
+		AUDIO_Crossfeed_Run(xf, c, &buffer[ptr], n);
+		ptr += 4U*n;
+		num_samples -= n;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+		}
+	}
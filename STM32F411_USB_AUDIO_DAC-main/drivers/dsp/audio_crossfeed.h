@@ -0,0 +1,62 @@
+#ifndef __AUDIO_CROSSFEED_H
+#define __AUDIO_CROSSFEED_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Headphone crossfeed (USE_AUDIO_CROSSFEED, see Makefile C_DEFS), after B. Bauer's stereophonic-to-binaural
+// network as implemented by bs2b : each output is its own channel through a first order high shelf, plus the
+// opposite channel through a first order low pass. The low pass also delays the crossfed channel by its group delay,
+// ~0.23ms at 700Hz, close to the interaural delay of a head, so no delay line is needed.
+// The gain is normalized so that a mono signal keeps its level at low frequencies.
+//
+// The filters run in Q31 fixed point with 64bit accumulators (SMULL/SMLAL), in place on the samples just converted
+// into the I2S buffer, see USBD_AUDIO_Process(). About 10 multiplies per stereo sample.
+// The coefficients are computed in float when the level or the sampling frequency changes, into the set not in use,
+// and the processing switches to them at the start of the next block, like the EQ (see audio_eq.h).
+
+typedef enum {
+	AUDIO_CROSSFEED_OFF = 0,
+	AUDIO_CROSSFEED_LOW,        // 650Hz, 9.5dB, J. Meier
+	AUDIO_CROSSFEED_MEDIUM,     // 700Hz, 6.0dB, C. Moy
+	AUDIO_CROSSFEED_HIGH,       // 700Hz, 4.5dB, bs2b default
+	AUDIO_CROSSFEED_LEVELS,
+	} AUDIO_CROSSFEED_LevelTypeDef;
+
+#ifndef AUDIO_CROSSFEED_DEFAULT
+#define AUDIO_CROSSFEED_DEFAULT     AUDIO_CROSSFEED_MEDIUM
+#endif
+
+typedef struct {
+	uint32_t on;                // 0 = the samples are not processed
+	int32_t  a0_lo, b1_lo;      // Q31 cross path low pass, gain normalization included
+	int32_t  a0_hi, a1_hi, b1_hi; // Q31 direct path high shelf, gain normalization included
+	} AUDIO_CROSSFEED_CoefTypeDef;
+
+typedef struct {
+	uint32_t level;             // AUDIO_CROSSFEED_LevelTypeDef, written by the OTG interrupt
+	uint32_t freq;              // sampling frequency of the coefficients
+	AUDIO_CROSSFEED_CoefTypeDef coef[2];
+	volatile uint32_t next;     // coefficients computed last
+	volatile uint32_t seq;      // incremented by the OTG interrupt when coef[next] is ready
+	uint32_t seq_seen;          // processing copy of seq
+	uint32_t active;            // coefficients used by the processing
+	int32_t  lo[2];             // low pass output, left and right
+	int32_t  hi[2];             // high shelf output
+	int32_t  prev[2];           // previous input sample
+	} AUDIO_CROSSFEED_TypeDef;
+
+void    AUDIO_Crossfeed_Init(AUDIO_CROSSFEED_TypeDef* xf, uint32_t level, uint32_t freq);
+uint8_t AUDIO_Crossfeed_SetLevel(AUDIO_CROSSFEED_TypeDef* xf, uint32_t level);
+void    AUDIO_Crossfeed_SetFrequency(AUDIO_CROSSFEED_TypeDef* xf, uint32_t freq);
+void    AUDIO_Crossfeed_Reset(AUDIO_CROSSFEED_TypeDef* xf);
+void    AUDIO_Crossfeed_Process(AUDIO_CROSSFEED_TypeDef* xf, uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
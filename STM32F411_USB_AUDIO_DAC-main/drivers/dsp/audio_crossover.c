@@ -0,0 +1,209 @@
+#include <math.h>
+#include <string.h>
+#include "stm32f4xx.h"
+#include "audio_crossover.h"
+
+#define AUDIO_CROSSOVER_PI          3.14159265f
+
+// Orders the coefficients before their publication, see AUDIO_Crossover_Design()
+#if defined(__arm__)
+#define AUDIO_CROSSOVER_BARRIER()   __DMB()
+#else
+#define AUDIO_CROSSOVER_BARRIER()   __sync_synchronize() // simulator host build
+#endif
+
+// the crossover frequency is kept below the Nyquist frequency, where the bilinear transform warps too much
+#define AUDIO_CROSSOVER_FREQ_LIMIT  0.45f
+
+// largest left-aligned 24bit sample before the rounding, converted from float without overflow
+#define AUDIO_CROSSOVER_SAMPLE_MAX  2147483136.0f
+#define AUDIO_CROSSOVER_SAMPLE_MIN  (-2147483648.0f)
+
+
+/**
+ * @brief  Design the low and high pass sections of the current crossover and sampling frequency into the set not
+ *         used by the processing, and publish it. Called by the OTG interrupt, the processing cannot preempt it.
+ */
+static void AUDIO_Crossover_Design(AUDIO_CROSSOVER_TypeDef* xo){
+	uint32_t b = xo->active ^ 1U;
+	AUDIO_CROSSOVER_CoefTypeDef* c = &xo->coef[b];
+
+	if (xo->cutoff == 0U || xo->freq == 0U) {
+		c->on = 0U;
+		}
+	else {
+		float f0 = (float)xo->cutoff;
+		if (f0 > AUDIO_CROSSOVER_FREQ_LIMIT*(float)xo->freq) {
+			f0 = AUDIO_CROSSOVER_FREQ_LIMIT*(float)xo->freq;
+			}
+		// RBJ Butterworth low and high pass, Q = 1/sqrt(2)
+		float w0 = 2.0f*AUDIO_CROSSOVER_PI*f0/(float)xo->freq;
+		float s = sinf(w0/2.0f);
+		float cw = 1.0f - 2.0f*s*s;
+		float alpha = sinf(w0)*0.70710678f;
+		float a0 = 1.0f + alpha;
+		c->a1 = -2.0f*cw/a0;
+		c->a2 = (1.0f - alpha)/a0;
+		// The numerators are derived from the rounded denominator, for an exact unity gain of the low pass at DC
+		// and of the high pass at the Nyquist frequency : 1 - cos(w0) is lost to the rounding at low frequencies.
+		c->b0_lo = (1.0f + c->a1 + c->a2)/4.0f;
+		c->b1_lo = 2.0f*c->b0_lo;
+		c->b0_hi = (1.0f - c->a1 + c->a2)/4.0f;
+		c->b1_hi = -2.0f*c->b0_hi;
+		c->on = 1U;
+		}
+
+	xo->next = b;
+	// the coefficients are complete before they are published
+	AUDIO_CROSSOVER_BARRIER();
+	xo->seq++;
+	}
+
+
+/**
+ * @brief  Clear the filter state. Called by the processing, e.g. when the playback starts.
+ */
+void AUDIO_Crossover_Reset(AUDIO_CROSSOVER_TypeDef* xo){
+	memset(xo->state, 0, sizeof(xo->state));
+	}
+
+
+/**
+ * @brief  Set the crossover frequency and design the filters. Call before the processing is started.
+ * @param  cutoff: crossover frequency [Hz], 0 for a bypass
+ * @param  freq: sampling frequency [Hz]
+ */
+void AUDIO_Crossover_Init(AUDIO_CROSSOVER_TypeDef* xo, uint32_t cutoff, uint32_t freq){
+	xo->cutoff = (cutoff >= AUDIO_CROSSOVER_FREQ_MIN && cutoff <= AUDIO_CROSSOVER_FREQ_MAX) ? cutoff : 0U;
+	xo->freq = freq;
+	xo->coef[0].on = 0U;
+	xo->coef[1].on = 0U;
+	xo->next = 0U;
+	xo->seq = 0U;
+	xo->seq_seen = 0U;
+	xo->active = 0U;
+	AUDIO_Crossover_Reset(xo);
+	AUDIO_Crossover_Design(xo);
+	}
+
+
+/**
+ * @brief  Select the crossover frequency
+ * @param  cutoff: crossover frequency [Hz], 0 for a bypass
+ * @retval 0 if the frequency was set, 1 if it is out of range
+ */
+uint8_t AUDIO_Crossover_SetCutoff(AUDIO_CROSSOVER_TypeDef* xo, uint32_t cutoff){
+	if (cutoff != 0U && (cutoff < AUDIO_CROSSOVER_FREQ_MIN || cutoff > AUDIO_CROSSOVER_FREQ_MAX)) {
+		return 1U;
+		}
+	xo->cutoff = cutoff;
+	AUDIO_Crossover_Design(xo);
+	return 0U;
+	}
+
+
+/**
+ * @brief  Redesign the filters for a new sampling frequency
+ * @param  freq: sampling frequency [Hz], the I2S rate
+ */
+void AUDIO_Crossover_SetFrequency(AUDIO_CROSSOVER_TypeDef* xo, uint32_t freq){
+	xo->freq = freq;
+	AUDIO_Crossover_Design(xo);
+	}
+
+
+/**
+ * @brief  One biquad over a block, in place, so that the coefficients and the state stay in FPU registers
+ * @param  b0: numerator b0 = b2
+ * @param  z: state of the section, [channel][z1, z2]
+ */
+static void AUDIO_Crossover_Section(float (*x)[2], uint32_t num_samples, float b0, float b1, float a1, float a2, float (*z)[2]){
+	float zl1 = z[0][0], zl2 = z[0][1];
+	float zr1 = z[1][0], zr2 = z[1][1];
+	for (uint32_t n = 0; n < num_samples; n++) {
+		float xl = x[n][0];
+		float xr = x[n][1];
+		float yl = b0*xl + zl1;
+		float yr = b0*xr + zr1;
+		zl1 = b1*xl - a1*yl + zl2;
+		zr1 = b1*xr - a1*yr + zr2;
+		zl2 = b0*xl - a2*yl;
+		zr2 = b0*xr - a2*yr;
+		x[n][0] = yl;
+		x[n][1] = yr;
+		}
+	z[0][0] = zl1;
+	z[0][1] = zl2;
+	z[1][0] = zr1;
+	z[1][1] = zr2;
+	}
+
+
+/**
+ * @brief  Write a block to an I2S buffer, clamped and rounded to 24bit
+ */
+static void AUDIO_Crossover_Write(const float (*x)[2], uint16_t* dst, uint32_t num_samples){
+	for (uint32_t n = 0; n < num_samples; n++) {
+		for (uint32_t ch = 0; ch < 2U; ch++) {
+			float y = x[n][ch];
+			y = y > AUDIO_CROSSOVER_SAMPLE_MAX ? AUDIO_CROSSOVER_SAMPLE_MAX : (y < AUDIO_CROSSOVER_SAMPLE_MIN ? AUDIO_CROSSOVER_SAMPLE_MIN : y);
+			// the low byte is the 0x00 pad of the I2S channel frame
+			uint32_t sample = ((uint32_t)(int32_t)y + 0x80U) & 0xFFFFFF00UL;
+			__UNALIGNED_UINT32_WRITE(&dst[4U*n + 2U*ch], __ROR(sample, 16U));
+			}
+		}
+	}
+
+
+/**
+ * @brief  Split a block of stereo samples
+ * @param  num_samples: stereo samples, not more than AUDIO_CROSSOVER_BLOCK_SAMPLES
+ */
+static void AUDIO_Crossover_Run(AUDIO_CROSSOVER_TypeDef* xo, const AUDIO_CROSSOVER_CoefTypeDef* c, uint16_t* low, uint16_t* high, uint32_t num_samples){
+	// only used by the I2S DMA interrupt, which does not reenter
+	static float x_lo[AUDIO_CROSSOVER_BLOCK_SAMPLES][2];
+	static float x_hi[AUDIO_CROSSOVER_BLOCK_SAMPLES][2];
+
+	for (uint32_t n = 0; n < num_samples; n++) {
+		x_lo[n][0] = x_hi[n][0] = (float)(int32_t)__ROR(__UNALIGNED_UINT32_READ(&low[4U*n]), 16U);
+		x_lo[n][1] = x_hi[n][1] = (float)(int32_t)__ROR(__UNALIGNED_UINT32_READ(&low[4U*n + 2U]), 16U);
+		}
+	for (uint32_t i = 0; i < 2U; i++) {
+		AUDIO_Crossover_Section(x_lo, num_samples, c->b0_lo, c->b1_lo, c->a1, c->a2, xo->state[0][i]);
+		AUDIO_Crossover_Section(x_hi, num_samples, c->b0_hi, c->b1_hi, c->a1, c->a2, xo->state[1][i]);
+		}
+	AUDIO_Crossover_Write((const float (*)[2])x_lo, low, num_samples);
+	AUDIO_Crossover_Write((const float (*)[2])x_hi, high, num_samples);
+	}
+
+
+/**
+ * @brief  Split a period buffer into the woofer and tweeter outputs
+ * @param  low: I2S period buffer, the full range input, overwritten with the low pass output
+ * @param  high: I2S period buffer of the second output, set to the high pass output
+ * @param  num_samples: stereo samples
+ */
+void AUDIO_Crossover_Process(AUDIO_CROSSOVER_TypeDef* xo, uint16_t* low, uint16_t* high, uint32_t num_samples){
+	uint32_t seq = xo->seq;
+	if (seq != xo->seq_seen) {
+		uint32_t next = xo->next;
+		// from the bypass, start from a cleared state
+		if (!xo->coef[xo->active].on) {
+			AUDIO_Crossover_Reset(xo);
+			}
+		xo->active = next;
+		xo->seq_seen = seq;
+		}
+	const AUDIO_CROSSOVER_CoefTypeDef* c = &xo->coef[xo->active];
+	if (!c->on) {
+		memcpy(high, low, num_samples*4U*sizeof(uint16_t));
+		return;
+		}
+	while (num_samples) {
+		uint32_t n = num_samples > AUDIO_CROSSOVER_BLOCK_SAMPLES ? AUDIO_CROSSOVER_BLOCK_SAMPLES : num_samples;
+		AUDIO_Crossover_Run(xo, c, low, high, n);
+		low += 4U*n;
+		high += 4U*n;
+		num_samples -= n;
+		}
+	}
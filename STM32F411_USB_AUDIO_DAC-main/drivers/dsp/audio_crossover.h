@@ -0,0 +1,68 @@
+#ifndef __AUDIO_CROSSOVER_H
+#define __AUDIO_CROSSOVER_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Two-way active crossover (USE_AUDIO_CROSSOVER, see Makefile C_DEFS) : the stereo stream is split into a woofer
+// pair played on I2S2 and a tweeter pair played on I2S3, so one board drives both DACs of an active speaker pair,
+// see the second output in bsp_audio.h.
+//
+// Linkwitz-Riley 4th order : each output is two cascaded 2nd order Butterworth sections (Q 0.707) at the crossover
+// frequency, low pass for the woofers and high pass for the tweeters. Both outputs are -6dB at the crossover
+// frequency and in phase, their sum is an allpass with a flat magnitude, so the tweeters are not inverted.
+// The low and high pass sections share their denominator.
+//
+// The filters run in single precision float on the M4 FPU, in the I2S DMA interrupt : each period buffer is split
+// once it has been copied (or resampled, or upsampled), the woofers in place and the tweeters into the period buffer
+// of the second output, see AUDIO_OUT_CopyPeriod() in usbd_audio.c. They run at the I2S rate, 8 biquads per stereo
+// sample, the cycles are the PROFILE_CROSSOVER point (USE_IRQ_PROFILE).
+// The coefficients are designed when the crossover or the sampling frequency changes, into the set not in use, and
+// the processing switches to them at the start of the next period, like the EQ (see audio_eq.h).
+// A crossover frequency of 0 is a bypass, both outputs play the full range stream.
+// The float state loses some precision far below the sampling frequency : with a 40Hz crossover at 96kHz the DC
+// gain of the low pass is -0.16dB, it is within 0.02dB from 80Hz.
+
+#ifndef AUDIO_CROSSOVER_FREQ_DEFAULT
+#define AUDIO_CROSSOVER_FREQ_DEFAULT    2000U
+#endif
+
+// Crossover frequency range [Hz], also limited to 0.45 x the sampling frequency
+#define AUDIO_CROSSOVER_FREQ_MIN        40U
+#define AUDIO_CROSSOVER_FREQ_MAX        20000U
+
+// stereo samples converted to float at a time
+#define AUDIO_CROSSOVER_BLOCK_SAMPLES   48U
+
+typedef struct {
+	uint32_t on;                // 0 = bypass
+	float b0_lo, b1_lo;         // low pass numerator, b2 = b0, a0 = 1
+	float b0_hi, b1_hi;         // high pass numerator, b2 = b0
+	float a1, a2;               // shared denominator
+	} AUDIO_CROSSOVER_CoefTypeDef;
+
+typedef struct {
+	uint32_t cutoff;            // crossover frequency [Hz], 0 = bypass, written by the OTG interrupt
+	uint32_t freq;              // sampling frequency of the coefficients
+	AUDIO_CROSSOVER_CoefTypeDef coef[2];
+	volatile uint32_t next;     // coefficients computed last
+	volatile uint32_t seq;      // incremented by the OTG interrupt when coef[next] is ready
+	uint32_t seq_seen;          // processing copy of seq
+	uint32_t active;            // coefficients used by the processing
+	float    state[2][2][2][2]; // [low, high][section][channel][z1, z2], transposed direct form II
+	} AUDIO_CROSSOVER_TypeDef;
+
+void    AUDIO_Crossover_Init(AUDIO_CROSSOVER_TypeDef* xo, uint32_t cutoff, uint32_t freq);
+uint8_t AUDIO_Crossover_SetCutoff(AUDIO_CROSSOVER_TypeDef* xo, uint32_t cutoff);
+void    AUDIO_Crossover_SetFrequency(AUDIO_CROSSOVER_TypeDef* xo, uint32_t freq);
+void    AUDIO_Crossover_Reset(AUDIO_CROSSOVER_TypeDef* xo);
+void    AUDIO_Crossover_Process(AUDIO_CROSSOVER_TypeDef* xo, uint16_t* low, uint16_t* high, uint32_t num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
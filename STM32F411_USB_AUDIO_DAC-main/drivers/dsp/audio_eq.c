@@ -0,0 +1,378 @@
+#include <math.h>
+#include <string.h>
+#include "stm32f4xx.h"
+#include "audio_eq.h"
+
+#define AUDIO_EQ_PI              3.14159265f
+
+// Orders the bank design before its publication, see AUDIO_EQ_Design()
+#if defined(__arm__)
+#define AUDIO_EQ_BARRIER()       __DMB()
+#else
+#define AUDIO_EQ_BARRIER()       __sync_synchronize() // simulator host build
+#endif
+
+// the corner frequencies are kept below the Nyquist frequency, where the bilinear transform warps too much
+#define AUDIO_EQ_FREQ_LIMIT      0.45f
+
+// log spaced frequencies from 20Hz where the peak gain of the cascade is looked for, in addition to the band frequencies
+#define AUDIO_EQ_PEAK_POINTS     24U
+#define AUDIO_EQ_PEAK_FMIN       20.0f
+
+// largest left-aligned 24bit sample before the rounding, converted from float without overflow
+#define AUDIO_EQ_SAMPLE_MAX      2147483136.0f
+#define AUDIO_EQ_SAMPLE_MIN      (-2147483648.0f)
+
+// Default bands, all flat, see audio_eq.h. The graphic EQ bands are UAC 1/3 octave bands 18, 22, 26, 30, 34 and 38.
+static const AUDIO_EQ_BandTypeDef AUDIO_EQ_DefaultBands[AUDIO_EQ_BANDS] = {
+	{AUDIO_EQ_LOW_SHELF,  0U,   100U, 181U, 0},  // Q 0.707
+	{AUDIO_EQ_PEAK,       0U,    63U, 267U, 0},  // Q 1.04 = 4/3 octave
+	{AUDIO_EQ_PEAK,       0U,   160U, 267U, 0},
+	{AUDIO_EQ_PEAK,       0U,   400U, 267U, 0},
+	{AUDIO_EQ_PEAK,       0U,  1000U, 267U, 0},
+	{AUDIO_EQ_PEAK,       0U,  2500U, 267U, 0},
+	{AUDIO_EQ_PEAK,       0U,  6300U, 267U, 0},
+	{AUDIO_EQ_HIGH_SHELF, 0U, 10000U, 181U, 0},
+	};
+
+
+/**
+ * @brief  Clear the filter state. Called by the processing, e.g. when the stream is flushed.
+ */
+void AUDIO_EQ_Reset(AUDIO_EQ_TypeDef* eq){
+	memset(eq->state, 0, sizeof(eq->state));
+	}
+
+
+/**
+ * @brief  Set the default bands, all flat, and design them. Call before the processing is started.
+ * @param  freq: sampling frequency [Hz]
+ */
+void AUDIO_EQ_Init(AUDIO_EQ_TypeDef* eq, uint32_t freq){
+	memcpy(eq->band, AUDIO_EQ_DefaultBands, sizeof(eq->band));
+	eq->freq = freq;
+	eq->bank[0].num = 0U;
+	eq->bank[0].mask = 0U;
+	eq->bank[1].num = 0U;
+	eq->bank[1].mask = 0U;
+	eq->next = 0U;
+	eq->seq = 0U;
+	eq->seq_seen = 0U;
+	eq->active = 0U;
+	eq->used = 0U;
+	eq->preamp = 0;
+	AUDIO_EQ_Reset(eq);
+	AUDIO_EQ_Design(eq);
+	}
+
+
+/**
+ * @brief  Redesign the bands for a new sampling frequency
+ * @param  freq: sampling frequency [Hz]
+ */
+void AUDIO_EQ_SetFrequency(AUDIO_EQ_TypeDef* eq, uint32_t freq){
+	eq->freq = freq;
+	AUDIO_EQ_Design(eq);
+	}
+
+
+/**
+ * @brief  Store a band definition, the gain is clamped to +/-AUDIO_EQ_GAIN_MAX. AUDIO_EQ_Design() applies it.
+ * @param  index: band 0 to AUDIO_EQ_BANDS-1
+ * @retval 0 if the band was stored, 1 if the index, type, frequency or Q is out of range
+ */
+uint8_t AUDIO_EQ_SetBand(AUDIO_EQ_TypeDef* eq, uint32_t index, const AUDIO_EQ_BandTypeDef* band){
+	if (index >= AUDIO_EQ_BANDS || band->type >= AUDIO_EQ_TYPE_NUM) {
+		return 1U;
+		}
+	if (band->type != AUDIO_EQ_OFF && (band->freq == 0U || band->q == 0U)) {
+		return 1U;
+		}
+	eq->band[index] = *band;
+	eq->band[index].reserved = 0U;
+	AUDIO_EQ_SetGain(eq, index, band->gain);
+	return 0U;
+	}
+
+
+/**
+ * @brief  Set the gain of a band, clamped to +/-AUDIO_EQ_GAIN_MAX. AUDIO_EQ_Design() applies it.
+ * @param  index: band 0 to AUDIO_EQ_BANDS-1
+ * @param  gain: 1/256 dB
+ */
+void AUDIO_EQ_SetGain(AUDIO_EQ_TypeDef* eq, uint32_t index, int16_t gain){
+	if (index >= AUDIO_EQ_BANDS) {
+		return;
+		}
+	if (gain > AUDIO_EQ_GAIN_MAX) {
+		gain = AUDIO_EQ_GAIN_MAX;
+		}
+	if (gain < -AUDIO_EQ_GAIN_MAX) {
+		gain = -AUDIO_EQ_GAIN_MAX;
+		}
+	eq->band[index].gain = gain;
+	}
+
+
+/**
+ * @brief  Gain of a band
+ * @param  index: band 0 to AUDIO_EQ_BANDS-1
+ * @retval 1/256 dB
+ */
+int16_t AUDIO_EQ_GetGain(AUDIO_EQ_TypeDef* eq, uint32_t index){
+	return index < AUDIO_EQ_BANDS ? eq->band[index].gain : 0;
+	}
+
+
+/**
+ * @brief  RBJ audio EQ cookbook biquad
+ * @param  band: band definition
+ * @param  freq: sampling frequency [Hz]
+ * @param  c: normalized coefficients
+ * @retval 0 if the band is flat and left out of the cascade
+ */
+static uint8_t AUDIO_EQ_DesignBand(const AUDIO_EQ_BandTypeDef* band, uint32_t freq, AUDIO_EQ_CoefTypeDef* c){
+	uint8_t shaped = band->type == AUDIO_EQ_PEAK || band->type == AUDIO_EQ_LOW_SHELF || band->type == AUDIO_EQ_HIGH_SHELF;
+	if (band->type == AUDIO_EQ_OFF || (shaped && band->gain == 0)) {
+		return 0U;
+		}
+	float f0 = (float)band->freq;
+	if (f0 > AUDIO_EQ_FREQ_LIMIT*(float)freq) {
+		f0 = AUDIO_EQ_FREQ_LIMIT*(float)freq;
+		}
+	float w0 = 2.0f*AUDIO_EQ_PI*f0/(float)freq;
+	float cw = cosf(w0);
+	float alpha = sinf(w0)/(2.0f*(float)band->q/256.0f);
+	float A = powf(10.0f, (float)band->gain/(256.0f*40.0f));
+	float sa = 2.0f*sqrtf(A)*alpha;
+	float b0, b1, b2, a0, a1, a2;
+
+	switch (band->type) {
+		case AUDIO_EQ_PEAK:
+			b0 = 1.0f + alpha*A;
+			b1 = -2.0f*cw;
+			b2 = 1.0f - alpha*A;
+			a0 = 1.0f + alpha/A;
+			a1 = -2.0f*cw;
+			a2 = 1.0f - alpha/A;
+			break;
+		case AUDIO_EQ_LOW_SHELF:
+			b0 = A*((A + 1.0f) - (A - 1.0f)*cw + sa);
+			b1 = 2.0f*A*((A - 1.0f) - (A + 1.0f)*cw);
+			b2 = A*((A + 1.0f) - (A - 1.0f)*cw - sa);
+			a0 = (A + 1.0f) + (A - 1.0f)*cw + sa;
+			a1 = -2.0f*((A - 1.0f) + (A + 1.0f)*cw);
+			a2 = (A + 1.0f) + (A - 1.0f)*cw - sa;
+			break;
+		case AUDIO_EQ_HIGH_SHELF:
+			b0 = A*((A + 1.0f) + (A - 1.0f)*cw + sa);
+			b1 = -2.0f*A*((A - 1.0f) + (A + 1.0f)*cw);
+			b2 = A*((A + 1.0f) + (A - 1.0f)*cw - sa);
+			a0 = (A + 1.0f) - (A - 1.0f)*cw + sa;
+			a1 = 2.0f*((A - 1.0f) - (A + 1.0f)*cw);
+			a2 = (A + 1.0f) - (A - 1.0f)*cw - sa;
+			break;
+		case AUDIO_EQ_LOW_PASS:
+			b0 = (1.0f - cw)/2.0f;
+			b1 = 1.0f - cw;
+			b2 = b0;
+			a0 = 1.0f + alpha;
+			a1 = -2.0f*cw;
+			a2 = 1.0f - alpha;
+			break;
+		default: // AUDIO_EQ_HIGH_PASS
+			b0 = (1.0f + cw)/2.0f;
+			b1 = -(1.0f + cw);
+			b2 = b0;
+			a0 = 1.0f + alpha;
+			a1 = -2.0f*cw;
+			a2 = 1.0f - alpha;
+			break;
+		}
+	c->b0 = b0/a0;
+	c->b1 = b1/a0;
+	c->b2 = b2/a0;
+	c->a1 = a1/a0;
+	c->a2 = a2/a0;
+	return 1U;
+	}
+
+
+/**
+ * @brief  Squared magnitude of the cascade at a frequency, in terms of phi = sin^2(w/2) which does not lose the
+ *         precision of the low frequencies to the cancellation of the cos(w) terms
+ * @param  w: normalized angular frequency
+ */
+static float AUDIO_EQ_Magnitude2(const AUDIO_EQ_BankTypeDef* bank, float w){
+	float s = sinf(w/2.0f);
+	float phi = s*s;
+	float m = 1.0f;
+	for (uint32_t i = 0; i < bank->num; i++) {
+		const AUDIO_EQ_CoefTypeDef* c = &bank->coef[i];
+		float bs = c->b0 + c->b1 + c->b2;
+		float as = 1.0f + c->a1 + c->a2;
+		float num = bs*bs - 4.0f*(c->b0*c->b1 + 4.0f*c->b0*c->b2 + c->b1*c->b2)*phi + 16.0f*c->b0*c->b2*phi*phi;
+		float den = as*as - 4.0f*(c->a1 + 4.0f*c->a2 + c->a1*c->a2)*phi + 16.0f*c->a2*phi*phi;
+		m *= num/den;
+		}
+	return m;
+	}
+
+
+/**
+ * @brief  Design the cascade of the current bands into the bank not used by the processing, and publish it.
+ *         Called by the OTG interrupt, the processing runs at a lower priority and cannot preempt the design.
+ *         The input attenuation is folded into the first section.
+ */
+void AUDIO_EQ_Design(AUDIO_EQ_TypeDef* eq){
+	uint32_t b = eq->active ^ 1U;
+	AUDIO_EQ_BankTypeDef* bank = &eq->bank[b];
+	uint32_t freq = eq->freq ? eq->freq : 48000U;
+	float wk = 2.0f*AUDIO_EQ_PI/(float)freq;
+
+	bank->num = 0U;
+	bank->mask = 0U;
+	for (uint32_t i = 0; i < AUDIO_EQ_BANDS; i++) {
+		if (AUDIO_EQ_DesignBand(&eq->band[i], freq, &bank->coef[bank->num])) {
+			bank->band[bank->num] = (uint8_t)i;
+			bank->mask |= 1U << i;
+			bank->num++;
+			}
+		}
+
+	// peak gain at the band frequencies and on a log grid up to the frequency limit
+	float peak = 1.0f;
+	if (bank->num) {
+		for (uint32_t i = 0; i < bank->num; i++) {
+			float f = (float)eq->band[bank->band[i]].freq;
+			if (f > AUDIO_EQ_FREQ_LIMIT*(float)freq) {
+				f = AUDIO_EQ_FREQ_LIMIT*(float)freq;
+				}
+			float m = AUDIO_EQ_Magnitude2(bank, wk*f);
+			peak = m > peak ? m : peak;
+			}
+		float ratio = powf(AUDIO_EQ_FREQ_LIMIT*(float)freq/AUDIO_EQ_PEAK_FMIN, 1.0f/(float)(AUDIO_EQ_PEAK_POINTS - 1U));
+		float f = AUDIO_EQ_PEAK_FMIN;
+		for (uint32_t i = 0; i < AUDIO_EQ_PEAK_POINTS; i++) {
+			float m = AUDIO_EQ_Magnitude2(bank, wk*f);
+			peak = m > peak ? m : peak;
+			f *= ratio;
+			}
+		}
+	if (peak > 1.0f) {
+		float g = 1.0f/sqrtf(peak);
+		bank->coef[0].b0 *= g;
+		bank->coef[0].b1 *= g;
+		bank->coef[0].b2 *= g;
+		}
+	eq->preamp = (int16_t)(-10.0f*log10f(peak)*256.0f);
+
+	eq->next = b;
+	// the bank is complete before it is published
+	AUDIO_EQ_BARRIER();
+	eq->seq++;
+	}
+
+
+/**
+ * @brief  Switch to the bank published last, the state of the bands not filtered so far is cleared
+ */
+static void AUDIO_EQ_Switch(AUDIO_EQ_TypeDef* eq){
+	uint32_t seq = eq->seq;
+	if (seq == eq->seq_seen) {
+		return;
+		}
+	uint32_t next = eq->next;
+	uint32_t mask = eq->bank[next].mask;
+	for (uint32_t i = 0; i < AUDIO_EQ_BANDS; i++) {
+		if ((mask & ~eq->used) & (1U << i)) {
+			memset(eq->state[i], 0, sizeof(eq->state[0]));
+			}
+		}
+	eq->used = mask;
+	eq->active = next;
+	eq->seq_seen = seq;
+	}
+
+
+/**
+ * @brief  Filter a contiguous run of stereo samples, one section at a time over the block so that the
+ *         coefficients and the state stay in FPU registers
+ * @param  dst: I2S buffer
+ * @param  num_samples: stereo samples, not more than AUDIO_EQ_BLOCK_SAMPLES
+ */
+static void AUDIO_EQ_Run(AUDIO_EQ_TypeDef* eq, const AUDIO_EQ_BankTypeDef* bank, uint16_t* dst, uint32_t num_samples){
+	// only used by USBD_AUDIO_Process(), which does not reenter
+	static float x[AUDIO_EQ_BLOCK_SAMPLES][2];
+
+	for (uint32_t n = 0; n < num_samples; n++) {
+		x[n][0] = (float)(int32_t)__ROR(__UNALIGNED_UINT32_READ(&dst[4U*n]), 16U);
+		x[n][1] = (float)(int32_t)__ROR(__UNALIGNED_UINT32_READ(&dst[4U*n + 2U]), 16U);
+		}
+
+	for (uint32_t i = 0; i < bank->num; i++) {
+		const AUDIO_EQ_CoefTypeDef* c = &bank->coef[i];
+		float b0 = c->b0, b1 = c->b1, b2 = c->b2, a1 = c->a1, a2 = c->a2;
+		float (*z)[2] = eq->state[bank->band[i]];
+		float zl1 = z[0][0], zl2 = z[0][1];
+		float zr1 = z[1][0], zr2 = z[1][1];
+		for (uint32_t n = 0; n < num_samples; n++) {
+			float xl = x[n][0];
+			float xr = x[n][1];
+			float yl = b0*xl + zl1;
+			float yr = b0*xr + zr1;
+			zl1 = b1*xl - a1*yl + zl2;
+			zr1 = b1*xr - a1*yr + zr2;
+			zl2 = b2*xl - a2*yl;
+			zr2 = b2*xr - a2*yr;
+			x[n][0] = yl;
+			x[n][1] = yr;
+			}
+		z[0][0] = zl1;
+		z[0][1] = zl2;
+		z[1][0] = zr1;
+		z[1][1] = zr2;
+		}
+
+	for (uint32_t n = 0; n < num_samples; n++) {
+		for (uint32_t ch = 0; ch < 2U; ch++) {
+			float y = x[n][ch];
+			y = y > AUDIO_EQ_SAMPLE_MAX ? AUDIO_EQ_SAMPLE_MAX : (y < AUDIO_EQ_SAMPLE_MIN ? AUDIO_EQ_SAMPLE_MIN : y);
+			// rounded to 24bit, the low byte is the 0x00 pad of the I2S channel frame
+			uint32_t sample = ((uint32_t)(int32_t)y + 0x80U) & 0xFFFFFF00UL;
+			__UNALIGNED_UINT32_WRITE(&dst[4U*n + 2U*ch], __ROR(sample, 16U));
+			}
+		}
+	}
+
+
+/**
+ * @brief  Equalize stereo samples already written to the I2S circular buffer, in place
+ * @param  buffer: I2S circular buffer
+ * @param  ptr: index of the first sample in halfwords, multiple of 4
+ * @param  num_samples: stereo samples
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ */
+void AUDIO_EQ_Process(AUDIO_EQ_TypeDef* eq, uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size){
+	AUDIO_EQ_Switch(eq);
+	const AUDIO_EQ_BankTypeDef* bank = &eq->bank[eq->active];
+	if (bank->num == 0U) {
+		return;
+		}
+	while (num_samples) {
+		// samples up to the end of the buffer
+		uint32_t n = (buffer_size - ptr)/4U;
+		if (n > num_samples) {
+			n = num_samples;
+			}
+		if (n > AUDIO_EQ_BLOCK_SAMPLES) {
+			n = AUDIO_EQ_BLOCK_SAMPLES;
+			}
+		AUDIO_EQ_Run(eq, bank, &buffer[ptr], n);
+		ptr += 4U*n;
+		num_samples -= n;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+		}
+	}
@@ -0,0 +1,96 @@
+#ifndef __AUDIO_EQ_H
+#define __AUDIO_EQ_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Parametric equalizer (USE_AUDIO_EQ, see Makefile C_DEFS) : a cascade of up to AUDIO_EQ_BANDS biquads per channel,
+// run in single precision float on the M4 FPU. The filters are applied in place to the samples just converted
+// into the I2S buffer, one USB packet at a time, see USBD_AUDIO_Process().
+//
+// The coefficients are designed (RBJ audio EQ cookbook) when a band or the sampling frequency changes, never in the
+// sample path. The OTG interrupt designs them into the bank not in use and publishes it, the processing switches to
+// it at the start of the next block, so a block is always filtered with a consistent set. The filter state is kept
+// across the switch, bands just enabled start from a cleared state.
+// Flat bands are left out of the cascade, the EQ costs nothing when all bands are flat. When the bands boost,
+// the input is attenuated by the peak gain of the cascade so that a full scale signal does not clip.
+//
+// Band layout, the UAC feature unit controls set the gain of the fixed bands :
+// 0 : bass, low shelf 100Hz
+// 1 to 6 : graphic EQ, peaking 63Hz 160Hz 400Hz 1kHz 2.5kHz 6.3kHz, 4/3 octave
+// 7 : treble, high shelf 10kHz
+// Any band can be redefined with AUDIO_VENDOR_REQ_EQ_BAND, e.g. for a headphone correction.
+// AUDIO_EQ_SetBand() and AUDIO_EQ_SetGain() only store the band, AUDIO_EQ_Design() publishes the new coefficients.
+
+#define AUDIO_EQ_BANDS              8U
+#define AUDIO_EQ_BAND_BASS          0U
+#define AUDIO_EQ_BAND_GRAPHIC       1U
+#define AUDIO_EQ_GRAPHIC_BANDS      6U
+#define AUDIO_EQ_BAND_TREBLE        7U
+
+// Gain limit of a band, 1/256 dB
+#define AUDIO_EQ_GAIN_MAX           (24*256)
+
+// stereo samples converted to float at a time
+#define AUDIO_EQ_BLOCK_SAMPLES      48U
+
+typedef enum {
+	AUDIO_EQ_OFF = 0,
+	AUDIO_EQ_PEAK,
+	AUDIO_EQ_LOW_SHELF,
+	AUDIO_EQ_HIGH_SHELF,
+	AUDIO_EQ_LOW_PASS,
+	AUDIO_EQ_HIGH_PASS,
+	AUDIO_EQ_TYPE_NUM,
+	} AUDIO_EQ_FilterTypeDef;
+
+// Band definition, also the 8 byte data stage of AUDIO_VENDOR_REQ_EQ_BAND, little endian
+typedef struct __attribute__((packed)) {
+	uint8_t  type;       // AUDIO_EQ_FilterTypeDef
+	uint8_t  reserved;
+	uint16_t freq;       // centre or corner frequency [Hz], limited to 0.45 x the sampling frequency
+	uint16_t q;          // quality factor, 1/256
+	int16_t  gain;       // 1/256 dB like the UAC volume, peaking and shelving filters only
+	} AUDIO_EQ_BandTypeDef;
+
+typedef struct {
+	float b0, b1, b2, a1, a2;  // normalized, a0 = 1
+	} AUDIO_EQ_CoefTypeDef;
+
+typedef struct {
+	uint32_t num;                              // sections in the cascade
+	uint32_t mask;                             // bit i set when band i is in the cascade
+	uint8_t  band[AUDIO_EQ_BANDS];             // band of each section, selects the filter state
+	AUDIO_EQ_CoefTypeDef coef[AUDIO_EQ_BANDS];
+	} AUDIO_EQ_BankTypeDef;
+
+typedef struct {
+	AUDIO_EQ_BandTypeDef band[AUDIO_EQ_BANDS]; // written by the OTG interrupt
+	uint32_t freq;                             // sampling frequency of the design
+	AUDIO_EQ_BankTypeDef bank[2];
+	volatile uint32_t next;                    // bank designed last
+	volatile uint32_t seq;                     // incremented by the OTG interrupt when bank[next] is ready
+	uint32_t seq_seen;                         // processing copy of seq
+	uint32_t active;                           // bank used by the processing
+	uint32_t used;                             // mask of the bands filtered by the processing
+	int16_t  preamp;                           // input attenuation of the last design, 1/256 dB
+	float    state[AUDIO_EQ_BANDS][2][2];      // [band][channel][z1, z2], transposed direct form II
+	} AUDIO_EQ_TypeDef;
+
+void    AUDIO_EQ_Init(AUDIO_EQ_TypeDef* eq, uint32_t freq);
+void    AUDIO_EQ_SetFrequency(AUDIO_EQ_TypeDef* eq, uint32_t freq);
+uint8_t AUDIO_EQ_SetBand(AUDIO_EQ_TypeDef* eq, uint32_t index, const AUDIO_EQ_BandTypeDef* band);
+void    AUDIO_EQ_SetGain(AUDIO_EQ_TypeDef* eq, uint32_t index, int16_t gain);
+int16_t AUDIO_EQ_GetGain(AUDIO_EQ_TypeDef* eq, uint32_t index);
+void    AUDIO_EQ_Design(AUDIO_EQ_TypeDef* eq);
+void    AUDIO_EQ_Reset(AUDIO_EQ_TypeDef* eq);
+void    AUDIO_EQ_Process(AUDIO_EQ_TypeDef* eq, uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+#include "stm32f4xx.h"
+#include "audio_fifo.h"
+
+// Orders the data copy before the index update. The producer and the consumer run on the same core at different
+// interrupt priorities, the barrier also keeps the compiler from reordering the accesses.
+#if defined(__arm__)
+#define AUDIO_FIFO_BARRIER()     __DMB()
+#else
+#define AUDIO_FIFO_BARRIER()     __sync_synchronize() // simulator host build
+#endif
+
+// one stereo sample is always left free so that a full FIFO can be told apart from an empty one
+#define AUDIO_FIFO_GAP           6U
+
+
+/**
+ * @brief  Empty the FIFO, call before the producer and the consumer are started
+ */
+void AUDIO_FIFO_Init(AUDIO_FIFO_TypeDef* fifo){
+	fifo->wr = 0U;
+	fifo->rd = 0U;
+	fifo->flush = 0U;
+	fifo->flush_rd = 0U;
+	fifo->flush_seen = 0U;
+	fifo->overflows = 0U;
+	}
+
+
+/**
+ * @brief  Producer : bytes waiting to be read
+ */
+uint32_t AUDIO_FIFO_Count(AUDIO_FIFO_TypeDef* fifo){
+	uint32_t wr = fifo->wr;
+	// the consumer has not applied the last flush yet
+	uint32_t rd = fifo->flush != fifo->flush_seen ? fifo->flush_rd : fifo->rd;
+	return (wr + AUDIO_FIFO_SIZE - rd) % AUDIO_FIFO_SIZE;
+	}
+
+
+/**
+ * @brief  Producer : bytes that can be written from the write index on
+ */
+uint32_t AUDIO_FIFO_Free(AUDIO_FIFO_TypeDef* fifo){
+	return AUDIO_FIFO_SIZE - AUDIO_FIFO_GAP - AUDIO_FIFO_Count(fifo);
+	}
+
+
+/**
+ * @brief  Producer : publish data written in place from the write index on
+ * @param  len: bytes written, multiple of the stereo sample size and not more than AUDIO_FIFO_Free()
+ */
+void AUDIO_FIFO_Commit(AUDIO_FIFO_TypeDef* fifo, uint32_t len){
+	uint32_t wr = fifo->wr + len;
+	if (wr >= AUDIO_FIFO_SIZE) {
+		wr -= AUDIO_FIFO_SIZE;
+		}
+	AUDIO_FIFO_BARRIER();
+	fifo->wr = wr;
+	}
+
+
+/**
+ * @brief  Producer : discard the data not yet read and restart at the beginning of the buffer.
+ *         The consumer applies the flush the next time it calls AUDIO_FIFO_Flushed().
+ */
+void AUDIO_FIFO_Flush(AUDIO_FIFO_TypeDef* fifo){
+	fifo->wr = 0U;
+	fifo->flush_rd = 0U;
+	AUDIO_FIFO_BARRIER();
+	fifo->flush++;
+	}
+
+
+/**
+ * @brief  Consumer : apply a pending flush
+ * @retval 1 if the FIFO was flushed since the last call, the consumer must reset its own state
+ */
+uint8_t AUDIO_FIFO_Flushed(AUDIO_FIFO_TypeDef* fifo){
+	uint32_t flush = fifo->flush;
+	if (flush == fifo->flush_seen) {
+		return 0U;
+		}
+	AUDIO_FIFO_BARRIER();
+	fifo->rd = fifo->flush_rd;
+	AUDIO_FIFO_BARRIER();
+	fifo->flush_seen = flush;
+	return 1U;
+	}
+
+
+/**
+ * @brief  Consumer : contiguous data available for reading
+ * @param  pdata: set to the first byte
+ * @retval bytes up to the write index or the end of the buffer, multiple of the stereo sample size
+ */
+uint32_t AUDIO_FIFO_Peek(AUDIO_FIFO_TypeDef* fifo, const uint8_t** pdata){
+	uint32_t wr = fifo->wr;
+	uint32_t rd = fifo->rd;
+	AUDIO_FIFO_BARRIER();
+	*pdata = &fifo->data[rd];
+	return wr >= rd ? wr - rd : AUDIO_FIFO_SIZE - rd;
+	}
+
+
+/**
+ * @brief  Consumer : free data returned by AUDIO_FIFO_Peek()
+ * @param  len: bytes consumed
+ */
+void AUDIO_FIFO_Release(AUDIO_FIFO_TypeDef* fifo, uint32_t len){
+	uint32_t rd = fifo->rd + len;
+	if (rd >= AUDIO_FIFO_SIZE) {
+		rd -= AUDIO_FIFO_SIZE;
+		}
+	AUDIO_FIFO_BARRIER();
+	fifo->rd = rd;
+	}
@@ -0,0 +1,45 @@
+#ifndef __AUDIO_FIFO_H
+#define __AUDIO_FIFO_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Single producer / single consumer byte FIFO staging the raw USB audio packets between the OTG interrupt
+// (producer) and the deferred sample conversion (consumer). No locks : each index is written by one side only,
+// and the producer publishes new data with a memory barrier before updating the write index.
+// The producer writes in place : the OTG RX FIFO is drained directly into data[] from the write index on,
+// wrapping at the end (see USBD_AUDIO_PrepareReceive), and the packet is published by AUDIO_FIFO_Commit().
+// The size is a multiple of both the 6 byte (24bit) and the 4 byte (16bit) stereo sample, and all the committed
+// lengths are multiples of the stereo sample of the current stream. A flush restarts both indexes at 0, so after a
+// change of sample size a sample still never straddles the end of the buffer and the consumer always sees whole samples.
+
+// 4 packets of 97 24bit stereo samples (96kHz + 1)
+#define AUDIO_FIFO_SIZE          (6U*97U*4U)
+
+typedef struct {
+	uint8_t  data[AUDIO_FIFO_SIZE];
+	volatile uint32_t wr;       // write index [bytes], producer only
+	volatile uint32_t rd;       // read index [bytes], consumer only
+	volatile uint32_t flush;    // incremented by the producer to discard the contents
+	volatile uint32_t flush_rd; // read index the consumer restarts from after a flush
+	volatile uint32_t flush_seen; // consumer copy of flush
+	uint32_t overflows;         // packets dropped because the consumer fell behind
+} AUDIO_FIFO_TypeDef;
+
+void     AUDIO_FIFO_Init(AUDIO_FIFO_TypeDef* fifo);
+uint32_t AUDIO_FIFO_Count(AUDIO_FIFO_TypeDef* fifo);
+uint32_t AUDIO_FIFO_Free(AUDIO_FIFO_TypeDef* fifo);
+void     AUDIO_FIFO_Commit(AUDIO_FIFO_TypeDef* fifo, uint32_t len);
+void     AUDIO_FIFO_Flush(AUDIO_FIFO_TypeDef* fifo);
+uint8_t  AUDIO_FIFO_Flushed(AUDIO_FIFO_TypeDef* fifo);
+uint32_t AUDIO_FIFO_Peek(AUDIO_FIFO_TypeDef* fifo, const uint8_t** pdata);
+void     AUDIO_FIFO_Release(AUDIO_FIFO_TypeDef* fifo, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,102 @@
+#include "stm32f4xx.h"
+#include "audio_upsample.h"
+
+// 24bit sample range, the outputs of the filter overshoot a full scale input
+#define AUDIO_UPSAMPLE_24B_MAX      0x007FFFFF
+#define AUDIO_UPSAMPLE_24B_MIN      (-0x00800000)
+
+
+/**
+ * @brief  Q30 accumulator to a 24bit sample, rounded and clamped
+ */
+static inline int32_t AUDIO_Upsample_Sat(int64_t acc){
+	int32_t s = (int32_t)((acc + (1 << 29)) >> 30);
+	return s > AUDIO_UPSAMPLE_24B_MAX ? AUDIO_UPSAMPLE_24B_MAX : (s < AUDIO_UPSAMPLE_24B_MIN ? AUDIO_UPSAMPLE_24B_MIN : s);
+	}
+
+
+/**
+ * @brief  Select the filter and clear the history. Call before the processing is started.
+ * @param  filter: AUDIO_UPSAMPLE_FilterTypeDef, AUDIO_UPSAMPLE_OFF if the I2S cannot run at twice the stream rate
+ */
+void AUDIO_Upsample_Init(AUDIO_UPSAMPLE_TypeDef* up, uint32_t filter){
+	up->filter = (uint8_t)(filter < AUDIO_UPSAMPLE_NUM ? filter : AUDIO_UPSAMPLE_OFF);
+	up->factor = up->filter == AUDIO_UPSAMPLE_OFF ? 1U : 2U;
+	AUDIO_Upsample_Reset(up);
+	}
+
+
+/**
+ * @brief  Clear the history, called when the playback starts
+ */
+void AUDIO_Upsample_Reset(AUDIO_UPSAMPLE_TypeDef* up){
+	for (uint32_t i = 0; i < 2U*AUDIO_UPSAMPLE_TAPS; i++) {
+		up->hist[i][0] = 0;
+		up->hist[i][1] = 0;
+		}
+	up->wr = 0U;
+	}
+
+
+/**
+ * @brief  Interpolate stereo samples of the I2S circular buffer into an I2S buffer at twice their rate
+ * @param  dst: output buffer, I2S format
+ * @param  num_samples: stereo samples to write to dst, even
+ * @param  buffer: I2S circular buffer, input samples at the stream rate
+ * @param  ptr: index of the next input sample in halfwords, multiple of 4
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ * @retval index of the next input sample, num_samples/2 samples after ptr
+ */
+uint32_t AUDIO_Upsample_Process(AUDIO_UPSAMPLE_TypeDef* up, uint16_t* dst, uint32_t num_samples, const uint16_t* buffer, uint32_t ptr, uint32_t buffer_size){
+	uint32_t len = up->filter == AUDIO_UPSAMPLE_MINIMUM ? AUDIO_UPSAMPLE_MIN_TAPS : AUDIO_UPSAMPLE_TAPS;
+	uint32_t wr = up->wr;
+
+	for (uint32_t n = num_samples/2U; n > 0U; n--) {
+		int32_t in_l = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&buffer[ptr]), 16U) >> 8;
+		int32_t in_r = (int32_t)__ROR(__UNALIGNED_UINT32_READ(&buffer[ptr + 2]), 16U) >> 8;
+		up->hist[wr][0] = up->hist[wr + len][0] = in_l;
+		up->hist[wr][1] = up->hist[wr + len][1] = in_r;
+		if (++wr >= len) {
+			wr = 0U;
+			}
+		ptr += 4U;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+
+		// window of the last len input samples, oldest first
+		const int32_t (*x)[2] = &up->hist[wr];
+		int64_t acc0_l = 0, acc0_r = 0;
+		int32_t l1, r1;
+		if (up->filter == AUDIO_UPSAMPLE_MINIMUM) {
+			int64_t acc1_l = 0, acc1_r = 0;
+			for (uint32_t k = 0; k < AUDIO_UPSAMPLE_MIN_TAPS; k++) {
+				acc0_l += (int64_t)AUDIO_Upsample_CoefMinimum[0][k] * x[k][0];
+				acc0_r += (int64_t)AUDIO_Upsample_CoefMinimum[0][k] * x[k][1];
+				acc1_l += (int64_t)AUDIO_Upsample_CoefMinimum[1][k] * x[k][0];
+				acc1_r += (int64_t)AUDIO_Upsample_CoefMinimum[1][k] * x[k][1];
+				}
+			l1 = AUDIO_Upsample_Sat(acc1_l);
+			r1 = AUDIO_Upsample_Sat(acc1_r);
+			}
+		else {
+			// symmetric branch, the 25bit sum of the two samples of a coefficient fits
+			for (uint32_t k = 0; k < AUDIO_UPSAMPLE_TAPS/2U; k++) {
+				acc0_l += (int64_t)AUDIO_Upsample_CoefLinear[k] * (x[k][0] + x[AUDIO_UPSAMPLE_TAPS - 1U - k][0]);
+				acc0_r += (int64_t)AUDIO_Upsample_CoefLinear[k] * (x[k][1] + x[AUDIO_UPSAMPLE_TAPS - 1U - k][1]);
+				}
+			l1 = x[AUDIO_UPSAMPLE_TAPS/2U][0];
+			r1 = x[AUDIO_UPSAMPLE_TAPS/2U][1];
+			}
+		int32_t l0 = AUDIO_Upsample_Sat(acc0_l);
+		int32_t r0 = AUDIO_Upsample_Sat(acc0_r);
+		__UNALIGNED_UINT32_WRITE(dst, __ROR((uint32_t)l0 << 8, 16U));
+		__UNALIGNED_UINT32_WRITE(dst + 2, __ROR((uint32_t)r0 << 8, 16U));
+		__UNALIGNED_UINT32_WRITE(dst + 4, __ROR((uint32_t)l1 << 8, 16U));
+		__UNALIGNED_UINT32_WRITE(dst + 6, __ROR((uint32_t)r1 << 8, 16U));
+		dst += 8;
+		}
+
+	up->wr = wr;
+	return ptr;
+	}
@@ -0,0 +1,60 @@
+#ifndef __AUDIO_UPSAMPLE_H
+#define __AUDIO_UPSAMPLE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// 2x oversampling interpolator (USE_AUDIO_UPSAMPLE, see Makefile C_DEFS). A 44.1kHz or 48kHz stream is played at
+// 88.2kHz or 96kHz, so the reconstruction filter up to twice the stream rate is this one instead of the DAC's.
+// The I2S DMA interrupt interpolates each period from the audio transfer buffer, see AUDIO_OUT_CopyPeriod() in
+// usbd_audio.c.
+//
+// Two-branch polyphase FIR, each input sample gives two output samples :
+//  - linear phase : half-band Kaiser windowed sinc of 2*AUDIO_UPSAMPLE_TAPS-1 taps. The first output is the symmetric
+//    branch of AUDIO_UPSAMPLE_TAPS taps, computed with AUDIO_UPSAMPLE_TAPS/2 multiplies per channel, the second is the
+//    input sample at the centre of the window. Delay AUDIO_UPSAMPLE_TAPS/2 input samples.
+//  - minimum phase : the same magnitude response with the energy at the start of the impulse response, no pre-echo
+//    and a shorter delay. Both branches are AUDIO_UPSAMPLE_MIN_TAPS taps.
+// Passband to 0.45 of the stream rate, stopband from 0.55. The coefficients are generated by upsample/upsamplegen.c
+// in audio_upsample_coef.c, Q30, 24bit samples and 64bit accumulators (SMLAL).
+// upsample/upsamplebench.c measures the response, the THD+N and the host time, the DWT cycles on the target are
+// the PROFILE_UPSAMPLE point (USE_IRQ_PROFILE).
+
+#define AUDIO_UPSAMPLE_TAPS         64U
+#define AUDIO_UPSAMPLE_MIN_TAPS     56U
+
+// Filter selected with the AUDIO_VENDOR_REQ_UPSAMPLE request
+typedef enum {
+	AUDIO_UPSAMPLE_OFF = 0,         // played at the stream rate
+	AUDIO_UPSAMPLE_LINEAR,
+	AUDIO_UPSAMPLE_MINIMUM,
+	AUDIO_UPSAMPLE_NUM
+	} AUDIO_UPSAMPLE_FilterTypeDef;
+
+#ifndef AUDIO_UPSAMPLE_DEFAULT
+#define AUDIO_UPSAMPLE_DEFAULT      AUDIO_UPSAMPLE_LINEAR
+#endif
+
+// window order, tap 0 is the oldest input sample
+extern const int32_t AUDIO_Upsample_CoefLinear[AUDIO_UPSAMPLE_TAPS/2U];
+extern const int32_t AUDIO_Upsample_CoefMinimum[2][AUDIO_UPSAMPLE_MIN_TAPS];
+
+typedef struct {
+	uint8_t  filter;            // AUDIO_UPSAMPLE_FilterTypeDef in use
+	uint8_t  factor;            // output samples per input sample, 1 if off
+	uint32_t wr;                // next index of the history
+	int32_t  hist[2*AUDIO_UPSAMPLE_TAPS][2]; // last input samples, written twice, the window is contiguous
+	} AUDIO_UPSAMPLE_TypeDef;
+
+void     AUDIO_Upsample_Init(AUDIO_UPSAMPLE_TypeDef* up, uint32_t filter);
+void     AUDIO_Upsample_Reset(AUDIO_UPSAMPLE_TypeDef* up);
+uint32_t AUDIO_Upsample_Process(AUDIO_UPSAMPLE_TypeDef* up, uint16_t* dst, uint32_t num_samples, const uint16_t* buffer, uint32_t ptr, uint32_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
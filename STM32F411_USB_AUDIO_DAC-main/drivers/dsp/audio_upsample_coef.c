@@ -0,0 +1,21 @@
+// Generated by upsample/upsamplegen.c, do not edit : run make -C upsample to regenerate.
+// 2x oversampling filters, see audio_upsample.h. Passband to 0.45, stopband from 0.55 of the input rate.
+// linear phase  : 127 taps, Kaiser beta 9.9, passband ripple 0.0002dB, stopband 97.4dB
+// minimum phase : 112 taps, passband ripple 0.0003dB, stopband 92.3dB
+
+#include "audio_upsample.h"
+
+#if AUDIO_UPSAMPLE_TAPS != 64 || AUDIO_UPSAMPLE_MIN_TAPS != 56
+#error "the upsampling filters do not match audio_upsample.h, run make -C upsample"
+#endif
+
+// first half of the symmetric branch, the other branch is the input sample AUDIO_UPSAMPLE_TAPS/2
+const int32_t AUDIO_Upsample_CoefLinear[AUDIO_UPSAMPLE_TAPS/2U] = {
+-8121, 21279, -44407, 81998, -139772, 224837, -345846, 513146, -738919, 1037316, -1424598, 1919294, -2542389, 3317599, -4271763, 5435442, -6843833, 8538183, -10567980, 12994355, -15895475, 19375216, -23577546, 28711281, -35094847, 43242538, -54044979, 69190220, -92306549, 132847636, -225517154, 682784750
+};
+
+// first and second output sample of each input sample
+const int32_t AUDIO_Upsample_CoefMinimum[2][AUDIO_UPSAMPLE_MIN_TAPS] = {
+{-10771, 21802, -38257, 61566, -93308, 135115, -188670, 255590, -337390, 435371, -550581, 683791, -835456, 1005784, -1194859, 1402890, -1630515, 1879281, -2152095, 2453273, -2787481, 3157752, -3581144, 4068603, -4639583, 5318108, -6134551, 7126649, -8340717, 9833037, -11671417, 13936984, -16726206, 20153180, -24352035, 29479245, -35715385, 43265314, -52354811, 63220066, -76083437, 91103086, -108274307, 127242227, -146953904, 165024185, -176608906, 172495724, -136217411, 41123929, 145808420, -421163004, 533688229, 678039976, 145933313, 4025536},
+{15583, -20533, 25017, -27871, 27459, -21524, 7127, 19515, -63096, 129362, -225179, 358631, -539131, 777478, -1085907, 1478113, -1969219, 2575560, -3314275, 4202600, -5256961, 6493485, -7936092, 9596366, -11491415, 13634423, -16036157, 18703918, -21640573, 24843327, -28302183, 31997896, -35899186, 39958880, -44108526, 48250760, -52248382, 55908769, -58961590, 61026994, -61570459, 59839769, -54779063, 44917381, -28238886, 2072214, 36880621, -92037236, 165054885, -250311616, 320379311, -292163704, -26617020, 801913647, 382663671, 34854848}
+};
@@ -0,0 +1,163 @@
+#include "stm32f4xx.h"
+#include "audio_verify.h"
+
+#define AUDIO_VERIFY_CRC_INIT       0xFFFFFFFFUL
+#define AUDIO_VERIFY_CRC_POLY       0x04C11DB7UL
+
+#if defined(__arm__)
+// Orders the result before its publication, see AUDIO_Verify_Publish()
+#define AUDIO_VERIFY_BARRIER()      __DMB()
+
+// F4 CRC unit : one word per write, the CRC is read back from the same register
+static inline void AUDIO_Verify_CrcReset(AUDIO_VERIFY_TypeDef* v){
+	(void)v;
+	CRC->CR = CRC_CR_RESET;
+	}
+
+static inline void AUDIO_Verify_CrcWord(AUDIO_VERIFY_TypeDef* v, uint32_t word){
+	(void)v;
+	CRC->DR = word;
+	}
+
+static inline uint32_t AUDIO_Verify_CrcValue(AUDIO_VERIFY_TypeDef* v){
+	(void)v;
+	return CRC->DR;
+	}
+#else
+#define AUDIO_VERIFY_BARRIER()      __sync_synchronize() // simulator and verify/ host builds
+
+// bitwise equivalent of the CRC unit
+static inline void AUDIO_Verify_CrcReset(AUDIO_VERIFY_TypeDef* v){
+	v->crc = AUDIO_VERIFY_CRC_INIT;
+	}
+
+static inline void AUDIO_Verify_CrcWord(AUDIO_VERIFY_TypeDef* v, uint32_t word){
+	uint32_t crc = v->crc ^ word;
+	for (uint32_t i = 0; i < 32U; i++) {
+		crc = (crc & 0x80000000UL) ? (crc << 1) ^ AUDIO_VERIFY_CRC_POLY : crc << 1;
+		}
+	v->crc = crc;
+	}
+
+static inline uint32_t AUDIO_Verify_CrcValue(AUDIO_VERIFY_TypeDef* v){
+	return v->crc;
+	}
+#endif
+
+
+/**
+ * @brief  Publish the CRC and the sample count together, in the result the OTG interrupt does not read.
+ *         Called by the processing, the OTG interrupt cannot be preempted by it.
+ */
+static void AUDIO_Verify_Publish(AUDIO_VERIFY_TypeDef* v){
+	uint32_t b = v->pub ^ 1U;
+	v->result[b].crc = AUDIO_Verify_CrcValue(v);
+	v->result[b].samples = v->samples;
+	// the result is complete before it is published
+	AUDIO_VERIFY_BARRIER();
+	v->pub = b;
+	}
+
+
+/**
+ * @brief  Start a new CRC, it waits for a sample that is not silence
+ */
+static void AUDIO_Verify_Clear(AUDIO_VERIFY_TypeDef* v){
+	AUDIO_Verify_CrcReset(v);
+	v->armed = 0U;
+	v->samples = 0U;
+	AUDIO_Verify_Publish(v);
+	}
+
+
+/**
+ * @brief  Enable the CRC unit and start a new CRC. Call before the processing is started.
+ */
+void AUDIO_Verify_Init(AUDIO_VERIFY_TypeDef* v){
+#if defined(__arm__)
+	SET_BIT(RCC->AHB1ENR, RCC_AHB1ENR_CRCEN);
+	// delay after the clock enable
+	(void)READ_BIT(RCC->AHB1ENR, RCC_AHB1ENR_CRCEN);
+#endif
+	v->pub = 0U;
+	v->restart = 0U;
+	v->restart_seen = 0U;
+	AUDIO_Verify_Clear(v);
+	}
+
+
+/**
+ * @brief  Restart the CRC from the next sample that is not silence. Called by the OTG interrupt, the processing
+ *         applies it before its next packet.
+ */
+void AUDIO_Verify_Restart(AUDIO_VERIFY_TypeDef* v){
+	v->restart++;
+	}
+
+
+/**
+ * @brief  Read the CRC and the sample count. Called by the OTG interrupt.
+ * @param  result: set to the CRC of the samples written so far, the initial value and 0 samples after a restart
+ */
+void AUDIO_Verify_Get(const AUDIO_VERIFY_TypeDef* v, AUDIO_VERIFY_ResultTypeDef* result){
+	if (v->restart != v->restart_seen) {
+		result->crc = AUDIO_VERIFY_CRC_INIT;
+		result->samples = 0U;
+		}
+	else {
+		*result = v->result[v->pub];
+		}
+	}
+
+
+/**
+ * @brief  Add contiguous stereo samples to the CRC
+ */
+static void AUDIO_Verify_Run(AUDIO_VERIFY_TypeDef* v, const uint16_t* p, uint32_t num_samples){
+	if (!v->armed) {
+		while (num_samples && (__UNALIGNED_UINT32_READ(p) | __UNALIGNED_UINT32_READ(p + 2)) == 0U) {
+			p += 4;
+			num_samples--;
+			}
+		if (num_samples == 0U) {
+			return;
+			}
+		v->armed = 1U;
+		}
+	v->samples += num_samples;
+	for (; num_samples; num_samples--) {
+		AUDIO_Verify_CrcWord(v, __ROR(__UNALIGNED_UINT32_READ(p), 16U));
+		AUDIO_Verify_CrcWord(v, __ROR(__UNALIGNED_UINT32_READ(p + 2), 16U));
+		p += 4;
+		}
+	}
+
+
+/**
+ * @brief  Add stereo samples written to the I2S circular buffer to the CRC, and publish it
+ * @param  buffer: I2S circular buffer
+ * @param  ptr: index of the first sample in halfwords, multiple of 4
+ * @param  num_samples: stereo samples
+ * @param  buffer_size: buffer size in halfwords, multiple of 4
+ */
+void AUDIO_Verify_Process(AUDIO_VERIFY_TypeDef* v, const uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size){
+	uint32_t restart = v->restart;
+	if (restart != v->restart_seen) {
+		AUDIO_Verify_Clear(v);
+		v->restart_seen = restart;
+		}
+	while (num_samples) {
+		// samples up to the end of the buffer
+		uint32_t n = (buffer_size - ptr)/4U;
+		if (n > num_samples) {
+			n = num_samples;
+			}
+		AUDIO_Verify_Run(v, &buffer[ptr], n);
+		ptr += 4U*n;
+		num_samples -= n;
+		if (ptr >= buffer_size) {
+			ptr = 0U;
+			}
+		}
+	AUDIO_Verify_Publish(v);
+	}
@@ -0,0 +1,57 @@
+#ifndef __AUDIO_VERIFY_H
+#define __AUDIO_VERIFY_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Bit-perfect verification (USE_AUDIO_VERIFY, see Makefile C_DEFS) : a rolling CRC32 of the samples written to the
+// I2S buffer, reported in the telemetry records (USE_USB_CDC_TELEMETRY) and compared by the host with the CRC of
+// the file played, see verify/verify.c.
+//
+// The CRC is computed by the conversion after the volume, EQ, crossfeed and packet loss crossfade, one USB packet at
+// a time, see USBD_AUDIO_Process(). It does not run in the OTG interrupt, USBD_AUDIO_DataOut() only commits the
+// packet. Each stereo sample is two words, left then right, the left-aligned sample of the I2S frame :
+// 24bit sample << 8, or 16bit sample << 16.
+// CRC-32/MPEG-2 : polynomial 0x04C11DB7, initial value 0xFFFFFFFF, 32bit words MSB first, no reflection and no final
+// XOR. It is the F4 CRC unit, which is only used here, and a bitwise software CRC on the host (simulator, verify/).
+//
+// The CRC starts at the first stereo sample that is not digital silence after a restart, so the silence sent by the
+// host before the file and the pre-roll do not count. The silence is tested on the converted samples, so this build
+// has no volume dither (AUDIO_VOLUME_DITHER_DEFAULT 0, see audio_volume.h) : the fade-in at each stream start would
+// dither the leading silence and start the CRC on noise. Attenuated volumes are truncated instead, they are not
+// bit-perfect anyway.
+// The samples written by the OTG interrupt are not included : the silence of an underrun and the synthesized packets
+// of the concealment, see AUDIO_OUT_Synthesize(). A lost packet or a fade-in after an underrun changes the CRC, as
+// it should.
+// The samples played by the I2S are only these ones when the ASRC, the upsampler and the crossover are not built in,
+// they process the I2S buffer into the period buffers.
+
+// CRC and stereo samples since the first sample that is not silence
+typedef struct {
+	uint32_t crc;
+	uint32_t samples;
+	} AUDIO_VERIFY_ResultTypeDef;
+
+typedef struct {
+	uint32_t armed;             // a sample that is not silence was written since the restart
+	uint32_t crc;               // CRC of the host build, the CRC unit holds it on the target
+	uint32_t samples;
+	AUDIO_VERIFY_ResultTypeDef result[2];
+	volatile uint32_t pub;      // result published last, read by the OTG interrupt
+	volatile uint32_t restart;  // incremented by the OTG interrupt to restart the CRC
+	uint32_t restart_seen;      // processing copy of restart
+	} AUDIO_VERIFY_TypeDef;
+
+void AUDIO_Verify_Init(AUDIO_VERIFY_TypeDef* v);
+void AUDIO_Verify_Restart(AUDIO_VERIFY_TypeDef* v);
+void AUDIO_Verify_Get(const AUDIO_VERIFY_TypeDef* v, AUDIO_VERIFY_ResultTypeDef* result);
+void AUDIO_Verify_Process(AUDIO_VERIFY_TypeDef* v, const uint16_t* buffer, uint32_t ptr, uint32_t num_samples, uint32_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
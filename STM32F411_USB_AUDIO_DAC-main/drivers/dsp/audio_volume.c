@@ -0,0 +1,129 @@
+#include "audio_volume.h"
+
+// Q31 gain = 2^31 * 10^(-0.5*i/20) for i = 0 (0dB) to 192 (-96dB), 0dB is clamped to AUDIO_GAIN_UNITY
+static const int32_t VolumeGainTable[AUDIO_VOLUME_STEPS] = {
+	0x7FFFFFFF, 0x78D6FC9F, 0x721482C0, 0x6BB2D604, 0x65AC8C2F, 0x5FFC8890,
+	0x5A9DF7AC, 0x558C4B22, 0x50C335D4, 0x4C3EA839, 0x47FACCF0, 0x43F4057F,
+	0x4026E73D, 0x3C903870, 0x392CED8E, 0x35FA26AA, 0x32F52CFF, 0x301B70A8,
+	0x2D6A866F, 0x2AE025C3, 0x287A26C5, 0x26368074, 0x241346F6, 0x220EA9F4,
+	0x2026F310, 0x1E5A8472, 0x1CA7D768, 0x1B0D7B1B, 0x198A1357, 0x181C5762,
+	0x16C310E3, 0x157D1AE2, 0x144960C5, 0x1326DD71, 0x12149A60, 0x1111AEDB,
+	0x101D3F2E, 0x0F367BEE, 0x0E5CA14C, 0x0D8EF66D, 0x0CCCCCCD, 0x0C157FA9,
+	0x0B68737A, 0x0AC51567, 0x0A2ADAD2, 0x099940DB, 0x090FCBF8, 0x088E0783,
+	0x08138562, 0x079FDD9F, 0x0732AE18, 0x06CB9A26, 0x066A4A53, 0x060E6C0B,
+	0x05B7B15B, 0x0565D0AB, 0x05188480, 0x04CF8B44, 0x048AA70B, 0x04499D60,
+	0x040C3714, 0x03D2400C, 0x039B8719, 0x0367DDCC, 0x0337184E, 0x03090D3F,
+	0x02DD958A, 0x02B48C50, 0x028DCEBC, 0x02693BF0, 0x0246B4E4, 0x02261C4A,
+	0x0207567A, 0x01EA4958, 0x01CEDC3D, 0x01B4F7E3, 0x019C8651, 0x018572CB,
+	0x016FA9BB, 0x015B18A5, 0x0147AE14, 0x01355991, 0x01240B8C, 0x0113B557,
+	0x01044915, 0x00F5B9B0, 0x00E7FACC, 0x00DB00C0, 0x00CEC08A, 0x00C32FC3,
+	0x00B8449C, 0x00ADF5D1, 0x00A43AA2, 0x009B0ACE, 0x00925E89, 0x008A2E77,
+	0x008273A6, 0x007B2787, 0x007443E8, 0x006DC2F0, 0x00679F1C, 0x0061D334,
+	0x005C5A4F, 0x00572FC8, 0x00524F3B, 0x004DB486, 0x00495BC1, 0x0045413B,
+	0x00416179, 0x003DB932, 0x003A454A, 0x003702D4, 0x0033EF0C, 0x00310756,
+	0x002E4939, 0x002BB263, 0x002940A2, 0x0026F1E1, 0x0024C42C, 0x0022B5AA,
+	0x0020C49C, 0x001EEF5B, 0x001D345B, 0x001B9222, 0x001A074F, 0x00189292,
+	0x001732AE, 0x0015E67A, 0x0014ACDB, 0x001384C7, 0x00126D43, 0x00116562,
+	0x00106C43, 0x000F8115, 0x000EA30E, 0x000DD172, 0x000D0B91, 0x000C50C1,
+	0x000BA064, 0x000AF9E5, 0x000A5CB6, 0x0009C852, 0x00093C3B, 0x0008B7FA,
+	0x00083B20, 0x0007C541, 0x000755FA, 0x0006ECEC, 0x000689BF, 0x00062C1F,
+	0x0005D3BB, 0x00058048, 0x00053181, 0x0004E722, 0x0004A0EC, 0x00045EA4,
+	0x00042010, 0x0003E4FD, 0x0003AD38, 0x00037891, 0x000346DC, 0x000317F0,
+	0x0002EBA3, 0x0002C1D0, 0x00029A55, 0x0002750F, 0x000251DE, 0x000230A6,
+	0x00021149, 0x0001F3AD, 0x0001D7BA, 0x0001BD57, 0x0001A46D, 0x00018CE8,
+	0x000176B5, 0x000161BF, 0x00014DF5, 0x00013B46, 0x000129A4, 0x000118FD,
+	0x00010945, 0x0000FA6F, 0x0000EC6C, 0x0000DF33, 0x0000D2B6, 0x0000C6ED,
+	0x0000BBCC, 0x0000B14B, 0x0000A760, 0x00009E03, 0x0000952C, 0x00008CD4,
+	0x000084F3,
+	};
+
+
+/**
+ * @brief  Q31 gain for a volume setting
+ * @param  volume: 0 (0dB) to 0xA000 (-96dB), rounded to the nearest 0.5dB step
+ * @retval Q31 gain, AUDIO_GAIN_UNITY for 0dB
+ */
+int32_t AUDIO_Volume_Gain(int16_t volume){
+	int32_t index = (-(int32_t)volume + AUDIO_VOLUME_STEP/2) / AUDIO_VOLUME_STEP;
+	if (index < 0) {
+		index = 0;
+		}
+	if (index > (int32_t)AUDIO_VOLUME_STEPS - 1) {
+		index = (int32_t)AUDIO_VOLUME_STEPS - 1;
+		}
+	return VolumeGainTable[index];
+	}
+
+
+/**
+ * @brief  Set the gain immediately, without a ramp. Call before the conversion is started.
+ * @param  volume: volume setting
+ * @param  mute: 1 = muted
+ */
+void AUDIO_Volume_Init(AUDIO_VOLUME_TypeDef* vol, int16_t volume, uint8_t mute){
+	int32_t gain = mute ? 0 : AUDIO_Volume_Gain(volume);
+	vol->target = gain;
+	vol->gain = gain;
+	vol->ramp_target = gain;
+	vol->step = 0;
+	vol->ramp_count = 0U;
+	vol->ramp_samples = 1U;
+	vol->seed = 22222U;
+	vol->dither = AUDIO_VOLUME_DITHER_DEFAULT;
+	vol->fade = 0U;
+	vol->fade_seen = 0U;
+	}
+
+
+/**
+ * @brief  Request a new volume/mute state, the conversion ramps to it
+ * @param  volume: volume setting
+ * @param  mute: 1 = muted
+ */
+void AUDIO_Volume_Set(AUDIO_VOLUME_TypeDef* vol, int16_t volume, uint8_t mute){
+	vol->target = mute ? 0 : AUDIO_Volume_Gain(volume);
+	}
+
+
+/**
+ * @brief  Set the ramp length for a sampling frequency
+ * @param  freq: sampling frequency [Hz]
+ */
+void AUDIO_Volume_SetFrequency(AUDIO_VOLUME_TypeDef* vol, uint32_t freq){
+	vol->ramp_samples = (freq * AUDIO_VOLUME_RAMP_MS) / 1000U;
+	}
+
+
+/**
+ * @brief  Restart the next converted samples from silence and ramp them to the target
+ */
+void AUDIO_Volume_FadeIn(AUDIO_VOLUME_TypeDef* vol){
+	vol->fade++;
+	}
+
+
+/**
+ * @brief  Start a ramp if the target changed or a fade in was requested. Called by the conversion before each block,
+ *         a new target during a ramp starts a new ramp from the current gain.
+ */
+void AUDIO_Volume_Update(AUDIO_VOLUME_TypeDef* vol){
+	uint32_t fade = vol->fade;
+	if (fade != vol->fade_seen) {
+		// drop the ramp in progress, the target is always different from 0 unless muted
+		vol->fade_seen = fade;
+		vol->gain = 0;
+		vol->ramp_target = 0;
+		vol->ramp_count = 0U;
+		vol->step = 0;
+		}
+	int32_t target = vol->target;
+	if (target != vol->ramp_target) {
+		uint32_t n = vol->ramp_samples;
+		if (n == 0U) {
+			n = 1U;
+			}
+		vol->ramp_target = target;
+		vol->ramp_count = n;
+		vol->step = (int32_t)(((int64_t)target - vol->gain) / (int32_t)n);
+		}
+	}
@@ -0,0 +1,58 @@
+#ifndef __AUDIO_VOLUME_H
+#define __AUDIO_VOLUME_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Digital volume control applied by the sample conversion, see audio_convert.c
+// Volume is in USB Audio Class units (1dB = 0x100), from 0dB down to -96dB in 0.5dB steps.
+// The gain is looked up in a Q31 table. Volume and mute changes do not switch the gain instantly,
+// the conversion ramps it linearly per stereo sample to the new value over AUDIO_VOLUME_RAMP_MS.
+// AUDIO_Volume_FadeIn() restarts the gain from silence, e.g. after an underrun, and ramps it back to the target.
+// When attenuating, the 24bit output is optionally re-quantized with TPDF dither instead of truncated.
+
+#define AUDIO_VOLUME_STEP         0x0080  // 0.5dB
+#define AUDIO_VOLUME_STEPS        193U    // 0dB to -96dB
+#define AUDIO_VOLUME_RAMP_MS      4U
+
+// No dither with USE_AUDIO_VERIFY : the fade-in of each stream start would turn the leading silence into noise,
+// which starts the CRC before the first sample of the file, see audio_verify.h
+#ifndef AUDIO_VOLUME_DITHER_DEFAULT
+#ifdef USE_AUDIO_VERIFY
+#define AUDIO_VOLUME_DITHER_DEFAULT   0U
+#else
+#define AUDIO_VOLUME_DITHER_DEFAULT   1U
+#endif
+#endif
+
+// Q31 gain, treated as unity : the samples are copied without the multiply
+#define AUDIO_GAIN_UNITY          ((int32_t)0x7FFFFFFF)
+
+typedef struct {
+	volatile int32_t  target;      // gain requested by the volume/mute control, written by the OTG interrupt
+	volatile uint32_t ramp_samples; // ramp length for the current sampling frequency
+	int32_t  gain;                 // gain applied to the current sample
+	int32_t  step;                 // gain increment per stereo sample while ramping
+	int32_t  ramp_target;          // target of the ramp in progress
+	uint32_t ramp_count;           // stereo samples left in the ramp
+	uint32_t seed;                 // dither noise generator state
+	uint8_t  dither;               // 1 = TPDF dither when attenuating
+	volatile uint32_t fade;        // incremented by the OTG interrupt to restart from silence
+	uint32_t fade_seen;            // conversion copy of fade
+} AUDIO_VOLUME_TypeDef;
+
+int32_t AUDIO_Volume_Gain(int16_t volume);
+void    AUDIO_Volume_Init(AUDIO_VOLUME_TypeDef* vol, int16_t volume, uint8_t mute);
+void    AUDIO_Volume_Set(AUDIO_VOLUME_TypeDef* vol, int16_t volume, uint8_t mute);
+void    AUDIO_Volume_SetFrequency(AUDIO_VOLUME_TypeDef* vol, uint32_t freq);
+void    AUDIO_Volume_FadeIn(AUDIO_VOLUME_TypeDef* vol);
+void    AUDIO_Volume_Update(AUDIO_VOLUME_TypeDef* vol);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
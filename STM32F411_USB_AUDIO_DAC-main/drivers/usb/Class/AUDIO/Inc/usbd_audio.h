@@ -25,6 +25,56 @@
 #endif
 
 #include  "usbd_ioreq.h"
+#include  "audio_fifo.h"
+#include  "audio_volume.h"
+#ifdef USE_AUDIO_EQ
+#include  "audio_eq.h"
+#endif
+#ifdef USE_AUDIO_CROSSFEED
+#include  "audio_crossfeed.h"
+#endif
+#ifdef USE_AUDIO_ASRC
+#include  "audio_asrc.h"
+#endif
+#ifdef USE_AUDIO_UPSAMPLE
+#include  "audio_upsample.h"
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+#include  "audio_crossover.h"
+#endif
+#ifdef USE_AUDIO_VERIFY
+#include  "audio_verify.h"
+#endif
+#ifdef USE_USB_CDC_TELEMETRY
+#include  "usbd_cdc_acm.h"
+#endif
+
+#if defined(USE_AUDIO_CAPTURE) && defined(USE_USB_CDC_TELEMETRY)
+#error "USE_AUDIO_CAPTURE and USE_USB_CDC_TELEMETRY both need the IN endpoint 2 and the TX FIFO space"
+#endif
+#if defined(USE_AUDIO_ASRC) && !defined(USE_I2S_DOUBLE_BUFFER)
+#error "USE_AUDIO_ASRC resamples into the period buffers of USE_I2S_DOUBLE_BUFFER"
+#endif
+#if defined(USE_AUDIO_ASRC) && defined(USE_AUDIO_CAPTURE)
+#error "USE_AUDIO_ASRC : the capture runs on the I2S frame clock, which no longer follows the stream rate"
+#endif
+#if defined(USE_AUDIO_UPSAMPLE) && !defined(USE_I2S_DOUBLE_BUFFER)
+#error "USE_AUDIO_UPSAMPLE interpolates into the period buffers of USE_I2S_DOUBLE_BUFFER"
+#endif
+#if defined(USE_AUDIO_UPSAMPLE) && (defined(USE_AUDIO_ASRC) || defined(USE_AUDIO_CAPTURE))
+#error "USE_AUDIO_UPSAMPLE : the I2S frame clock runs at twice the stream rate, not with USE_AUDIO_ASRC or USE_AUDIO_CAPTURE"
+#endif
+#if defined(USE_AUDIO_CROSSOVER) && !defined(USE_I2S_DOUBLE_BUFFER)
+#error "USE_AUDIO_CROSSOVER splits the period buffers of USE_I2S_DOUBLE_BUFFER"
+#endif
+// the simulator host build reads the CRC with USBD_AUDIO_GetStatus()
+#if defined(USE_AUDIO_VERIFY) && !defined(USE_USB_CDC_TELEMETRY) && defined(__arm__)
+#error "USE_AUDIO_VERIFY reports the CRC in the telemetry, it needs USE_USB_CDC_TELEMETRY"
+#endif
+// The period buffers are resampled from the audio transfer buffer, period_len[] is the span of each one
+#if defined(USE_AUDIO_ASRC) || defined(USE_AUDIO_UPSAMPLE)
+#define AUDIO_OUT_PERIOD_RESAMPLED
+#endif
 
 
 #ifndef USBD_AUDIO_FREQ_DEFAULT
@@ -50,9 +100,9 @@
  #define USBD_AUDIO_VOL_DEFAULT                        0xA000U
  #endif
 
- // 3dB step resolution
+ // 0.5dB step resolution, see audio_volume.h
  #ifndef USBD_AUDIO_VOL_STEP
- #define USBD_AUDIO_VOL_STEP                           0x0300U
+ #define USBD_AUDIO_VOL_STEP                           0x0080U
  #endif
 
  // default mute state is on (muted)
@@ -68,10 +118,26 @@
 /* bEndpointAddress, see UAC 1.0 spec, p.61 */
 #define AUDIO_OUT_EP                                  0x01U
 #define AUDIO_IN_EP                                   0x81U
+#ifdef USE_AUDIO_CAPTURE
+// Isochronous IN endpoint and streaming interface of the capture, see bsp_capture.h
+#define AUDIO_CAPTURE_EP                              0x82U
+#define AUDIO_CAPTURE_ITF                             0x02U
+#endif
 
 #define SOF_RATE                                      0x02U
 
-#define USB_AUDIO_CONFIG_DESC_SIZ                     124
+#ifdef USE_USB_CDC_TELEMETRY
+// composite device : interface associations for the audio function and the CDC-ACM function, see usbd_cdc_acm.h
+#define USB_AUDIO_NUM_INTERFACES                      4U
+#define USB_AUDIO_CONFIG_DESC_SIZ                     (194 + USB_IAD_DESC_SIZ + USB_CDC_ACM_DESC_SIZ)
+#elif defined(USE_AUDIO_CAPTURE)
+// audio control, playback streaming and capture streaming interfaces
+#define USB_AUDIO_NUM_INTERFACES                      3U
+#define USB_AUDIO_CONFIG_DESC_SIZ                     (194 + 86)
+#else
+#define USB_AUDIO_NUM_INTERFACES                      2U
+#define USB_AUDIO_CONFIG_DESC_SIZ                     194
+#endif
 
 #define AUDIO_INTERFACE_DESC_SIZE                     0x09U
 #define USB_AUDIO_DESC_SIZ                            0x09U
@@ -102,6 +168,9 @@
 
 #define AUDIO_CONTROL_MUTE                            0x0001U
 #define AUDIO_CONTROL_VOL                             0x0002U
+#define AUDIO_CONTROL_BASS                            0x0004U
+#define AUDIO_CONTROL_TREBLE                          0x0010U
+#define AUDIO_CONTROL_GRAPHIC_EQ                      0x0020U
 
 #define AUDIO_FORMAT_TYPE_I                           0x01U
 #define AUDIO_FORMAT_TYPE_III                         0x03U
@@ -125,6 +194,9 @@
 /* Feature Unit, UAC Spec 1.0 p.102 */
 #define AUDIO_CONTROL_REQ_FU_MUTE                     0x01U
 #define AUDIO_CONTROL_REQ_FU_VOL                      0x02U
+#define AUDIO_CONTROL_REQ_FU_BASS                     0x03U
+#define AUDIO_CONTROL_REQ_FU_TREBLE                   0x05U
+#define AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ               0x06U
 
 /* Audio Streaming Requests */
 #define AUDIO_STREAMING_REQ                           0x02U
@@ -136,22 +208,115 @@
 // e.g. 96kHz, 24bit : (96000 / 1000 + 1) * 2(stereo) * 3(24bit) = 582 bytes
 
 #define AUDIO_OUT_PACKET_24B                          ((uint16_t)((USBD_AUDIO_FREQ_MAX / 1000U + 1) * 2U * 3U))
+#define AUDIO_OUT_PACKET_16B                          ((uint16_t)((USBD_AUDIO_FREQ_MAX / 1000U + 1) * 2U * 2U))
+
+// Streaming interface alternate settings, 0 is zero bandwidth
+#define AUDIO_ALT_24B                                 1U
+#define AUDIO_ALT_16B                                 2U
+
+// Bytes per stereo sample in the USB packet for a bit depth of 24 or 16
+#define AUDIO_SAMPLE_BYTES(bit_depth)                 ((bit_depth) == 16U ? 4U : 6U)
 
 /* Input endpoint is for feedback. See USB 1.1 Spec, 5.10.4.2 Feedback. */
 #define AUDIO_IN_PACKET                               3U
 
-// Number of sub-packets in the audio transfer buffer.
-// You can modify this value but always make sure that it is an even number higher than 3.
+#ifdef USE_AUDIO_CAPTURE
+// The capture is 16bit stereo only : a 24bit packet at 96kHz (582 bytes) would not fit in the TX FIFO space left
+#define AUDIO_CAPTURE_PACKET                          AUDIO_OUT_PACKET_16B
+#define AUDIO_CAPTURE_ALT                             1U
+// Capture samples kept in the ring buffer ahead of the packets, in frames. It absorbs the jitter of the
+// packet transmission time within the frame.
+#define AUDIO_CAPTURE_DELAY_FRAMES                    2U
+#endif
+
+// Number of sub-packets in the audio transfer buffer, for each latency profile.
+// You can modify these values but always make sure that they are even numbers higher than 3.
 // Larger values will increase latency since we start playing only when the buffer is half-full
-#define AUDIO_OUT_PACKET_NUM                          8U
+#define AUDIO_OUT_PACKET_NUM_LOW                      4U
+#define AUDIO_OUT_PACKET_NUM                          6U
+#ifdef STM32F411xE
+#define AUDIO_OUT_PACKET_NUM_DEEP                     64U // 73KB of the 128KB SRAM
+#else
+#define AUDIO_OUT_PACKET_NUM_DEEP                     24U // 27KB of the 64KB SRAM
+#endif
+
+// Size of the audio transfer buffer in halfwords for a number of sub-packets
+#define AUDIO_BUF_SIZE(packet_num)                    ((uint16_t)((USBD_AUDIO_FREQ_MAX / 1000U + 1) * 2U * 3U * (packet_num)))
+
+// The audio transfer buffer is allocated for the deepest profile
+#define AUDIO_TOTAL_BUF_SIZE                          AUDIO_BUF_SIZE(AUDIO_OUT_PACKET_NUM_DEEP)
+
+
+// The minimum distance between rd_ptr and wr_ptr to prevent overwriting unplayed buffer, for a buffer size
+// in halfwords. 1/9 of the buffer, this is one 96kHz packet (97 samples) with the default profile.
+#define AUDIO_BUF_SAFEZONE_SAMPLES(buf_size)          ((buf_size) / (4U * 9U))
+
+// Latency profiles, selected with the AUDIO_VENDOR_REQ_LATENCY request and kept across resets.
+// The half-full setpoint at 48kHz is 6ms (low), 9ms (normal), 97ms on F411 or 36ms on F401 (deep).
+typedef enum
+{
+  AUDIO_LATENCY_LOW = 0,
+  AUDIO_LATENCY_NORMAL,
+  AUDIO_LATENCY_DEEP,
+  AUDIO_LATENCY_NUM,
+} AUDIO_LatencyTypeDef;
+
+#ifndef AUDIO_LATENCY_DEFAULT
+#define AUDIO_LATENCY_DEFAULT                         AUDIO_LATENCY_NORMAL
+#endif
 
-// Total size of the audio transfer buffer
-#define AUDIO_TOTAL_BUF_SIZE                          ((uint16_t)((USBD_AUDIO_FREQ_MAX / 1000U + 1) * 2U * 3U * AUDIO_OUT_PACKET_NUM))
+// Vendor request to the device (bmRequestType 0x40), wValue = AUDIO_LatencyTypeDef, no data stage.
+// With bmRequestType 0xC0 the current profile is returned in 1 byte.
+#define AUDIO_VENDOR_REQ_LATENCY                      0x01U
+
+#ifdef USE_AUDIO_EQ
+// Bass, treble and graphic EQ controls of the feature unit, 1/4 dB signed bytes, UAC 1.0 5.2.2.4.3.4 to 5.2.2.4.3.6
+#define USBD_AUDIO_TONE_MIN                           (-48)  // -12dB
+#define USBD_AUDIO_TONE_MAX                           48     // +12dB
+#define USBD_AUDIO_TONE_RES                           1      // 0.25dB
+// The graphic EQ data is a 4 byte bmBandsPresent, bit 0 = 1/3 octave band 14 (25Hz), then one byte per band present.
+// The bands are the AUDIO_EQ_GRAPHIC_BANDS peaking bands of audio_eq.h : 63Hz (18) to 6.3kHz (38), every 4th band.
+#define AUDIO_GRAPHIC_EQ_FIRST_BAND                   4U     // bit of band 18
+#define AUDIO_GRAPHIC_EQ_BAND_STEP                    4U
+#define AUDIO_GRAPHIC_EQ_DATA_SIZE                    (4U + AUDIO_EQ_GRAPHIC_BANDS)
+
+// Vendor request to the device (bmRequestType 0x40), wValue = band 0 to AUDIO_EQ_BANDS-1, 8 byte data stage
+// AUDIO_EQ_BandTypeDef. With bmRequestType 0xC0 the band definition is returned.
+#define AUDIO_VENDOR_REQ_EQ_BAND                      0x02U
+#endif
 
+#ifdef USE_AUDIO_CROSSFEED
+// Vendor request to the device (bmRequestType 0x40), wValue = AUDIO_CROSSFEED_LevelTypeDef, no data stage.
+// With bmRequestType 0xC0 the current level is returned in 1 byte.
+#define AUDIO_VENDOR_REQ_CROSSFEED                    0x03U
+#endif
+
+#ifdef USE_AUDIO_UPSAMPLE
+// Vendor request to the device (bmRequestType 0x40), wValue = AUDIO_UPSAMPLE_FilterTypeDef, no data stage.
+// Playback restarts if streaming. With bmRequestType 0xC0 the selected filter is returned in 1 byte.
+#define AUDIO_VENDOR_REQ_UPSAMPLE                     0x04U
+#endif
 
-// The minimum distance between rd_ptr and wr_ptr to prevent overwriting unplayed buffer
+#ifdef USE_AUDIO_CROSSOVER
+// Vendor request to the device (bmRequestType 0x40), wValue = crossover frequency in Hz, 0 for full range on both
+// outputs, no data stage. With bmRequestType 0xC0 the current frequency is returned in 2 bytes, little endian.
+#define AUDIO_VENDOR_REQ_CROSSOVER                    0x05U
+#endif
 
-#define AUDIO_BUF_SAFEZONE_SAMPLES                    ((USBD_AUDIO_FREQ_MAX / 1000U) + 1)
+#ifdef USE_I2S_DOUBLE_BUFFER
+// Stereo samples in each of the two I2S DMA period buffers, 1ms at 48kHz. The samples are copied from the
+// audio transfer buffer one period at a time, so this only adds up to one period of latency.
+#ifndef AUDIO_OUT_PERIOD_SAMPLES
+#define AUDIO_OUT_PERIOD_SAMPLES                      48U
+#endif
+#define AUDIO_PERIOD_BUF_SIZE                         (AUDIO_OUT_PERIOD_SAMPLES * 4U)
+// With USE_AUDIO_CROSSOVER, period buffers 2 and 3 are those of the second output
+#ifdef USE_AUDIO_CROSSOVER
+#define AUDIO_OUT_PERIOD_BUFS                         4U
+#else
+#define AUDIO_OUT_PERIOD_BUFS                         2U
+#endif
+#endif
 
     /* Audio Commands enumeration */
 typedef enum
@@ -170,6 +335,20 @@ typedef enum
   AUDIO_OFFSET_UNKNOWN,
 } AUDIO_OffsetTypeDef;
 
+// Stream start, stop and rate or alt setting switch, run at SOF, see AUDIO_OUT_Switch()
+typedef enum
+{
+  AUDIO_SWITCH_IDLE = 0,
+  AUDIO_SWITCH_FADE,    // the output is faded out at the next SOF, once the FIFO is converted
+  AUDIO_SWITCH_DRAIN,   // the DMA plays the fade out and silence, then the DAC is muted and the new settings applied
+  AUDIO_SWITCH_LOCK,    // PLLI2S locks on the new rate
+  AUDIO_SWITCH_PREROLL, // the DMA plays silence with the DAC muted, then the mute output is released
+} AUDIO_SwitchTypeDef;
+
+// GetState() of the audio interface
+#define AUDIO_STATE_READY                             0
+#define AUDIO_STATE_LOCKING                           1   // the I2S clock is not stable yet, the DMA is not started
+
 
 
  typedef struct
@@ -189,17 +368,78 @@ USBD_AUDIO_ControlTypeDef;
 typedef struct
 {
   uint32_t                  alt_setting;
-  uint16_t                  buffer[AUDIO_TOTAL_BUF_SIZE];
+  uint16_t*                 buffer; // audio transfer buffer, AUDIO_TOTAL_BUF_SIZE halfwords of which buf_size are used
+  uint16_t                  buf_size; // halfwords, set by the latency profile
+  uint16_t                  safezone; // samples, see AUDIO_BUF_SAFEZONE_SAMPLES
+  uint8_t                   latency; // AUDIO_LatencyTypeDef
   AUDIO_OffsetTypeDef       offset;
   uint8_t                   rd_enable;
   uint16_t                  rd_ptr;
-  uint16_t                  wr_ptr;
+  uint16_t                  wr_ptr; // write index including the samples staged in fifo
+  uint16_t                  conv_ptr; // write index of USBD_AUDIO_Process()
+  volatile uint32_t         skip; // halfwords the write index was moved by the underrun/overrun concealment
+  volatile uint32_t         skip_seen; // USBD_AUDIO_Process() copy of skip
+  uint8_t                   starved; // underrun, no samples received since
+  uint32_t                  underruns; // underruns concealed with a fade to silence
+  uint32_t                  overruns; // overruns concealed by dropping the samples beyond the setpoint
+  uint8_t                   rx_frame; // a packet was received since the last SOF
+  uint8_t                   missed; // frames in a row without a packet
+  volatile uint16_t         plc_period; // stereo samples repeated by the packet loss concealment
+  volatile uint32_t         plc; // incremented when a lost packet was synthesized
+  uint32_t                  plc_seen; // USBD_AUDIO_Process() copy of plc
+  uint16_t                  xfade_period; // crossfade of the first samples after a synthesized packet,
+  uint16_t                  xfade_left; // run by USBD_AUDIO_Process()
+  uint32_t                  frames_missed; // frames without a packet while playing
+  uint32_t                  frames_concealed; // lost packets synthesized
+  uint8_t                   sw_state; // AUDIO_SwitchTypeDef
+  uint8_t                   sw_measure; // the switch time is being measured
+  uint8_t                   sw_first_set; // sw_first is the first sample received after the pre-roll
+  uint16_t                  sw_first;
+  uint32_t                  sw_frames; // frames left in the DRAIN and PREROLL states, or waited in LOCK
+  uint32_t                  sw_elapsed; // SOFs since the request that started the switch
+  uint32_t                  sw_start_us; // time of that request after its SOF
+  uint32_t                  sw_unmute_us; // mute output released, from the request
+  uint32_t                  switch_us; // last switch time, from the request to the first sample of the new stream played
   uint32_t                  freq;
   uint32_t                  bit_depth;
   int16_t                   volume;
-  int32_t                   vol_3dB_shift; // 3dB attenuation steps equivalent to volume setting
+  AUDIO_VOLUME_TypeDef      vol; // gain applied to the samples, ramped on volume and mute changes
   uint8_t                   mute; // 0 = unmuted, 1 = muted
+#ifdef USE_AUDIO_EQ
+  AUDIO_EQ_TypeDef          eq; // parametric EQ applied after the volume, see audio_eq.h
+#endif
+#ifdef USE_AUDIO_CROSSFEED
+  AUDIO_CROSSFEED_TypeDef   xfeed; // headphone crossfeed applied last, see audio_crossfeed.h
+#endif
   USBD_AUDIO_ControlTypeDef control;
+  AUDIO_FIFO_TypeDef        fifo; // received packets waiting for USBD_AUDIO_Process()
+#ifdef USE_AUDIO_CAPTURE
+  uint32_t                  capture_alt; // alternate setting of the capture streaming interface
+  uint8_t                   capture_primed; // AUDIO_CAPTURE_DELAY_FRAMES of samples were captured
+  uint32_t                  capture_underruns; // packets sent short of samples
+  uint32_t                  capture_overruns; // samples dropped to recentre the capture ring
+#endif
+#ifdef USE_I2S_DOUBLE_BUFFER
+  uint16_t                  period[AUDIO_OUT_PERIOD_BUFS][AUDIO_PERIOD_BUF_SIZE] __attribute__((aligned(USBD_AUDIO_RAM_ALIGN))); // I2S DMA period buffers
+  uint16_t                  period_ptr[2]; // buffer index the period buffers were copied from
+  uint16_t                  copy_ptr; // buffer index of the next period to copy
+#endif
+#ifdef AUDIO_OUT_PERIOD_RESAMPLED
+  uint16_t                  period_len[2]; // halfwords of the audio transfer buffer resampled into each period buffer
+#endif
+#ifdef USE_AUDIO_ASRC
+  AUDIO_ASRC_TypeDef        asrc; // resampler from the stream rate to AUDIO_ASRC_OUT_FREQ, see audio_asrc.h
+#endif
+#ifdef USE_AUDIO_UPSAMPLE
+  uint8_t                   upsample; // AUDIO_UPSAMPLE_FilterTypeDef selected by AUDIO_VENDOR_REQ_UPSAMPLE
+  AUDIO_UPSAMPLE_TypeDef    ups; // 2x interpolator of the stream, off when PLLI2S cannot run at twice the rate
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+  AUDIO_CROSSOVER_TypeDef   xover; // splits each period buffer into the two outputs, see audio_crossover.h
+#endif
+#ifdef USE_AUDIO_VERIFY
+  AUDIO_VERIFY_TypeDef      verify; // CRC of the samples written to the I2S buffer, see audio_verify.h
+#endif
 } USBD_AUDIO_HandleTypeDef;
 
 
@@ -214,6 +454,29 @@ typedef struct
     int8_t  (*GetState)     (void);
 } USBD_AUDIO_ItfTypeDef;
 
+// Playback state and concealment counters, see USBD_AUDIO_GetStatus()
+typedef struct
+{
+  uint8_t                   playing; // the I2S DMA is running
+  uint8_t                   alt_setting;
+  uint8_t                   bit_depth;
+  uint8_t                   latency; // AUDIO_LatencyTypeDef
+  uint8_t                   mute;
+  uint8_t                   starved; // underrun, no samples received since
+  int16_t                   volume; // 1/256 dB
+  uint32_t                  freq;
+  int32_t                   fill; // buffer fill at the last SOF, 1/256 stereo samples
+  uint32_t                  fb_value; // feedback, 10.22 samples per frame
+  uint32_t                  underruns;
+  uint32_t                  overruns;
+  uint32_t                  frames_missed;
+  uint32_t                  frames_concealed;
+  uint32_t                  fifo_overflows;
+  uint32_t                  switch_us; // last stream start or switch, request to first audible sample
+  uint32_t                  crc; // USE_AUDIO_VERIFY CRC of the samples written, 0 without it
+  uint32_t                  crc_samples; // stereo samples in crc
+} USBD_AUDIO_StatusTypeDef;
+
 #ifdef DEBUG_FEEDBACK_ENDPOINT
 extern volatile uint32_t  DbgMinWritableSamples;
 extern volatile uint32_t  DbgMaxWritableSamples;
@@ -221,6 +484,8 @@ extern volatile uint32_t  DbgSofHistory[];
 extern volatile uint32_t  DbgWritableSampleHistory[];
 extern volatile float     DbgFeedbackHistory[];
 extern volatile uint8_t   DbgIndex;
+extern volatile uint32_t  fs_meas_ticks;
+extern volatile uint32_t  fs_meas_nominal;
 #endif
 
 extern USBD_ClassTypeDef  USBD_AUDIO;
@@ -230,6 +495,11 @@ extern USBD_ClassTypeDef  USBD_AUDIO;
 uint8_t  USBD_AUDIO_RegisterInterface  (USBD_HandleTypeDef   *pdev,
                                         USBD_AUDIO_ItfTypeDef *fops);
 void  USBD_AUDIO_Sync (USBD_HandleTypeDef *pdev, AUDIO_OffsetTypeDef offset);
+void  USBD_AUDIO_Process (USBD_HandleTypeDef *pdev);
+void  USBD_AUDIO_GetStatus (USBD_HandleTypeDef *pdev, USBD_AUDIO_StatusTypeDef *status);
+void  USBD_AUDIO_ClearCounters (USBD_HandleTypeDef *pdev);
+void  USBD_AUDIO_RestartVerify (USBD_HandleTypeDef *pdev);
+uint8_t  USBD_AUDIO_SetLatency (USBD_HandleTypeDef *pdev, uint32_t latency);
 
 #ifdef __cplusplus
 }
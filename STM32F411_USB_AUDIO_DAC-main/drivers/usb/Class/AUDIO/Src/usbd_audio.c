@@ -11,20 +11,23 @@
   *             - Device descriptor management
   *             - Configuration descriptor management
   *             - Standard AC Interface Descriptor management
-  *             - 1 Audio Streaming Interface (with single channel, PCM, Stereo mode)
+  *             - 1 Audio Streaming Interface (PCM, Stereo mode), alt setting 1 24bit, alt setting 2 16bit
   *             - 1 Audio Streaming Endpoint
   *             - 1 Audio Terminal Input (1 channel)
   *             - Audio Class-Specific AC Interfaces
   *             - Audio Class-Specific AS Interfaces
-  *             - AudioControl Requests: only SET_CUR and GET_CUR requests are supported (for Mute)
-  *             - Audio Feature Unit (Mute and Volume control)
+  *             - AudioControl Requests: SET_CUR, GET_CUR, GET_MIN, GET_MAX and GET_RES
+  *             - Audio Feature Unit (Mute, Volume, and with USE_AUDIO_EQ Bass, Treble and Graphic Equalizer
+  *               controls, see AUDIO_REQ_GetEq() and AUDIO_REQ_SetEq())
+  *             - Vendor requests : latency profile, and with USE_AUDIO_EQ the parametric EQ bands
   *             - Audio Synchronization type: Asynchronous
   *          The current audio class version supports the following audio features:
   *             - Pulse Coded Modulation (PCM) format
-  *             - sampling rate: 44.1kHz, 48kHz, 96kHz
-  *             - Bit resolution: 24
+  *             - sampling rate: 32kHz, 44.1kHz, 48kHz, 88.2kHz, 96kHz
+  *             - Bit resolution: 24 (alt setting 1) or 16 (alt setting 2)
   *             - Number of channels: 2
-  *             - Volume control max=0dB, min=-96dB, 3dB attenuation steps
+  *             - Volume control max=0dB, min=-96dB, 0.5dB steps : Q31 gain ramped over 4ms,
+  *               TPDF dither when attenuating, see audio_volume.h
   *             - Mute/Unmute
   *             - Asynchronous Endpoints
   *             - Endpoint for Sampling frequency DbgFeedbackHistory 10.14 3bytes
@@ -34,6 +37,13 @@
 #include "usbd_audio.h"
 #include "usbd_ctlreq.h"
 #include "bsp_audio.h"
+#include "bsp_sof_tim.h"
+#include "audio_convert.h"
+#include "log.h"
+#include "profile.h"
+#ifdef USE_AUDIO_CAPTURE
+#include "bsp_capture.h"
+#endif
 
 
 #define AUDIO_SAMPLE_FREQ(frq) (uint8_t)(frq), (uint8_t)((frq >> 8)), (uint8_t)((frq >> 16))
@@ -44,12 +54,57 @@
 #define AUDIO_PACKET_SZE_24B(frq) (uint8_t)(((frq / 1000U + 1) * 2U * 3U) & 0xFFU), \
                                   (uint8_t)((((frq / 1000U + 1) * 2U * 3U) >> 8) & 0xFFU)
 
+#define AUDIO_PACKET_SZE_16B(frq) (uint8_t)(((frq / 1000U + 1) * 2U * 2U) & 0xFFU), \
+                                  (uint8_t)((((frq / 1000U + 1) * 2U * 2U) >> 8) & 0xFFU)
+
 
-#define AUDIO_FB_DEFAULT 0x1800ED70 // I2S_Clk_Config24[2].nominal_fdbk (96kHz, 24bit, USE_MCLK_OUT false)
+#define AUDIO_FB_DEFAULT 0x18000000 // 96kHz, replaced by I2S_Clk_Config24[].nominal_fdbk when playback starts
+
+// I2S sampling frequency of the stream. With USE_AUDIO_ASRC the I2S clock is fixed and the stream is resampled,
+// with USE_AUDIO_UPSAMPLE it is twice the stream rate when the upsampler is on.
+#ifdef USE_AUDIO_ASRC
+#define AUDIO_OUT_I2S_FREQ(haudio)  AUDIO_ASRC_OUT_FREQ
+#elif defined(USE_AUDIO_UPSAMPLE)
+#define AUDIO_OUT_I2S_FREQ(haudio)  ((haudio)->freq * (haudio)->ups.factor)
+#else
+#define AUDIO_OUT_I2S_FREQ(haudio)  ((haudio)->freq)
+#endif
 
 // DbgFeedbackHistory is limited to +/- 1kHz
 #define  AUDIO_FB_DELTA_MAX (uint32_t)(1 << 22)
 
+// Feedback PI controller, fill error in stereo samples, correction in samples per frame.
+// The loop time constant is ~64 frames, much longer than the host's feedback latency of a few frames.
+#define  AUDIO_FB_LPF_K       0.125f            // fill error low-pass, time constant 8 frames
+#define  AUDIO_FB_KP          (1.0f/64.0f)
+#define  AUDIO_FB_KI          (1.0f/16384.0f)   // per frame, integral zero at 1/4 of the crossover
+
+// Crystal error measurement window in USB frames, must be less than the 2048 frame FNSOF rollover.
+// One timer tick in 1024 frames is ~0.01ppm
+#define  AUDIO_FS_MEAS_FRAMES 1024U
+
+// Underrun/overrun concealment, see AUDIO_OUT_Conceal(). Halfwords ahead of the DMA read position that the
+// I2S DMA FIFO may already have fetched, and stereo samples faded out before an overrun splice.
+#define  AUDIO_CONCEAL_DMA_GUARD    32U
+#define  AUDIO_CONCEAL_FADE_SAMPLES 32U
+
+// Packet loss concealment, see AUDIO_OUT_Synthesize(). Lost packets synthesized in a row, and stereo samples
+// crossfaded at each end of the synthesized samples.
+#define  AUDIO_PLC_MAX_FRAMES       2U
+#define  AUDIO_PLC_XFADE_SAMPLES    16U
+
+// Stereo samples of the silence played to keep the I2S frame clock running for the capture, see AUDIO_IN_Start()
+#define  AUDIO_CAPTURE_SILENCE_SAMPLES  96U
+
+// Stream start, stop and switch, see AUDIO_OUT_Switch(). Fade out of the current stream in ms of samples, frames
+// waited for the PLLI2S lock before the DMA is started anyway, and silence played with the DAC muted while it
+// locks on the new I2S clock.
+#define  AUDIO_SWITCH_FADE_MS       2U
+#define  AUDIO_SWITCH_LOCK_FRAMES   10U
+#ifndef AUDIO_SWITCH_PREROLL_MS
+#define  AUDIO_SWITCH_PREROLL_MS    2U
+#endif
+
 static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx);
 static uint8_t USBD_AUDIO_DeInit(USBD_HandleTypeDef* pdev, uint8_t cfgidx);
 static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
@@ -67,9 +122,41 @@ static void AUDIO_REQ_GetMax(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req
 static void AUDIO_REQ_GetMin(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
 static void AUDIO_REQ_GetRes(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
 static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req);
+#ifdef USE_AUDIO_EQ
+static uint16_t AUDIO_REQ_GetEq(USBD_AUDIO_HandleTypeDef* haudio, uint8_t cs, uint8_t cmd, uint8_t* data);
+static void AUDIO_REQ_SetEq(USBD_AUDIO_HandleTypeDef* haudio);
+#endif
 static void AUDIO_OUT_StopAndReset(USBD_HandleTypeDef* pdev);
 static void AUDIO_OUT_Restart(USBD_HandleTypeDef* pdev);
-static int32_t USBD_AUDIO_Get_Vol3dB_Shift(int16_t volume);
+static void AUDIO_OUT_Switch(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_SwitchSOF(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_SwitchApply(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_SwitchMeasure(USBD_AUDIO_HandleTypeDef* haudio, uint32_t elapsed_ticks);
+static uint32_t AUDIO_OUT_FadeOut(USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_Preroll(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_Unstarve(USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_UpdateRdPtr(USBD_AUDIO_HandleTypeDef* haudio);
+static void USBD_AUDIO_Measure_Fs(USBD_HandleTypeDef* pdev);
+static uint32_t USBD_AUDIO_Fb_Nominal(uint32_t fb_pll);
+static void USBD_AUDIO_PrepareReceive(USBD_HandleTypeDef* pdev);
+static void AUDIO_OUT_SetLatency(USBD_AUDIO_HandleTypeDef* haudio, uint32_t latency);
+static int32_t AUDIO_OUT_Conceal(USBD_AUDIO_HandleTypeDef* haudio, int32_t fill);
+static int32_t AUDIO_OUT_Synthesize(USBD_AUDIO_HandleTypeDef* haudio, int32_t fill);
+static uint32_t AUDIO_OUT_GuardPtr(USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_ConvSync(USBD_AUDIO_HandleTypeDef* haudio);
+#ifdef USE_I2S_DOUBLE_BUFFER
+static void AUDIO_OUT_CopyPeriod(USBD_AUDIO_HandleTypeDef* haudio, uint32_t target);
+static void AUDIO_OUT_FillPeriod(USBD_AUDIO_HandleTypeDef* haudio, uint32_t target);
+#endif
+#ifdef USE_AUDIO_UPSAMPLE
+static void AUDIO_OUT_SetUpsample(USBD_AUDIO_HandleTypeDef* haudio);
+static void AUDIO_OUT_SelectUpsample(USBD_HandleTypeDef* pdev, uint32_t filter);
+#endif
+#ifdef USE_AUDIO_CAPTURE
+static void AUDIO_IN_Start(USBD_HandleTypeDef* pdev);
+static void AUDIO_IN_Stop(USBD_HandleTypeDef* pdev);
+static void AUDIO_IN_Transmit(USBD_HandleTypeDef* pdev);
+#endif
 
 
 USBD_ClassTypeDef USBD_AUDIO = {
@@ -89,20 +176,40 @@ USBD_ClassTypeDef USBD_AUDIO = {
     USBD_AUDIO_GetDeviceQualifierDesc,
 };
 
-// USB AUDIO device Configuration Descriptor
+#ifdef USE_USB_CDC_TELEMETRY
+#define AUDIO_CFG_IAD_SIZ USB_IAD_DESC_SIZ
+#else
+#define AUDIO_CFG_IAD_SIZ 0U
+#endif
+
+// USB AUDIO device Configuration Descriptor. With USE_USB_CDC_TELEMETRY this is a composite device, each function
+// is grouped by an interface association descriptor and the CDC-ACM interfaces follow the audio interfaces.
 __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALIGN_END = {
     // Configuration 1
     0x09,                              /* bLength */
     USB_DESC_TYPE_CONFIGURATION,       /* bDescriptorType */
     LOBYTE(USB_AUDIO_CONFIG_DESC_SIZ), /* wTotalLength bytes*/
     HIBYTE(USB_AUDIO_CONFIG_DESC_SIZ),
-    0x02, /* bNumInterfaces */
+    USB_AUDIO_NUM_INTERFACES, /* bNumInterfaces */
     0x01, /* bConfigurationValue */
     0x00, /* iConfiguration */
     0x80, /* bmAttributes  BUS Powered (0xC0 = self-powered) */
     0x32, /* bMaxPower = 50*2mA = 100 mA*/
     // 09 byte
 
+#ifdef USE_USB_CDC_TELEMETRY
+    // Interface Association Descriptor, audio function
+    USB_IAD_DESC_SIZ,            /* bLength */
+    USB_DESC_TYPE_IAD,           /* bDescriptorType */
+    0x00,                        /* bFirstInterface */
+    0x02,                        /* bInterfaceCount */
+    USB_DEVICE_CLASS_AUDIO,      /* bFunctionClass */
+    AUDIO_SUBCLASS_AUDIOCONTROL, /* bFunctionSubClass */
+    AUDIO_PROTOCOL_UNDEFINED,    /* bFunctionProtocol */
+    0x00,                        /* iFunction */
+    // 08 byte
+#endif
+
     // USB Speaker Standard interface descriptor
     AUDIO_INTERFACE_DESC_SIZE,   /* bLength */
     USB_DESC_TYPE_INTERFACE,     /* bDescriptorType */
@@ -115,6 +222,20 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     0x00,                        /* iInterface */
     // 09 byte
 
+#ifdef USE_AUDIO_CAPTURE
+    // Class-specific AC Interface Descriptor, the playback and capture streaming interfaces
+    AUDIO_INTERFACE_DESC_SIZE + 1,   /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_CONTROL_HEADER,            /* bDescriptorSubtype */
+    0x00, /* 1.00 */                 /* bcdADC */
+    0x01,
+    0x3D, /* wTotalLength = 61*/
+    0x00,
+    0x02,              /* bInCollection */
+    0x01,              /* baInterfaceNr(1) */
+    AUDIO_CAPTURE_ITF, /* baInterfaceNr(2) */
+    // 10 byte
+#else
     // USB Speaker Class-specific AC Interface Descriptor
     AUDIO_INTERFACE_DESC_SIZE,       /* bLength */
     AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
@@ -126,6 +247,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     0x01, /* bInCollection */
     0x01, /* baInterfaceNr */
     // 09 byte
+#endif
 
     // USB Speaker Input Terminal Descriptor
     AUDIO_INPUT_TERMINAL_DESC_SIZE,  /* bLength */
@@ -149,7 +271,11 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     AUDIO_OUT_STREAMING_CTRL,        /* bUnitID */
     0x01,                            /* bSourceID */
     0x01,                            /* bControlSize */
+#ifdef USE_AUDIO_EQ
+	(AUDIO_CONTROL_MUTE | AUDIO_CONTROL_VOL | AUDIO_CONTROL_BASS | AUDIO_CONTROL_TREBLE | AUDIO_CONTROL_GRAPHIC_EQ), /* bmaControls(0) */
+#else
 	(AUDIO_CONTROL_MUTE | AUDIO_CONTROL_VOL),          /* bmaControls(0) */
+#endif
     0,                               /* bmaControls(1) */
     0x00,                            /* iTerminal */
     // 09 byte
@@ -166,6 +292,35 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     0x00, /* iTerminal */
     // 09 byte
 
+#ifdef USE_AUDIO_CAPTURE
+    // Capture Input Terminal Descriptor
+    AUDIO_INPUT_TERMINAL_DESC_SIZE,  /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_CONTROL_INPUT_TERMINAL,    /* bDescriptorSubtype */
+    0x04,                            /* bTerminalID */
+    0x03,                            /* wTerminalType Line connector 0x0603 */
+    0x06,
+    0x00, /* bAssocTerminal */
+    0x02, /* bNrChannels */
+    0x03, /* wChannelConfig 0x0003  FL FR */
+    0x00,
+    0x00, /* iChannelNames */
+    0x00, /* iTerminal */
+    // 12 byte
+
+    // Capture Output Terminal Descriptor
+    0x09,                            /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_CONTROL_OUTPUT_TERMINAL,   /* bDescriptorSubtype */
+    0x05,                            /* bTerminalID */
+    0x01,                            /* wTerminalType AUDIO_TERMINAL_USB_STREAMING 0x0101 */
+    0x01,
+    0x00, /* bAssocTerminal */
+    0x04, /* bSourceID */
+    0x00, /* iTerminal */
+    // 09 byte
+#endif
+
     // USB Speaker Standard AS Interface Descriptor
     // Interface 1, Alternate Setting 0
 	// Zero Bandwidth with zero endpoints, used to relinquish bandwidth
@@ -187,7 +342,7 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
     USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
     0x01,                          /* bInterfaceNumber */
-    0x01,                          /* bAlternateSetting */
+    AUDIO_ALT_24B,                 /* bAlternateSetting */
     0x02,                          /* bNumEndpoints - 1 output & 1 feedback */
     USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
     AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
@@ -206,18 +361,20 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     // 07 byte
 
     // USB Speaker Audio Type I Format Interface Descriptor
-    17,                            /* bLength */
+    23,                            /* bLength */
     AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
     AUDIO_STREAMING_FORMAT_TYPE,     /* bDescriptorSubtype */
     AUDIO_FORMAT_TYPE_I,             /* bFormatType */
     2,                            /* bNrChannels */
     3,                            /* bSubFrameSize :  3 Bytes per frame (24bits) */
     24,                            /* bBitResolution (24-bits per sample) */
-    3,                            /* bSamFreqType 3 frequencies supported */
+    AUDIO_FREQ_NUM,               /* bSamFreqType 5 frequencies supported, see I2S_Clk_Config24 */
+    AUDIO_SAMPLE_FREQ(32000),        /* Audio sampling frequency coded on 3 bytes */
     AUDIO_SAMPLE_FREQ(44100),        /* Audio sampling frequency coded on 3 bytes */
     AUDIO_SAMPLE_FREQ(48000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(88200),        /* Audio sampling frequency coded on 3 bytes */
     AUDIO_SAMPLE_FREQ(96000),        /* Audio sampling frequency coded on 3 bytes */
-    // 17 byte
+    // 23 byte
 
     // Endpoint 1 - Standard Descriptor
 	// Isochronous Async endpoint for audio packets
@@ -253,6 +410,250 @@ __ALIGN_BEGIN static uint8_t USBD_AUDIO_CfgDesc[USB_AUDIO_CONFIG_DESC_SIZ] __ALI
     0x00,                              /* bSynchAddress */
     // 09 byte
 
+    // USB Speaker Standard AS Interface Descriptor
+    // Interface 1, Alternate Setting 2
+	// 16bit stream, 2/3 of the 24bit bandwidth for CD quality sources
+    AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
+    USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
+    0x01,                          /* bInterfaceNumber */
+    AUDIO_ALT_16B,                 /* bAlternateSetting */
+    0x02,                          /* bNumEndpoints - 1 output & 1 feedback */
+    USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
+    AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
+    AUDIO_PROTOCOL_UNDEFINED,      /* bInterfaceProtocol */
+    0x00,                          /* iInterface */
+    // 09 byte
+
+    // USB Speaker Audio Streaming Interface Descriptor
+    AUDIO_STREAMING_INTERFACE_DESC_SIZE, /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_STREAMING_GENERAL,             /* bDescriptorSubtype */
+    0x01,                                /* bTerminalLink */
+    0x01,                                /* bDelay */
+    0x01,                                /* wFormatTag AUDIO_FORMAT_PCM  0x0001*/
+    0x00,
+    // 07 byte
+
+    // USB Speaker Audio Type I Format Interface Descriptor
+    23,                            /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_STREAMING_FORMAT_TYPE,     /* bDescriptorSubtype */
+    AUDIO_FORMAT_TYPE_I,             /* bFormatType */
+    2,                            /* bNrChannels */
+    2,                            /* bSubFrameSize :  2 Bytes per frame (16bits) */
+    16,                            /* bBitResolution (16-bits per sample) */
+    AUDIO_FREQ_NUM,               /* bSamFreqType 5 frequencies supported, see I2S_Clk_Config24 */
+    AUDIO_SAMPLE_FREQ(32000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(44100),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(48000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(88200),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(96000),        /* Audio sampling frequency coded on 3 bytes */
+    // 23 byte
+
+    // Endpoint 1 - Standard Descriptor
+	// Isochronous Async endpoint for audio packets
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE,         /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                    /* bDescriptorType */
+    AUDIO_OUT_EP,                              /* bEndpointAddress 1 out endpoint*/
+    USBD_EP_TYPE_ISOC_ASYNC,                   /* bmAttributes */
+    AUDIO_PACKET_SZE_16B(USBD_AUDIO_FREQ_MAX), /* wMaxPacketSize in Bytes (freq / 1000 + extra_samples) * channels * bytes_per_sample */
+    0x01,                                      /* bInterval */
+    0x00,                                      /* bRefresh */
+    AUDIO_IN_EP,                               /* bSynchAddress */
+    // 09 byte
+
+    // Endpoint - Audio Streaming Descriptor
+    AUDIO_STREAMING_ENDPOINT_DESC_SIZE, /* bLength */
+    AUDIO_ENDPOINT_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_ENDPOINT_GENERAL,             /* bDescriptor */
+    0x01,                               /* bmAttributes - Sampling Frequency control is supported. See UAC Spec 1.0 p.62 */
+    0x00,                               /* bLockDelayUnits */
+    0x00,                               /* wLockDelay */
+    0x00,
+    // 07 byte
+
+    // Endpoint 2 - Standard Descriptor - See UAC Spec 1.0 p.63 4.6.2.1 Standard AS Isochronous Synch Endpoint Descriptor
+	// 3byte 10.14 sampling frequency feedback to host
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE, /* bLength */
+    USB_DESC_TYPE_ENDPOINT,            /* bDescriptorType */
+    AUDIO_IN_EP,                       /* bEndpointAddress */
+    0x11,                              /* bmAttributes */
+    0x03, 0x00,                        /* wMaxPacketSize in Bytes */
+    0x01,                              /* bInterval 1ms */
+    SOF_RATE,                          /* bRefresh 4ms = 2^2 */
+    0x00,                              /* bSynchAddress */
+    // 09 byte
+
+#ifdef USE_AUDIO_CAPTURE
+    // Capture Standard AS Interface Descriptor
+    // Interface 2, Alternate Setting 0, zero bandwidth
+    AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
+    USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
+    AUDIO_CAPTURE_ITF,             /* bInterfaceNumber */
+    0x00,                          /* bAlternateSetting */
+    0x00,                          /* bNumEndpoints */
+    USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
+    AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
+    AUDIO_PROTOCOL_UNDEFINED,      /* bInterfaceProtocol */
+    0x00,                          /* iInterface */
+    // 09 byte
+
+    // Capture Standard AS Interface Descriptor
+    // Interface 2, Alternate Setting 1, 16bit stream
+    AUDIO_INTERFACE_DESC_SIZE,     /* bLength */
+    USB_DESC_TYPE_INTERFACE,       /* bDescriptorType */
+    AUDIO_CAPTURE_ITF,             /* bInterfaceNumber */
+    AUDIO_CAPTURE_ALT,             /* bAlternateSetting */
+    0x01,                          /* bNumEndpoints - 1 input, asynchronous without a feedback endpoint */
+    USB_DEVICE_CLASS_AUDIO,        /* bInterfaceClass */
+    AUDIO_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
+    AUDIO_PROTOCOL_UNDEFINED,      /* bInterfaceProtocol */
+    0x00,                          /* iInterface */
+    // 09 byte
+
+    // Capture Audio Streaming Interface Descriptor
+    AUDIO_STREAMING_INTERFACE_DESC_SIZE, /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_STREAMING_GENERAL,             /* bDescriptorSubtype */
+    0x05,                                /* bTerminalLink */
+    0x01,                                /* bDelay */
+    0x01,                                /* wFormatTag AUDIO_FORMAT_PCM  0x0001*/
+    0x00,
+    // 07 byte
+
+    // Capture Audio Type I Format Interface Descriptor
+    23,                            /* bLength */
+    AUDIO_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    AUDIO_STREAMING_FORMAT_TYPE,     /* bDescriptorSubtype */
+    AUDIO_FORMAT_TYPE_I,             /* bFormatType */
+    2,                            /* bNrChannels */
+    2,                            /* bSubFrameSize :  2 Bytes per frame (16bits) */
+    16,                            /* bBitResolution (16-bits per sample) */
+    AUDIO_FREQ_NUM,               /* bSamFreqType 5 frequencies supported, shared with the playback */
+    AUDIO_SAMPLE_FREQ(32000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(44100),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(48000),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(88200),        /* Audio sampling frequency coded on 3 bytes */
+    AUDIO_SAMPLE_FREQ(96000),        /* Audio sampling frequency coded on 3 bytes */
+    // 23 byte
+
+    // Endpoint 2 - Standard Descriptor
+    // Isochronous Async endpoint for the captured audio packets
+    AUDIO_STANDARD_ENDPOINT_DESC_SIZE,         /* bLength */
+    USB_DESC_TYPE_ENDPOINT,                    /* bDescriptorType */
+    AUDIO_CAPTURE_EP,                          /* bEndpointAddress 2 in endpoint */
+    USBD_EP_TYPE_ISOC_ASYNC,                   /* bmAttributes */
+    AUDIO_PACKET_SZE_16B(USBD_AUDIO_FREQ_MAX), /* wMaxPacketSize in Bytes (freq / 1000 + extra_samples) * channels * bytes_per_sample */
+    0x01,                                      /* bInterval */
+    0x00,                                      /* bRefresh */
+    0x00,                                      /* bSynchAddress */
+    // 09 byte
+
+    // Endpoint - Audio Streaming Descriptor
+    AUDIO_STREAMING_ENDPOINT_DESC_SIZE, /* bLength */
+    AUDIO_ENDPOINT_DESCRIPTOR_TYPE,     /* bDescriptorType */
+    AUDIO_ENDPOINT_GENERAL,             /* bDescriptor */
+    0x01,                               /* bmAttributes - Sampling Frequency control is supported. See UAC Spec 1.0 p.62 */
+    0x00,                               /* bLockDelayUnits */
+    0x00,                               /* wLockDelay */
+    0x00,
+    // 07 byte
+#endif
+
+#ifdef USE_USB_CDC_TELEMETRY
+    // Interface Association Descriptor, CDC-ACM function
+    USB_IAD_DESC_SIZ,          /* bLength */
+    USB_DESC_TYPE_IAD,         /* bDescriptorType */
+    CDC_ACM_CMD_ITF,           /* bFirstInterface */
+    0x02,                      /* bInterfaceCount */
+    USB_DEVICE_CLASS_CDC,      /* bFunctionClass */
+    CDC_SUBCLASS_ACM,          /* bFunctionSubClass */
+    CDC_PROTOCOL_AT,           /* bFunctionProtocol */
+    0x00,                      /* iFunction */
+    // 08 byte
+
+    // CDC Communication Interface Descriptor
+    0x09,                      /* bLength */
+    USB_DESC_TYPE_INTERFACE,   /* bDescriptorType */
+    CDC_ACM_CMD_ITF,           /* bInterfaceNumber */
+    0x00,                      /* bAlternateSetting */
+    0x01,                      /* bNumEndpoints - notification */
+    USB_DEVICE_CLASS_CDC,      /* bInterfaceClass */
+    CDC_SUBCLASS_ACM,          /* bInterfaceSubClass */
+    CDC_PROTOCOL_AT,           /* bInterfaceProtocol */
+    0x00,                      /* iInterface */
+    // 09 byte
+
+    // Header Functional Descriptor
+    0x05,                          /* bLength */
+    CDC_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    CDC_FUNC_HEADER,               /* bDescriptorSubtype */
+    0x10, /* 1.10 */               /* bcdCDC */
+    0x01,
+    // 05 byte
+
+    // Call Management Functional Descriptor
+    0x05,                          /* bLength */
+    CDC_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    CDC_FUNC_CALL_MANAGEMENT,      /* bDescriptorSubtype */
+    0x00,                          /* bmCapabilities - no call management */
+    CDC_ACM_DATA_ITF,              /* bDataInterface */
+    // 05 byte
+
+    // ACM Functional Descriptor
+    0x04,                          /* bLength */
+    CDC_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    CDC_FUNC_ACM,                  /* bDescriptorSubtype */
+    0x02,                          /* bmCapabilities - line coding and control line state */
+    // 04 byte
+
+    // Union Functional Descriptor
+    0x05,                          /* bLength */
+    CDC_INTERFACE_DESCRIPTOR_TYPE, /* bDescriptorType */
+    CDC_FUNC_UNION,                /* bDescriptorSubtype */
+    CDC_ACM_CMD_ITF,               /* bMasterInterface */
+    CDC_ACM_DATA_ITF,              /* bSlaveInterface0 */
+    // 05 byte
+
+    // Endpoint 3 - Notification, never used but required by the ACM drivers
+    0x07,                          /* bLength */
+    USB_DESC_TYPE_ENDPOINT,        /* bDescriptorType */
+    CDC_ACM_CMD_EP,                /* bEndpointAddress */
+    USBD_EP_TYPE_INTR,             /* bmAttributes */
+    CDC_ACM_CMD_PACKET, 0x00,      /* wMaxPacketSize */
+    0x10,                          /* bInterval 16ms */
+    // 07 byte
+
+    // CDC Data Interface Descriptor
+    0x09,                      /* bLength */
+    USB_DESC_TYPE_INTERFACE,   /* bDescriptorType */
+    CDC_ACM_DATA_ITF,          /* bInterfaceNumber */
+    0x00,                      /* bAlternateSetting */
+    0x02,                      /* bNumEndpoints */
+    USB_DEVICE_CLASS_CDC_DATA, /* bInterfaceClass */
+    0x00,                      /* bInterfaceSubClass */
+    0x00,                      /* bInterfaceProtocol */
+    0x00,                      /* iInterface */
+    // 09 byte
+
+    // Endpoint 2 - Bulk OUT, control commands
+    0x07,                          /* bLength */
+    USB_DESC_TYPE_ENDPOINT,        /* bDescriptorType */
+    CDC_ACM_OUT_EP,                /* bEndpointAddress */
+    USBD_EP_TYPE_BULK,             /* bmAttributes */
+    CDC_ACM_DATA_PACKET, 0x00,     /* wMaxPacketSize */
+    0x00,                          /* bInterval */
+    // 07 byte
+
+    // Endpoint 2 - Bulk IN, telemetry records
+    0x07,                          /* bLength */
+    USB_DESC_TYPE_ENDPOINT,        /* bDescriptorType */
+    CDC_ACM_IN_EP,                 /* bEndpointAddress */
+    USBD_EP_TYPE_BULK,             /* bmAttributes */
+    CDC_ACM_DATA_PACKET, 0x00,     /* wMaxPacketSize */
+    0x00,                          /* bInterval */
+    // 07 byte
+#endif
 };
 
 /** 
@@ -276,9 +677,44 @@ volatile uint32_t tx_flag = 1;
 volatile uint32_t is_playing = 0;
 volatile uint32_t all_ready = 0;
 
-volatile uint32_t fb_nom = AUDIO_FB_DEFAULT;
+volatile uint32_t fb_pll = AUDIO_FB_DEFAULT; // Fs generated by PLLI2S with a 0ppm crystal
+volatile uint32_t fb_nom = AUDIO_FB_DEFAULT; // fb_pll corrected by the measured crystal error
 volatile uint32_t fb_value = AUDIO_FB_DEFAULT;
-volatile uint32_t audio_buf_writable_samples_last = AUDIO_TOTAL_BUF_SIZE /(2*6);
+#ifdef USE_AUDIO_ASRC
+// With USE_AUDIO_ASRC, fb_pll and fb_nom are the nominal stream rate, exact in USB frames. The crystal error
+// only changes the I2S rate that the resampler writes, in samples per frame in 10.22 format like the feedback.
+volatile uint32_t asrc_out_pll = AUDIO_FB_DEFAULT; // I2S Fs generated by PLLI2S with a 0ppm crystal
+volatile uint32_t asrc_out_nom = AUDIO_FB_DEFAULT; // asrc_out_pll corrected by the measured crystal error
+#endif
+volatile uint32_t audio_buf_writable_samples_last = AUDIO_BUF_SIZE(AUDIO_OUT_PACKET_NUM) /(2*4);
+
+// Audio transfer buffer, sized for the deepest latency profile. Not cleared by the startup code, see usbd_conf.h
+USBD_AUDIO_RAM static uint16_t USBD_AUDIO_Buffer[AUDIO_TOTAL_BUF_SIZE];
+
+// Sub-packets in the audio transfer buffer for each AUDIO_LatencyTypeDef
+static const uint16_t AUDIO_LatencyBufSize[AUDIO_LATENCY_NUM] = {
+    AUDIO_BUF_SIZE(AUDIO_OUT_PACKET_NUM_LOW),
+    AUDIO_BUF_SIZE(AUDIO_OUT_PACKET_NUM),
+    AUDIO_BUF_SIZE(AUDIO_OUT_PACKET_NUM_DEEP),
+};
+
+// The selected latency profile is kept in a RTC backup register, it survives a reset but not a power cycle
+// unless VBAT is powered
+#define AUDIO_LATENCY_BKP_REG                         0U
+#define AUDIO_LATENCY_BKP_MAGIC                       0x4C410000U
+
+// The OUT endpoint receives directly into haudio->fifo, the samples are converted by USBD_AUDIO_Process().
+// This buffer only takes the packets dropped when the FIFO is full.
+__ALIGN_BEGIN static uint8_t USBD_AUDIO_RxBuf[AUDIO_OUT_PACKET_24B] __ALIGN_END;
+static uint8_t rx_to_fifo = 0;
+
+// Feedback controller state
+static uint32_t sof_count = 0;
+static float fb_err_lpf = 0.0f;
+static float fb_integ = 0.0f;
+static uint32_t fill_last = 0; // buffer fill in halfwords at the last SOF
+static uint32_t plc_frac = 0; // fractional samples of the synthesized packets, 22 bits
+static float fill_sof = 0.0f; // sub-sample buffer fill at the last SOF, see USBD_AUDIO_GetStatus()
 
 volatile uint8_t fb_data[3] = {
     (uint8_t)((AUDIO_FB_DEFAULT >> 8) & 0x000000FF),
@@ -289,12 +725,22 @@ volatile uint8_t fb_data[3] = {
 // FNSOF is critical for frequency changing to work
 volatile uint32_t fnsof = 0;
 
-// volume attenuation is from 0dB (max volume, 0x0000) to -96dB (min volume, 0xA000) in 3dB steps
-static int32_t USBD_AUDIO_Get_Vol3dB_Shift(int16_t volume ){
-	if (volume < (int16_t)USBD_AUDIO_VOL_MIN) volume = (int16_t)USBD_AUDIO_VOL_MIN;
-	if (volume > (int16_t)USBD_AUDIO_VOL_MAX) volume = (int16_t)USBD_AUDIO_VOL_MAX;
-	return (int32_t)((((int16_t)USBD_AUDIO_VOL_MAX - volume) + (int16_t)USBD_AUDIO_VOL_STEP/2)/(int16_t)USBD_AUDIO_VOL_STEP);
-	}
+// Timer ticks measured over the last valid window, and the nominal ticks for that window. See bsp_sof_tim.h
+volatile uint32_t fs_meas_ticks = 0;
+volatile uint32_t fs_meas_nominal = 0;
+static uint32_t fs_meas_capture_start = 0;
+static uint32_t fs_meas_frame_start = 0;
+
+#ifdef USE_AUDIO_CAPTURE
+// Capture packet, 16bit stereo
+__ALIGN_BEGIN static int16_t USBD_AUDIO_TxBuf[AUDIO_CAPTURE_PACKET / 2U] __ALIGN_END;
+// Played by the I2S DMA while capturing without playback
+static uint16_t USBD_AUDIO_Silence[AUDIO_CAPTURE_SILENCE_SAMPLES * 4U];
+static uint8_t capture_tx_busy = 0; // a capture packet is armed
+static uint32_t capture_tx_frame = 0; // frame number when it was armed
+static uint32_t capture_frac = 0; // fractional samples per frame, in 1/1000
+static uint8_t clock_kept = 0; // the I2S DMA plays USBD_AUDIO_Silence
+#endif
 
 /**
   * @brief  USBD_AUDIO_Init
@@ -318,13 +764,26 @@ static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx)
   /* Flush feedback endpoint */
   USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
 
+#ifdef USE_AUDIO_CAPTURE
+  /* Open the capture EP IN */
+  USBD_LL_OpenEP(pdev, AUDIO_CAPTURE_EP, USBD_EP_TYPE_ISOC, AUDIO_CAPTURE_PACKET);
+  pdev->ep_in[AUDIO_CAPTURE_EP & 0xFU].is_used = 1U;
+  USBD_LL_FlushEP(pdev, AUDIO_CAPTURE_EP);
+  capture_tx_busy = 0U;
+  clock_kept = 0U;
+#endif
+
+#ifdef USE_USB_CDC_TELEMETRY
+  USBD_CDC_ACM_Init(pdev);
+#endif
+
   /** 
    * Set tx_flag 1 to block feedback transmission in SOF handler since 
    * device is not ready.
    */
   tx_flag = 1U;
 
-  /* Allocate Audio structure */
+  /* Allocate Audio structure, from the static arena, see USBD_static_malloc() */
   pdev->pClassData = USBD_malloc(sizeof(USBD_AUDIO_HandleTypeDef));
 
   if (pdev->pClassData == NULL) {
@@ -334,16 +793,67 @@ static uint8_t USBD_AUDIO_Init(USBD_HandleTypeDef* pdev, uint8_t cfgidx)
     haudio->alt_setting = 0U;
     haudio->offset = AUDIO_OFFSET_UNKNOWN;
     haudio->wr_ptr = 0U;
+    haudio->conv_ptr = 0U;
+    haudio->skip = 0U;
+    haudio->skip_seen = 0U;
+    haudio->starved = 0U;
+    haudio->underruns = 0U;
+    haudio->overruns = 0U;
+    haudio->rx_frame = 0U;
+    haudio->missed = 0U;
+    haudio->plc_period = 0U;
+    haudio->plc = 0U;
+    haudio->plc_seen = 0U;
+    haudio->xfade_period = 0U;
+    haudio->xfade_left = 0U;
+    haudio->frames_missed = 0U;
+    haudio->frames_concealed = 0U;
+    haudio->sw_state = AUDIO_SWITCH_IDLE;
+    haudio->sw_measure = 0U;
+    haudio->switch_us = 0U;
+#ifdef USE_AUDIO_CAPTURE
+    haudio->capture_alt = 0U;
+    haudio->capture_primed = 0U;
+    haudio->capture_underruns = 0U;
+    haudio->capture_overruns = 0U;
+#endif
     haudio->rd_ptr = 0U;
     haudio->rd_enable = 0U;
+    haudio->buffer = USBD_AUDIO_Buffer;
+    // no stale samples from the last configuration
+    USBD_memset(USBD_AUDIO_Buffer, 0, sizeof(USBD_AUDIO_Buffer));
+    uint32_t bkp = BSP_BKP_Read(AUDIO_LATENCY_BKP_REG);
+    if ((bkp & 0xFFFF0000U) == AUDIO_LATENCY_BKP_MAGIC && (bkp & 0xFFFFU) < AUDIO_LATENCY_NUM) {
+      AUDIO_OUT_SetLatency(haudio, bkp & 0xFFFFU);
+    } else {
+      AUDIO_OUT_SetLatency(haudio, AUDIO_LATENCY_DEFAULT);
+    }
+    AUDIO_FIFO_Init(&haudio->fifo);
     haudio->freq = USBD_AUDIO_FREQ_DEFAULT;
     haudio->bit_depth = USBD_AUDIO_BIT_DEPTH_DEFAULT;
     haudio->volume = USBD_AUDIO_VOL_DEFAULT;
-    haudio->vol_3dB_shift = USBD_AUDIO_Get_Vol3dB_Shift(USBD_AUDIO_VOL_DEFAULT);
     haudio->mute = USBD_AUDIO_MUTE_DEFAULT;
+    AUDIO_Volume_Init(&haudio->vol, haudio->volume, haudio->mute);
+    AUDIO_Volume_SetFrequency(&haudio->vol, haudio->freq);
+#ifdef USE_AUDIO_EQ
+    AUDIO_EQ_Init(&haudio->eq, haudio->freq);
+#endif
+#ifdef USE_AUDIO_CROSSFEED
+    AUDIO_Crossfeed_Init(&haudio->xfeed, AUDIO_CROSSFEED_DEFAULT, haudio->freq);
+#endif
+#ifdef USE_AUDIO_UPSAMPLE
+    haudio->upsample = AUDIO_UPSAMPLE_DEFAULT;
+    AUDIO_OUT_SetUpsample(haudio);
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+    AUDIO_Crossover_Init(&haudio->xover, AUDIO_CROSSOVER_FREQ_DEFAULT, AUDIO_OUT_I2S_FREQ(haudio));
+#endif
+#ifdef USE_AUDIO_VERIFY
+    AUDIO_Verify_Init(&haudio->verify);
+#endif
 
-    // Initialize the Audio output Hardware layer
-    if (((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(haudio->freq, haudio->volume, haudio->mute) != 0) {
+    // Initialize the Audio output Hardware layer, the DAC stays muted until a stream starts, see AUDIO_OUT_Preroll()
+    if (((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(AUDIO_OUT_I2S_FREQ(haudio), haudio->volume, 1U) != 0) {
       return USBD_FAIL;
     }
   }
@@ -372,6 +882,20 @@ static uint8_t USBD_AUDIO_DeInit(USBD_HandleTypeDef* pdev,
   USBD_LL_CloseEP(pdev, AUDIO_IN_EP);
   pdev->ep_in[AUDIO_IN_EP & 0xFU].is_used = 0U;
 
+#ifdef USE_AUDIO_CAPTURE
+  /* Stop the capture and close its EP IN, the I2S DMA is stopped below */
+  BSP_CAPTURE_Stop();
+  USBD_LL_FlushEP(pdev, AUDIO_CAPTURE_EP);
+  USBD_LL_CloseEP(pdev, AUDIO_CAPTURE_EP);
+  pdev->ep_in[AUDIO_CAPTURE_EP & 0xFU].is_used = 0U;
+  capture_tx_busy = 0U;
+  clock_kept = 0U;
+#endif
+
+#ifdef USE_USB_CDC_TELEMETRY
+  USBD_CDC_ACM_DeInit(pdev);
+#endif
+
   /* Clear feedback transmission flag */
   tx_flag = 0U;
 
@@ -403,6 +927,13 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
 
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
+#ifdef USE_USB_CDC_TELEMETRY
+  /* Requests to the CDC-ACM interfaces of the composite device */
+  if ((req->bmRequest & USB_REQ_RECIPIENT_MASK) == USB_REQ_RECIPIENT_INTERFACE && USBD_CDC_ACM_IsInterface(LOBYTE(req->wIndex))) {
+    return USBD_CDC_ACM_Setup(pdev, req);
+  }
+#endif
+
   switch (req->bmRequest & USB_REQ_TYPE_MASK) {
     /* AUDIO Class Requests */
     case USB_REQ_TYPE_CLASS:
@@ -434,6 +965,94 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
       }
       break;
 
+    case USB_REQ_TYPE_VENDOR:
+      switch (req->bRequest) {
+        /* Latency profile, see AUDIO_VENDOR_REQ_LATENCY */
+        case AUDIO_VENDOR_REQ_LATENCY:
+          if (req->bmRequest & 0x80U) {
+            USBD_CtlSendData(pdev, &haudio->latency, MIN(1U, req->wLength));
+          } else if (USBD_AUDIO_SetLatency(pdev, req->wValue) == USBD_OK) {
+            USBD_CtlSendStatus(pdev);
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+#ifdef USE_AUDIO_EQ
+        /* EQ band definition, see AUDIO_VENDOR_REQ_EQ_BAND */
+        case AUDIO_VENDOR_REQ_EQ_BAND:
+          if (req->wValue >= AUDIO_EQ_BANDS) {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          } else if (req->bmRequest & 0x80U) {
+            USBD_CtlSendData(pdev, (uint8_t*)&haudio->eq.band[req->wValue], MIN(sizeof(AUDIO_EQ_BandTypeDef), req->wLength));
+          } else if (req->wLength != sizeof(AUDIO_EQ_BandTypeDef)) {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          } else {
+            /* The band is set in USBD_AUDIO_EP0_RxReady() */
+            USBD_CtlPrepareRx(pdev, haudio->control.data, req->wLength);
+            haudio->control.cmd = AUDIO_VENDOR_REQ_EQ_BAND;
+            haudio->control.req_type = USB_REQ_TYPE_VENDOR;
+            haudio->control.len = (uint8_t)req->wLength;
+            haudio->control.cn = LOBYTE(req->wValue);
+          }
+          break;
+#endif
+
+#ifdef USE_AUDIO_CROSSFEED
+        /* Crossfeed level, see AUDIO_VENDOR_REQ_CROSSFEED */
+        case AUDIO_VENDOR_REQ_CROSSFEED:
+          if (req->bmRequest & 0x80U) {
+            USBD_CtlSendData(pdev, (uint8_t*)&haudio->xfeed.level, MIN(1U, req->wLength));
+          } else if (AUDIO_Crossfeed_SetLevel(&haudio->xfeed, req->wValue) == 0U) {
+            LOG("crossfeed : level %u\r\n", req->wValue);
+            USBD_CtlSendStatus(pdev);
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+#endif
+
+#ifdef USE_AUDIO_UPSAMPLE
+        /* Oversampling filter, see AUDIO_VENDOR_REQ_UPSAMPLE */
+        case AUDIO_VENDOR_REQ_UPSAMPLE:
+          if (req->bmRequest & 0x80U) {
+            USBD_CtlSendData(pdev, &haudio->upsample, MIN(1U, req->wLength));
+          } else if (req->wValue < AUDIO_UPSAMPLE_NUM) {
+            AUDIO_OUT_SelectUpsample(pdev, req->wValue);
+            USBD_CtlSendStatus(pdev);
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+#endif
+
+#ifdef USE_AUDIO_CROSSOVER
+        /* Crossover frequency, see AUDIO_VENDOR_REQ_CROSSOVER */
+        case AUDIO_VENDOR_REQ_CROSSOVER:
+          if (req->bmRequest & 0x80U) {
+            USBD_CtlSendData(pdev, (uint8_t*)&haudio->xover.cutoff, MIN(2U, req->wLength));
+          } else if (AUDIO_Crossover_SetCutoff(&haudio->xover, req->wValue) == 0U) {
+            LOG("crossover : %u Hz\r\n", req->wValue);
+            USBD_CtlSendStatus(pdev);
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+#endif
+
+        default:
+          USBD_CtlError(pdev, req);
+          ret = USBD_FAIL;
+          break;
+      }
+      break;
+
     /* Standard Requests */
     case USB_REQ_TYPE_STANDARD:
       switch (req->bRequest) {
@@ -448,7 +1067,7 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
 
         case USB_REQ_GET_DESCRIPTOR:
           if ((req->wValue >> 8) == AUDIO_DESCRIPTOR_TYPE) {
-            pbuf = USBD_AUDIO_CfgDesc + 18;
+            pbuf = USBD_AUDIO_CfgDesc + 18 + AUDIO_CFG_IAD_SIZ;
             len = MIN(USB_AUDIO_DESC_SIZ, req->wLength);
 
             USBD_CtlSendData(pdev, pbuf, len);
@@ -457,6 +1076,12 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
 
         case USB_REQ_GET_INTERFACE:
           if (pdev->dev_state == USBD_STATE_CONFIGURED) {
+#ifdef USE_AUDIO_CAPTURE
+            if (LOBYTE(req->wIndex) == AUDIO_CAPTURE_ITF) {
+              USBD_CtlSendData(pdev, (uint8_t*)(void*)&haudio->capture_alt, 1U);
+              break;
+            }
+#endif
             USBD_CtlSendData(pdev, (uint8_t*)(void*)&haudio->alt_setting, 1U);
           } else {
             USBD_CtlError(pdev, req);
@@ -466,17 +1091,29 @@ static uint8_t USBD_AUDIO_Setup(USBD_HandleTypeDef* pdev,
 
         case USB_REQ_SET_INTERFACE:
           if (pdev->dev_state == USBD_STATE_CONFIGURED) {
-            if ((uint8_t)(req->wValue) <= USBD_MAX_NUM_INTERFACES) {
+#ifdef USE_AUDIO_CAPTURE
+            if (LOBYTE(req->wIndex) == AUDIO_CAPTURE_ITF) {
+              if ((uint8_t)(req->wValue) > AUDIO_CAPTURE_ALT) {
+                USBD_CtlError(pdev, req);
+                ret = USBD_FAIL;
+              } else if (haudio->capture_alt != (uint8_t)(req->wValue)) {
+                haudio->capture_alt = (uint8_t)(req->wValue);
+                if (haudio->capture_alt == 0U) {
+                  AUDIO_IN_Stop(pdev);
+                  LOG("capture : stream stopped\r\n");
+                } else {
+                  AUDIO_IN_Start(pdev);
+                }
+              }
+              break;
+            }
+#endif
+            if ((uint8_t)(req->wValue) <= AUDIO_ALT_16B) {
               /* Do things only when alt_setting changes */
               if (haudio->alt_setting != (uint8_t)(req->wValue)) {
                 haudio->alt_setting = (uint8_t)(req->wValue);
-                if (haudio->alt_setting == 0U) {
-                	AUDIO_OUT_StopAndReset(pdev);
-                	}
-                else {
-                	haudio->bit_depth = USBD_AUDIO_BIT_DEPTH_DEFAULT;
-                  	AUDIO_OUT_Restart(pdev);
-                	}
+                // stop, start or bit depth change, the bit depth applies after the fade out
+                AUDIO_OUT_Switch(pdev);
               	}
               USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
             } else {
@@ -533,6 +1170,18 @@ static uint8_t USBD_AUDIO_DataIn(USBD_HandleTypeDef* pdev,
   if (epnum == (AUDIO_IN_EP & 0xf)) {
     tx_flag = 0U;
   }
+#ifdef USE_AUDIO_CAPTURE
+  else if (epnum == (AUDIO_CAPTURE_EP & 0xfU)) {
+    /* Arm the next capture packet, for the next frame */
+    capture_tx_busy = 0U;
+    AUDIO_IN_Transmit(pdev);
+  }
+#endif
+#ifdef USE_USB_CDC_TELEMETRY
+  else {
+    return USBD_CDC_ACM_DataIn(pdev, epnum);
+  }
+#endif
   return USBD_OK;
 }
 
@@ -557,56 +1206,116 @@ static uint8_t USBD_AUDIO_SOF(USBD_HandleTypeDef* pdev)
 {
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
-  static volatile uint32_t sof_count = 0;
+
+  PROFILE_ENTER();
+#ifdef USE_IRQ_PROFILE
+  // SOF interrupt latency from the capture of the SOF pulse, the timer clock is the core clock
+  uint32_t sof_latency = BSP_SOF_TIM_GetElapsed();
+  if (sof_latency < BSP_SOF_TIM_GetTicksPerFrame()) {
+    PROFILE_LATENCY(PROFILE_SOF, sof_latency);
+  }
+#endif
+
+  USBD_AUDIO_Measure_Fs(pdev);
+
+  // stream start, stop and switch
+  AUDIO_OUT_SwitchSOF(pdev);
+
+#ifdef USE_USB_CDC_TELEMETRY
+  // telemetry of the last frame, see usbd_cdc_if.c
+  USBD_CDC_ACM_SOF(pdev);
+#endif
+
+#ifdef USE_AUDIO_CAPTURE
+  /* First capture packet, or after a packet the host did not read. The next ones are armed in USBD_AUDIO_DataIn() */
+  if (haudio->capture_alt != 0U && capture_tx_busy == 0U) {
+    AUDIO_IN_Transmit(pdev);
+  }
+#endif
 
   /* Do stuff only when playing */
   if (haudio->rd_enable == 1U && all_ready == 1U) {
 #ifdef DEBUG_FEEDBACK_ENDPOINT
 	DbgSofCounter++;
 #endif
+	// Timer ticks since the SOF was captured, read together with the DMA position
+	uint32_t elapsed_ticks = BSP_SOF_TIM_GetElapsed();
 	// Update audio read pointer
-    haudio->rd_ptr = AUDIO_TOTAL_BUF_SIZE - BSP_AUDIO_OUT_GetRemainingDataSize();
-
-    // Calculate remaining writable buffer samples
-    uint32_t audio_buf_writable_samples = haudio->rd_ptr < haudio->wr_ptr ?
-    		  (haudio->rd_ptr + AUDIO_TOTAL_BUF_SIZE - haudio->wr_ptr)/6 : (haudio->rd_ptr - haudio->wr_ptr)/6;
+	AUDIO_OUT_UpdateRdPtr(haudio);
+	AUDIO_OUT_SwitchMeasure(haudio, elapsed_ticks);
+
+    // Buffer fill in halfwords, a stereo sample uses 4 halfwords
+    uint32_t fill_halfwords = (haudio->wr_ptr + haudio->buf_size - haudio->rd_ptr) % haudio->buf_size;
+    // The fill changes by much less than a quarter of the buffer in a frame. A jump across the ends of the range
+    // means that the DMA read position passed the write index (underrun) or the other way round (overrun).
+    int32_t fill_signed = (int32_t)fill_halfwords;
+    if (fill_last < haudio->buf_size/4U && fill_halfwords > haudio->buf_size - haudio->buf_size/4U) {
+    	fill_signed -= (int32_t)haudio->buf_size;
+    	}
+    else
+    if (fill_last > haudio->buf_size - haudio->buf_size/4U && fill_halfwords < haudio->buf_size/4U) {
+    	fill_signed += (int32_t)haudio->buf_size;
+    	}
+    fill_signed = AUDIO_OUT_Synthesize(haudio, fill_signed);
+    fill_signed = AUDIO_OUT_Conceal(haudio, fill_signed);
+    if (fill_signed < 0) {
+    	fill_signed = 0;
+    	}
+    if (fill_signed > (int32_t)haudio->buf_size) {
+    	fill_signed = (int32_t)haudio->buf_size;
+    	}
+    fill_halfwords = (uint32_t)fill_signed;
+    fill_last = fill_halfwords;
+    uint32_t audio_buf_writable_samples = (haudio->buf_size - fill_halfwords)/4;
 
     // Monitor remaining writable buffer samples with LED
-    if (audio_buf_writable_samples < AUDIO_BUF_SAFEZONE_SAMPLES) {
+    if (audio_buf_writable_samples < haudio->safezone || fill_halfwords/4 < haudio->safezone) {
     	BSP_OnboardLED_On();
     	}
     else {
     	BSP_OnboardLED_Off();
     	}
 
+    // Sub-sample fill at the SOF instant. The interrupt latency varies, so add back the samples played
+    // since the SOF capture. Nominal samples per frame = fb_nom >> 22
+    float fill = (float)fill_halfwords * 0.25f;
+    uint32_t ticks_per_frame = BSP_SOF_TIM_GetTicksPerFrame();
+    if (elapsed_ticks < ticks_per_frame) {
+    	fill += (float)elapsed_ticks * ((float)fb_nom / (float)(1<<22)) / (float)ticks_per_frame;
+    	}
+    fill_sof = fill;
+
+	// we start transmitting to I2S DAC when the audio buffer is half full, so the optimal
+	// fill is (haudio->buf_size/2)/4 samples
+	fb_err_lpf += AUDIO_FB_LPF_K * ((fill - (float)(haudio->buf_size/8)) - fb_err_lpf);
+
     sof_count += 1;
 
-    if (sof_count == 1U) {
+    // Update the feedback value at the bRefresh rate of the feedback endpoint
+    if (sof_count >= (1U << SOF_RATE)) {
 		sof_count = 0;
-		// we start transmitting to I2S DAC when the audio buffer is half full, so the optimal
-		// remaining writable size is (AUDIO_TOTAL_BUF_SIZE/2)/6 samples
-		// Calculate feedback value based on the deviation from optimal
-		int32_t audio_buf_writable_dev_from_nom_samples = audio_buf_writable_samples - AUDIO_TOTAL_BUF_SIZE/(2*6);
-		 // The feedback is ideally the true Fs generated by the I2S PLL clock and dividers. Unfortunately we have no means
-		 // to measure it internally. So we can only start with a nominal value calculated by assuming the HSE clock crystal
-		 // has 0ppm accuracy, and calculate the Fs frequency generated by the PLLI2S N, R, I2SDIV and ODD register values.
-		 // We then modify this nominal feedback frequency by the deviation from the ideal write pointer position wrt the read
-		 // pointer over time.
-		 // Need to multiply by at least a "PID k factor" of (1<<22) + 256 for a deviation of 1 sample to produce a change in feedback
-		 // as the internal fb value = (10.14) shifted 8bits in uint32_t.
-		 // We also should use the minimum "PID k factor" that keeps the write-pointer to read-pointer distance out of the
-		 // danger zone. This is to minimize the distortion caused by changes in host sampling frequency Fs.
-		uint64_t tmp = (uint64_t)((int32_t)(1<<22) + (audio_buf_writable_dev_from_nom_samples * 256));
-		uint64_t pid_k = ((uint64_t)fb_nom) * tmp;
-		fb_value = (uint32_t)(pid_k >> 22);
+		 // The feedback is ideally the true Fs generated by the I2S PLL clock and dividers. We start with a nominal value
+		 // calculated from the PLLI2S N, R, I2SDIV and ODD register values assuming the HSE clock crystal has 0ppm accuracy,
+		 // and correct it by the crystal error measured against the USB SOF (see USBD_AUDIO_Measure_Fs).
+		 // A PI controller on the low-pass filtered fill error then corrects this nominal value, in samples per frame.
+		 // The proportional term recentres the fill after host jitter or lost packets, the integral term removes the
+		 // remaining steady state offset, e.g. before the first crystal measurement is available.
+		float corr_max = (float)AUDIO_FB_DELTA_MAX / (float)(1<<22);
+		fb_integ += AUDIO_FB_KI * (float)(1U << SOF_RATE) * fb_err_lpf;
+		if (fb_integ > corr_max) fb_integ = corr_max;
+		if (fb_integ < -corr_max) fb_integ = -corr_max;
+		float corr = AUDIO_FB_KP * fb_err_lpf + fb_integ;
 		// Clamp feedback value to nominal value +/- 1kHz
-		if (fb_value > fb_nom +  AUDIO_FB_DELTA_MAX) {
-			fb_value = fb_nom +  AUDIO_FB_DELTA_MAX;
-			}
-		else
-		if (fb_value < fb_nom -  AUDIO_FB_DELTA_MAX) {
-			fb_value = fb_nom -  AUDIO_FB_DELTA_MAX;
-			}
+		if (corr > corr_max) corr = corr_max;
+		if (corr < -corr_max) corr = -corr_max;
+#ifdef USE_AUDIO_ASRC
+		// The feedback stays at the nominal rate, which the hosts that ignore it send anyway. The correction steers
+		// the resampler instead : a fill above the setpoint consumes the samples faster.
+		AUDIO_ASRC_SetRatio(&haudio->asrc, (uint32_t)((int32_t)fb_nom + (int32_t)(corr * (float)(1<<22))), asrc_out_nom);
+#else
+		// A fill above the setpoint asks the host for fewer samples
+		fb_value = (uint32_t)((int32_t)fb_nom - (int32_t)(corr * (float)(1<<22)));
+#endif
 
 		#ifdef DEBUG_FEEDBACK_ENDPOINT
 		if (audio_buf_writable_samples != audio_buf_writable_samples_last) {
@@ -631,10 +1340,8 @@ static uint8_t USBD_AUDIO_SOF(USBD_HandleTypeDef* pdev)
 
     /* Transmit feedback only when the last one is transmitted */
     if (tx_flag == 0U) {
-      /* Get FNSOF. Use volatile for fnsof_new since its address is mapped to a hardware register. */
-      USB_OTG_GlobalTypeDef* USBx = USB_OTG_FS;
-      uint32_t USBx_BASE = (uint32_t)USBx;
-      uint32_t volatile fnsof_new = (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
+      /* Get FNSOF of the current frame */
+      uint32_t fnsof_new = USBD_LL_GetFrameNumber(pdev);
 
       if ((fnsof & 0x1) == (fnsof_new & 0x1)) {
         USBD_LL_Transmit(pdev, AUDIO_IN_EP, (uint8_t*)fb_data, 3U);
@@ -644,19 +1351,314 @@ static uint8_t USBD_AUDIO_SOF(USBD_HandleTypeDef* pdev)
     }
   }
 
+  PROFILE_EXIT(PROFILE_SOF);
   return USBD_OK;
 }
 
 
+/**
+  * @brief  USBD_AUDIO_Measure_Fs
+  *         Measure the crystal error against the host USB frame clock, called on every SOF.
+  *         TIM2 latches its counter on each SOF in hardware, so the ticks counted over AUDIO_FS_MEAS_FRAMES
+  *         frames give the true Fs generated by PLLI2S with the same resolution as the 10.14 feedback format.
+  * @param  pdev: device instance
+  */
+static void USBD_AUDIO_Measure_Fs(USBD_HandleTypeDef* pdev)
+{
+  uint32_t capture = BSP_SOF_TIM_GetCapture();
+  uint32_t frame = USBD_LL_GetFrameNumber(pdev);
+  uint32_t frames = (frame - fs_meas_frame_start) & 0x7FFU;
+
+  if (frames >= AUDIO_FS_MEAS_FRAMES) {
+    uint32_t ticks = capture - fs_meas_capture_start;
+    uint32_t nominal = frames * BSP_SOF_TIM_GetTicksPerFrame();
+
+    // Discard the window if the timer is not running, an SOF was missed by the host or
+    // the frame number was reset by a bus reset. The crystal error is well within +/-1000ppm.
+    if (nominal != 0U && ticks > nominal - nominal/1000U && ticks < nominal + nominal/1000U) {
+      fs_meas_ticks = ticks;
+      fs_meas_nominal = nominal;
+#ifdef USE_AUDIO_ASRC
+      asrc_out_nom = USBD_AUDIO_Fb_Nominal(asrc_out_pll);
+#else
+      fb_nom = USBD_AUDIO_Fb_Nominal(fb_pll);
+#endif
+      }
+    fs_meas_capture_start = capture;
+    fs_meas_frame_start = frame;
+    }
+}
+
+
+/**
+  * @brief  USBD_AUDIO_Fb_Nominal
+  *         Correct the PLLI2S nominal feedback value by the measured crystal error
+  * @param  fb_pll: nominal feedback value assuming a 0ppm crystal
+  * @retval feedback value for the measured Fs
+  */
+static uint32_t USBD_AUDIO_Fb_Nominal(uint32_t fb_pll)
+{
+  if (fs_meas_nominal == 0U) {
+    return fb_pll;
+    }
+  return (uint32_t)(((uint64_t)fb_pll * fs_meas_ticks) / fs_meas_nominal);
+}
+
+
+/**
+  * @brief  AUDIO_OUT_UpdateRdPtr
+  *         Read the position of the sample being played into haudio->rd_ptr
+  * @param  haudio: audio class handle
+  */
+static void AUDIO_OUT_UpdateRdPtr(USBD_AUDIO_HandleTypeDef* haudio)
+{
+#ifdef USE_I2S_DOUBLE_BUFFER
+  // position of the sample being played, the period buffer was copied from haudio->period_ptr[target]
+  uint8_t target;
+  uint32_t remaining = BSP_AUDIO_OUT_GetRemainingPeriodSize(&target);
+  uint32_t played = AUDIO_PERIOD_BUF_SIZE - remaining;
+#ifdef AUDIO_OUT_PERIOD_RESAMPLED
+  if (haudio->period_len[target] != AUDIO_PERIOD_BUF_SIZE) {
+    // the input samples of the period are spread evenly over its output samples
+    played = 4U*((haudio->period_len[target]/4U) * played / AUDIO_PERIOD_BUF_SIZE);
+  }
+#endif
+  haudio->rd_ptr = (haudio->period_ptr[target] + played) % haudio->buf_size;
+#else
+  haudio->rd_ptr = haudio->buf_size - BSP_AUDIO_OUT_GetRemainingDataSize();
+#endif
+}
+
+
+/**
+  * @brief  AUDIO_OUT_GuardPtr
+  *         First sample of the audio transfer buffer that the DMA has not fetched yet
+  * @param  haudio: audio class handle
+  * @retval buffer index, multiple of 4
+  */
+static uint32_t AUDIO_OUT_GuardPtr(USBD_AUDIO_HandleTypeDef* haudio)
+{
+#ifdef USE_I2S_DOUBLE_BUFFER
+  // the samples up to copy_ptr are already in the period buffers
+  return haudio->copy_ptr;
+#else
+  return ((haudio->rd_ptr & ~3U) + AUDIO_CONCEAL_DMA_GUARD) % haudio->buf_size;
+#endif
+}
+
+
+/**
+  * @brief  AUDIO_OUT_Synthesize
+  *         Packet loss concealment, called on each SOF while playing. When no packet was received in the last frame,
+  *         the samples of the lost packet are synthesized by repeating the last packet, crossfaded with the samples
+  *         before it. USBD_AUDIO_Process() crossfades the next samples received with the repetition. The write index
+  *         advances by the samples the host would have sent, so it stays on its nominal trajectory.
+  * @param  haudio: audio class handle
+  * @param  fill: buffer fill in halfwords
+  * @retval buffer fill after the synthesis
+  */
+// Longer gaps are not synthesized, the repeated packet would become a tone. The samples are only written while
+// USBD_AUDIO_Process() is idle, see AUDIO_OUT_Conceal().
+static int32_t AUDIO_OUT_Synthesize(USBD_AUDIO_HandleTypeDef* haudio, int32_t fill)
+{
+  if (haudio->rx_frame) {
+    haudio->rx_frame = 0U;
+    haudio->missed = 0U;
+    return fill;
+  }
+  haudio->frames_missed++;
+  haudio->missed++;
+  // after an underrun or in the pre-roll the last samples are silence, see AUDIO_OUT_Conceal()
+  if (haudio->missed > AUDIO_PLC_MAX_FRAMES || haudio->starved) {
+    return fill;
+  }
+
+  // samples the host would have sent at the feedback rate
+  uint32_t frac = plc_frac + (fb_value & ((1U << 22) - 1U));
+  uint32_t n = (fb_value >> 22) + (frac >> 22);
+  plc_frac = frac & ((1U << 22) - 1U);
+
+  uint32_t size = haudio->buf_size;
+  int32_t guard = (int32_t)((AUDIO_OUT_GuardPtr(haudio) + size - (haudio->rd_ptr & ~3U)) % size);
+  // the samples repeated have not been played, and there is room for the new ones
+  if (fill < guard + (int32_t)(4U * (n + AUDIO_PLC_XFADE_SAMPLES)) || fill + (int32_t)(8U * n) > (int32_t)size ||
+      AUDIO_FIFO_Count(&haudio->fifo) != 0U) {
+    return fill;
+  }
+
+  uint32_t wr = haudio->wr_ptr;
+  if (haudio->missed == 1U) {
+    haudio->plc_period = (uint16_t)n;
+    AUDIO_Convert_Repeat(haudio->buffer, wr, n, n, size);
+    // from the last samples received to the repetition
+    AUDIO_Convert_Crossfade(haudio->buffer, (wr + size - 4U*AUDIO_PLC_XFADE_SAMPLES) % size, AUDIO_PLC_XFADE_SAMPLES,
+        n, 0U, AUDIO_PLC_XFADE_SAMPLES, 0U, size);
+  } else {
+    // continue the repetition
+    AUDIO_Convert_Repeat(haudio->buffer, wr, n, haudio->plc_period, size);
+  }
+  haudio->wr_ptr = (uint16_t)((wr + 4U*n) % size);
+  // USBD_AUDIO_Process() moves conv_ptr past the synthesized samples, then starts the crossfade
+  haudio->skip += 4U*n;
+  haudio->plc++;
+  haudio->frames_concealed++;
+  LOG("audio : lost packet %u synthesized, %u samples\r\n", haudio->missed, n);
+  return fill + (int32_t)(4U * n);
+}
+
+
+/**
+  * @brief  AUDIO_OUT_Conceal
+  *         Conceal an underrun or an overrun of the audio transfer buffer, called on each SOF while playing.
+  *         Underrun : the samples left are faded out and the rest of the buffer is silenced, so that the DMA
+  *         plays silence instead of the stale contents for as long as the host does not send samples.
+  *         Overrun : the samples beyond the setpoint are dropped, the samples kept end with a fade out.
+  *         In both cases the write index restarts at the setpoint and the next samples are faded in.
+  * @param  haudio: audio class handle
+  * @param  fill: buffer fill in halfwords, negative after an underrun, above haudio->buf_size after an overrun
+  * @retval buffer fill after the concealment
+  */
+// Both cases are handled before the DMA reaches stale samples or USBD_AUDIO_Process() overwrites unplayed ones,
+// i.e. when less than a frame of samples is left. The circular DMA cannot skip, so the splice is always made on
+// the write side. USBD_AUDIO_Process() owns the part of the buffer it is writing, so nothing is done while
+// samples are waiting in the FIFO, they are converted right after this interrupt.
+static int32_t AUDIO_OUT_Conceal(USBD_AUDIO_HandleTypeDef* haudio, int32_t fill)
+{
+  uint32_t size = haudio->buf_size;
+  // halfwords played or received in a frame, plus one sample for the DMA position within a sample
+  int32_t margin = (int32_t)(4U * ((fb_nom >> 22) + 2U));
+  uint32_t rd = haudio->rd_ptr & ~3U;
+  uint32_t start = AUDIO_OUT_GuardPtr(haudio);
+  int32_t guard = (int32_t)((start + size - rd) % size);
+
+  if ((fill >= guard + margin && fill <= (int32_t)size - margin) || AUDIO_FIFO_Count(&haudio->fifo) != 0U) {
+    return fill;
+  }
+
+  // new write index at the setpoint
+  uint32_t wr = ((rd + size/2U) % size) & ~3U;
+
+  if (fill < guard + margin) {
+    if (haudio->starved == 0U) {
+      haudio->starved = 1U;
+      haudio->underruns++;
+      LOG("audio : underrun, fill %d halfwords\r\n", fill);
+    }
+    uint32_t tail = 0U;
+    if (fill > guard) {
+      tail = (haudio->wr_ptr + size - start) % size;
+      AUDIO_Convert_FadeOut(haudio->buffer, start, tail/4U, size);
+    }
+    // up to the read position, the DMA plays silence after the faded samples
+    AUDIO_Convert_Silence(haudio->buffer, (start + tail) % size, (size - (uint32_t)guard - tail)/4U, size);
+  } else {
+    haudio->overruns++;
+    LOG("audio : overrun, fill %d halfwords\r\n", fill);
+    // the samples kept end at the setpoint, USBD_AUDIO_Process() overwrites the ones beyond
+    AUDIO_Convert_FadeOut(haudio->buffer, (wr + size - 4U*AUDIO_CONCEAL_FADE_SAMPLES) % size, AUDIO_CONCEAL_FADE_SAMPLES, size);
+  }
+
+  haudio->skip += (wr + size - haudio->wr_ptr) % size;
+  haudio->wr_ptr = (uint16_t)wr;
+  AUDIO_Volume_FadeIn(&haudio->vol);
+  return (int32_t)((wr + size - haudio->rd_ptr) % size);
+}
+
+
 /**
   * @brief  USBD_AUDIO_Sync
   *         handle Sync event called from usbd_audio_if.c
+  *         In DMA double buffer mode, AUDIO_OFFSET_HALF reports that period buffer 0 was played and
+  *         AUDIO_OFFSET_FULL that period buffer 1 was played, it is refilled with the next period.
   * @param  pdev: device instance
   * @retval status
   */
 void USBD_AUDIO_Sync(USBD_HandleTypeDef* pdev, AUDIO_OffsetTypeDef offset)
 {
+#ifdef USE_I2S_DOUBLE_BUFFER
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+  if (haudio == NULL || haudio->rd_enable == 0U) {
+    return;
+    }
+  AUDIO_OUT_CopyPeriod(haudio, offset == AUDIO_OFFSET_HALF ? 0U : 1U);
+#endif
+}
+
+
+#ifdef USE_I2S_DOUBLE_BUFFER
+/**
+  * @brief  Copy the next period of the audio transfer buffer into an I2S DMA period buffer
+  * @param  haudio: audio class handle
+  * @param  target: period buffer 0 or 1, not being played
+  */
+// The audio transfer buffer remains the jitter buffer that the feedback regulates, the period buffers only
+// decouple the DMA transfer size from its size. rd_ptr is the sample being played, so the buffer fill
+// includes the samples already copied to the period buffers.
+static void AUDIO_OUT_CopyPeriod(USBD_AUDIO_HandleTypeDef* haudio, uint32_t target)
+{
+  AUDIO_OUT_FillPeriod(haudio, target);
+#ifdef USE_AUDIO_CROSSOVER
+  // The second output switched to its other period buffer on the same frame, it is refilled with the tweeters
+  PROFILE_ENTER();
+  AUDIO_Crossover_Process(&haudio->xover, haudio->period[target], haudio->period[2U + target], AUDIO_OUT_PERIOD_SAMPLES);
+  PROFILE_EXIT(PROFILE_CROSSOVER);
+#endif
+}
+
+
+/**
+  * @brief  Copy, resample or upsample the next period of the audio transfer buffer, see AUDIO_OUT_CopyPeriod()
+  * @param  haudio: audio class handle
+  * @param  target: period buffer 0 or 1, not being played
+  */
+static void AUDIO_OUT_FillPeriod(USBD_AUDIO_HandleTypeDef* haudio, uint32_t target)
+{
+#ifdef USE_AUDIO_ASRC
+  // The period is resampled from the stream rate instead of copied. copy_ptr is the next sample to enter the history
+  // of the resampler, the samples before it may have been read. period_len lets USBD_AUDIO_SOF() place rd_ptr.
+  PROFILE_ENTER();
+  uint32_t start = haudio->copy_ptr;
+  uint32_t ptr = AUDIO_ASRC_Process(&haudio->asrc, haudio->period[target], AUDIO_OUT_PERIOD_SAMPLES,
+      haudio->buffer, start, haudio->buf_size);
+  haudio->period_ptr[target] = (uint16_t)start;
+  haudio->period_len[target] = (uint16_t)((ptr + haudio->buf_size - start) % haudio->buf_size);
+  haudio->copy_ptr = (uint16_t)ptr;
+  PROFILE_EXIT(PROFILE_ASRC);
+#else
+#ifdef USE_AUDIO_UPSAMPLE
+  if (haudio->ups.factor > 1U) {
+    // Each sample of the stream gives two samples of the period, see audio_upsample.h
+    PROFILE_ENTER();
+    uint32_t start = haudio->copy_ptr;
+    uint32_t ptr = AUDIO_Upsample_Process(&haudio->ups, haudio->period[target], AUDIO_OUT_PERIOD_SAMPLES,
+        haudio->buffer, start, haudio->buf_size);
+    haudio->period_ptr[target] = (uint16_t)start;
+    haudio->period_len[target] = (uint16_t)(AUDIO_PERIOD_BUF_SIZE / 2U);
+    haudio->copy_ptr = (uint16_t)ptr;
+    PROFILE_EXIT(PROFILE_UPSAMPLE);
+    return;
+    }
+  haudio->period_len[target] = AUDIO_PERIOD_BUF_SIZE;
+#endif
+  uint32_t ptr = haudio->copy_ptr;
+  uint32_t len = haudio->buf_size - ptr;
+  if (len > AUDIO_PERIOD_BUF_SIZE) {
+    len = AUDIO_PERIOD_BUF_SIZE;
+    }
+  USBD_memcpy(haudio->period[target], &haudio->buffer[ptr], len * 2U);
+  if (len < AUDIO_PERIOD_BUF_SIZE) {
+    USBD_memcpy(&haudio->period[target][len], &haudio->buffer[0], (AUDIO_PERIOD_BUF_SIZE - len) * 2U);
+    }
+  haudio->period_ptr[target] = (uint16_t)ptr;
+  ptr += AUDIO_PERIOD_BUF_SIZE;
+  if (ptr >= haudio->buf_size) {
+    ptr -= haudio->buf_size;
+    }
+  haudio->copy_ptr = (uint16_t)ptr;
+#endif
 }
+#endif
 
 /**
  * !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -678,15 +1680,22 @@ void USBD_AUDIO_Sync(USBD_HandleTypeDef* pdev, AUDIO_OffsetTypeDef offset)
   */
 static uint8_t USBD_AUDIO_IsoINIncomplete(USBD_HandleTypeDef* pdev, uint8_t epnum)
 {
-  USB_OTG_GlobalTypeDef* USBx = USB_OTG_FS;
-  uint32_t USBx_BASE = (uint32_t)USBx;
-  fnsof = (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
+  fnsof = USBD_LL_GetFrameNumber(pdev);
 
   if (tx_flag == 1U) {
     tx_flag = 0U;
     USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
   }
 
+#ifdef USE_AUDIO_CAPTURE
+  /* A capture packet armed for a frame that has ended was not read, it is armed for the next frame at SOF.
+     The packet armed in this frame is for the next one. */
+  if (capture_tx_busy == 1U && ((fnsof - capture_tx_frame) & 0x7FFU) != 0U) {
+    capture_tx_busy = 0U;
+    USBD_LL_FlushEP(pdev, AUDIO_CAPTURE_EP);
+  }
+#endif
+
   return USBD_OK;
 }
 
@@ -700,40 +1709,36 @@ static uint8_t USBD_AUDIO_IsoINIncomplete(USBD_HandleTypeDef* pdev, uint8_t epnu
 // Fix suggested by Andrew to restart audio (fix Windows problem ?)
 static uint8_t USBD_AUDIO_IsoOutIncomplete(USBD_HandleTypeDef* pdev, uint8_t epnum){
 	UNUSED(epnum);
-	USBD_AUDIO_HandleTypeDef *haudio;
-	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
 	USBD_LL_FlushEP(pdev, AUDIO_OUT_EP);
 
 	/* Prepare Out endpoint to receive next audio packet */
-	(void)USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, (uint8_t *)&haudio->buffer[haudio->wr_ptr], AUDIO_OUT_PACKET_24B);
+	USBD_AUDIO_PrepareReceive(pdev);
 
 	return (uint8_t)USBD_OK;
 	}
 
 
-typedef  union UN32_ {
-	uint8_t b[4];
-	int32_t s;
-} UN32;
-
-// ref : https://www.microchip.com/forums/m932509.aspx
-
-inline int32_t USBD_AUDIO_Volume_Ctrl(int32_t sample, int32_t shift_3dB){
-	int32_t sample_atten = sample;
-	int32_t shift_6dB = shift_3dB>>1;
+/**
+  * @brief  USBD_AUDIO_PrepareReceive
+  *         Arm the OUT endpoint. The OTG RX FIFO is drained straight into the staging FIFO at its write index,
+  *         and USBD_AUDIO_DataOut() commits the packet. If the staging FIFO cannot take a full size packet,
+  *         the packet is received into USBD_AUDIO_RxBuf and dropped.
+  * @param  pdev: device instance
+  */
+static void USBD_AUDIO_PrepareReceive(USBD_HandleTypeDef* pdev){
+	USBD_AUDIO_HandleTypeDef* haudio;
+	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
-	if (shift_3dB & 1) {
-	    // shift_3dB is odd, implement 6dB shift and compensate
-	    shift_6dB++;
-        sample_atten >>= shift_6dB;
-        sample_atten += (sample_atten>>1);
-	    }
-	else{
-	    // shift_3dB is even, implement with 6dB shift
-	    sample_atten >>= shift_6dB;
+	uint32_t packet_size = haudio != NULL && haudio->bit_depth == 16U ? AUDIO_OUT_PACKET_16B : AUDIO_OUT_PACKET_24B;
+	if (haudio != NULL && AUDIO_FIFO_Free(&haudio->fifo) >= packet_size) {
+		rx_to_fifo = 1U;
+		(void)USBD_LL_PrepareReceiveRing(pdev, AUDIO_OUT_EP, haudio->fifo.data, AUDIO_FIFO_SIZE, haudio->fifo.wr, packet_size);
+		}
+	else {
+		rx_to_fifo = 0U;
+		(void)USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, USBD_AUDIO_RxBuf, AUDIO_OUT_PACKET_24B);
 		}
-	return sample_atten;
 	}
 
 
@@ -745,22 +1750,26 @@ inline int32_t USBD_AUDIO_Volume_Ctrl(int32_t sample, int32_t shift_3dB){
   * @retval status
   */
 // incoming USB audio data buffer : uint8_t array
-// Each 24bit stereo sample is encoded as : L channel 3bytes + R channel 3bytes, LSbyte first
+// Each 24bit stereo sample (alt setting 1) is encoded as : L channel 3bytes + R channel 3bytes, LSbyte first
 // b0:lo_L, b1:mid_L, b2:hi_L, b3:lo_R, b4:mid_R, b5:hi_R
+// Each 16bit stereo sample (alt setting 2) is encoded as : L channel 2bytes + R channel 2bytes, LSbyte first
 
-// volume control is implemented by scaling the data, attenuation resolution is 3dB.
-// 6dB is equivalent to a shift right by 1 bit.
-
-// outgoing I2S Philips data format is : left-aligned 24bits in 32bit frame, MSbyte first
-// STM32 I2S peripheral uses a 16bit data register
-// => outgoing I2S transmit data buffer : uint16_t array
-// Each I2S stereo sample is encoded as {hi_L:mid_L}, {lo_L:0x00}, {hi_R:mid_R}, {lo_R:0x00}
+// The packet was received directly into the staging FIFO, it is only committed here. The conversion to the I2S format
+// and the volume control run later in USBD_AUDIO_Process(), at a lower priority, so that they do not delay
+// the SOF feedback update and the control transfers.
+// haudio->wr_ptr is advanced as if the samples had already been written to the I2S buffer, so the SOF buffer
+// fill includes the samples still waiting in the FIFO.
 
 static uint8_t USBD_AUDIO_DataOut(USBD_HandleTypeDef* pdev,  uint8_t epnum){
 	USBD_AUDIO_HandleTypeDef* haudio;
 	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
-	static uint8_t tmpbuf[1024];
+#ifdef USE_USB_CDC_TELEMETRY
+	if (epnum == CDC_ACM_OUT_EP) {
+		return USBD_CDC_ACM_DataOut(pdev, epnum);
+		}
+#endif
+	PROFILE_ENTER();
 
 	if (all_ready == 1U && epnum == AUDIO_OUT_EP) {
 		uint32_t curr_length = USBD_GetRxCount(pdev, epnum);
@@ -768,60 +1777,151 @@ static uint8_t USBD_AUDIO_DataOut(USBD_HandleTypeDef* pdev,  uint8_t epnum){
 		if (curr_length > AUDIO_OUT_PACKET_24B) {
 			curr_length = 0U;
 			}
+		// no packet loss concealment for this frame, see AUDIO_OUT_Synthesize()
+		if (curr_length) {
+			haudio->rx_frame = 1U;
+			}
 
-		uint32_t tmpbuf_ptr = 0U;
-		uint32_t num_samples = curr_length / 6; // 3bytes per sample
-
-		for (int i = 0; i < num_samples; i++) {
-			UN32 sample;
-			sample.b[0] = tmpbuf[tmpbuf_ptr]; // lsb
-			sample.b[1] = tmpbuf[tmpbuf_ptr+1];
-			sample.b[2] = tmpbuf[tmpbuf_ptr+2]; // msb
-			sample.b[3] = sample.b[2] & 0x80 ? 0xFF : 0x00; // sign extend to 32bits
-			sample.s = USBD_AUDIO_Volume_Ctrl(sample.s,haudio->vol_3dB_shift);
+		uint32_t sample_bytes = AUDIO_SAMPLE_BYTES(haudio->bit_depth);
+		uint32_t num_samples = curr_length / sample_bytes;
+		if (num_samples && rx_to_fifo == 0U) {
+			haudio->fifo.overflows++;
+			num_samples = 0U;
+			}
+		if (num_samples) {
+			// ends an underrun or the pre-roll, the samples are faded in after the silence
+			if (haudio->starved) {
+				AUDIO_OUT_Unstarve(haudio);
+				haudio->starved = 0U;
+				}
+			// first sample of the new stream, see AUDIO_OUT_SwitchMeasure()
+			if (haudio->sw_measure && haudio->sw_first_set == 0U) {
+				haudio->sw_first = haudio->wr_ptr;
+				haudio->sw_first_set = 1U;
+				}
+			// a partial sample at the end of a malformed packet is overwritten by the next packet
+			AUDIO_FIFO_Commit(&haudio->fifo, num_samples*sample_bytes);
+			haudio->wr_ptr += num_samples*4;
+			// Rollover at end of buffer
+			if (haudio->wr_ptr >= haudio->buf_size) {
+				haudio->wr_ptr -= haudio->buf_size;
+				}
+			// Schedule USBD_AUDIO_Process()
+			((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->PeriodicTC(AUDIO_CMD_PLAY);
+			}
 
-			haudio->buffer[haudio->wr_ptr++] = (((uint16_t)sample.b[2]) << 8) | (uint16_t)sample.b[1];
-			haudio->buffer[haudio->wr_ptr++] = ((uint16_t)sample.b[0]) << 8;
+		USBD_AUDIO_PrepareReceive(pdev);
+		}
 
-			sample.b[0] = tmpbuf[tmpbuf_ptr+3]; // lsb
-			sample.b[1] = tmpbuf[tmpbuf_ptr+4];
-			sample.b[2] = tmpbuf[tmpbuf_ptr+5]; // msb
-			sample.b[3] = sample.b[2] & 0x80 ? 0xFF : 0x00; // sign extend to 32bits
+	PROFILE_EXIT(PROFILE_DATAOUT);
+	return USBD_OK;
+	}
 
-			sample.s = USBD_AUDIO_Volume_Ctrl(sample.s,haudio->vol_3dB_shift);
 
-			haudio->buffer[haudio->wr_ptr++] = (((uint16_t)sample.b[2]) << 8) | (uint16_t)sample.b[1];
-			haudio->buffer[haudio->wr_ptr++] = ((uint16_t)sample.b[0]) << 8;
+/**
+  * @brief  USBD_AUDIO_Process
+  *         Convert the staged packets and write them to the I2S buffer.
+  *         Called at a lower priority than the OTG interrupt, see Audio_PeriodicTC() in usbd_audio_if.c
+  * @param  pdev: device instance
+  */
+// outgoing I2S Philips data format is : left-aligned 24bits in 32bit frame, MSbyte first
+// STM32 I2S peripheral uses a 16bit data register
+// => outgoing I2S transmit data buffer : uint16_t array
+// Each I2S stereo sample is encoded as {hi_L:mid_L}, {lo_L:0x00}, {hi_R:mid_R}, {lo_R:0x00}
 
-			tmpbuf_ptr += 6;
+// volume control is implemented by scaling the data with a Q31 gain, attenuation resolution is 0.5dB.
 
-			// Rollover at end of buffer
-			if (haudio->wr_ptr >= AUDIO_TOTAL_BUF_SIZE) {
-				haudio->wr_ptr = 0U;
-				}
-			}
+// The OTG interrupt may preempt this function and flush the FIFO (AUDIO_OUT_StopAndReset). The flush is
+// picked up after each block, and the few stale samples already written are overwritten by the new stream
+// before the DMA reaches them. The write index moves of the underrun/overrun concealment are picked up the same way.
 
-		// Start playing when half of the audio buffer is filled
-		// so if you increase the buffer length too much, the audio latency will be obvious when watching video+audio
-		if (haudio->offset == AUDIO_OFFSET_UNKNOWN && is_playing == 0U) {
-			if (haudio->wr_ptr >= AUDIO_TOTAL_BUF_SIZE / 2U) {
-				haudio->offset = AUDIO_OFFSET_NONE;
-				is_playing = 1U;
+void USBD_AUDIO_Process(USBD_HandleTypeDef* pdev){
+	USBD_AUDIO_HandleTypeDef* haudio;
+	haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+	if (haudio == NULL) {
+		return;
+		}
 
-				if (haudio->rd_enable == 0U) {
-					haudio->rd_enable = 1U;
-					// Set last writable buffer size to actual value. Note that rd_ptr is 0 now.
-					audio_buf_writable_samples_last = (AUDIO_TOTAL_BUF_SIZE - haudio->wr_ptr)/6;
-					}
+	AUDIO_OUT_ConvSync(haudio);
 
-				((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->AudioCmd(&haudio->buffer[0], AUDIO_TOTAL_BUF_SIZE * 2, AUDIO_CMD_START);
-				}
+	const uint8_t* src;
+	uint32_t len;
+	while ((len = AUDIO_FIFO_Peek(&haudio->fifo, &src)) != 0U) {
+		uint32_t start = haudio->conv_ptr;
+		uint32_t num_samples = len / AUDIO_SAMPLE_BYTES(haudio->bit_depth);
+		// see drivers/dsp/audio_convert.c. A change of bit depth always flushes the FIFO.
+		if (haudio->bit_depth == 16U) {
+			haudio->conv_ptr = AUDIO_Convert_16b(src, len/4, haudio->buffer, haudio->conv_ptr, haudio->buf_size, &haudio->vol);
+			}
+		else {
+			haudio->conv_ptr = AUDIO_Convert_24b(src, len/6, haudio->buffer, haudio->conv_ptr, haudio->buf_size, &haudio->vol);
+			}
+#ifdef USE_AUDIO_EQ
+		// in place on the converted samples, before the crossfade that mixes them with samples already equalized
+		AUDIO_EQ_Process(&haudio->eq, haudio->buffer, start, num_samples, haudio->buf_size);
+#endif
+#ifdef USE_AUDIO_CROSSFEED
+		{
+		// cycles per packet, see profile.h
+		PROFILE_ENTER();
+		AUDIO_Crossfeed_Process(&haudio->xfeed, haudio->buffer, start, num_samples, haudio->buf_size);
+		PROFILE_EXIT(PROFILE_CROSSFEED);
+		}
+#endif
+		// from the synthesized samples to the samples received, see AUDIO_OUT_Synthesize()
+		if (haudio->xfade_left) {
+			uint32_t n = haudio->xfade_left < num_samples ? haudio->xfade_left : num_samples;
+			AUDIO_Convert_Crossfade(haudio->buffer, start, n, haudio->xfade_period, AUDIO_PLC_XFADE_SAMPLES - haudio->xfade_left,
+				AUDIO_PLC_XFADE_SAMPLES, 1U, haudio->buf_size);
+			haudio->xfade_left -= n;
 			}
+#ifdef USE_AUDIO_VERIFY
+		// the samples as they will be played, see audio_verify.h
+		AUDIO_Verify_Process(&haudio->verify, haudio->buffer, start, num_samples, haudio->buf_size);
+#endif
+		AUDIO_FIFO_Release(&haudio->fifo, len);
 
-		USBD_LL_PrepareReceive(pdev, AUDIO_OUT_EP, tmpbuf, AUDIO_OUT_PACKET_24B);
+		AUDIO_OUT_ConvSync(haudio);
 		}
+	}
 
-	return USBD_OK;
+
+/**
+  * @brief  AUDIO_OUT_ConvSync
+  *         Apply the write index changes made by the OTG interrupt to conv_ptr : a FIFO flush restarts at 0,
+  *         a concealment moves the write index, see AUDIO_OUT_Conceal() and AUDIO_OUT_Synthesize()
+  * @param  haudio: audio class handle
+  */
+static void AUDIO_OUT_ConvSync(USBD_AUDIO_HandleTypeDef* haudio){
+	uint32_t skip, plc;
+	// the OTG interrupt updates skip before plc, read them again if it ran in between
+	do {
+		skip = haudio->skip;
+		plc = haudio->plc;
+		} while (skip != haudio->skip);
+
+	if (AUDIO_FIFO_Flushed(&haudio->fifo)) {
+		haudio->conv_ptr = 0U;
+#ifdef USE_AUDIO_EQ
+		AUDIO_EQ_Reset(&haudio->eq);
+#endif
+#ifdef USE_AUDIO_CROSSFEED
+		AUDIO_Crossfeed_Reset(&haudio->xfeed);
+#endif
+		haudio->skip_seen = skip;
+		haudio->plc_seen = plc;
+		haudio->xfade_left = 0U;
+		return;
+		}
+	if (skip != haudio->skip_seen) {
+		haudio->conv_ptr = (uint16_t)((haudio->conv_ptr + (skip - haudio->skip_seen)) % haudio->buf_size);
+		haudio->skip_seen = skip;
+		}
+	if (plc != haudio->plc_seen) {
+		haudio->plc_seen = plc;
+		haudio->xfade_period = haudio->plc_period;
+		haudio->xfade_left = AUDIO_PLC_XFADE_SAMPLES;
+		}
 	}
 
 
@@ -849,6 +1949,16 @@ static void AUDIO_REQ_GetCurrent(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef*
         USBD_CtlSendData(pdev, (uint8_t*)&haudio->volume, 2);
       };
           break;
+#ifdef USE_AUDIO_EQ
+      case AUDIO_CONTROL_REQ_FU_BASS:
+      case AUDIO_CONTROL_REQ_FU_TREBLE:
+      case AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ: {
+        // Current tone and graphic EQ gains, sent from control.data which outlives the request
+        uint16_t len = AUDIO_REQ_GetEq(haudio, HIBYTE(req->wValue), AUDIO_REQ_GET_CUR, haudio->control.data);
+        USBD_CtlSendData(pdev, haudio->control.data, MIN(len, req->wLength));
+      };
+          break;
+#endif
     }
   } else if ((req->bmRequest & 0x1f) == AUDIO_STREAMING_REQ) {
     if (HIBYTE(req->wValue) == AUDIO_STREAMING_REQ_FREQ_CTRL) {
@@ -876,6 +1986,16 @@ static void AUDIO_REQ_GetMax(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req
         USBD_CtlSendData(pdev, (uint8_t*)&vol_max, 2);
       };
           break;
+#ifdef USE_AUDIO_EQ
+      case AUDIO_CONTROL_REQ_FU_BASS:
+      case AUDIO_CONTROL_REQ_FU_TREBLE:
+      case AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ: {
+        USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+        uint16_t len = AUDIO_REQ_GetEq(haudio, HIBYTE(req->wValue), AUDIO_REQ_GET_MAX, haudio->control.data);
+        USBD_CtlSendData(pdev, haudio->control.data, MIN(len, req->wLength));
+      };
+          break;
+#endif
     }
   }
 }
@@ -897,6 +2017,16 @@ static void AUDIO_REQ_GetMin(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req
         USBD_CtlSendData(pdev, (uint8_t*)&vol_min, 2);
       };
           break;
+#ifdef USE_AUDIO_EQ
+      case AUDIO_CONTROL_REQ_FU_BASS:
+      case AUDIO_CONTROL_REQ_FU_TREBLE:
+      case AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ: {
+        USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+        uint16_t len = AUDIO_REQ_GetEq(haudio, HIBYTE(req->wValue), AUDIO_REQ_GET_MIN, haudio->control.data);
+        USBD_CtlSendData(pdev, haudio->control.data, MIN(len, req->wLength));
+      };
+          break;
+#endif
     }
   }
 }
@@ -918,6 +2048,16 @@ static void AUDIO_REQ_GetRes(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req
         USBD_CtlSendData(pdev, (uint8_t*)&vol_res, 2);
       };
           break;
+#ifdef USE_AUDIO_EQ
+      case AUDIO_CONTROL_REQ_FU_BASS:
+      case AUDIO_CONTROL_REQ_FU_TREBLE:
+      case AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ: {
+        USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+        uint16_t len = AUDIO_REQ_GetEq(haudio, HIBYTE(req->wValue), AUDIO_REQ_GET_RES, haudio->control.data);
+        USBD_CtlSendData(pdev, haudio->control.data, MIN(len, req->wLength));
+      };
+          break;
+#endif
     }
   }
 }
@@ -951,6 +2091,108 @@ static void AUDIO_REQ_SetCurrent(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef*
 }
 
 
+#ifdef USE_AUDIO_EQ
+/**
+  * @brief  Tone control value of a band gain
+  * @param  gain: 1/256 dB
+  * @retval 1/4 dB
+  */
+static uint8_t AUDIO_REQ_ToneValue(int16_t gain)
+{
+  return (uint8_t)(int8_t)(gain / 64);
+}
+
+
+/**
+  * @brief  AUDIO_REQ_GetEq
+  *         Build the data of a GET request to the bass, treble or graphic EQ control
+  * @param  haudio: audio class handle
+  * @param  cs: control selector
+  * @param  cmd: AUDIO_REQ_GET_CUR, AUDIO_REQ_GET_MIN, AUDIO_REQ_GET_MAX or AUDIO_REQ_GET_RES
+  * @param  data: AUDIO_GRAPHIC_EQ_DATA_SIZE bytes
+  * @retval data length
+  */
+static uint16_t AUDIO_REQ_GetEq(USBD_AUDIO_HandleTypeDef* haudio, uint8_t cs, uint8_t cmd, uint8_t* data)
+{
+  uint32_t first = AUDIO_EQ_BAND_BASS;
+  uint32_t num = 1U;
+  uint16_t len = 0U;
+
+  if (cs == AUDIO_CONTROL_REQ_FU_TREBLE) {
+    first = AUDIO_EQ_BAND_TREBLE;
+  } else if (cs == AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ) {
+    uint32_t present = 0U;
+    for (uint32_t i = 0; i < AUDIO_EQ_GRAPHIC_BANDS; i++) {
+      present |= 1UL << (AUDIO_GRAPHIC_EQ_FIRST_BAND + i*AUDIO_GRAPHIC_EQ_BAND_STEP);
+    }
+    data[0] = (uint8_t)present;
+    data[1] = (uint8_t)(present >> 8);
+    data[2] = (uint8_t)(present >> 16);
+    data[3] = (uint8_t)(present >> 24);
+    len = 4U;
+    first = AUDIO_EQ_BAND_GRAPHIC;
+    num = AUDIO_EQ_GRAPHIC_BANDS;
+  }
+  for (uint32_t i = 0; i < num; i++) {
+    switch (cmd) {
+      case AUDIO_REQ_GET_MIN:
+        data[len++] = (uint8_t)USBD_AUDIO_TONE_MIN;
+        break;
+      case AUDIO_REQ_GET_MAX:
+        data[len++] = (uint8_t)USBD_AUDIO_TONE_MAX;
+        break;
+      case AUDIO_REQ_GET_RES:
+        data[len++] = (uint8_t)USBD_AUDIO_TONE_RES;
+        break;
+      default:
+        data[len++] = AUDIO_REQ_ToneValue(AUDIO_EQ_GetGain(&haudio->eq, first + i));
+        break;
+    }
+  }
+  return len;
+}
+
+
+/**
+  * @brief  AUDIO_REQ_SetEq
+  *         Apply the SET_CUR data received for the bass, treble or graphic EQ control, and design the EQ.
+  *         The graphic EQ bands that are not present in the device are ignored.
+  * @param  haudio: audio class handle
+  */
+static void AUDIO_REQ_SetEq(USBD_AUDIO_HandleTypeDef* haudio)
+{
+  const uint8_t* data = haudio->control.data;
+
+  if (haudio->control.cs == AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ) {
+    if (haudio->control.len < 4U) {
+      return;
+    }
+    uint32_t present = data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+    uint32_t pos = 4U;
+    // one byte per band present, in band order
+    for (uint32_t bit = 0; bit < 32U && pos < haudio->control.len; bit++) {
+      if ((present & (1UL << bit)) == 0U) {
+        continue;
+      }
+      int32_t value = (int8_t)data[pos++];
+      if (bit >= AUDIO_GRAPHIC_EQ_FIRST_BAND && (bit - AUDIO_GRAPHIC_EQ_FIRST_BAND) % AUDIO_GRAPHIC_EQ_BAND_STEP == 0U) {
+        uint32_t i = (bit - AUDIO_GRAPHIC_EQ_FIRST_BAND) / AUDIO_GRAPHIC_EQ_BAND_STEP;
+        if (i < AUDIO_EQ_GRAPHIC_BANDS) {
+          value = MAX(USBD_AUDIO_TONE_MIN, MIN(USBD_AUDIO_TONE_MAX, value));
+          AUDIO_EQ_SetGain(&haudio->eq, AUDIO_EQ_BAND_GRAPHIC + i, (int16_t)(value * 64));
+        }
+      }
+    }
+  } else {
+    int32_t value = MAX(USBD_AUDIO_TONE_MIN, MIN(USBD_AUDIO_TONE_MAX, (int8_t)data[0]));
+    uint32_t band = haudio->control.cs == AUDIO_CONTROL_REQ_FU_BASS ? AUDIO_EQ_BAND_BASS : AUDIO_EQ_BAND_TREBLE;
+    AUDIO_EQ_SetGain(&haudio->eq, band, (int16_t)(value * 64));
+  }
+  AUDIO_EQ_Design(&haudio->eq);
+}
+#endif
+
+
 /**
   * @brief  USBD_AUDIO_EP0_RxReady
   *         handle EP0 Rx Ready event
@@ -962,6 +2204,24 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
+#ifdef USE_AUDIO_EQ
+  if (haudio->control.req_type == USB_REQ_TYPE_VENDOR) {
+    // EQ band definition, the band index was checked in USBD_AUDIO_Setup(). An invalid definition is ignored.
+    AUDIO_EQ_BandTypeDef band;
+    USBD_memcpy(&band, haudio->control.data, sizeof(band));
+    if (AUDIO_EQ_SetBand(&haudio->eq, haudio->control.cn, &band) == 0U) {
+      AUDIO_EQ_Design(&haudio->eq);
+      LOG("eq : band %u type %u %u Hz Q %u/256 gain %d/256 dB, preamp %d/256 dB\r\n", haudio->control.cn, band.type,
+        band.freq, band.q, haudio->eq.band[haudio->control.cn].gain, haudio->eq.preamp);
+    }
+    haudio->control.req_type = 0U;
+    haudio->control.cn = 0U;
+    haudio->control.cmd = 0U;
+    haudio->control.len = 0U;
+    return USBD_OK;
+  }
+#endif
+
   if (haudio->control.cmd == AUDIO_REQ_SET_CUR) { /* In this driver, to simplify code, only SET_CUR request is managed */
 
     if (haudio->control.req_type == AUDIO_CONTROL_REQ) {
@@ -969,17 +2229,29 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
         // Mute Control
         case AUDIO_CONTROL_REQ_FU_MUTE: {
         	haudio->mute = haudio->control.data[0];
-          ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->MuteCtl(haudio->control.data[0]);
+          AUDIO_Volume_Set(&haudio->vol, haudio->volume, haudio->mute);
+          // a switch releases the DAC mute output after its pre-roll
+          if (haudio->sw_state == AUDIO_SWITCH_IDLE) {
+            ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->MuteCtl(haudio->control.data[0]);
+          }
         };
             break;
         // Volume Control
         case AUDIO_CONTROL_REQ_FU_VOL: {
           int16_t volume = *(int16_t*)&haudio->control.data[0];
           haudio->volume = volume;
-          haudio->vol_3dB_shift = USBD_AUDIO_Get_Vol3dB_Shift(volume);
+          AUDIO_Volume_Set(&haudio->vol, haudio->volume, haudio->mute);
           ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->VolumeCtl(volume);
         };
             break;
+#ifdef USE_AUDIO_EQ
+        // Bass, Treble and Graphic Equalizer Controls
+        case AUDIO_CONTROL_REQ_FU_BASS:
+        case AUDIO_CONTROL_REQ_FU_TREBLE:
+        case AUDIO_CONTROL_REQ_FU_GRAPHIC_EQ:
+          AUDIO_REQ_SetEq(haudio);
+          break;
+#endif
       }
 
     } else if (haudio->control.req_type == AUDIO_STREAMING_REQ) {
@@ -989,7 +2261,7 @@ static uint8_t USBD_AUDIO_EP0_RxReady(USBD_HandleTypeDef* pdev)
 
         if (haudio->freq != new_freq) {
           haudio->freq = new_freq;
-          AUDIO_OUT_Restart(pdev);
+          AUDIO_OUT_Switch(pdev);
         }
       }
     }
@@ -1030,7 +2302,13 @@ static void AUDIO_OUT_StopAndReset(USBD_HandleTypeDef* pdev)
   all_ready = 0U;
   tx_flag = 1U;
   is_playing = 0U;
-  audio_buf_writable_samples_last = AUDIO_TOTAL_BUF_SIZE /(2*6);
+  audio_buf_writable_samples_last = haudio->buf_size /(2*4);
+  sof_count = 0;
+  fb_err_lpf = 0.0f;
+  fb_integ = 0.0f;
+  fill_last = haudio->buf_size / 2U;
+  fill_sof = 0.0f;
+  plc_frac = 0;
 #ifdef DEBUG_FEEDBACK_ENDPOINT
   DbgMinWritableSamples = 99999;
   DbgMaxWritableSamples = 0;
@@ -1041,16 +2319,25 @@ static void AUDIO_OUT_StopAndReset(USBD_HandleTypeDef* pdev)
   haudio->rd_enable = 0U;
   haudio->rd_ptr = 0U;
   haudio->wr_ptr = 0U;
+  haudio->starved = 0U;
+  haudio->missed = 0U;
+  // USBD_AUDIO_Process() resets conv_ptr when it sees the flush
+  AUDIO_FIFO_Flush(&haudio->fifo);
 
   USBD_LL_FlushEP(pdev, AUDIO_IN_EP);
   USBD_LL_FlushEP(pdev, AUDIO_OUT_EP);
 
   ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->DeInit(0);
+#ifdef USE_AUDIO_CAPTURE
+  // the silence is stopped too, the caller restarts the capture
+  clock_kept = 0U;
+#endif
 }
 
 
 /**
- * @brief  Restart playing with new parameters
+ * @brief  Set up the new stream parameters and restart the I2S clock with the DAC muted. Only call after
+ *         AUDIO_OUT_StopAndReset(), the DMA is started by AUDIO_OUT_Preroll() once PLLI2S is locked.
  * @param  pdev: instance
  */
 static void AUDIO_OUT_Restart(USBD_HandleTypeDef* pdev)
@@ -1058,25 +2345,598 @@ static void AUDIO_OUT_Restart(USBD_HandleTypeDef* pdev)
   USBD_AUDIO_HandleTypeDef* haudio;
   haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
 
-  AUDIO_OUT_StopAndReset(pdev);
+  haudio->bit_depth = haudio->alt_setting == AUDIO_ALT_16B ? 16U : 24U;
+
+#ifdef USE_AUDIO_ASRC
+  // The I2S clock stays at AUDIO_ASRC_OUT_FREQ, PLLI2S is not relocked. The feedback is the nominal stream rate.
+  asrc_out_pll = BSP_AUDIO_OUT_GetAsrcClkConfig(AUDIO_ASRC_OUT_FREQ)->nominal_fdbk;
+  asrc_out_nom = USBD_AUDIO_Fb_Nominal(asrc_out_pll);
+  fb_pll = fb_nom = fb_value = (uint32_t)(((uint64_t)haudio->freq << 22) / 1000U);
+  AUDIO_ASRC_Init(&haudio->asrc, haudio->freq, AUDIO_ASRC_OUT_FREQ);
+  AUDIO_ASRC_SetRatio(&haudio->asrc, fb_nom, asrc_out_nom);
+#else
+#ifdef USE_AUDIO_UPSAMPLE
+  AUDIO_OUT_SetUpsample(haudio);
+#endif
+  // 96kHz settings if the frequency is not supported
+  fb_pll = BSP_AUDIO_OUT_GetClkConfig(AUDIO_OUT_I2S_FREQ(haudio))->nominal_fdbk;
+#ifdef USE_AUDIO_UPSAMPLE
+  // the feedback counts the samples of the stream, the I2S plays factor samples for each
+  fb_pll /= haudio->ups.factor;
+#endif
+  fb_nom = fb_value = USBD_AUDIO_Fb_Nominal(fb_pll);
+#endif
+  // Do not send the feedback value of the previous sampling frequency before the first update
+  fb_data[0] = (uint8_t)((fb_value >> 8) & 0x000000FF);
+  fb_data[1] = (uint8_t)((fb_value >> 16) & 0x000000FF);
+  fb_data[2] = (uint8_t)((fb_value >> 24) & 0x000000FF);
+
+  AUDIO_Volume_SetFrequency(&haudio->vol, haudio->freq);
+#ifdef USE_AUDIO_EQ
+  AUDIO_EQ_SetFrequency(&haudio->eq, haudio->freq);
+#endif
+#ifdef USE_AUDIO_CROSSFEED
+  AUDIO_Crossfeed_SetFrequency(&haudio->xfeed, haudio->freq);
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+  // the crossover runs on the period buffers, at the I2S rate
+  AUDIO_Crossover_SetFrequency(&haudio->xover, AUDIO_OUT_I2S_FREQ(haudio));
+#endif
+  // PLLI2S locks in the background, see AUDIO_OUT_SwitchSOF()
+  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(AUDIO_OUT_I2S_FREQ(haudio), haudio->volume, 1U);
+  LOG("audio : stream %u Hz %u bit, latency profile %u\r\n", haudio->freq, haudio->bit_depth, haudio->latency);
+#ifdef USE_AUDIO_UPSAMPLE
+  LOG("audio : I2S %u Hz, upsampler filter %u\r\n", AUDIO_OUT_I2S_FREQ(haudio), haudio->ups.filter);
+#endif
+}
+
+
+/**
+ * @brief  AUDIO_OUT_Switch
+ *         Apply a new sampling frequency, alt setting, latency profile or upsampler filter without a click.
+ *         While playing, the output is faded out and the DAC is muted once it plays silence. The new settings are
+ *         applied with the DAC muted, PLLI2S locks while the SOFs go on, and the DMA starts on a pre-roll of
+ *         silence. The mute output is released after AUDIO_SWITCH_PREROLL_MS and the first samples are faded in.
+ *         Call from the OTG interrupt after the settings in haudio were changed.
+ * @param  pdev: instance
+ */
+// The states are run by AUDIO_OUT_SwitchSOF(). A request during the fade is applied with the others at its end,
+// a request while the DAC is muted is applied at once.
+static void AUDIO_OUT_Switch(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio->sw_state == AUDIO_SWITCH_IDLE) {
+    // the switch time is measured from this request, see AUDIO_OUT_SwitchMeasure()
+    uint32_t elapsed = BSP_SOF_TIM_GetElapsed();
+    uint32_t ticks_per_frame = BSP_SOF_TIM_GetTicksPerFrame();
+    haudio->sw_measure = 1U;
+    haudio->sw_first_set = 0U;
+    haudio->sw_elapsed = 0U;
+    haudio->sw_start_us = elapsed < ticks_per_frame ? elapsed * 1000U / ticks_per_frame : 0U;
+    haudio->sw_unmute_us = 0U;
+    if (is_playing == 1U && haudio->rd_enable == 1U) {
+      // no more packets, the SOF fades out what is left
+      all_ready = 0U;
+      haudio->sw_state = AUDIO_SWITCH_FADE;
+      return;
+    }
+  } else if (haudio->sw_state == AUDIO_SWITCH_FADE || haudio->sw_state == AUDIO_SWITCH_DRAIN) {
+    return;
+  }
+  AUDIO_OUT_SwitchApply(pdev);
+}
 
-  switch (haudio->freq) {
-    case 44100:
-      fb_nom = fb_value = I2S_Clk_Config24[0].nominal_fdbk;
+
+/**
+ * @brief  Run the stream switch states, called on each SOF
+ * @param  pdev: instance
+ */
+static void AUDIO_OUT_SwitchSOF(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio->sw_measure) {
+    haudio->sw_elapsed++;
+  }
+
+  switch (haudio->sw_state) {
+    case AUDIO_SWITCH_FADE:
+      // USBD_AUDIO_Process() owns the part of the buffer it is writing, see AUDIO_OUT_Conceal()
+      if (AUDIO_FIFO_Count(&haudio->fifo) == 0U) {
+        haudio->sw_frames = AUDIO_OUT_FadeOut(haudio);
+        haudio->sw_state = AUDIO_SWITCH_DRAIN;
+      }
       break;
-    case 48000:
-      fb_nom = fb_value = I2S_Clk_Config24[1].nominal_fdbk;
+
+    case AUDIO_SWITCH_DRAIN:
+      if (--haudio->sw_frames == 0U) {
+        AUDIO_OUT_SwitchApply(pdev);
+      }
       break;
-    case 96000:
-    default :
-      fb_nom = fb_value = I2S_Clk_Config24[2].nominal_fdbk;
+
+    case AUDIO_SWITCH_LOCK:
+      // USBD_AUDIO_Process() has seen the flush before the pre-roll moves the write index
+      if (haudio->fifo.flush != haudio->fifo.flush_seen) {
+        break;
+      }
+      if (((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->GetState() != AUDIO_STATE_READY) {
+        if (++haudio->sw_frames <= AUDIO_SWITCH_LOCK_FRAMES) {
+          break;
+        }
+        LOG("audio : PLLI2S not locked\r\n");
+      }
+      AUDIO_OUT_Preroll(pdev);
+      break;
+
+    case AUDIO_SWITCH_PREROLL:
+      if (--haudio->sw_frames == 0U) {
+        haudio->sw_state = AUDIO_SWITCH_IDLE;
+        ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->MuteCtl(0U);
+        haudio->sw_unmute_us = haudio->sw_elapsed * 1000U - haudio->sw_start_us;
+      }
+      break;
+
+    default:
       break;
   }
+}
 
-  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->Init(haudio->freq, haudio->volume, haudio->mute);
 
+/**
+ * @brief  Stop the DMA with the DAC muted and apply the new settings : start the I2S clock of the new stream,
+ *         or stay stopped on alt setting 0
+ * @param  pdev: instance
+ */
+static void AUDIO_OUT_SwitchApply(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  // the I2S stop sets the DAC mute output
+  AUDIO_OUT_StopAndReset(pdev);
+  // USBD_AUDIO_Process() resets conv_ptr on the flush
+  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->PeriodicTC(AUDIO_CMD_PLAY);
+  // the latency profile selected while playing, see USBD_AUDIO_SetLatency()
+  AUDIO_OUT_SetLatency(haudio, haudio->latency);
+
+  if (haudio->alt_setting == 0U) {
+    haudio->sw_state = AUDIO_SWITCH_IDLE;
+    LOG("audio : stream stopped\r\n");
+#ifdef USE_AUDIO_CAPTURE
+    // the capture needs the I2S frame clock
+    AUDIO_IN_Start(pdev);
+#endif
+    return;
+  }
+
+  AUDIO_OUT_Restart(pdev);
+  haudio->sw_frames = 0U;
+  haudio->sw_state = AUDIO_SWITCH_LOCK;
+}
+
+
+/**
+ * @brief  Fade out the samples ahead of the DMA and silence the rest of the buffer, the DMA keeps playing
+ * @param  haudio: audio class handle
+ * @retval frames until the DMA plays silence
+ */
+static uint32_t AUDIO_OUT_FadeOut(USBD_AUDIO_HandleTypeDef* haudio)
+{
+  uint32_t size = haudio->buf_size;
+  // samples per frame, rounded up
+  uint32_t spf = (fb_nom >> 22) + 1U;
+  AUDIO_OUT_UpdateRdPtr(haudio);
+  uint32_t rd = haudio->rd_ptr & ~3U;
+  uint32_t start = AUDIO_OUT_GuardPtr(haudio);
+  uint32_t guard = (start + size - rd) % size;
+  uint32_t fill = (haudio->wr_ptr + size - rd) % size;
+
+  // the first AUDIO_SWITCH_FADE_MS of the samples left, none after an underrun
+  uint32_t n = 0U;
+  if (haudio->starved == 0U && fill > guard && fill < size - 4U*spf) {
+    n = (fill - guard)/4U;
+    if (n > AUDIO_SWITCH_FADE_MS * spf) {
+      n = AUDIO_SWITCH_FADE_MS * spf;
+    }
+    AUDIO_Convert_FadeOut(haudio->buffer, start, n, size);
+  }
+  AUDIO_Convert_Silence(haudio->buffer, (start + 4U*n) % size, (size - guard)/4U - n, size);
+  LOG("audio : fade out, %u samples\r\n", n);
+  // plus the samples in the DMA FIFO and the SOF latency
+  return (guard/4U + n) / spf + 2U;
+}
+
+
+/**
+ * @brief  Start the I2S DMA on silence for a new stream, the DAC is still muted. The write index is at the setpoint.
+ * @param  pdev: instance
+ */
+static void AUDIO_OUT_Preroll(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+  // the setpoint, on a stereo sample
+  uint32_t half = (haudio->buf_size / 2U) & ~3U;
+
+  // the rest of the buffer is silenced up to the first packet, see AUDIO_OUT_Unstarve()
+  AUDIO_Convert_Silence(haudio->buffer, 0U, half/4U, haudio->buf_size);
+  haudio->offset = AUDIO_OFFSET_NONE;
+  haudio->rd_ptr = 0U;
+  haudio->wr_ptr = (uint16_t)half;
+  // USBD_AUDIO_Process() moves conv_ptr to the setpoint
+  haudio->skip += half;
+  // no samples received yet
+  haudio->starved = 1U;
+  fill_last = half;
+  audio_buf_writable_samples_last = (haudio->buf_size - half)/4U;
+  haudio->rd_enable = 1U;
+  is_playing = 1U;
+
+#ifdef USE_I2S_DOUBLE_BUFFER
+  // both period buffers are filled before the DMA starts
+  haudio->copy_ptr = 0U;
+#ifdef USE_AUDIO_ASRC
+  AUDIO_ASRC_Reset(&haudio->asrc);
+#endif
+#ifdef USE_AUDIO_UPSAMPLE
+  AUDIO_Upsample_Reset(&haudio->ups);
+#endif
+#ifdef USE_AUDIO_CROSSOVER
+  AUDIO_Crossover_Reset(&haudio->xover);
+#endif
+  AUDIO_OUT_CopyPeriod(haudio, 0U);
+  AUDIO_OUT_CopyPeriod(haudio, 1U);
+  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->AudioCmd(haudio->period[0], AUDIO_PERIOD_BUF_SIZE * 2 * 2, AUDIO_CMD_START);
+#else
+  ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->AudioCmd(&haudio->buffer[0], haudio->buf_size * 2, AUDIO_CMD_START);
+#endif
+  AUDIO_Volume_FadeIn(&haudio->vol);
+  LOG("audio : playback started, pre-roll %u ms\r\n", AUDIO_SWITCH_PREROLL_MS);
+
+  haudio->sw_frames = AUDIO_SWITCH_PREROLL_MS;
+  haudio->sw_state = AUDIO_SWITCH_PREROLL;
   tx_flag = 0U;
   all_ready = 1U;
+  USBD_AUDIO_PrepareReceive(pdev);
+#ifdef USE_AUDIO_CAPTURE
+  // resynchronize the capture on the restarted frame clock
+  AUDIO_IN_Start(pdev);
+#endif
+}
+
+
+/**
+ * @brief  First packet after an underrun or the pre-roll : the write index is moved to the setpoint over silence,
+ *         so the samples are played half a buffer after they were received
+ * @param  haudio: audio class handle
+ */
+// Between two concealments the write index stays where AUDIO_OUT_Conceal() left it while the DMA goes on.
+// The samples up to the new write index have not been played, the DMA is behind the old one.
+static void AUDIO_OUT_Unstarve(USBD_AUDIO_HandleTypeDef* haudio)
+{
+  uint32_t size = haudio->buf_size;
+  uint32_t wr = (((haudio->rd_ptr & ~3U) + size/2U) % size) & ~3U;
+  uint32_t delta = (wr + size - haudio->wr_ptr) % size;
+
+  if (delta == 0U || delta >= size/2U || AUDIO_FIFO_Count(&haudio->fifo) != 0U) {
+    return;
+  }
+  AUDIO_Convert_Silence(haudio->buffer, haudio->wr_ptr, delta/4U, size);
+  haudio->skip += delta;
+  haudio->wr_ptr = (uint16_t)wr;
+  fill_last = size/2U;
+}
+
+
+/**
+ * @brief  Switch time : from the request that started the switch to the first sample received after it being played
+ *         with the DAC mute output released. Called on each SOF while playing, after rd_ptr was read.
+ * @param  haudio: audio class handle
+ * @param  elapsed_ticks: timer ticks since the SOF when rd_ptr was read
+ */
+static void AUDIO_OUT_SwitchMeasure(USBD_AUDIO_HandleTypeDef* haudio, uint32_t elapsed_ticks)
+{
+  if (haudio->sw_measure == 0U || haudio->sw_first_set == 0U || haudio->sw_state != AUDIO_SWITCH_IDLE) {
+    return;
+  }
+  uint32_t size = haudio->buf_size;
+  uint32_t past = (haudio->rd_ptr + size - haudio->sw_first) % size;
+  if (past >= size/2U) {
+    // not played yet
+    return;
+  }
+  uint32_t ticks_per_frame = BSP_SOF_TIM_GetTicksPerFrame();
+  int32_t us = (int32_t)(haudio->sw_elapsed * 1000U) - (int32_t)haudio->sw_start_us;
+  if (elapsed_ticks < ticks_per_frame) {
+    us += (int32_t)(elapsed_ticks * 1000U / ticks_per_frame);
+  }
+  // the first sample was played past/4 samples ago
+  us -= (int32_t)((uint64_t)(past/4U) * 1000000U / haudio->freq);
+  // or before the mute output was released
+  if (us < (int32_t)haudio->sw_unmute_us) {
+    us = (int32_t)haudio->sw_unmute_us;
+  }
+  haudio->switch_us = (uint32_t)us;
+  haudio->sw_measure = 0U;
+  LOG("audio : switched in %u us, DAC unmuted after %u us\r\n", haudio->switch_us, haudio->sw_unmute_us);
+}
+
+
+#ifdef USE_AUDIO_CAPTURE
+/**
+ * @brief  (Re)start the capture on the I2S frame clock. Called when the capture interface is selected, and each time
+ *         the I2S master is restarted : the playback starts, stops or changes rate. The capture source is
+ *         resynchronized, which makes a gap of a few ms in the captured stream.
+ *         Without playback, the I2S DMA plays silence to keep the frame clock running.
+ * @param  pdev: instance
+ */
+static void AUDIO_IN_Start(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio->capture_alt == 0U) {
+    return;
+  }
+  // restarted when the switch starts the I2S DMA or stops, see AUDIO_OUT_Switch()
+  if (haudio->sw_state != AUDIO_SWITCH_IDLE && haudio->sw_state != AUDIO_SWITCH_PREROLL) {
+    return;
+  }
+  if (is_playing == 0U && clock_kept == 0U) {
+    ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->AudioCmd(USBD_AUDIO_Silence, sizeof(USBD_AUDIO_Silence), AUDIO_CMD_START);
+    clock_kept = 1U;
+  }
+  haudio->capture_primed = 0U;
+  capture_frac = 0U;
+  if (BSP_CAPTURE_Start() != AUDIO_OK) {
+    LOG("capture : source not started\r\n");
+  }
+}
+
+
+/**
+ * @brief  Stop the capture, and the silence if there is no playback
+ * @param  pdev: instance
+ */
+static void AUDIO_IN_Stop(USBD_HandleTypeDef* pdev)
+{
+  BSP_CAPTURE_Stop();
+  if (capture_tx_busy) {
+    capture_tx_busy = 0U;
+    USBD_LL_FlushEP(pdev, AUDIO_CAPTURE_EP);
+  }
+  if (clock_kept) {
+    ((USBD_AUDIO_ItfTypeDef*)pdev->pUserData)->DeInit(0U);
+    clock_kept = 0U;
+  }
+}
+
+
+/**
+ * @brief  Arm the capture packet of the next frame
+ * @param  pdev: instance
+ */
+// The capture runs on the I2S frame clock, which drifts from the USB frames by the crystal error. The asynchronous
+// IN endpoint sends one sample more or less than nominal when the captured samples waiting in the ring move away
+// from AUDIO_CAPTURE_DELAY_FRAMES by more than half a frame. The fill is read when the previous packet was sent,
+// at about the same time in each frame.
+static void AUDIO_IN_Transmit(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio == NULL || haudio->capture_alt == 0U) {
+    return;
+  }
+
+  // nominal samples in this frame, e.g. 44 or 45 at 44.1kHz
+  uint32_t nominal = haudio->freq / 1000U;
+  uint32_t target = AUDIO_CAPTURE_DELAY_FRAMES * nominal;
+  uint32_t n = nominal;
+  capture_frac += haudio->freq % 1000U;
+  if (capture_frac >= 1000U) {
+    capture_frac -= 1000U;
+    n++;
+  }
+
+  uint32_t avail = BSP_CAPTURE_GetAvailable();
+  if (haudio->capture_primed == 0U && avail >= target) {
+    haudio->capture_primed = 1U;
+    LOG("capture : stream %u Hz, %u samples buffered\r\n", haudio->freq, avail);
+  }
+
+  if (haudio->capture_primed == 0U) {
+    // zero length packets until the delay is captured
+    n = 0U;
+  } else {
+    if (avail > BSP_CAPTURE_RING_SAMPLES / 2U) {
+      // the host stopped reading for a while, drop the oldest samples
+      haudio->capture_overruns++;
+      LOG("capture : overrun, %u samples\r\n", avail);
+      BSP_CAPTURE_Skip(avail - target);
+      avail = target;
+    }
+    if (avail > target + nominal / 2U) {
+      n++;
+    } else if (avail + nominal / 2U < target) {
+      n--;
+    }
+    if (n > AUDIO_CAPTURE_PACKET / 4U) {
+      n = AUDIO_CAPTURE_PACKET / 4U;
+    }
+    if (n > avail) {
+      haudio->capture_underruns++;
+    }
+    n = BSP_CAPTURE_Read(USBD_AUDIO_TxBuf, n);
+  }
+
+  USBD_LL_Transmit(pdev, AUDIO_CAPTURE_EP, (uint8_t*)USBD_AUDIO_TxBuf, n * 4U);
+  capture_tx_busy = 1U;
+  capture_tx_frame = USBD_LL_GetFrameNumber(pdev);
+}
+#endif
+
+
+/**
+ * @brief  Select the audio transfer buffer depth. The setpoint of the feedback loop, the playback start threshold
+ *         and the safe zone all follow haudio->buf_size. Only call while not playing, or restart playback after.
+ * @param  haudio: audio class handle
+ * @param  latency: AUDIO_LatencyTypeDef
+ */
+static void AUDIO_OUT_SetLatency(USBD_AUDIO_HandleTypeDef* haudio, uint32_t latency)
+{
+  haudio->latency = (uint8_t)latency;
+  haudio->buf_size = AUDIO_LatencyBufSize[latency];
+  haudio->safezone = AUDIO_BUF_SAFEZONE_SAMPLES(haudio->buf_size);
+}
+
+
+/**
+ * @brief  Select a latency profile and keep it in the backup register. Playback restarts if streaming.
+ *         Call from the OTG interrupt, like the control requests.
+ * @param  pdev: instance
+ * @param  latency: AUDIO_LatencyTypeDef
+ * @retval USBD_FAIL if the profile does not exist
+ */
+uint8_t USBD_AUDIO_SetLatency(USBD_HandleTypeDef* pdev, uint32_t latency)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio == NULL || latency >= AUDIO_LATENCY_NUM) {
+    return USBD_FAIL;
+  }
+  if (haudio->latency != latency) {
+    BSP_BKP_Write(AUDIO_LATENCY_BKP_REG, AUDIO_LATENCY_BKP_MAGIC | latency);
+    if (haudio->alt_setting != 0U) {
+      // the buffer is faded out at the current depth, the new one applies from the pre-roll
+      haudio->latency = (uint8_t)latency;
+      AUDIO_OUT_Switch(pdev);
+    } else {
+      AUDIO_OUT_SetLatency(haudio, latency);
+    }
+  }
+  return USBD_OK;
+}
+
+
+#ifdef USE_AUDIO_UPSAMPLE
+/**
+ * @brief  Set up the upsampler for the stream rate : the selected filter if PLLI2S has twice the rate in its table,
+ *         else the stream is played at its rate. Only call while not playing, the I2S rate follows.
+ * @param  haudio: audio class handle
+ */
+static void AUDIO_OUT_SetUpsample(USBD_AUDIO_HandleTypeDef* haudio)
+{
+  uint32_t filter = haudio->upsample;
+  if (BSP_AUDIO_OUT_GetClkConfig(2U * haudio->freq)->freq != 2U * haudio->freq) {
+    filter = AUDIO_UPSAMPLE_OFF;
+  }
+  AUDIO_Upsample_Init(&haudio->ups, filter);
+}
+
+
+/**
+ * @brief  Select the oversampling filter, AUDIO_VENDOR_REQ_UPSAMPLE. Playback restarts if streaming, the I2S rate
+ *         may change. Call from the OTG interrupt, like the control requests.
+ * @param  pdev: instance
+ * @param  filter: AUDIO_UPSAMPLE_FilterTypeDef
+ */
+static void AUDIO_OUT_SelectUpsample(USBD_HandleTypeDef* pdev, uint32_t filter)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio->upsample != filter) {
+    haudio->upsample = (uint8_t)filter;
+    LOG("upsample : filter %u\r\n", filter);
+    // else applied when the stream starts, see AUDIO_OUT_Restart()
+    if (haudio->alt_setting != 0U) {
+      AUDIO_OUT_Switch(pdev);
+    }
+  }
+}
+#endif
+
+
+/**
+ * @brief  Playback state and concealment counters. Call from the OTG interrupt, e.g. at SOF, for a consistent set.
+ * @param  pdev: instance
+ * @param  status: filled in, all zero when the device is not configured
+ */
+void USBD_AUDIO_GetStatus(USBD_HandleTypeDef* pdev, USBD_AUDIO_StatusTypeDef* status)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  USBD_memset(status, 0, sizeof(*status));
+  if (haudio == NULL) {
+    return;
+  }
+  status->playing = (uint8_t)is_playing;
+  status->alt_setting = (uint8_t)haudio->alt_setting;
+  status->bit_depth = (uint8_t)haudio->bit_depth;
+  status->latency = haudio->latency;
+  status->mute = haudio->mute;
+  status->starved = haudio->starved;
+  status->volume = haudio->volume;
+  status->freq = haudio->freq;
+  status->fill = (int32_t)(fill_sof * 256.0f);
+  status->fb_value = fb_value;
+  status->underruns = haudio->underruns;
+  status->overruns = haudio->overruns;
+  status->frames_missed = haudio->frames_missed;
+  status->frames_concealed = haudio->frames_concealed;
+  status->fifo_overflows = haudio->fifo.overflows;
+  status->switch_us = haudio->switch_us;
+#ifdef USE_AUDIO_VERIFY
+  AUDIO_VERIFY_ResultTypeDef verify;
+  AUDIO_Verify_Get(&haudio->verify, &verify);
+  status->crc = verify.crc;
+  status->crc_samples = verify.samples;
+#endif
+}
+
+
+/**
+ * @brief  Clear the concealment counters. Call from the OTG interrupt.
+ * @param  pdev: instance
+ */
+void USBD_AUDIO_ClearCounters(USBD_HandleTypeDef* pdev)
+{
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio != NULL) {
+    haudio->underruns = 0U;
+    haudio->overruns = 0U;
+    haudio->frames_missed = 0U;
+    haudio->frames_concealed = 0U;
+    haudio->fifo.overflows = 0U;
+  }
+}
+
+
+/**
+ * @brief  Restart the CRC of the bit-perfect verification from the next sample that is not silence, see
+ *         audio_verify.h. Does nothing without USE_AUDIO_VERIFY. Call from the OTG interrupt.
+ * @param  pdev: instance
+ */
+void USBD_AUDIO_RestartVerify(USBD_HandleTypeDef* pdev)
+{
+#ifdef USE_AUDIO_VERIFY
+  USBD_AUDIO_HandleTypeDef* haudio;
+  haudio = (USBD_AUDIO_HandleTypeDef*)pdev->pClassData;
+
+  if (haudio != NULL) {
+    AUDIO_Verify_Restart(&haudio->verify);
+  }
+#else
+  (void)pdev;
+#endif
 }
 
 
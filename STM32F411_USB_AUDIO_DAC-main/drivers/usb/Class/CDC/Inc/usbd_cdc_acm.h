@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    usbd_cdc_acm.h
+  * @brief   header file for the usbd_cdc_acm.c file.
+  ******************************************************************************
+  */
+
+#ifndef __USB_CDC_ACM_H
+#define __USB_CDC_ACM_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include  "usbd_ioreq.h"
+
+// CDC-ACM function of the composite device. It is not a class of its own : the AUDIO class owns the
+// configuration descriptor and forwards the requests and endpoint events of these interfaces, see usbd_audio.c.
+// The interfaces follow the audio control (0) and audio streaming (1) interfaces.
+#define CDC_ACM_CMD_ITF                               0x02U
+#define CDC_ACM_DATA_ITF                              0x03U
+
+/* bEndpointAddress, EP1 is used by the audio stream and the feedback */
+#define CDC_ACM_CMD_EP                                0x83U
+#define CDC_ACM_OUT_EP                                0x02U
+#define CDC_ACM_IN_EP                                 0x82U
+
+#define CDC_ACM_CMD_PACKET                            8U
+#define CDC_ACM_DATA_PACKET                           64U
+
+// Interface association, communication and data interface descriptors with their endpoints
+#define USB_IAD_DESC_SIZ                              0x08U
+#define USB_CDC_ACM_DESC_SIZ                          66U
+
+#define USB_DESC_TYPE_IAD                             0x0BU
+#define USB_DEVICE_CLASS_CDC                          0x02U
+#define USB_DEVICE_CLASS_CDC_DATA                     0x0AU
+#define CDC_SUBCLASS_ACM                              0x02U
+#define CDC_PROTOCOL_AT                               0x01U
+
+/* CDC functional descriptors, see CDC 1.2 spec, 5.2.3 */
+#define CDC_INTERFACE_DESCRIPTOR_TYPE                 0x24U
+#define CDC_FUNC_HEADER                               0x00U
+#define CDC_FUNC_CALL_MANAGEMENT                      0x01U
+#define CDC_FUNC_ACM                                  0x02U
+#define CDC_FUNC_UNION                                0x06U
+
+/* CDC PSTN requests, see PSTN 1.2 spec, 6.3 */
+#define CDC_REQ_SET_LINE_CODING                       0x20U
+#define CDC_REQ_GET_LINE_CODING                       0x21U
+#define CDC_REQ_SET_CONTROL_LINE_STATE                0x22U
+#define CDC_REQ_SEND_BREAK                            0x23U
+
+// SET_CONTROL_LINE_STATE wValue, the host sets DTR when a terminal opens the port
+#define CDC_ACM_LINE_DTR                              0x0001U
+#define CDC_ACM_LINE_RTS                              0x0002U
+
+
+typedef struct
+{
+    void  (*Init)         (void);
+    void  (*DeInit)       (void);
+    void  (*LineState)    (uint16_t state);
+    void  (*Receive)      (const uint8_t* pbuf, uint32_t len);
+    void  (*SOF)          (USBD_HandleTypeDef* pdev);
+} USBD_CDC_ACM_ItfTypeDef;
+
+
+uint8_t  USBD_CDC_ACM_RegisterInterface (USBD_CDC_ACM_ItfTypeDef *fops);
+void     USBD_CDC_ACM_Init (USBD_HandleTypeDef *pdev);
+void     USBD_CDC_ACM_DeInit (USBD_HandleTypeDef *pdev);
+uint8_t  USBD_CDC_ACM_IsInterface (uint8_t itf);
+uint8_t  USBD_CDC_ACM_Setup (USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
+uint8_t  USBD_CDC_ACM_DataIn (USBD_HandleTypeDef *pdev, uint8_t epnum);
+uint8_t  USBD_CDC_ACM_DataOut (USBD_HandleTypeDef *pdev, uint8_t epnum);
+void     USBD_CDC_ACM_SOF (USBD_HandleTypeDef *pdev);
+uint8_t  USBD_CDC_ACM_Transmit (USBD_HandleTypeDef *pdev, const uint8_t *pbuf, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __USB_CDC_ACM_H */
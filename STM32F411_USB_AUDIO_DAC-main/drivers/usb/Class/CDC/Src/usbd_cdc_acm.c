@@ -0,0 +1,254 @@
+/*******************************************************************************
+  * @file    usbd_cdc_acm.c
+  * @brief   CDC-ACM function of the composite USB Audio device.
+  *
+  *          The host sees a virtual serial port next to the audio interfaces. The audio class owns the
+  *          configuration and forwards the requests to the communication and data interfaces and the events
+  *          of their endpoints to this file :
+  *             - Line coding requests, accepted and ignored (there is no UART behind the port)
+  *             - Control line state, reported to the application which streams only while DTR is set
+  *             - Bulk OUT endpoint, each packet is passed to the application
+  *             - Bulk IN endpoint, one transfer of up to 64 bytes at a time
+  *             - Interrupt IN notification endpoint, opened but never used
+  ******************************************************************************
+  */
+
+#include "usbd_cdc_acm.h"
+#include "usbd_ctlreq.h"
+
+
+static USBD_CDC_ACM_ItfTypeDef* cdc_fops = NULL;
+
+// 115200 baud, 1 stop bit, no parity, 8 data bits. Reported back to the host, the data rate does not depend on it.
+__ALIGN_BEGIN static uint8_t cdc_line_coding[7] __ALIGN_END = { 0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08 };
+
+__ALIGN_BEGIN static uint8_t cdc_rx_buf[CDC_ACM_DATA_PACKET] __ALIGN_END;
+// The OTG FIFO is filled from this buffer when the host polls the endpoint, after USBD_CDC_ACM_Transmit() returned
+__ALIGN_BEGIN static uint8_t cdc_tx_buf[CDC_ACM_DATA_PACKET] __ALIGN_END;
+static volatile uint8_t cdc_tx_busy = 0;
+
+
+/**
+  * @brief  USBD_CDC_ACM_RegisterInterface
+  * @param  fops: CDC-ACM interface callback
+  * @retval status
+  */
+uint8_t USBD_CDC_ACM_RegisterInterface(USBD_CDC_ACM_ItfTypeDef* fops)
+{
+  if (fops != NULL) {
+    cdc_fops = fops;
+  }
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_CDC_ACM_Init
+  *         Open the endpoints, called by USBD_AUDIO_Init()
+  * @param  pdev: device instance
+  */
+void USBD_CDC_ACM_Init(USBD_HandleTypeDef* pdev)
+{
+  USBD_LL_OpenEP(pdev, CDC_ACM_IN_EP, USBD_EP_TYPE_BULK, CDC_ACM_DATA_PACKET);
+  pdev->ep_in[CDC_ACM_IN_EP & 0xFU].is_used = 1U;
+
+  USBD_LL_OpenEP(pdev, CDC_ACM_OUT_EP, USBD_EP_TYPE_BULK, CDC_ACM_DATA_PACKET);
+  pdev->ep_out[CDC_ACM_OUT_EP & 0xFU].is_used = 1U;
+
+  USBD_LL_OpenEP(pdev, CDC_ACM_CMD_EP, USBD_EP_TYPE_INTR, CDC_ACM_CMD_PACKET);
+  pdev->ep_in[CDC_ACM_CMD_EP & 0xFU].is_used = 1U;
+
+  cdc_tx_busy = 0U;
+  if (cdc_fops != NULL) {
+    cdc_fops->Init();
+  }
+
+  USBD_LL_PrepareReceive(pdev, CDC_ACM_OUT_EP, cdc_rx_buf, CDC_ACM_DATA_PACKET);
+}
+
+/**
+  * @brief  USBD_CDC_ACM_DeInit
+  *         Close the endpoints, called by USBD_AUDIO_DeInit()
+  * @param  pdev: device instance
+  */
+void USBD_CDC_ACM_DeInit(USBD_HandleTypeDef* pdev)
+{
+  USBD_LL_CloseEP(pdev, CDC_ACM_IN_EP);
+  pdev->ep_in[CDC_ACM_IN_EP & 0xFU].is_used = 0U;
+
+  USBD_LL_CloseEP(pdev, CDC_ACM_OUT_EP);
+  pdev->ep_out[CDC_ACM_OUT_EP & 0xFU].is_used = 0U;
+
+  USBD_LL_CloseEP(pdev, CDC_ACM_CMD_EP);
+  pdev->ep_in[CDC_ACM_CMD_EP & 0xFU].is_used = 0U;
+
+  cdc_tx_busy = 0U;
+  if (cdc_fops != NULL) {
+    cdc_fops->DeInit();
+  }
+}
+
+/**
+  * @brief  USBD_CDC_ACM_IsInterface
+  * @param  itf: bInterfaceNumber of an interface request
+  * @retval 1 for the communication and data interfaces
+  */
+uint8_t USBD_CDC_ACM_IsInterface(uint8_t itf)
+{
+  return (itf == CDC_ACM_CMD_ITF || itf == CDC_ACM_DATA_ITF) ? 1U : 0U;
+}
+
+/**
+  * @brief  USBD_CDC_ACM_Setup
+  *         Handle the requests to the CDC-ACM interfaces
+  * @param  pdev: device instance
+  * @param  req: usb request
+  * @retval status
+  */
+uint8_t USBD_CDC_ACM_Setup(USBD_HandleTypeDef* pdev, USBD_SetupReqTypedef* req)
+{
+  static uint8_t alt_setting = 0U;
+  uint16_t status_info = 0U;
+  uint8_t ret = USBD_OK;
+
+  switch (req->bmRequest & USB_REQ_TYPE_MASK) {
+    /* CDC Class Requests */
+    case USB_REQ_TYPE_CLASS:
+      switch (req->bRequest) {
+        case CDC_REQ_SET_LINE_CODING:
+          USBD_CtlPrepareRx(pdev, cdc_line_coding, MIN(sizeof(cdc_line_coding), req->wLength));
+          break;
+
+        case CDC_REQ_GET_LINE_CODING:
+          USBD_CtlSendData(pdev, cdc_line_coding, MIN(sizeof(cdc_line_coding), req->wLength));
+          break;
+
+        case CDC_REQ_SET_CONTROL_LINE_STATE:
+          if (cdc_fops != NULL) {
+            cdc_fops->LineState(req->wValue);
+          }
+          break;
+
+        case CDC_REQ_SEND_BREAK:
+          break;
+
+        default:
+          USBD_CtlError(pdev, req);
+          ret = USBD_FAIL;
+          break;
+      }
+      break;
+
+    /* Standard Requests */
+    case USB_REQ_TYPE_STANDARD:
+      switch (req->bRequest) {
+        case USB_REQ_GET_STATUS:
+          if (pdev->dev_state == USBD_STATE_CONFIGURED) {
+            USBD_CtlSendData(pdev, (uint8_t*)(void*)&status_info, 2U);
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        case USB_REQ_GET_INTERFACE:
+          if (pdev->dev_state == USBD_STATE_CONFIGURED) {
+            USBD_CtlSendData(pdev, &alt_setting, 1U);
+          } else {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        case USB_REQ_SET_INTERFACE:
+          /* Both interfaces only have the alternate setting 0 */
+          if (pdev->dev_state != USBD_STATE_CONFIGURED || (uint8_t)(req->wValue) != 0U) {
+            USBD_CtlError(pdev, req);
+            ret = USBD_FAIL;
+          }
+          break;
+
+        default:
+          USBD_CtlError(pdev, req);
+          ret = USBD_FAIL;
+          break;
+      }
+      break;
+
+    default:
+      USBD_CtlError(pdev, req);
+      ret = USBD_FAIL;
+      break;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  USBD_CDC_ACM_DataIn
+  *         The last transfer of the bulk IN endpoint was read by the host
+  * @param  pdev: device instance
+  * @param  epnum: endpoint index
+  * @retval status
+  */
+uint8_t USBD_CDC_ACM_DataIn(USBD_HandleTypeDef* pdev, uint8_t epnum)
+{
+  UNUSED(pdev);
+
+  if (epnum == (CDC_ACM_IN_EP & 0xFU)) {
+    cdc_tx_busy = 0U;
+  }
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_CDC_ACM_DataOut
+  *         Pass a packet of the bulk OUT endpoint to the application and receive the next one
+  * @param  pdev: device instance
+  * @param  epnum: endpoint index
+  * @retval status
+  */
+uint8_t USBD_CDC_ACM_DataOut(USBD_HandleTypeDef* pdev, uint8_t epnum)
+{
+  uint32_t len = USBD_GetRxCount(pdev, epnum);
+
+  if (cdc_fops != NULL && len) {
+    cdc_fops->Receive(cdc_rx_buf, len);
+  }
+  USBD_LL_PrepareReceive(pdev, CDC_ACM_OUT_EP, cdc_rx_buf, CDC_ACM_DATA_PACKET);
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_CDC_ACM_SOF
+  *         Called at every SOF, the application sends its periodic data from here
+  * @param  pdev: device instance
+  */
+void USBD_CDC_ACM_SOF(USBD_HandleTypeDef* pdev)
+{
+  if (cdc_fops != NULL) {
+    cdc_fops->SOF(pdev);
+  }
+}
+
+/**
+  * @brief  USBD_CDC_ACM_Transmit
+  *         Queue a transfer on the bulk IN endpoint. The data is copied, the caller can reuse its buffer.
+  *         A transfer of exactly 64 bytes would need a zero length packet to end it, so the length is limited to 63.
+  * @param  pdev: device instance
+  * @param  pbuf: data
+  * @param  len: bytes, less than CDC_ACM_DATA_PACKET
+  * @retval USBD_BUSY if the host has not read the last transfer yet
+  */
+uint8_t USBD_CDC_ACM_Transmit(USBD_HandleTypeDef* pdev, const uint8_t* pbuf, uint16_t len)
+{
+  if (pdev->dev_state != USBD_STATE_CONFIGURED || len >= CDC_ACM_DATA_PACKET) {
+    return USBD_FAIL;
+  }
+  if (cdc_tx_busy) {
+    return USBD_BUSY;
+  }
+  cdc_tx_busy = 1U;
+  USBD_memcpy(cdc_tx_buf, pbuf, len);
+  USBD_LL_Transmit(pdev, CDC_ACM_IN_EP, cdc_tx_buf, len);
+  return USBD_OK;
+}
@@ -97,7 +97,15 @@ USBD_StatusTypeDef  USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev,
                                            uint8_t  *pbuf,
                                            uint16_t  size);
 
+USBD_StatusTypeDef  USBD_LL_PrepareReceiveRing(USBD_HandleTypeDef *pdev,
+                                               uint8_t  ep_addr,
+                                               uint8_t  *pring,
+                                               uint32_t  ring_size,
+                                               uint32_t  ring_pos,
+                                               uint16_t  size);
+
 uint32_t USBD_LL_GetRxDataSize  (USBD_HandleTypeDef *pdev, uint8_t  ep_addr);
+uint32_t USBD_LL_GetFrameNumber (USBD_HandleTypeDef *pdev);
 void  USBD_LL_Delay (uint32_t Delay);
 
 
@@ -0,0 +1,286 @@
+// Host-side decoder of the binary log records sent on the UART by the firmware, see src/log.h
+//
+// Each record is a header word (sync nibble 0xA, number of arguments, format string ID), a DWT cycle counter
+// timestamp and one word per argument, little-endian. The format strings are not in the flash : they are read from
+// the .logstr section of the ELF file, the ID is the offset in that section. A %s argument is the address of a string
+// in flash (e.g. __FILE__), read from the loaded sections of the ELF file.
+//
+// The decoder resynchronizes on the next valid header after a corrupted or partial record, e.g. when it is started
+// in the middle of a transfer.
+//
+// Usage : make, then ./build/logdecode [-b baud] [-c core_clock_hz] ../build/usb_audio_i2s.elf /dev/ttyUSB0
+// The input can also be a file captured from the UART, or - for stdin.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <elf.h>
+
+// see src/log.h
+#define LOG_SYNC            0xA0000000U
+#define LOG_SYNC_MASK       0xF0000000U
+#define LOG_NARGS(hdr)      (((hdr) >> 24) & 0x0FU)
+#define LOG_ID_MASK         0x00FFFFFFU
+#define LOG_MAX_ARGS        6U
+
+typedef struct {
+	uint8_t*  image;        // the whole ELF file
+	size_t    size;
+	const char* logstr;     // .logstr section contents
+	uint32_t  logstr_size;
+} ELF_FILE;
+
+static ELF_FILE elf;
+
+
+static int elf_load(const char* path){
+	FILE* f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return -1;
+		}
+	fseek(f, 0, SEEK_END);
+	elf.size = (size_t)ftell(f);
+	fseek(f, 0, SEEK_SET);
+	elf.image = malloc(elf.size);
+	if (elf.image == NULL || fread(elf.image, 1, elf.size, f) != elf.size) {
+		fclose(f);
+		fprintf(stderr, "%s : read error\n", path);
+		return -1;
+		}
+	fclose(f);
+
+	Elf32_Ehdr* eh = (Elf32_Ehdr*)elf.image;
+	if (elf.size < sizeof(Elf32_Ehdr) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 || eh->e_ident[EI_CLASS] != ELFCLASS32 ||
+		eh->e_shoff + (size_t)eh->e_shnum * sizeof(Elf32_Shdr) > elf.size) {
+		fprintf(stderr, "%s : not a 32bit ELF file\n", path);
+		return -1;
+		}
+	Elf32_Shdr* sh = (Elf32_Shdr*)(elf.image + eh->e_shoff);
+	const char* names = (const char*)(elf.image + sh[eh->e_shstrndx].sh_offset);
+	for (int i = 0; i < eh->e_shnum; i++) {
+		if (strcmp(names + sh[i].sh_name, ".logstr") == 0) {
+			elf.logstr = (const char*)(elf.image + sh[i].sh_offset);
+			elf.logstr_size = sh[i].sh_size;
+			}
+		}
+	if (elf.logstr == NULL) {
+		fprintf(stderr, "%s : no .logstr section\n", path);
+		return -1;
+		}
+	return 0;
+	}
+
+
+// String at a flash address, from the loaded sections
+static const char* elf_string(uint32_t addr){
+	Elf32_Ehdr* eh = (Elf32_Ehdr*)elf.image;
+	Elf32_Shdr* sh = (Elf32_Shdr*)(elf.image + eh->e_shoff);
+	for (int i = 0; i < eh->e_shnum; i++) {
+		if ((sh[i].sh_flags & SHF_ALLOC) && sh[i].sh_type == SHT_PROGBITS &&
+			addr >= sh[i].sh_addr && addr < sh[i].sh_addr + sh[i].sh_size) {
+			const char* s = (const char*)(elf.image + sh[i].sh_offset + (addr - sh[i].sh_addr));
+			if (memchr(s, 0, sh[i].sh_addr + sh[i].sh_size - addr) != NULL) {
+				return s;
+				}
+			}
+		}
+	return "(?)";
+	}
+
+
+// A header word starts a format string of the .logstr section
+static int valid_header(uint32_t hdr){
+	uint32_t id = hdr & LOG_ID_MASK;
+	return (hdr & LOG_SYNC_MASK) == LOG_SYNC && LOG_NARGS(hdr) <= LOG_MAX_ARGS && id < elf.logstr_size &&
+		(id == 0U || elf.logstr[id - 1U] == 0);
+	}
+
+
+// printf the format string with the 32bit arguments, converted according to each conversion specifier
+static void print_record(const char* fmt, const uint32_t* args, uint32_t nargs){
+	char out[1024];
+	size_t len = 0;
+	uint32_t arg = 0;
+
+	while (*fmt && len < sizeof(out) - 1) {
+		if (*fmt != '%') {
+			if (*fmt != '\r') {
+				out[len++] = *fmt;
+				}
+			fmt++;
+			continue;
+			}
+		// copy the specifier without the length modifiers, all the arguments are 32bit
+		char spec[32];
+		size_t n = 0;
+		spec[n++] = *fmt++;
+		while (*fmt && strchr("-+ #0123456789.hljztL", *fmt) && n < sizeof(spec) - 2) {
+			if (!strchr("hljztL", *fmt)) {
+				spec[n++] = *fmt;
+				}
+			fmt++;
+			}
+		char conv = *fmt ? *fmt++ : '%';
+		spec[n++] = conv;
+		spec[n] = 0;
+
+		size_t room = sizeof(out) - len;
+		int w;
+		if (conv == '%') {
+			w = snprintf(out + len, room, "%%");
+			}
+		else
+		if (arg >= nargs) {
+			w = snprintf(out + len, room, "?");
+			}
+		else {
+			uint32_t a = args[arg++];
+			union { uint32_t u; float f; } v = { a };
+			switch (conv) {
+				case 'd': case 'i':
+					w = snprintf(out + len, room, spec, (int)(int32_t)a);
+					break;
+				case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+					w = snprintf(out + len, room, spec, (double)v.f);
+					break;
+				case 's':
+					w = snprintf(out + len, room, spec, elf_string(a));
+					break;
+				case 'p':
+					w = snprintf(out + len, room, "0x%08x", a);
+					break;
+				default:
+					w = snprintf(out + len, room, spec, (unsigned)a);
+					break;
+				}
+			}
+		if (w > 0) {
+			len += (size_t)w < room ? (size_t)w : room - 1;
+			}
+		}
+	out[len] = 0;
+	// one line per record
+	while (len && out[len - 1] == '\n') {
+		out[--len] = 0;
+		}
+	printf("%s\n", out);
+	}
+
+
+static speed_t baud_rate(long baud){
+	switch (baud) {
+		case 9600: return B9600;
+		case 19200: return B19200;
+		case 38400: return B38400;
+		case 57600: return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+		case 460800: return B460800;
+		case 921600: return B921600;
+		default: return 0;
+		}
+	}
+
+
+int main(int argc, char* argv[]){
+	long baud = 115200;
+	double clock_hz = 100.0e6;
+	int opt;
+	while ((opt = getopt(argc, argv, "b:c:h")) != -1) {
+		switch (opt) {
+			case 'b': baud = strtol(optarg, NULL, 0); break;
+			case 'c': clock_hz = strtod(optarg, NULL); break;
+			default:
+				fprintf(stderr, "usage : %s [-b baud] [-c core_clock_hz] firmware.elf /dev/ttyUSB0|capture_file|-\n", argv[0]);
+				fprintf(stderr, "  -b UART baud rate, default 115200\n");
+				fprintf(stderr, "  -c core clock for the timestamps, default 100000000 (F411), 84000000 on the F401\n");
+				return 1;
+			}
+		}
+	if (argc - optind != 2 || elf_load(argv[optind]) != 0) {
+		fprintf(stderr, "usage : %s [-b baud] [-c core_clock_hz] firmware.elf /dev/ttyUSB0|capture_file|-\n", argv[0]);
+		return 1;
+		}
+
+	const char* input = argv[optind + 1];
+	int fd = strcmp(input, "-") == 0 ? STDIN_FILENO : open(input, O_RDONLY | O_NOCTTY);
+	if (fd < 0) {
+		perror(input);
+		return 1;
+		}
+	if (isatty(fd)) {
+		struct termios tio;
+		speed_t speed = baud_rate(baud);
+		if (speed == 0 || tcgetattr(fd, &tio) != 0) {
+			fprintf(stderr, "%s : cannot set %ld baud\n", input, baud);
+			return 1;
+			}
+		cfmakeraw(&tio);
+		cfsetispeed(&tio, speed);
+		cfsetospeed(&tio, speed);
+		tio.c_cc[VMIN] = 1;
+		tio.c_cc[VTIME] = 0;
+		tcsetattr(fd, TCSANOW, &tio);
+		}
+
+	uint8_t buf[4096];
+	size_t count = 0;
+	uint32_t ts_last = 0;
+	uint64_t ts_high = 0;
+	int first = 1;
+	unsigned long skipped = 0;
+
+	for (;;) {
+		ssize_t r = read(fd, buf + count, sizeof(buf) - count);
+		if (r <= 0) {
+			break;
+			}
+		count += (size_t)r;
+
+		size_t pos = 0;
+		while (count - pos >= 4) {
+			uint32_t hdr = buf[pos] | (buf[pos+1] << 8) | (buf[pos+2] << 16) | ((uint32_t)buf[pos+3] << 24);
+			if (!valid_header(hdr)) {
+				pos++;
+				skipped++;
+				continue;
+				}
+			uint32_t nargs = LOG_NARGS(hdr);
+			size_t rec_len = 8U + 4U*nargs;
+			if (count - pos < rec_len) {
+				break;
+				}
+			uint32_t w[2 + LOG_MAX_ARGS];
+			for (uint32_t i = 0; i < 2U + nargs; i++) {
+				const uint8_t* p = buf + pos + 4U*i;
+				w[i] = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+				}
+			pos += rec_len;
+
+			if (skipped) {
+				printf("logdecode : %lu bytes skipped\n", skipped);
+				skipped = 0;
+				}
+			// the records of preempted writers can be slightly out of order, a large step back is a wrap
+			uint32_t ts = w[1];
+			if (!first && ts < ts_last && ts_last - ts > 0x80000000U) {
+				ts_high += 1ULL << 32;
+				}
+			if (first || ts > ts_last || ts_last - ts > 0x80000000U) {
+				ts_last = ts;
+				}
+			first = 0;
+			printf("[%12.6f] ", (double)(ts_high + ts) / clock_hz);
+			print_record(elf.logstr + (hdr & LOG_ID_MASK), &w[2], nargs);
+			fflush(stdout);
+			}
+		memmove(buf, buf + pos, count - pos);
+		count -= pos;
+		}
+	return 0;
+	}
@@ -0,0 +1,197 @@
+// Host-side PLLI2S solver, generates drivers/BSP/bsp_audio_clk.c
+//
+// For every supported sampling frequency, searches the PLLI2S dividers M, N, R and the I2S prescaler I2SDIV, ODD
+// giving the smallest frequency error, for each MCU and MCLK output option :
+//  - STM32F411 with MCLK output  : Fs = I2SCLK / (256 * (2*I2SDIV + ODD))
+//  - STM32F411 without MCLK      : Fs = I2SCLK / (64 * (2*I2SDIV + ODD)), 24bit data in 32bit channel frame
+//  - STM32F401 (no MCLK output)  : same, but PLLI2S shares the main PLL input divider M = 25
+// I2SCLK = HSE / M * N / R, HSE = 25MHz.
+// Each table entry also holds the nominal feedback value, Fs/1000 in 10.22 format, see USBD_AUDIO_SOF(), and the
+// RCC_PLLI2SCFGR and SPI_I2SPR register images that BSP_AUDIO_OUT_ClockConfig() writes on a rate change.
+// The ASRC table (USE_AUDIO_ASRC) holds the fixed I2S clocks of the resampler output : the jitter of the PLL
+// decreases with its input frequency, so the highest VCO input frequency is selected first, then the smallest error.
+// The resampler measures the true Fs, a few ppm of error do not matter.
+//
+// Usage : make, or ./build/plli2s > ../drivers/BSP/bsp_audio_clk.c
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#define HSE_HZ          25000000ULL
+
+// RM0383 / RM0368 PLLI2S constraints
+#define VCO_IN_MIN      1000000ULL  // 2MHz recommended to limit the jitter
+#define VCO_IN_MAX      2000000ULL
+#define VCO_OUT_MIN     100000000ULL
+#define VCO_OUT_MAX     432000000ULL
+#define I2SCLK_MAX      192000000ULL
+#define PLLI2SN_MIN     50U
+#define PLLI2SN_MAX     432U
+#define PLLI2SR_MIN     2U
+#define PLLI2SR_MAX     7U
+#define I2SDIV_MIN      2U
+#define I2SDIV_MAX      255U
+
+// Must match AUDIO_FREQ_NUM and the sampling frequencies in the USBD_AUDIO_CfgDesc descriptor
+static const uint32_t Freq[] = {32000, 44100, 48000, 88200, 96000};
+#define FREQ_NUM        (sizeof(Freq)/sizeof(Freq[0]))
+
+// Must match AUDIO_ASRC_FREQ_NUM, the AUDIO_ASRC_OUT_FREQ choices
+static const uint32_t FreqAsrc[] = {48000, 96000};
+#define FREQ_ASRC_NUM   (sizeof(FreqAsrc)/sizeof(FreqAsrc[0]))
+
+typedef struct {
+	uint32_t M, N, R, I2SDIV, ODD;
+	double fs;
+	double ppm;
+	uint32_t nominal_fdbk;
+	uint32_t plli2scfgr, i2spr;
+} SOLUTION;
+
+typedef struct {
+	const char* condition;
+	const char* description;
+	uint32_t m_min, m_max;   // F401 : fixed by the main PLL
+	uint32_t m_reg;          // 1 if RCC_PLLI2SCFGR has the PLLI2SM field (F411)
+	uint32_t frame_div;      // 256 with MCLK output, else 64
+} VARIANT;
+
+static const VARIANT Variant[] = {
+	{"#if defined(STM32F411xE) && defined(USE_MCLK_OUT) // Makefile compile flag", "STM32F411, MCLK output", 13, 25, 1, 256},
+	{"#elif defined(STM32F411xE)", "STM32F411, no MCLK output", 13, 25, 1, 64},
+	{"#else", "STM32F401, no MCLK output, M = 25 is set by the main PLL", 25, 25, 0, 64},
+	};
+
+// RM0383 / RM0368 register fields
+#define PLLI2SCFGR_N_POS    6U
+#define PLLI2SCFGR_R_POS    28U
+#define I2SPR_ODD_POS       8U
+#define I2SPR_MCKOE         (1U << 9)
+
+
+/**
+ * @brief  Search the dividers for one sampling frequency
+ * @param  jitter: 1 to select the highest VCO input frequency first
+ * @retval 0 if no solution exists
+ */
+static int solve(const VARIANT* v, uint32_t freq, uint32_t jitter, SOLUTION* best){
+	int found = 0;
+	for (uint32_t m = v->m_min; m <= v->m_max; m++) {
+		uint64_t vco_in = HSE_HZ / m;
+		if ((HSE_HZ % m) || vco_in < VCO_IN_MIN || vco_in > VCO_IN_MAX) {
+			continue;
+			}
+		// M is searched upwards, the first M with a solution has the highest VCO input frequency
+		if (jitter && found) {
+			break;
+			}
+		for (uint32_t n = PLLI2SN_MIN; n <= PLLI2SN_MAX; n++) {
+			uint64_t vco = vco_in * n;
+			if (vco < VCO_OUT_MIN || vco > VCO_OUT_MAX) {
+				continue;
+				}
+			for (uint32_t r = PLLI2SR_MIN; r <= PLLI2SR_MAX; r++) {
+				if (vco / r > I2SCLK_MAX) {
+					continue;
+					}
+				double i2sclk = (double)vco / r;
+				// nearest prescaler 2*I2SDIV + ODD
+				uint32_t div = (uint32_t)lround(i2sclk / ((double)v->frame_div * freq));
+				if (div < 2U*I2SDIV_MIN || div > 2U*I2SDIV_MAX + 1U) {
+					continue;
+					}
+				double fs = i2sclk / ((double)v->frame_div * div);
+				double ppm = (fs - freq) * 1.0e6 / freq;
+				// smallest error first, then the highest VCO input frequency
+				if (!found || fabs(ppm) < fabs(best->ppm) - 1.0e-9) {
+					found = 1;
+					best->M = m;
+					best->N = n;
+					best->R = r;
+					best->I2SDIV = div / 2U;
+					best->ODD = div & 1U;
+					best->fs = fs;
+					best->ppm = ppm;
+					// Fs/1000 in 10.22 format, exact rational rounding
+					uint64_t num = HSE_HZ * n << 22;
+					uint64_t den = (uint64_t)m * r * v->frame_div * div * 1000ULL;
+					best->nominal_fdbk = (uint32_t)((num + den/2) / den);
+					}
+				}
+			}
+		}
+	return found;
+	}
+
+
+/**
+ * @brief  Print a settings table
+ * @retval 0 if a frequency has no solution
+ */
+static int table(const VARIANT* v, const char* name, const char* size, const uint32_t* freq, uint32_t num, uint32_t jitter){
+	printf("const I2S_CLK_CONFIG %s[%s] = {\n", name, size);
+	for (uint32_t k = 0; k < num; k++) {
+		SOLUTION s = {0};
+		if (!solve(v, freq[k], jitter, &s)) {
+			fprintf(stderr, "no PLLI2S solution for %uHz (%s)\n", freq[k], v->description);
+			return 0;
+			}
+		// the reserved bits are 0 at reset
+		s.plli2scfgr = (s.R << PLLI2SCFGR_R_POS) | (s.N << PLLI2SCFGR_N_POS) | (v->m_reg ? s.M : 0U);
+		s.i2spr = (v->frame_div == 256U ? I2SPR_MCKOE : 0U) | (s.ODD << I2SPR_ODD_POS) | s.I2SDIV;
+		printf("{%u, %u, %u, %u, %u, %u, 0x%08X, 0x%08X, 0x%03X}%s // %.4f kHz, %+.1f ppm\n",
+			freq[k], s.M, s.N, s.R, s.I2SDIV, s.ODD, s.nominal_fdbk, s.plli2scfgr, s.i2spr, k + 1 < num ? ", " : "  ",
+			s.fs/1000.0, s.ppm);
+		}
+	printf("};\n\n");
+	return 1;
+	}
+
+
+int main(void){
+	printf("// Generated by plli2s/plli2s.c, do not edit : run make -C plli2s to regenerate.\n");
+	printf("// PLLI2S and I2S prescaler settings for each sampling frequency, see BSP_AUDIO_OUT_ClockConfig().\n");
+	printf("// HSE 25MHz, I2SCLK = HSE / M * N / R\n\n");
+	printf("#include \"bsp_audio.h\"\n\n");
+	for (uint32_t i = 0; i < sizeof(Variant)/sizeof(Variant[0]); i++) {
+		const VARIANT* v = &Variant[i];
+		printf("%s\n\n", v->condition);
+		printf("// %s : Fs = I2SCLK / (%u * (2*I2SDIV + ODD))\n", v->description, v->frame_div);
+		if (!table(v, "I2S_Clk_Config24", "AUDIO_FREQ_NUM", Freq, FREQ_NUM, 0)) {
+			return 1;
+			}
+		printf("// Fixed I2S clocks of the ASRC output, highest VCO input frequency first\n");
+		if (!table(v, "I2S_Clk_ConfigAsrc", "AUDIO_ASRC_FREQ_NUM", FreqAsrc, FREQ_ASRC_NUM, 1)) {
+			return 1;
+			}
+		}
+	printf("#endif\n\n\n");
+	printf("/**\n");
+	printf(" * @brief  PLLI2S settings for a sampling frequency\n");
+	printf(" * @param  freq: sampling frequency [Hz]\n");
+	printf(" * @retval settings, the 96kHz settings if the frequency is not supported\n");
+	printf(" */\n");
+	printf("const I2S_CLK_CONFIG* BSP_AUDIO_OUT_GetClkConfig(uint32_t freq) {\n");
+	printf("\tfor (int index = 0; index < AUDIO_FREQ_NUM; index++) {\n");
+	printf("\t\tif (I2S_Clk_Config24[index].freq == freq) {\n");
+	printf("\t\t\treturn &I2S_Clk_Config24[index];\n");
+	printf("\t\t\t}\n");
+	printf("\t\t}\n");
+	printf("\treturn &I2S_Clk_Config24[AUDIO_FREQ_NUM - 1];\n");
+	printf("\t}\n\n\n");
+	printf("/**\n");
+	printf(" * @brief  Fixed PLLI2S settings of the ASRC output (USE_AUDIO_ASRC)\n");
+	printf(" * @param  freq: I2S sampling frequency [Hz], AUDIO_ASRC_OUT_FREQ\n");
+	printf(" * @retval settings, the 48kHz settings if the frequency is not supported\n");
+	printf(" */\n");
+	printf("const I2S_CLK_CONFIG* BSP_AUDIO_OUT_GetAsrcClkConfig(uint32_t freq) {\n");
+	printf("\tfor (int index = 0; index < AUDIO_ASRC_FREQ_NUM; index++) {\n");
+	printf("\t\tif (I2S_Clk_ConfigAsrc[index].freq == freq) {\n");
+	printf("\t\t\treturn &I2S_Clk_ConfigAsrc[index];\n");
+	printf("\t\t\t}\n");
+	printf("\t\t}\n");
+	printf("\treturn &I2S_Clk_ConfigAsrc[0];\n");
+	printf("\t}\n");
+	return 0;
+	}
@@ -0,0 +1,570 @@
+// Host-side closed loop simulator for the USB audio feedback path.
+//
+// Links the real USBD_AUDIO class driver (SOF, DataOut, DataIn, IsoINIncomplete, IsoOutIncomplete, Process)
+// against the mock LL layer in sim_ll.c. Each 1ms USB frame the event loop
+//  - runs the SOF interrupt, optionally delayed by a random interrupt latency,
+//  - polls the feedback IN endpoint and hands the value to the simulated host,
+//  - sends an isochronous OUT packet sized by the host's feedback accumulator (or a fixed pattern),
+//  - runs the deferred conversion (PendSV) of the staged packet,
+//  - raises the incomplete isochronous IN/OUT interrupts for anything not completed in the frame.
+// The I2S DMA drains the audio ring at the PLLI2S sampling frequency offset by the device crystal ppm,
+// so the distance between the DMA read position and the firmware's write pointer is what the loop controls.
+// With USE_AUDIO_ASRC and USE_AUDIO_UPSAMPLE the DMA plays the resampled periods and the read position is that
+// of the resampler.
+// With -S the host switches the stream half way through the run : alt setting 0, the same alt setting again and the
+// new sampling frequency, in one frame. PLLI2S takes SIM_PLLI2S_LOCK_TIME to lock after each reconfiguration.
+//
+// Usage example : one hour with a -150ppm crystal drifting 2ppm/hour, 100us SOF latency jitter, 0.1% lost frames
+// ./build/fbsim -f 48000 -t 3600 -d -150 -r 2 -j 100 -x 0.001 -i 60
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "sim.h"
+#include "bsp_audio.h"
+
+#define SIM_BLOCK_FRAMES     16U   // settling history resolution
+#define SIM_FB_QUEUE         64U   // max host feedback latency in frames
+#define SIM_PATTERN_MAX      64U
+
+typedef struct SIM_BLOCK_ {
+	int32_t fill_min;   // halfwords
+	int32_t fill_max;
+	float   fb_err_min; // ppm
+	float   fb_err_max;
+	uint8_t valid;      // playback was running
+} SIM_BLOCK;
+
+// simulation parameters
+static uint32_t opt_freq = 96000;
+static uint32_t opt_bits = 24;
+static uint32_t opt_profile = AUDIO_LATENCY_DEFAULT;
+static double   opt_time = 3600.0;
+static double   opt_ppm = 0.0;
+static double   opt_drift = 0.0;
+static double   opt_jitter_us = 0.0;
+static double   opt_drop = 0.0;
+static uint32_t opt_burst = 1;
+static uint32_t opt_latency = 1;
+static double   opt_band = 4.0;
+static double   opt_fb_band = 200.0;
+static double   opt_trace = 0.0;
+static uint32_t opt_seed = 1;
+static uint32_t opt_switch = 0;
+static uint32_t pattern[SIM_PATTERN_MAX];
+static uint32_t pattern_len = 0;
+
+static uint32_t rng_state;
+
+static double rng_uniform(void){
+	// xorshift32, reproducible across hosts
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return (double)rng_state / 4294967296.0;
+	}
+
+static void usage(void){
+	printf("usage: fbsim [options]\n"
+		"  -f <Hz>      sampling frequency 32000, 44100, 48000, 88200 or 96000 (default 96000)\n"
+		"  -w <bits>    stream bit depth 24 (alt setting 1) or 16 (alt setting 2) (default 24)\n"
+		"  -l <n>       latency profile 0 low, 1 normal, 2 deep (default %u)\n"
+		"  -t <s>       virtual run time (default 3600)\n"
+		"  -d <ppm>     device crystal offset wrt the host USB frame clock (default 0)\n"
+		"  -r <ppm/h>   crystal drift rate (default 0)\n"
+		"  -j <us>      SOF interrupt latency jitter, uniform 0..j (default 0)\n"
+		"  -x <p>       probability of a dropped frame, no OUT packet and no feedback poll (default 0)\n"
+		"  -g <frames>  frames lost in a row from each drop, e.g. a stalled host (default 1)\n"
+		"  -p <list>    host ignores feedback and repeats this packet size pattern, e.g. 47,48,49\n"
+		"  -L <frames>  host feedback latency (default 1)\n"
+		"  -b <samples> fill settling band (default 4)\n"
+		"  -B <ppm>     feedback settling band (default 200)\n"
+		"  -i <s>       trace interval, 0 = off (default 0)\n"
+		"  -s <seed>    random seed (default 1)\n"
+		"  -S <Hz>      switch to this sampling frequency half way through the run (default off)\n", AUDIO_LATENCY_DEFAULT);
+	}
+
+static int parse_pattern(const char* s){
+	char* end;
+	pattern_len = 0;
+	while (*s && pattern_len < SIM_PATTERN_MAX) {
+		pattern[pattern_len++] = (uint32_t)strtoul(s, &end, 10);
+		if (end == s) return -1;
+		s = (*end == ',') ? end + 1 : end;
+		}
+	return pattern_len ? 0 : -1;
+	}
+
+// Rate the feedback converges to : the I2S Fs, or with USE_AUDIO_ASRC the nominal stream rate, the resampler takes
+// up the crystal error
+static double sim_fb_fs(void){
+#ifdef USE_AUDIO_ASRC
+	return (double)opt_freq;
+#elif defined(USE_AUDIO_UPSAMPLE)
+	// the I2S plays factor samples for each sample of the stream
+	USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)sim_dev.pClassData;
+	return sim_i2s_fs(sim.freq) * (1.0 + sim.ppm * 1.0e-6) / haudio->ups.factor;
+#else
+	return sim_i2s_fs(opt_freq) * (1.0 + sim.ppm * 1.0e-6);
+#endif
+	}
+
+static double fb_to_hz(const uint8_t* fb){
+	uint32_t v = fb[0] | (fb[1] << 8) | (fb[2] << 16);
+	return (double)v * 1000.0 / (double)(1 << 14);
+	}
+
+// SET_INTERFACE of the audio streaming interface
+static void sim_set_interface(uint16_t alt){
+	USBD_SetupReqTypedef req;
+	req.bmRequest = USB_REQ_TYPE_STANDARD | USB_REQ_RECIPIENT_INTERFACE;
+	req.bRequest = USB_REQ_SET_INTERFACE;
+	req.wValue = alt;
+	req.wIndex = 1;
+	req.wLength = 0;
+	USBD_AUDIO.Setup(&sim_dev, &req);
+	}
+
+// SET_CUR sampling frequency of the OUT endpoint
+static void sim_set_freq(uint32_t freq){
+	USBD_SetupReqTypedef req;
+	req.bmRequest = USB_REQ_TYPE_CLASS | USB_REQ_RECIPIENT_ENDPOINT;
+	req.bRequest = AUDIO_REQ_SET_CUR;
+	req.wValue = AUDIO_STREAMING_REQ_FREQ_CTRL << 8;
+	req.wIndex = AUDIO_OUT_EP;
+	req.wLength = 3;
+	sim.ep0_rx_buf = NULL;
+	USBD_AUDIO.Setup(&sim_dev, &req);
+	if (sim.ep0_rx_buf != NULL) {
+		sim.ep0_rx_buf[0] = (uint8_t)(freq);
+		sim.ep0_rx_buf[1] = (uint8_t)(freq >> 8);
+		sim.ep0_rx_buf[2] = (uint8_t)(freq >> 16);
+		USBD_AUDIO.EP0_RxReady(&sim_dev);
+		}
+	}
+
+// Drive the class driver through enumeration : latency profile vendor request, SET_INTERFACE alt 1 or 2,
+// then SET_CUR sampling frequency
+static void sim_enumerate(void){
+	USBD_SetupReqTypedef req;
+
+	USBD_AUDIO_RegisterInterface(&sim_dev, &sim_audio_fops);
+	sim_dev.pClass = &USBD_AUDIO;
+	sim_dev.dev_state = USBD_STATE_CONFIGURED;
+	USBD_AUDIO.Init(&sim_dev, 0);
+
+	req.bmRequest = USB_REQ_TYPE_VENDOR | USB_REQ_RECIPIENT_DEVICE;
+	req.bRequest = AUDIO_VENDOR_REQ_LATENCY;
+	req.wValue = opt_profile;
+	req.wIndex = 0;
+	req.wLength = 0;
+	USBD_AUDIO.Setup(&sim_dev, &req);
+
+	sim_set_interface(opt_bits == 16U ? AUDIO_ALT_16B : AUDIO_ALT_24B);
+	sim_set_freq(opt_freq);
+	}
+
+// The stream is fading out or draining before a switch, no packets and the DMA plays past the write index
+static int sim_switching(const USBD_AUDIO_HandleTypeDef* haudio){
+	return haudio->sw_state == AUDIO_SWITCH_FADE || haudio->sw_state == AUDIO_SWITCH_DRAIN;
+	}
+
+// Time from the request that started the last stream switch to its first sample played
+static uint32_t sim_switch_us(void){
+	USBD_AUDIO_StatusTypeDef status;
+	USBD_AUDIO_GetStatus(&sim_dev, &status);
+	return status.switch_us;
+	}
+
+// Account the moves of the write index by the concealment : forward over silence after an underrun,
+// back to the setpoint after an overrun, forward to the setpoint on the first packet after an underrun
+static void sim_skip(const USBD_AUDIO_HandleTypeDef* haudio, int64_t* wr_total, uint32_t* skip_last){
+	if (haudio->skip != *skip_last) {
+		*wr_total += (haudio->skip - *skip_last) % haudio->buf_size;
+		if (*wr_total - (int64_t)sim_rd_pos() > (int64_t)haudio->buf_size) {
+			*wr_total -= haudio->buf_size;
+			}
+		*skip_last = haudio->skip;
+		}
+	}
+
+// Run USBD_AUDIO_Process and account the samples written, the write index moves were counted by sim_skip
+static void sim_process(const USBD_AUDIO_HandleTypeDef* haudio, int64_t* wr_total){
+	uint16_t wr_before = haudio->conv_ptr;
+	uint32_t skip_before = haudio->skip_seen;
+	uint32_t flush_before = haudio->fifo.flush_seen;
+	USBD_AUDIO_Process(&sim_dev);
+	if (haudio->fifo.flush_seen != flush_before) {
+		// conv_ptr restarts from 0, the DMA restart resynchronizes wr_total
+		return;
+		}
+	uint32_t skipped = (haudio->skip_seen - skip_before) % haudio->buf_size;
+	*wr_total += (haudio->conv_ptr + 2U*haudio->buf_size - wr_before - skipped) % haudio->buf_size;
+	}
+
+int main(int argc, char* argv[]){
+	int c;
+	while ((c = getopt(argc, argv, "f:w:l:t:d:r:j:x:g:p:L:b:B:i:s:S:h")) != -1) {
+		switch (c) {
+			case 'f': opt_freq = (uint32_t)atoi(optarg); break;
+			case 'w': opt_bits = (uint32_t)atoi(optarg); break;
+			case 'l': opt_profile = (uint32_t)atoi(optarg); break;
+			case 't': opt_time = atof(optarg); break;
+			case 'd': opt_ppm = atof(optarg); break;
+			case 'r': opt_drift = atof(optarg); break;
+			case 'j': opt_jitter_us = atof(optarg); break;
+			case 'x': opt_drop = atof(optarg); break;
+			case 'g': opt_burst = (uint32_t)atoi(optarg); break;
+			case 'p':
+				if (parse_pattern(optarg) != 0) { usage(); return 2; }
+				break;
+			case 'L': opt_latency = (uint32_t)atoi(optarg); break;
+			case 'b': opt_band = atof(optarg); break;
+			case 'B': opt_fb_band = atof(optarg); break;
+			case 'i': opt_trace = atof(optarg); break;
+			case 's': opt_seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'S': opt_switch = (uint32_t)atoi(optarg); break;
+			default : usage(); return 2;
+			}
+		}
+	if (BSP_AUDIO_OUT_GetClkConfig(opt_freq)->freq != opt_freq || opt_freq > USBD_AUDIO_FREQ_MAX ||
+		(opt_bits != 16U && opt_bits != 24U) || opt_profile >= AUDIO_LATENCY_NUM ||
+		opt_latency >= SIM_FB_QUEUE || opt_burst == 0U || opt_time <= 0.0 ||
+		(opt_switch != 0U && (BSP_AUDIO_OUT_GetClkConfig(opt_switch)->freq != opt_switch || opt_switch > USBD_AUDIO_FREQ_MAX))) {
+		usage();
+		return 2;
+		}
+	rng_state = opt_seed ? opt_seed : 1U;
+
+	uint32_t num_frames = (uint32_t)(opt_time * 1000.0);
+	uint32_t num_blocks = num_frames / SIM_BLOCK_FRAMES + 1;
+	SIM_BLOCK* blocks = calloc(num_blocks, sizeof(SIM_BLOCK));
+	if (blocks == NULL) {
+		printf("out of memory\n");
+		return 2;
+		}
+
+	sim.ppm = opt_ppm;
+	sim_enumerate();
+	USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)sim_dev.pClassData;
+	const uint32_t ring_size = haudio->buf_size;
+	const uint32_t max_samples = AUDIO_OUT_PACKET_24B / 6U;
+
+	// host state
+	uint32_t host_fb = (uint32_t)(((uint64_t)opt_freq << 14) / 1000U); // 10.14 samples per frame
+	uint32_t host_acc = 0;
+	uint32_t host_fb_q[SIM_FB_QUEUE] = {0};
+	uint8_t  host_fb_q_valid[SIM_FB_QUEUE] = {0};
+	uint8_t  packet[AUDIO_OUT_PACKET_24B];
+	uint32_t pkt_hist[AUDIO_OUT_PACKET_24B / 6U + 1] = {0};
+	uint32_t audio_val = 0;
+
+	// statistics
+	int64_t  wr_total = 0;   // halfwords written to the ring by USBD_AUDIO_Process or silenced by the concealment
+	uint32_t skip_last = 0;  // haudio->skip last accounted
+	uint32_t dma_starts = 0; // sim.dma_starts last seen
+	uint32_t switch_frame = opt_switch ? num_frames / 2U : UINT32_MAX;
+	uint32_t switch_start_us = 0; // time to the first sample played after the enumeration
+	uint32_t switch_freq = opt_freq;
+	uint32_t drop_left = 0;
+	uint32_t underruns = 0, overruns = 0, dropped = 0, out_incomplete = 0, in_incomplete = 0, fb_received = 0;
+	int32_t  fill_min = INT32_MAX, fill_max = INT32_MIN;
+	double   fb_min = 1e9, fb_max = 0.0, fb_sum = 0.0;
+	uint32_t fb_count = 0;
+	double   fb_last = 0.0;
+	double   start_time = -1.0;
+	double   next_trace = opt_trace;
+	clock_t  cpu_start = clock();
+
+	for (uint32_t k = 0; k < num_frames; k++) {
+		double t0 = k * 1.0e-3;
+		sim.ppm = opt_ppm + opt_drift * t0 / 3600.0;
+		sim.frame = k;
+		uint8_t drop = 0U;
+		if (drop_left) {
+			drop = 1U;
+			drop_left--;
+			}
+		else
+		if (opt_drop > 0.0 && rng_uniform() < opt_drop) {
+			drop = 1U;
+			drop_left = opt_burst - 1U;
+			}
+		uint8_t out_done = 0U, in_done = 0U;
+		dropped += drop;
+
+		// SOF interrupt, TIM2 captures the SOF in hardware before the interrupt latency
+		sim.now = t0;
+		sim_dma_advance(sim.now);
+		sim_sof_capture();
+		// fill statistics at the SOF instant
+		if (sim.dma_on && sim_switching(haudio) == 0) {
+			if (start_time < 0.0) start_time = sim.now;
+			int32_t fill = (int32_t)(wr_total - (int64_t)sim_rd_pos());
+			while (fill < 0) {
+				// the DMA read position passed the write pointer and replays old data
+				underruns++;
+				wr_total += ring_size;
+				fill += ring_size;
+				}
+			if (fill < fill_min) fill_min = fill;
+			if (fill > fill_max) fill_max = fill;
+			SIM_BLOCK* b = &blocks[k / SIM_BLOCK_FRAMES];
+			if (b->valid == 0U) {
+				b->valid = 1U;
+				b->fill_min = b->fill_max = fill;
+				b->fb_err_min = 1e9f;
+				b->fb_err_max = -1e9f;
+				}
+			if (fill < b->fill_min) b->fill_min = fill;
+			if (fill > b->fill_max) b->fill_max = fill;
+			}
+
+		sim.now = t0 + opt_jitter_us * 1.0e-6 * (opt_jitter_us > 0.0 ? rng_uniform() : 0.0);
+		sim_dma_advance(sim.now);
+		if (k == switch_frame) {
+			// the host switches the stream during its SOF
+			switch_start_us = sim_switch_us();
+			sim_set_interface(0U);
+			sim_set_interface(opt_bits == 16U ? AUDIO_ALT_16B : AUDIO_ALT_24B);
+			sim_set_freq(opt_switch);
+			switch_freq = opt_freq;
+			opt_freq = opt_switch;
+			host_fb = (uint32_t)(((uint64_t)opt_freq << 14) / 1000U);
+			host_acc = 0U;
+			memset(host_fb_q_valid, 0, sizeof(host_fb_q_valid));
+			}
+		USBD_AUDIO.SOF(&sim_dev);
+		if (sim.process_pending) {
+			// PendSV, the switch flushes the staging FIFO
+			sim.process_pending = 0U;
+			sim_process(haudio, &wr_total);
+			}
+		sim_skip(haudio, &wr_total, &skip_last);
+		if (sim.dma_starts != dma_starts) {
+			// the DMA restarted on the pre-roll, ahead of the write index
+			dma_starts = sim.dma_starts;
+			wr_total = haudio->wr_ptr;
+			skip_last = haudio->skip;
+			}
+
+		// Feedback IN poll, the packet was armed in an earlier frame
+		sim.now = t0 + 0.1e-3;
+		sim_dma_advance(sim.now);
+		if (sim.fb_armed && sim.fb_arm_frame < k && drop == 0U) {
+			sim.fb_armed = 0U;
+			in_done = 1U;
+			fb_received++;
+			host_fb_q[(k + opt_latency) % SIM_FB_QUEUE] = sim.fb_data[0] | (sim.fb_data[1] << 8) | (sim.fb_data[2] << 16);
+			host_fb_q_valid[(k + opt_latency) % SIM_FB_QUEUE] = 1U;
+			fb_last = fb_to_hz(sim.fb_data);
+			if (sim.dma_on) {
+				double fs = sim_fb_fs();
+				float err = (float)((fb_last - fs) / fs * 1.0e6);
+				SIM_BLOCK* b = &blocks[k / SIM_BLOCK_FRAMES];
+				if (err < b->fb_err_min) b->fb_err_min = err;
+				if (err > b->fb_err_max) b->fb_err_max = err;
+				if (fb_last < fb_min) fb_min = fb_last;
+				if (fb_last > fb_max) fb_max = fb_last;
+				if (k >= num_frames - num_frames / 10) {
+					fb_sum += fb_last;
+					fb_count++;
+					}
+				}
+			USBD_AUDIO.DataIn(&sim_dev, AUDIO_IN_EP & 0xFU);
+			}
+
+		// Isochronous OUT packet from the host
+		if (host_fb_q_valid[k % SIM_FB_QUEUE]) {
+			host_fb = host_fb_q[k % SIM_FB_QUEUE];
+			host_fb_q_valid[k % SIM_FB_QUEUE] = 0U;
+			}
+		uint32_t n;
+		if (pattern_len) {
+			n = pattern[k % pattern_len];
+			}
+		else {
+			host_acc += host_fb;
+			n = host_acc >> 14;
+			host_acc &= 0x3FFFU;
+			}
+		if (n > max_samples) n = max_samples;
+		pkt_hist[n]++;
+
+		sim.now = t0 + 0.5e-3;
+		sim_dma_advance(sim.now);
+		if (drop == 0U && sim.rx_armed) {
+			uint32_t len = n * AUDIO_SAMPLE_BYTES(opt_bits);
+			if (len > sim.rx_max) len = sim.rx_max;
+			if (opt_bits == 16U) {
+				for (uint32_t i = 0; i < len; i += 2) {
+					audio_val += 0x10000;
+					packet[i] = (uint8_t)(audio_val >> 16);
+					packet[i+1] = (uint8_t)(audio_val >> 24);
+					}
+				}
+			else {
+				for (uint32_t i = 0; i < len; i += 3) {
+					audio_val += 0x1000;
+					packet[i] = (uint8_t)(audio_val >> 8);
+					packet[i+1] = (uint8_t)(audio_val >> 16);
+					packet[i+2] = (uint8_t)(audio_val >> 24);
+					}
+				}
+			if (sim.rx_ring != NULL) {
+				// RX FIFO drained into the staging FIFO, see USB_ReadPacketRing()
+				sim.rx_into_fifo++;
+				if (sim.rx_ring_pos + len > sim.rx_ring_size) {
+					sim.rx_fifo_wraps++;
+					}
+				for (uint32_t i = 0; i < len; i++) {
+					sim.rx_ring[(sim.rx_ring_pos + i) % sim.rx_ring_size] = packet[i];
+					}
+				}
+			else
+			if (sim.rx_buf != NULL) {
+				// the FIFO was full, the packet is dropped, see USBD_AUDIO_PrepareReceive()
+				memcpy(sim.rx_buf, packet, len);
+				}
+			sim.rx_count = len;
+			sim.rx_armed = 0U;
+			out_done = 1U;
+
+			if (sim.dma_on && sim_switching(haudio) == 0) {
+				int32_t fill = (int32_t)(wr_total - (int64_t)sim_rd_pos());
+				while (fill < 0) {
+					// the DMA read position passed the write pointer and replays old data
+					underruns++;
+					wr_total += ring_size;
+					fill += ring_size;
+					}
+				}
+			USBD_AUDIO.DataOut(&sim_dev, AUDIO_OUT_EP);
+			// the first packet after an underrun or the pre-roll moves the write index
+			sim_skip(haudio, &wr_total, &skip_last);
+
+			// PendSV tail-chains after the OTG interrupt
+			sim.now = t0 + 0.52e-3;
+			sim_dma_advance(sim.now);
+			if (sim.process_pending) {
+				sim.process_pending = 0U;
+				sim_process(haudio, &wr_total);
+				}
+			if (sim.dma_on && sim_switching(haudio) == 0) {
+				int32_t fill = (int32_t)(wr_total - (int64_t)sim_rd_pos());
+				while (fill > (int32_t)ring_size) {
+					// the write pointer overtook the DMA read position and overwrote unplayed data
+					overruns++;
+					wr_total -= ring_size;
+					fill -= ring_size;
+					}
+				}
+			}
+
+		// End of periodic frame
+		sim.now = t0 + 0.95e-3;
+		sim_dma_advance(sim.now);
+		if (sim.fb_armed && sim.fb_arm_frame < k && in_done == 0U) {
+			in_incomplete++;
+			USBD_AUDIO.IsoINIncomplete(&sim_dev, 0U);
+			}
+		if (out_done == 0U) {
+			// the HAL reports incomplete isochronous OUT with epnum 0
+			out_incomplete++;
+			USBD_AUDIO.IsoOUTIncomplete(&sim_dev, 0U);
+			}
+
+		if (opt_trace > 0.0 && t0 >= next_trace) {
+			next_trace += opt_trace;
+			double fs = sim_fb_fs();
+			printf("t %9.1fs  ppm %+8.2f  fill %7.2f  fb %10.4fHz  fs %10.4fHz  err %+8.1fppm\n",
+				t0, sim.ppm, (wr_total - sim_rd_pos()) / 4.0, fb_last, fs, (fb_last - fs) / fs * 1.0e6);
+			}
+		}
+
+	double cpu = (double)(clock() - cpu_start) / CLOCKS_PER_SEC;
+
+	// final mean over the last 10% of the run
+	uint32_t first_tail = (num_frames - num_frames / 10) / SIM_BLOCK_FRAMES;
+	uint32_t last_block = (num_frames - 1) / SIM_BLOCK_FRAMES;
+	double fill_final = 0.0;
+	uint32_t tail_count = 0;
+	for (uint32_t i = first_tail; i <= last_block; i++) {
+		fill_final += (blocks[i].fill_min + blocks[i].fill_max) / 2.0;
+		tail_count++;
+		}
+	fill_final /= tail_count ? tail_count : 1;
+
+	double fill_settle = -1.0, fb_settle = -1.0;
+	for (uint32_t i = last_block + 1; i-- > 0;) {
+		if (blocks[i].valid == 0U) break; // not playing yet
+		double t = (i + 1) * SIM_BLOCK_FRAMES * 1.0e-3;
+		if (fill_settle < 0.0 && (fabs(blocks[i].fill_min - fill_final) > opt_band * 4.0 || fabs(blocks[i].fill_max - fill_final) > opt_band * 4.0)) {
+			fill_settle = t;
+			}
+		if (fb_settle < 0.0 && blocks[i].fb_err_min < 1e8f && (fabsf(blocks[i].fb_err_min) > opt_fb_band || fabsf(blocks[i].fb_err_max) > opt_fb_band)) {
+			fb_settle = t;
+			}
+		}
+	if (fill_settle < 0.0) fill_settle = start_time;
+	if (fb_settle < 0.0) fb_settle = start_time;
+
+	double setpoint = ring_size / 8.0;
+	double fs_end = sim_fb_fs();
+	double fb_mean = fb_count ? fb_sum / fb_count : 0.0;
+
+	printf("run       : %.1fs virtual in %.2fs cpu, %u frames, seed %u\n", opt_time, cpu, num_frames, opt_seed);
+	printf("device    : %uHz %ubit (PLLI2S %.4fHz), crystal %+.2fppm drifting %+.2fppm/h, SOF jitter %.0fus\n",
+		opt_freq, opt_bits, sim_i2s_fs(sim.freq), opt_ppm, opt_drift, opt_jitter_us);
+	if (pattern_len) {
+		printf("host      : fixed packet pattern of %u entries, drop probability %g\n", pattern_len, opt_drop);
+		}
+	else {
+		printf("host      : feedback following, latency %u frames, drop probability %g\n", opt_latency, opt_drop);
+		}
+	printf("packets   :");
+	for (uint32_t i = 0; i <= max_samples; i++) {
+		if (pkt_hist[i]) printf(" %u:%u", i, pkt_hist[i]);
+		}
+	printf("\n");
+	if (start_time < 0.0) {
+		printf("playback never started\n");
+		free(blocks);
+		return 1;
+		}
+	printf("ring      : %u samples (latency profile %u), setpoint %.1f samples, playback started at %.3fs\n",
+		ring_size / 4U, haudio->latency, setpoint, start_time);
+	printf("fill      : min %.2f max %.2f final %.2f samples (offset %+.2f)\n",
+		fill_min / 4.0, fill_max / 4.0, fill_final / 4.0, fill_final / 4.0 - setpoint);
+	printf("settling  : fill within +/-%g samples after %.3fs, feedback within +/-%gppm after %.3fs\n",
+		opt_band, fill_settle, opt_fb_band, fb_settle);
+	printf("feedback  : min %.4fHz max %.4fHz final %.4fHz, true Fs %.4fHz (error %+.1fppm)\n",
+		fb_min, fb_max, fb_mean, fs_end, fb_count ? (fb_mean - fs_end) / fs_end * 1.0e6 : 0.0);
+	printf("events    : underruns %u, overruns %u, dropped frames %u, iso OUT incomplete %u, iso IN incomplete %u\n",
+		underruns, overruns, dropped, out_incomplete, in_incomplete);
+	printf("firmware  : %u feedback packets, %u packets received into the staging FIFO (%u wrapped past its end), %u FIFO overflows, LED on %.3f%% of SOFs\n",
+		fb_received, sim.rx_into_fifo, sim.rx_fifo_wraps, haudio->fifo.overflows, 100.0 * sim.led_on_sofs / num_frames);
+	printf("concealed : %u underruns, %u overruns, %u of %u lost packets synthesized\n",
+		haudio->underruns, haudio->overruns, haudio->frames_concealed, haudio->frames_missed);
+	if (opt_switch) {
+		printf("switch    : first sample played %uus after the enumeration, %uus after the switch from %uHz\n",
+			switch_start_us, sim_switch_us(), switch_freq);
+		}
+	else {
+		printf("switch    : first sample played %uus after the enumeration\n", sim_switch_us());
+		}
+#ifdef USE_AUDIO_VERIFY
+	{
+	// the stream is a ramp at the default volume, this only shows that the CRC runs, see verify/verify.c
+	USBD_AUDIO_StatusTypeDef status;
+	USBD_AUDIO_GetStatus(&sim_dev, &status);
+	printf("verify    : CRC 0x%08X of %u samples\n", status.crc, status.crc_samples);
+	}
+#endif
+
+	free(blocks);
+	return (underruns || overruns) ? 1 : 0;
+	}
@@ -0,0 +1,68 @@
+#ifndef __SIM_H
+#define __SIM_H
+
+// Host-side closed loop simulator for the USB audio feedback path.
+// The real usbd_audio.c class driver is linked against the mock LL/BSP layer in sim_ll.c,
+// and the event loop in fbsim.c plays the part of the USB host and the I2S DMA.
+
+#include <stdint.h>
+#include "usbd_audio.h"
+
+typedef struct SIM_STATE_ {
+	double   now;           // virtual time [s], referenced to the host USB frame clock
+	uint32_t frame;         // USB frame counter (11bit FNSOF = frame & 0x7FF)
+	double   ppm;           // device crystal offset wrt the host USB frame clock
+
+	// TIM2 SOF capture
+	double   sof_time;      // time of the last SOF
+	double   sof_ticks;     // timer count at the last SOF
+	uint32_t sof_capture;
+
+	// control endpoint, only the SET_CUR data stage is modelled
+	uint8_t* ep0_rx_buf;
+
+	// isochronous OUT endpoint (audio data)
+	uint8_t* rx_buf;        // destination of the last USBD_LL_PrepareReceive, NULL if armed with USBD_LL_PrepareReceiveRing
+	uint8_t* rx_ring;       // circular destination of the last USBD_LL_PrepareReceiveRing
+	uint32_t rx_ring_size;
+	uint32_t rx_ring_pos;
+	uint32_t rx_max;
+	uint32_t rx_count;
+	uint8_t  rx_armed;
+	uint32_t rx_into_fifo;     // packets received into the staging FIFO with USBD_LL_PrepareReceiveRing
+	uint32_t rx_fifo_wraps;    // of these, packets split across the end of the FIFO
+
+	// isochronous IN endpoint (feedback)
+	uint8_t  fb_armed;
+	uint32_t fb_arm_frame;
+	uint8_t  fb_data[3];
+
+	// I2S DMA model
+	uint8_t  dma_on;
+	uint32_t dma_size;      // circular buffer size in halfwords
+	double   dma_pos;       // halfwords consumed since AUDIO_CMD_START
+	double   dma_t;         // time of the last dma_pos update
+	uint32_t freq;          // sampling frequency requested by Init
+	uint32_t dma_starts;    // AUDIO_CMD_START count
+	double   lock_time;     // PLLI2S locked from this time on, see Sim_GetState
+#ifdef AUDIO_OUT_PERIOD_RESAMPLED
+	// resampler model, the ring is read at the stream rate while the DMA plays the resampled periods
+	uint64_t rs_copied;     // ring halfwords consumed by the resampler since AUDIO_CMD_START
+	uint64_t rs_start[2];   // rs_copied when period buffer 0 / 1 was last filled
+#endif
+
+	uint32_t led_on_sofs;   // SOFs with the writable samples monitor LED on
+
+	uint8_t  process_pending; // PendSV pended by Audio_PeriodicTC, runs USBD_AUDIO_Process
+} SIM_STATE;
+
+extern SIM_STATE sim;
+extern USBD_HandleTypeDef sim_dev;
+extern USBD_AUDIO_ItfTypeDef sim_audio_fops;
+
+void   sim_dma_advance(double t);
+void   sim_sof_capture(void);
+double sim_i2s_fs(uint32_t freq);
+double sim_rd_pos(void);
+
+#endif
@@ -0,0 +1,302 @@
+// Mock USB LL / BSP layer for the feedback simulator.
+// Replaces src/usbd_conf.c, src/usbd_audio_if.c, src/log.c and the parts of drivers/BSP used by usbd_audio.c.
+
+#include <math.h>
+#include <string.h>
+#include "sim.h"
+#include "bsp_audio.h"
+#include "bsp_sof_tim.h"
+#include "log.h"
+
+SIM_STATE sim;
+USBD_HandleTypeDef sim_dev;
+
+// APB1 timer clock, see SystemClock_Config() in src/main.c
+#ifdef STM32F411xE
+#define SIM_TIM_TICKS_PER_FRAME   96000U
+#else
+#define SIM_TIM_TICKS_PER_FRAME   84000U
+#endif
+
+/**
+ * @brief  Sampling frequency generated by the I2S PLL with a 0ppm HSE crystal
+ * @param  freq: requested sampling frequency, with USE_AUDIO_ASRC the I2S runs at AUDIO_ASRC_OUT_FREQ whatever it is
+ * @retval Fs in Hz
+ */
+double sim_i2s_fs(uint32_t freq){
+#ifdef USE_AUDIO_ASRC
+	const I2S_CLK_CONFIG* cfg = BSP_AUDIO_OUT_GetAsrcClkConfig(AUDIO_ASRC_OUT_FREQ);
+#else
+	const I2S_CLK_CONFIG* cfg = BSP_AUDIO_OUT_GetClkConfig(freq);
+#endif
+	// PLLI2S input is HSE 25MHz / M, see drivers/BSP/bsp_audio_clk.c
+	double i2sclk = 25.0e6 / cfg->M * cfg->N / cfg->R;
+#if defined(STM32F411xE) && defined(USE_MCLK_OUT)
+	return i2sclk / (256.0 * (2*cfg->I2SDIV + cfg->ODD));
+#else
+	// 24bit data in 32bit channel frame, stereo
+	return i2sclk / (64.0 * (2*cfg->I2SDIV + cfg->ODD));
+#endif
+	}
+
+
+/**
+ * @brief  Read position of the audio ring, the DMA position or with USE_AUDIO_ASRC and USE_AUDIO_UPSAMPLE the input
+ *         sample of the resampler being played, placed within the period like USBD_AUDIO_SOF() does
+ * @retval halfwords read since AUDIO_CMD_START
+ */
+double sim_rd_pos(void){
+#ifdef AUDIO_OUT_PERIOD_RESAMPLED
+	USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)sim_dev.pClassData;
+	uint8_t target;
+	uint32_t remaining = BSP_AUDIO_OUT_GetRemainingPeriodSize(&target);
+	uint32_t played = AUDIO_PERIOD_BUF_SIZE - remaining;
+	if (haudio->period_len[target] != AUDIO_PERIOD_BUF_SIZE) {
+		played = 4U*((haudio->period_len[target]/4U) * played / AUDIO_PERIOD_BUF_SIZE);
+		}
+	return (double)(sim.rs_start[target] + played);
+#else
+	return sim.dma_pos;
+#endif
+	}
+
+
+/**
+ * @brief  Advance the I2S DMA to time t, firing the half/full transfer callbacks
+ * @param  t: virtual time [s]
+ */
+void sim_dma_advance(double t){
+	if (sim.dma_on) {
+		double half = sim.dma_size / 2;
+		double rate = 4.0 * sim_i2s_fs(sim.freq) * (1.0 + sim.ppm * 1.0e-6); // 4 halfwords per stereo sample
+		double pos = sim.dma_pos + rate * (t - sim.dma_t);
+		uint64_t n = (uint64_t)(sim.dma_pos / half);
+		uint64_t n_end = (uint64_t)(pos / half);
+		sim.dma_pos = pos;
+		while (n < n_end) {
+			n++;
+			USBD_AUDIO_Sync(&sim_dev, (n & 1) ? AUDIO_OFFSET_HALF : AUDIO_OFFSET_FULL);
+#ifdef AUDIO_OUT_PERIOD_RESAMPLED
+			USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)sim_dev.pClassData;
+			uint32_t target = (n & 1) ? 0U : 1U;
+			sim.rs_start[target] = sim.rs_copied;
+			sim.rs_copied += haudio->period_len[target];
+#endif
+			}
+		}
+	sim.dma_t = t;
+	}
+
+
+/**
+ * @brief  Latch the TIM2 count on the SOF, the timer runs from the device crystal
+ */
+void sim_sof_capture(void){
+	sim.sof_time = sim.now;
+	sim.sof_ticks += SIM_TIM_TICKS_PER_FRAME * (1.0 + sim.ppm * 1.0e-6);
+	sim.sof_capture = (uint32_t)(uint64_t)sim.sof_ticks;
+	}
+
+uint32_t BSP_SOF_TIM_GetCapture(void){
+	return sim.sof_capture;
+	}
+
+uint32_t BSP_SOF_TIM_GetElapsed(void){
+	return (uint32_t)((sim.now - sim.sof_time) * 1000.0 * SIM_TIM_TICKS_PER_FRAME * (1.0 + sim.ppm * 1.0e-6));
+	}
+
+uint32_t BSP_SOF_TIM_GetTicksPerFrame(void){
+	return SIM_TIM_TICKS_PER_FRAME;
+	}
+
+uint32_t BSP_AUDIO_OUT_GetRemainingDataSize(void){
+	if (sim.dma_on == 0U) {
+		return sim.dma_size;
+		}
+	double rate = 4.0 * sim_i2s_fs(sim.freq) * (1.0 + sim.ppm * 1.0e-6);
+	uint64_t pos = (uint64_t)(sim.dma_pos + rate * (sim.now - sim.dma_t));
+	// NDTR is reloaded as soon as it reaches 0 in circular mode
+	return sim.dma_size - (uint32_t)(pos % sim.dma_size);
+	}
+
+#ifdef USE_I2S_DOUBLE_BUFFER
+uint32_t BSP_AUDIO_OUT_GetRemainingPeriodSize(uint8_t* pTarget){
+	// dma_size covers both period buffers, played one after the other
+	uint32_t period = sim.dma_size / 2U;
+	uint32_t pos = sim.dma_size - BSP_AUDIO_OUT_GetRemainingDataSize();
+	*pTarget = pos >= period ? 1U : 0U;
+	return period - pos % period;
+	}
+#endif
+
+// RTC backup registers, cleared at the start of the run like after a power cycle
+static uint32_t sim_bkp[20];
+
+uint32_t BSP_BKP_Read(uint32_t index){
+	return sim_bkp[index];
+	}
+
+void BSP_BKP_Write(uint32_t index, uint32_t value){
+	sim_bkp[index] = value;
+	}
+
+void BSP_OnboardLED_On(void){
+	sim.led_on_sofs++;
+	}
+
+void BSP_OnboardLED_Off(void){
+	}
+
+
+// Audio interface, stands in for src/usbd_audio_if.c
+
+// PLLI2S lock time after a reconfiguration, a conservative value
+#define SIM_PLLI2S_LOCK_TIME    300.0e-6
+
+static int8_t Sim_Init(uint32_t audioFreq, int16_t volume, uint8_t options){
+	if (audioFreq != sim.freq) {
+		// PLLI2S relocks on the new register images
+		sim.lock_time = sim.now + SIM_PLLI2S_LOCK_TIME;
+		}
+	sim.freq = audioFreq;
+	sim.dma_on = 0U;
+	return 0;
+	}
+
+static int8_t Sim_DeInit(uint8_t options){
+	sim.dma_on = 0U;
+	return 0;
+	}
+
+static int8_t Sim_PlaybackCmd(uint16_t* pbuf, uint32_t size, uint8_t cmd){
+	if (cmd == AUDIO_CMD_START) {
+		// size is in bytes, the DMA transfers halfwords. In double buffer mode pbuf holds both period buffers
+		// and the half/full transfer events are the ends of period buffer 0 and 1
+		sim.dma_size = size / 2U;
+		sim.dma_pos = 0.0;
+		sim.dma_t = sim.now;
+		sim.dma_on = 1U;
+		sim.dma_starts++;
+#ifdef AUDIO_OUT_PERIOD_RESAMPLED
+		// both period buffers were resampled from the start of the ring
+		USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)sim_dev.pClassData;
+		sim.rs_start[0] = 0U;
+		sim.rs_start[1] = haudio->period_len[0];
+		sim.rs_copied = haudio->period_len[0] + haudio->period_len[1];
+#endif
+		}
+	return 0;
+	}
+
+static int8_t Sim_VolumeCtl(int16_t vol){
+	return 0;
+	}
+
+static int8_t Sim_MuteCtl(uint8_t mute){
+	return 0;
+	}
+
+static int8_t Sim_PeriodicTC(uint8_t cmd){
+	if (cmd == AUDIO_CMD_PLAY) {
+		sim.process_pending = 1U;
+		}
+	return 0;
+	}
+
+static int8_t Sim_GetState(void){
+	return sim.now < sim.lock_time ? AUDIO_STATE_LOCKING : AUDIO_STATE_READY;
+	}
+
+USBD_AUDIO_ItfTypeDef sim_audio_fops = {
+	Sim_Init,
+	Sim_DeInit,
+	Sim_PlaybackCmd,
+	Sim_VolumeCtl,
+	Sim_MuteCtl,
+	Sim_PeriodicTC,
+	Sim_GetState,
+	};
+
+
+// Logger, stands in for src/log.c. The records are discarded.
+
+void LOG_Write(const uint32_t* rec, uint32_t nargs){
+	}
+
+
+// USB LL layer, stands in for src/usbd_conf.c
+
+static uint8_t sim_arena[sizeof(USBD_AUDIO_HandleTypeDef)] __attribute__((aligned(USBD_AUDIO_RAM_ALIGN)));
+
+void* USBD_static_malloc(uint32_t size){
+	if (size > sizeof(sim_arena)) {
+		return NULL;
+		}
+	memset(sim_arena, 0, sizeof(sim_arena));
+	return sim_arena;
+	}
+
+void USBD_static_free(void* p){
+	}
+
+USBD_StatusTypeDef USBD_LL_OpenEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t ep_type, uint16_t ep_mps){
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_CloseEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr){
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_FlushEP(USBD_HandleTypeDef *pdev, uint8_t ep_addr){
+	// Flushing the TxFIFO drops a feedback packet not yet sent. The RxFIFO flush does not disarm the OUT endpoint.
+	if (ep_addr == AUDIO_IN_EP) {
+		sim.fb_armed = 0U;
+		}
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_Transmit(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size){
+	if (ep_addr == AUDIO_IN_EP && size == 3U) {
+		memcpy(sim.fb_data, pbuf, 3);
+		sim.fb_armed = 1U;
+		sim.fb_arm_frame = sim.frame;
+		}
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pbuf, uint16_t size){
+	if (ep_addr == 0U) {
+		sim.ep0_rx_buf = pbuf;
+		}
+	else
+	if (ep_addr == AUDIO_OUT_EP) {
+		sim.rx_buf = pbuf;
+		sim.rx_ring = NULL;
+		sim.rx_max = size;
+		sim.rx_armed = 1U;
+		}
+	return USBD_OK;
+	}
+
+USBD_StatusTypeDef USBD_LL_PrepareReceiveRing(USBD_HandleTypeDef *pdev, uint8_t ep_addr, uint8_t *pring, uint32_t ring_size, uint32_t ring_pos, uint16_t size){
+	if (ep_addr == AUDIO_OUT_EP) {
+		sim.rx_buf = NULL;
+		sim.rx_ring = pring;
+		sim.rx_ring_size = ring_size;
+		sim.rx_ring_pos = ring_pos;
+		sim.rx_max = size;
+		sim.rx_armed = 1U;
+		}
+	return USBD_OK;
+	}
+
+uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr){
+	return sim.rx_count;
+	}
+
+uint32_t USBD_LL_GetFrameNumber(USBD_HandleTypeDef *pdev){
+	return sim.frame & 0x7FFU;
+	}
+
+void USBD_CtlError(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req){
+	}
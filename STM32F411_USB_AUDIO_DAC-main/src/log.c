@@ -0,0 +1,134 @@
+#include "main.h"
+#include "usart.h"
+#include "log.h"
+
+// USART2_TX request : DMA1 stream 6, channel 4
+#define LOG_DMA                       DMA1
+#define LOG_DMA_STREAM                LL_DMA_STREAM_6
+#define LOG_DMA_CHANNEL               LL_DMA_CHANNEL_4
+
+// Words sent per DMA transfer, ~30ms at 115200 baud
+#define LOG_DMA_MAX_WORDS             96U
+
+#define LOG_RING_MASK                 (LOG_RING_WORDS - 1U)
+
+// Free running indexes in words, the ring position is index & LOG_RING_MASK
+static uint32_t log_ring[LOG_RING_WORDS];
+static volatile uint32_t log_wr = 0; // reserved by the writers
+static volatile uint32_t log_rd = 0; // freed by LOG_Drain() once sent
+static uint32_t log_pub = 0; // end of the complete records found by LOG_Drain()
+static uint32_t log_sending = 0; // words in the DMA transfer
+static volatile uint32_t log_dropped = 0;
+static uint32_t log_dropped_seen = 0;
+static uint8_t log_ready = 0;
+
+
+/**
+ * @brief  Start the cycle counter used for the timestamps and set up the UART transmit DMA.
+ *         Call after MX_USART2_UART_Init().
+ */
+void LOG_Init(void){
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	LL_DMA_DisableStream(LOG_DMA, LOG_DMA_STREAM);
+	LL_DMA_SetChannelSelection(LOG_DMA, LOG_DMA_STREAM, LOG_DMA_CHANNEL);
+	LL_DMA_ConfigTransfer(LOG_DMA, LOG_DMA_STREAM, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_PRIORITY_LOW |
+		LL_DMA_MODE_NORMAL | LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE);
+	LL_DMA_SetPeriphAddress(LOG_DMA, LOG_DMA_STREAM, (uint32_t)&USART2->DR);
+	SET_BIT(USART2->CR3, USART_CR3_DMAT);
+	log_ready = 1U;
+	}
+
+
+/**
+ * @brief  Store a record, use the LOG() macro. Safe from any interrupt priority.
+ * @param  rec: header word followed by the arguments
+ * @param  nargs: number of arguments
+ */
+void LOG_Write(const uint32_t* rec, uint32_t nargs){
+	uint32_t len = nargs + 2U;
+	uint32_t wr = log_wr;
+	do {
+		if (wr + len - log_rd > LOG_RING_WORDS) {
+			__atomic_fetch_add(&log_dropped, 1U, __ATOMIC_RELAXED);
+			return;
+			}
+		} while (!__atomic_compare_exchange_n(&log_wr, &wr, wr + len, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	log_ring[(wr + 1U) & LOG_RING_MASK] = DWT->CYCCNT;
+	for (uint32_t i = 0; i < nargs; i++) {
+		log_ring[(wr + 2U + i) & LOG_RING_MASK] = rec[1 + i];
+		}
+	// the header is written last, it publishes the record
+	__DMB();
+	log_ring[wr & LOG_RING_MASK] = rec[0];
+	}
+
+
+/**
+ * @brief  Free the words of the finished DMA transfer and start the next one.
+ *         Called every 1ms from SysTick_Handler(), which is the only consumer of the ring.
+ */
+void LOG_Drain(void){
+	if (log_ready == 0U || LL_DMA_IsEnabledStream(LOG_DMA, LOG_DMA_STREAM)) {
+		return;
+		}
+	if (log_sending) {
+		// clear the words sent, a header is only found in a word written since
+		for (uint32_t i = 0; i < log_sending; i++) {
+			log_ring[(log_rd + i) & LOG_RING_MASK] = 0U;
+			}
+		__DMB();
+		log_rd += log_sending;
+		log_sending = 0U;
+		}
+
+	uint32_t dropped = log_dropped;
+	if (dropped != log_dropped_seen) {
+		LOG("log : %u records dropped\r\n", dropped - log_dropped_seen);
+		log_dropped_seen = dropped;
+		}
+
+	// complete records from the read index on, the words past the write index are 0
+	while (log_pub - log_rd < LOG_DMA_MAX_WORDS) {
+		uint32_t hdr = log_ring[log_pub & LOG_RING_MASK];
+		if ((hdr & LOG_SYNC_MASK) != LOG_SYNC) {
+			break;
+			}
+		__DMB();
+		log_pub += LOG_NARGS(hdr) + 2U;
+		}
+
+	// up to the end of the ring, the rest of a record that wraps is sent with the next transfer
+	uint32_t rd = log_rd & LOG_RING_MASK;
+	uint32_t n = log_pub - log_rd;
+	if (n > LOG_RING_WORDS - rd) {
+		n = LOG_RING_WORDS - rd;
+		}
+	if (n) {
+		log_sending = n;
+		LL_DMA_ClearFlag_TC6(LOG_DMA);
+		LL_DMA_ClearFlag_HT6(LOG_DMA);
+		LL_DMA_ClearFlag_TE6(LOG_DMA);
+		LL_DMA_ClearFlag_FE6(LOG_DMA);
+		LL_DMA_SetMemoryAddress(LOG_DMA, LOG_DMA_STREAM, (uint32_t)&log_ring[rd]);
+		LL_DMA_SetDataLength(LOG_DMA, LOG_DMA_STREAM, n*4U);
+		LL_DMA_EnableStream(LOG_DMA, LOG_DMA_STREAM);
+		}
+	}
+
+
+/**
+ * @brief  Wait until the records already written have been sent. Main loop only, e.g. between the lines of a
+ *         long dump that would not fit in the ring.
+ */
+void LOG_Flush(void){
+	if (log_ready == 0U) {
+		return;
+		}
+	uint32_t wr = log_wr;
+	while ((int32_t)(wr - log_rd) > 0) {
+		}
+	}
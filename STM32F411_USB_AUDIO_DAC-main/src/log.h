@@ -0,0 +1,83 @@
+#ifndef __LOG_H
+#define __LOG_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Deferred binary logger on USART2, replaces the blocking printf over the UART.
+//
+// LOG("fmt", args...) only stores a record in a RAM ring : a header word with the format string ID and the number
+// of arguments, a DWT cycle counter timestamp and one word per argument. It does not format anything and does not
+// wait, so it can be called from any interrupt, e.g. USBD_AUDIO_SOF(). LOG_Drain() sends the records over the UART
+// with the DMA in the background, and the host decoder logdecode/logdecode.c rebuilds the text with the format
+// strings read from the ELF file.
+//
+// The format strings are placed in the .logstr section, which is not loaded into the flash (see the linker scripts).
+// The ID of a format string is its offset in that section.
+//
+// Arguments : up to LOG_MAX_ARGS integers, floats (%f, sent as single precision) or pointers to strings in flash (%s),
+// e.g. __FILE__. A string in RAM cannot be logged, the decoder reads the string at that address in the ELF file.
+//
+// The ring is shared without locks : a writer reserves its words with a compare and swap of the write index, writes
+// the timestamp and the arguments, then the header. LOG_Drain() only sends the records whose header is written, so
+// a record still being written by a preempted writer holds back the records after it until it is complete.
+// When the ring is full the record is dropped and counted, the drain then logs the number of dropped records.
+
+// Words in the ring, a power of 2. A record takes 2 words + 1 per argument.
+#ifndef LOG_RING_WORDS
+#define LOG_RING_WORDS                1024U
+#endif
+
+#define LOG_MAX_ARGS                  6U
+
+// Header word : sync nibble, number of arguments, format string ID. Never 0, which marks a word not written yet.
+#define LOG_SYNC                      0xA0000000U
+#define LOG_SYNC_MASK                 0xF0000000U
+#define LOG_NARGS(hdr)                (((hdr) >> 24) & 0x0FU)
+#define LOG_ID_MASK                   0x00FFFFFFU
+
+void LOG_Init(void);
+void LOG_Write(const uint32_t* rec, uint32_t nargs);
+void LOG_Drain(void);
+void LOG_Flush(void);
+
+static inline uint32_t LOG_Word(uint32_t x){ return x; }
+static inline uint32_t LOG_Float(double x){ union { float f; uint32_t u; } v; v.f = (float)x; return v.u; }
+static inline uint32_t LOG_Str(const void* s){ return (uint32_t)(uintptr_t)s; }
+
+#define LOG_ARG(x) _Generic((x), \
+	float: LOG_Float, double: LOG_Float, \
+	char*: LOG_Str, const char*: LOG_Str, uint8_t*: LOG_Str, const uint8_t*: LOG_Str, \
+	default: LOG_Word)(x)
+
+// The format string in the .logstr section, its address is the ID
+#define LOG_ID(fmt) __extension__ ({ \
+	static const char log_fmt_[] __attribute__((section(".logstr"), used)) = fmt; \
+	(uint32_t)(uintptr_t)log_fmt_; })
+
+#define LOG_COUNT(...)                LOG_COUNT_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_COUNT_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+#define LOG_CAT(a, b)                 LOG_CAT_(a, b)
+#define LOG_CAT_(a, b)                a##b
+#define LOG_ARGS_0()
+#define LOG_ARGS_1(a)                 , LOG_ARG(a)
+#define LOG_ARGS_2(a, b)              , LOG_ARG(a), LOG_ARG(b)
+#define LOG_ARGS_3(a, b, c)           , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c)
+#define LOG_ARGS_4(a, b, c, d)        , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d)
+#define LOG_ARGS_5(a, b, c, d, e)     , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e)
+#define LOG_ARGS_6(a, b, c, d, e, f)  , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e), LOG_ARG(f)
+
+#define LOG(fmt, ...) do { \
+	const uint32_t log_rec_[] = { LOG_SYNC | (LOG_COUNT(__VA_ARGS__) << 24) | LOG_ID(fmt) \
+		LOG_CAT(LOG_ARGS_, LOG_COUNT(__VA_ARGS__))(__VA_ARGS__) }; \
+	LOG_Write(log_rec_, LOG_COUNT(__VA_ARGS__)); \
+	} while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,8 +1,14 @@
 #include "main.h"
 #include "usart.h"
 #include "usbd_audio.h"
-#include <stdio.h>
-#include <stdarg.h>
+#include "audio_convert.h"
+#include "profile.h"
+#ifdef USE_USB_CDC_TELEMETRY
+#include "usbd_cdc_if.h"
+#endif
+#ifdef USE_AUDIO_CAPTURE
+#include "bsp_capture.h"
+#endif
 
 USBD_HandleTypeDef USBD_Device;
 AUDIO_STATUS_TypeDef audio_status;
@@ -15,21 +21,51 @@ int main(void) {
   SystemClock_Config();
 
   MX_USART2_UART_Init();
-  printMsg("\r\nUSB Audio I2S Bridge\r\n");
+  // binary log records on the UART, see src/log.h and logdecode/
+  LOG_Init();
+  LOG("\r\nUSB Audio I2S Bridge\r\n");
+#ifdef USE_IRQ_PROFILE // see Makefile C_DEFS
+  // cycles of the interrupts on the audio path, reported when the KEY button is pressed
+  PROFILE_Init();
+#endif
 
   bsp_init();
 
+#ifdef DEBUG_CONVERT_BENCHMARK // see Makefile C_DEFS
+  // cycles to convert one 1mS packet at 48kHz and 96kHz
+  uint32_t cycles_ref, cycles_unity, cycles_gain;
+  AUDIO_Convert_Benchmark(48, &cycles_ref, &cycles_unity, &cycles_gain);
+  LOG("Convert 48 samples : reference %d, 0dB %d, -9dB %d cycles\r\n", cycles_ref, cycles_unity, cycles_gain);
+  AUDIO_Convert_Benchmark(96, &cycles_ref, &cycles_unity, &cycles_gain);
+  LOG("Convert 96 samples : reference %d, 0dB %d, -9dB %d cycles\r\n", cycles_ref, cycles_unity, cycles_gain);
+#endif
+
   // Init Device Library
   USBD_Init(&USBD_Device, &AUDIO_Desc, 0);
   // Add Supported Class
   USBD_RegisterClass(&USBD_Device, USBD_AUDIO_CLASS);
   // Add Interface callbacks for AUDIO Class
   USBD_AUDIO_RegisterInterface(&USBD_Device, &USBD_AUDIO_fops);
+#ifdef USE_USB_CDC_TELEMETRY // see Makefile C_DEFS
+  // Telemetry and control over the CDC-ACM port of the composite device
+  USBD_CDC_ACM_RegisterInterface(&USBD_CDC_fops);
+#endif
+#ifdef USE_AUDIO_CAPTURE // see Makefile C_DEFS
+  // Recording on the isochronous IN endpoint, see bsp_capture.h for the sources
+  BSP_CAPTURE_SetSource(&AUDIO_CAPTURE_SOURCE);
+#endif
   // Start Device Process
   USBD_Start(&USBD_Device);
+  // Capture SOF with TIM2 to measure the crystal error wrt the USB host
+  BSP_SOF_TIM_Init();
   
   while (1) {
     switch (audio_status.frequency) {
+      case 32000:
+          BSP_LED_Off(LED_RED);
+          BSP_LED_On(LED_GREEN);
+          BSP_LED_On(LED_BLUE);
+          break;
       case 44100:
           BSP_LED_Off(LED_RED);
           BSP_LED_Off(LED_GREEN);
@@ -40,6 +76,11 @@ int main(void) {
           BSP_LED_On(LED_GREEN);
           BSP_LED_Off(LED_BLUE);
           break;
+      case 88200:
+          BSP_LED_On(LED_RED);
+          BSP_LED_Off(LED_GREEN);
+          BSP_LED_On(LED_BLUE);
+          break;
       case 96000:
           BSP_LED_On(LED_RED);
           BSP_LED_Off(LED_GREEN);
@@ -53,18 +94,39 @@ int main(void) {
     }
 
     HAL_Delay(100);
-#ifdef DEBUG_FEEDBACK_ENDPOINT // see Makefile C_DEFS
-    // see USBD_AUDIO_SOF() in usbd_audio.c
+#if defined(DEBUG_FEEDBACK_ENDPOINT) || defined(USE_IRQ_PROFILE) // see Makefile C_DEFS
 	if (BtnPressed) {
 		BtnPressed = 0;
-		printMsg("DbgOptimalWritableSamples = %d\r\nDbgSafeZoneWritableSamples = %d\r\n", AUDIO_TOTAL_BUF_SIZE/(2*6), AUDIO_BUF_SAFEZONE_SAMPLES);
-		printMsg("DbgMaxWritableSamples = %d\r\nDbgMinWritableSamples = %d\r\n\r\n", DbgMaxWritableSamples, DbgMinWritableSamples);
+#ifdef USE_IRQ_PROFILE
+		// see profile.h
+		PROFILE_Report();
+#endif
+#ifdef DEBUG_FEEDBACK_ENDPOINT
+		// see USBD_AUDIO_SOF() in usbd_audio.c
+		USBD_AUDIO_HandleTypeDef* haudio = (USBD_AUDIO_HandleTypeDef*)USBD_Device.pClassData;
+		if (haudio != NULL) {
+			LOG("Latency profile = %d\r\nDbgOptimalWritableSamples = %d\r\nDbgSafeZoneWritableSamples = %d\r\n", haudio->latency, haudio->buf_size/(2*4), haudio->safezone);
+			LOG("Concealed underruns = %d, overruns = %d\r\n", haudio->underruns, haudio->overruns);
+			LOG("Lost packets = %d, synthesized = %d\r\n", haudio->frames_missed, haudio->frames_concealed);
+#ifdef USE_AUDIO_CAPTURE
+			LOG("Capture underruns = %d, overruns = %d\r\n", haudio->capture_underruns, haudio->capture_overruns);
+#endif
+			}
+		if (fs_meas_nominal) {
+			LOG("Measured crystal error = %f ppm\r\n", (float)(int32_t)(fs_meas_ticks - fs_meas_nominal)*1.0e6f/(float)fs_meas_nominal);
+			}
+		LOG("DbgMaxWritableSamples = %d\r\nDbgMinWritableSamples = %d\r\n\r\n", DbgMaxWritableSamples, DbgMinWritableSamples);
 		int count = 256;
 		while (count--){
 			// print oldest to newest
-			printMsg("%d %d %f\r\n", DbgSofHistory[DbgIndex], DbgWritableSampleHistory[DbgIndex], DbgFeedbackHistory[DbgIndex]);
+			LOG("%d %d %f\r\n", DbgSofHistory[DbgIndex], DbgWritableSampleHistory[DbgIndex], DbgFeedbackHistory[DbgIndex]);
 			DbgIndex++;
+			// the 256 lines do not fit in the log ring
+			if ((count & 31) == 0) {
+				LOG_Flush();
+				}
 			}
+#endif
 		}
 #endif
 
@@ -186,15 +248,6 @@ void SystemClock_Config(void)
 
 
 
-void printMsg(char* format, ...) {
-	char sz[100];
-	va_list args;
-	va_start(args, format);
-	vsprintf(sz, format, args);
-	HAL_UART_Transmit(&huart2, (uint8_t *)sz, strlen(sz), HAL_MAX_DELAY);
-	va_end(args);
-	}
-
 void Error_Handler(void){
 	uint32_t counter;
 	while(1){
@@ -215,7 +268,7 @@ void Error_Handler(void){
   */
 void assert_failed(uint8_t *file, uint32_t line)
 { 
-    printMsg("Wrong parameters value: file %s on line %d\r\n", file, line);
+    LOG("Wrong parameters value: file %s on line %d\r\n", file, line);
 }
 #endif /* USE_FULL_ASSERT */
 
@@ -32,9 +32,10 @@ extern "C" {
 #include "usbd_audio.h"
 #include "usbd_audio_if.h"
 #include "bsp_audio.h"
+#include "bsp_sof_tim.h"
+#include "log.h"
 
 void Error_Handler(void);
-void printMsg(char* format, ...);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,159 @@
+#include <string.h>
+#include "main.h"
+#include "profile.h"
+
+static const char* const profile_names[PROFILE_NUM_POINTS] = {
+	"OTG_FS_IRQ",
+	"I2S_DMA_IRQ",
+	"Convert",
+	"DataOut",
+	"SOF",
+	"Crossfeed",
+	"ASRC",
+	"Upsample",
+	"Crossover",
+	};
+
+static PROFILE_StatsTypeDef profile_stats[PROFILE_NUM_POINTS];
+// profiled handlers active
+static volatile uint32_t profile_depth = 0;
+// cycles spent in the profiled handlers, excluding their own preemption, wraps
+static volatile uint32_t profile_irq_cycles = 0;
+// HAL tick of the last PROFILE_Clear(), for the CPU load
+static uint32_t profile_clear_tick = 0;
+
+
+/**
+ * @brief  Start the DWT cycle counter and clear the statistics
+ */
+void PROFILE_Init(void){
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	PROFILE_Clear();
+	}
+
+
+void PROFILE_Clear(void){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	for (uint32_t i = 0; i < PROFILE_NUM_POINTS; i++) {
+		memset(&profile_stats[i], 0, sizeof(PROFILE_StatsTypeDef));
+		profile_stats[i].min = 0xFFFFFFFFU;
+		}
+	profile_clear_tick = HAL_GetTick();
+	__set_PRIMASK(primask);
+	}
+
+
+/**
+ * @brief  Start of a profiled run, use the PROFILE_IRQ_ENTER() and PROFILE_ENTER() macros
+ * @param  frame: entry state, passed to PROFILE_Exit()
+ * @param  handler: 1 for an interrupt handler, 0 for a function called from one
+ */
+void PROFILE_Enter(PROFILE_FrameTypeDef* frame, uint32_t handler){
+	frame->nested = profile_irq_cycles;
+	frame->start = DWT->CYCCNT;
+	if (handler) {
+		// restored by the handlers that preempt this one before they return
+		profile_depth++;
+		}
+	}
+
+
+/**
+ * @brief  End of a profiled run
+ * @param  point: profiled point
+ * @param  frame: entry state set by PROFILE_Enter()
+ * @param  handler: same as for PROFILE_Enter()
+ */
+void PROFILE_Exit(PROFILE_PointTypeDef point, const PROFILE_FrameTypeDef* frame, uint32_t handler){
+	PROFILE_StatsTypeDef* s = &profile_stats[point];
+	uint32_t cycles = (DWT->CYCCNT - frame->start) - (profile_irq_cycles - frame->nested);
+
+	if (handler) {
+		if (profile_depth > s->depth_max) {
+			s->depth_max = profile_depth;
+			}
+		__atomic_fetch_add(&profile_irq_cycles, cycles, __ATOMIC_RELAXED);
+		profile_depth--;
+		}
+	s->count++;
+	s->total += cycles;
+	if (cycles < s->min) {
+		s->min = cycles;
+		}
+	if (cycles > s->max) {
+		s->max = cycles;
+		}
+	uint32_t bin = 32U - __CLZ(cycles);
+	s->hist[bin < PROFILE_HIST_BINS ? bin : PROFILE_HIST_BINS - 1U]++;
+	}
+
+
+/**
+ * @brief  Record the interrupt latency of a profiled point
+ * @param  point: profiled point
+ * @param  cycles: cycles from the hardware event to the handler code
+ */
+void PROFILE_Latency(PROFILE_PointTypeDef point, uint32_t cycles){
+	PROFILE_StatsTypeDef* s = &profile_stats[point];
+	s->latency_count++;
+	s->latency_total += cycles;
+	if (cycles > s->latency_max) {
+		s->latency_max = cycles;
+		}
+	}
+
+
+/**
+ * @brief  Consistent copy of the statistics of a profiled point
+ * @param  point: profiled point
+ * @param  stats: copy
+ */
+void PROFILE_Get(PROFILE_PointTypeDef point, PROFILE_StatsTypeDef* stats){
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	*stats = profile_stats[point];
+	__set_PRIMASK(primask);
+	}
+
+
+/**
+ * @brief  Write the statistics of all the profiled points to the log. Safe from the main loop and from the
+ *         OTG interrupt.
+ */
+void PROFILE_Report(void){
+	PROFILE_StatsTypeDef s;
+	uint32_t ms = HAL_GetTick() - profile_clear_tick;
+	float window = (float)ms * (float)(SystemCoreClock / 1000U);
+
+	LOG("profile : %u ms at %u Hz\r\n", ms, SystemCoreClock);
+	for (uint32_t i = 0; i < PROFILE_NUM_POINTS; i++) {
+		PROFILE_Get((PROFILE_PointTypeDef)i, &s);
+		if (s.count == 0U) {
+			LOG("%s : not run\r\n", profile_names[i]);
+			continue;
+			}
+		LOG("%s : %u runs, cycles min %u mean %u max %u\r\n", profile_names[i], s.count, s.min,
+			(uint32_t)(s.total / s.count), s.max);
+		LOG("%s : CPU %.3f %%, %u cycles per ms, nesting max %u\r\n", profile_names[i],
+			window > 0.0f ? (float)s.total * 100.0f / window : 0.0f, ms ? (uint32_t)(s.total / ms) : 0U, s.depth_max);
+		if (s.latency_count) {
+			LOG("%s : latency mean %u max %u cycles\r\n", profile_names[i],
+				(uint32_t)(s.latency_total / s.latency_count), s.latency_max);
+			}
+		// the bins that are not empty, 4 per line : bin n is 2^(n-1) .. 2^n-1 cycles
+		uint32_t first = 0, last = PROFILE_HIST_BINS - 1U;
+		while (s.hist[first] == 0U) {
+			first++;
+			}
+		while (s.hist[last] == 0U) {
+			last--;
+			}
+		for (uint32_t b = first; b <= last; b += 4U) {
+			LOG("%s : hist from 2^%u : %u %u %u %u\r\n", profile_names[i], b == 0U ? 0U : b - 1U,
+				s.hist[b], b + 1U <= last ? s.hist[b + 1U] : 0U, b + 2U <= last ? s.hist[b + 2U] : 0U,
+				b + 3U <= last ? s.hist[b + 3U] : 0U);
+			}
+		}
+	}
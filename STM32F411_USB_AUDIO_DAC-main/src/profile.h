@@ -0,0 +1,88 @@
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Cycle profiling of the interrupts on the audio path (USE_IRQ_PROFILE, see Makefile C_DEFS).
+//
+// Each profiled point records the number of runs, the min/max/mean DWT cycles per run and a log2 histogram of
+// the cycles. The interrupt handlers (OTG, I2S DMA, PendSV conversion) also record the nesting depth, i.e. the number
+// of profiled handlers active when they are entered. The cycles of a handler exclude the profiled handlers that
+// preempted it, so the cycles of the conversion do not include the OTG interrupts that ran in the middle.
+// USBD_AUDIO_DataOut() and USBD_AUDIO_SOF() run inside the OTG interrupt, their cycles are also part of it.
+//
+// Interrupt latency, the time from the hardware event to the handler code, is measured where the hardware gives
+// the time of the event : the SOF from the TIM2 capture of the SOF pulse, the I2S DMA half/transfer complete from
+// the halfwords the DMA has transferred since. The TIM2 clock is the core clock with this clock configuration.
+//
+// PROFILE_Report() writes the statistics to the log, see log.h. It is called when the KEY button is pressed,
+// and by the telemetry command TELEMETRY_CMD_PROFILE (see usbd_cdc_if.h).
+// Without USE_IRQ_PROFILE the macros are empty.
+
+typedef enum {
+	PROFILE_OTG = 0,     // OTG_FS_IRQHandler()
+	PROFILE_I2S_DMA,     // DMA1_Stream4_IRQHandler()
+	PROFILE_CONVERT,     // PendSV_Handler(), USBD_AUDIO_Process()
+	PROFILE_DATAOUT,     // USBD_AUDIO_DataOut()
+	PROFILE_SOF,         // USBD_AUDIO_SOF()
+	PROFILE_CROSSFEED,   // AUDIO_Crossfeed_Process(), per USB packet inside the conversion
+	PROFILE_ASRC,        // AUDIO_ASRC_Process(), per I2S DMA period inside the I2S DMA interrupt
+	PROFILE_UPSAMPLE,    // AUDIO_Upsample_Process(), per I2S DMA period inside the I2S DMA interrupt
+	PROFILE_CROSSOVER,   // AUDIO_Crossover_Process(), per I2S DMA period inside the I2S DMA interrupt
+	PROFILE_NUM_POINTS
+	} PROFILE_PointTypeDef;
+
+// Histogram bin n counts the runs of 2^(n-1) to 2^n - 1 cycles, the last bin also counts the longer runs
+#define PROFILE_HIST_BINS             18U
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	uint32_t hist[PROFILE_HIST_BINS];
+	uint32_t depth_max;            // handlers only, 1 if never nested
+	uint32_t latency_count;
+	uint32_t latency_max;          // cycles from the hardware event, SOF and I2S DMA only
+	uint64_t latency_total;
+	} PROFILE_StatsTypeDef;
+
+// Entry state of a profiled run, on the stack of the handler
+typedef struct {
+	uint32_t start;
+	uint32_t nested;
+	} PROFILE_FrameTypeDef;
+
+void PROFILE_Init(void);
+void PROFILE_Clear(void);
+void PROFILE_Enter(PROFILE_FrameTypeDef* frame, uint32_t handler);
+void PROFILE_Exit(PROFILE_PointTypeDef point, const PROFILE_FrameTypeDef* frame, uint32_t handler);
+void PROFILE_Latency(PROFILE_PointTypeDef point, uint32_t cycles);
+void PROFILE_Get(PROFILE_PointTypeDef point, PROFILE_StatsTypeDef* stats);
+void PROFILE_Report(void);
+
+#ifdef USE_IRQ_PROFILE
+// An interrupt handler, excludes the profiled handlers that preempt it
+#define PROFILE_IRQ_ENTER()                 PROFILE_FrameTypeDef profile_frame_; PROFILE_Enter(&profile_frame_, 1U)
+#define PROFILE_IRQ_EXIT(point)             PROFILE_Exit(point, &profile_frame_, 1U)
+// A function called from an interrupt handler
+#define PROFILE_ENTER()                     PROFILE_FrameTypeDef profile_frame_; PROFILE_Enter(&profile_frame_, 0U)
+#define PROFILE_EXIT(point)                 PROFILE_Exit(point, &profile_frame_, 0U)
+#define PROFILE_LATENCY(point, cycles)      PROFILE_Latency(point, cycles)
+#else
+#define PROFILE_IRQ_ENTER()
+#define PROFILE_IRQ_EXIT(point)
+#define PROFILE_ENTER()
+#define PROFILE_EXIT(point)
+#define PROFILE_LATENCY(point, cycles)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
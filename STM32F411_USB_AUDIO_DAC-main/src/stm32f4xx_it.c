@@ -18,9 +18,14 @@
   */
 #include "main.h"
 #include "stm32f4xx_it.h"
+#ifdef USE_USB_CDC_TELEMETRY
+#include "usbd_cdc_if.h"
+#endif
+#include "profile.h"
 
 extern PCD_HandleTypeDef hpcd;
 extern DMA_HandleTypeDef hdma_i2sTx;
+extern USBD_HandleTypeDef USBD_Device;
 
 /******************************************************************************/
 /*           Cortex-M4 Processor Interruption and Exception Handlers          */ 
@@ -130,7 +135,16 @@ void DebugMon_Handler(void)
 void PendSV_Handler(void)
 {
   /* USER CODE BEGIN PendSV_IRQn 0 */
-
+  // Deferred conversion of the received audio packets, pended by Audio_PeriodicTC()
+  PROFILE_IRQ_ENTER();
+#ifdef USE_USB_CDC_TELEMETRY
+  uint32_t start = DWT->CYCCNT;
+  USBD_AUDIO_Process(&USBD_Device);
+  TELEMETRY_Cycles(&telemetry_conv_cycles, DWT->CYCCNT - start);
+#else
+  USBD_AUDIO_Process(&USBD_Device);
+#endif
+  PROFILE_IRQ_EXIT(PROFILE_CONVERT);
   /* USER CODE END PendSV_IRQn 0 */
   /* USER CODE BEGIN PendSV_IRQn 1 */
 
@@ -147,6 +161,8 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  // send the log records over the UART, see log.c
+  LOG_Drain();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -167,7 +183,11 @@ void EXTI0_IRQHandler(void)
   */
 void DMA1_Stream4_IRQHandler(void)
 {
+  // cycles and latency, see profile.h
+  PROFILE_IRQ_ENTER();
+  PROFILE_LATENCY(PROFILE_I2S_DMA, BSP_AUDIO_OUT_GetEventLatency());
   HAL_DMA_IRQHandler(&hdma_i2sTx);
+  PROFILE_IRQ_EXIT(PROFILE_I2S_DMA);
 }
 
 /**
@@ -175,7 +195,16 @@ void DMA1_Stream4_IRQHandler(void)
   */
 void OTG_FS_IRQHandler(void)
 {
+  PROFILE_IRQ_ENTER();
+#ifdef USE_USB_CDC_TELEMETRY
+  // CPU time reported by the telemetry, see usbd_cdc_if.c
+  uint32_t start = DWT->CYCCNT;
+  HAL_PCD_IRQHandler(&hpcd);
+  TELEMETRY_Cycles(&telemetry_otg_cycles, DWT->CYCCNT - start);
+#else
   HAL_PCD_IRQHandler(&hpcd);
+#endif
+  PROFILE_IRQ_EXIT(PROFILE_OTG);
 }
 
 /* USER CODE BEGIN 1 */
@@ -24,35 +24,22 @@
 /* Includes */
 #include <errno.h>
 #include <stdio.h>
+#include <sys/types.h>
 
 /* Variables */
 extern int errno;
-register char * stack_ptr asm("sp");
 
 /* Functions */
 
 /**
  _sbrk
- Increase program data space. Malloc and related functions depend on this
+ Increase program data space. Malloc and related functions depend on this.
+ There is no heap (_Min_Heap_Size is 0 in the linker scripts), the USB class data is allocated from a static
+ arena, see USBD_static_malloc() in usbd_conf.c. Any call to malloc fails instead of growing into the stack.
 **/
 caddr_t _sbrk(int incr)
 {
-	extern char end asm("end");
-	static char *heap_end;
-	char *prev_heap_end;
-
-	if (heap_end == 0)
-		heap_end = &end;
-
-	prev_heap_end = heap_end;
-	if (heap_end + incr > stack_ptr)
-	{
-		errno = ENOMEM;
-		return (caddr_t) -1;
-	}
-
-	heap_end += incr;
-
-	return (caddr_t) prev_heap_end;
+	(void)incr;
+	errno = ENOMEM;
+	return (caddr_t) -1;
 }
-
@@ -72,11 +72,14 @@ USBD_AUDIO_ItfTypeDef USBD_AUDIO_fops = {
  * @param  AudioFreq: Audio frequency used to play the audio stream.
  * @param  Volume: Initial volume level : 0 (Min) to 100 (Max)
  * @param  options: 1 => Mute On, 0 = Mute off
+ *         The I2S clock may still be locking on return, see Audio_GetState()
  * @retval Result of the operation: USBD_OK if all operations are OK else
  * USBD_FAIL
  */
 static int8_t Audio_Init(uint32_t audioFreq, int16_t volume, uint8_t options) {
 	audio_status.frequency = audioFreq;
+	// PendSV runs USBD_AUDIO_Process(), below the OTG and I2S DMA interrupts
+	HAL_NVIC_SetPriority(PendSV_IRQn, 15, 0);
 	BSP_AUDIO_OUT_Init(volume, audioFreq, options);
 	return 0;
 	}
@@ -96,6 +99,8 @@ static int8_t Audio_DeInit(uint8_t options){
 /**
  * @brief  Handles AUDIO command.
  * @param  pbuf: Pointer to buffer of data to be sent
+ *         With USE_I2S_DOUBLE_BUFFER, AUDIO_CMD_START gets the two consecutive DMA period buffers,
+ *         with USE_AUDIO_CROSSOVER followed by the two period buffers of the second output
  * @param  size: Number of data to be sent (in bytes)
  * @param  cmd: Command opcode
  * @retval Result of the operation: USBD_OK if all operations are OK else
@@ -104,7 +109,13 @@ static int8_t Audio_DeInit(uint8_t options){
 static int8_t Audio_PlaybackCmd(uint16_t* pbuf, uint32_t size, uint8_t cmd){
 	switch (cmd) {
 		case AUDIO_CMD_START:
+#if defined(USE_AUDIO_CROSSOVER)
+		  BSP_AUDIO_OUT_PlayDoubleBufferDual(pbuf, pbuf + size/4, pbuf + size/2, pbuf + 3*size/4, size/2);
+#elif defined(USE_I2S_DOUBLE_BUFFER)
+		  BSP_AUDIO_OUT_PlayDoubleBuffer(pbuf, pbuf + size/4, size/2);
+#else
 		  BSP_AUDIO_OUT_Play(pbuf, size);
+#endif
 		  audio_status.playing = 1U;
 		  break;
 
@@ -135,28 +146,37 @@ static int8_t Audio_VolumeCtl(int16_t vol){
  * USBD_FAIL
  */
 static int8_t Audio_MuteCtl(uint8_t mute){
-	BSP_AUDIO_OUT_SetMute(mute);
+	// Mute is ramped in the sample conversion, see audio_volume.h. Switching the DAC mute output
+	// would click, it is only released here once the output is silent : after the pre-roll of a stream
+	// start or a rate switch, see AUDIO_OUT_Switch() in usbd_audio.c
+	if (!mute) {
+		BSP_AUDIO_OUT_SetMute(0);
+		}
 	return 0;
 	}
 
 /**
  * @brief  Audio_PeriodicTC
+ *         Called by USBD_AUDIO_DataOut() when a packet is staged, pends the
+ *         PendSV interrupt that runs USBD_AUDIO_Process()
  * @param  cmd: Command opcode
  * @retval Result of the operation: USBD_OK if all operations are OK else
  * USBD_FAIL
  */
 static int8_t Audio_PeriodicTC(uint8_t cmd){
+	if (cmd == AUDIO_CMD_PLAY) {
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+		}
 	return 0;
 	}
 
 /**
  * @brief  Gets AUDIO State.
  * @param  None
- * @retval Result of the operation: USBD_OK if all operations are OK else
- * USBD_FAIL
+ * @retval AUDIO_STATE_READY, or AUDIO_STATE_LOCKING while PLLI2S locks after Audio_Init()
  */
 static int8_t Audio_GetState(void){
-	return 0;
+	return BSP_AUDIO_OUT_ClockReady() ? AUDIO_STATE_READY : AUDIO_STATE_LOCKING;
 	}
 
 /**
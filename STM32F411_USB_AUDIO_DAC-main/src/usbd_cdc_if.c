@@ -0,0 +1,230 @@
+#include "main.h"
+#include "usbd_cdc_if.h"
+#include "profile.h"
+
+// Telemetry records and control commands over the CDC-ACM port, see usbd_cdc_if.h.
+// All the callbacks run in the OTG interrupt, so the audio class state is read and changed the same way
+// as from the audio control requests, and the main loop is never involved.
+
+static void Telemetry_Init(void);
+static void Telemetry_DeInit(void);
+static void Telemetry_LineState(uint16_t state);
+static void Telemetry_Receive(const uint8_t* pbuf, uint32_t len);
+static void Telemetry_SOF(USBD_HandleTypeDef* pdev);
+static void Telemetry_Send(USBD_HandleTypeDef* pdev);
+static uint8_t Telemetry_SendVerify(USBD_HandleTypeDef* pdev);
+
+extern USBD_HandleTypeDef USBD_Device;
+
+USBD_CDC_ACM_ItfTypeDef USBD_CDC_fops = {
+	Telemetry_Init,
+	Telemetry_DeInit,
+	Telemetry_LineState,
+	Telemetry_Receive,
+	Telemetry_SOF,
+	};
+
+TELEMETRY_CyclesTypeDef telemetry_otg_cycles;
+TELEMETRY_CyclesTypeDef telemetry_conv_cycles;
+
+static uint8_t  port_open = 0;
+static uint8_t  snapshot = 0;
+static uint8_t  verify_report = 0; // a TELEMETRY_VerifyRecordTypeDef was requested
+static uint16_t period = TELEMETRY_PERIOD_DEFAULT;
+static uint16_t frames = 0; // since the last record
+static uint32_t sequence = 0;
+static uint32_t otg_total_last = 0;
+static uint32_t conv_total_last = 0;
+
+
+/**
+ * @brief  The device was configured, start the DWT cycle counter used by TELEMETRY_Cycles()
+ */
+static void Telemetry_Init(void){
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	port_open = 0U;
+	snapshot = 0U;
+	verify_report = 0U;
+	frames = 0U;
+	}
+
+
+static void Telemetry_DeInit(void){
+	port_open = 0U;
+	}
+
+
+/**
+ * @brief  Records are only sent while a terminal holds the port open
+ * @param  state: CDC_ACM_LINE_DTR, CDC_ACM_LINE_RTS
+ */
+static void Telemetry_LineState(uint16_t state){
+	port_open = (state & CDC_ACM_LINE_DTR) ? 1U : 0U;
+	}
+
+
+/**
+ * @brief  Run the commands of a bulk OUT packet, an incomplete command at the end is ignored
+ * @param  pbuf: packet
+ * @param  len: bytes
+ */
+static void Telemetry_Receive(const uint8_t* pbuf, uint32_t len){
+	for (uint32_t i = 0; i + 3U <= len; i += 3U) {
+		uint16_t arg = (uint16_t)(pbuf[i+1] | (pbuf[i+2] << 8));
+		switch (pbuf[i]) {
+			case TELEMETRY_CMD_PERIOD:
+				period = arg > TELEMETRY_PERIOD_MAX ? TELEMETRY_PERIOD_MAX : arg;
+				break;
+			case TELEMETRY_CMD_SNAPSHOT:
+				snapshot = 1U;
+				break;
+			case TELEMETRY_CMD_CLEAR:
+				USBD_AUDIO_ClearCounters(&USBD_Device);
+				break;
+			case TELEMETRY_CMD_LATENCY:
+				(void)USBD_AUDIO_SetLatency(&USBD_Device, arg);
+				break;
+#ifdef USE_IRQ_PROFILE
+			case TELEMETRY_CMD_PROFILE:
+				PROFILE_Report();
+				if (arg == 1U) {
+					PROFILE_Clear();
+					}
+				break;
+#endif
+			case TELEMETRY_CMD_VERIFY:
+				if (arg == TELEMETRY_VERIFY_RESTART) {
+					USBD_AUDIO_RestartVerify(&USBD_Device);
+					}
+				else if (arg == TELEMETRY_VERIFY_REPORT) {
+					verify_report = 1U;
+					}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+
+/**
+ * @brief  Send a record when it is due. If the host has not read the last one yet, try again at the next SOF.
+ *         A verify record requested goes first, the periodic record follows at the next SOF.
+ * @param  pdev: device instance
+ */
+static void Telemetry_SOF(USBD_HandleTypeDef* pdev){
+	if (frames < TELEMETRY_PERIOD_MAX) {
+		frames++;
+		}
+	if (verify_report) {
+		if (port_open == 0U || Telemetry_SendVerify(pdev) == 0U) {
+			verify_report = 0U;
+			}
+		return;
+		}
+	if ((period != 0U && frames >= period) || snapshot) {
+		if (port_open == 0U) {
+			// nobody listening, start a new measurement window
+			snapshot = 0U;
+			frames = 0U;
+			otg_total_last = telemetry_otg_cycles.total;
+			conv_total_last = telemetry_conv_cycles.total;
+			TELEMETRY_CyclesClear(&telemetry_otg_cycles);
+			TELEMETRY_CyclesClear(&telemetry_conv_cycles);
+			}
+		else {
+			Telemetry_Send(pdev);
+			}
+		}
+	}
+
+
+/**
+ * @brief  Build and queue a record, then start a new measurement window
+ * @param  pdev: device instance
+ */
+static void Telemetry_Send(USBD_HandleTypeDef* pdev){
+	TELEMETRY_RecordTypeDef rec;
+	USBD_AUDIO_StatusTypeDef status;
+
+	USBD_AUDIO_GetStatus(pdev, &status);
+
+	uint32_t otg_total = telemetry_otg_cycles.total;
+	uint32_t conv_total = telemetry_conv_cycles.total;
+	// CPU load from the cycles spent since the last record, SystemCoreClock/1000 cycles per frame
+	float frame_cycles = (float)frames * (float)(SystemCoreClock / 1000U);
+	float otg_load = (float)(otg_total - otg_total_last) * 65536.0f / frame_cycles;
+	float conv_load = (float)(conv_total - conv_total_last) * 65536.0f / frame_cycles;
+
+	rec.sync[0] = TELEMETRY_SYNC0;
+	rec.sync[1] = TELEMETRY_SYNC1;
+	rec.version = TELEMETRY_VERSION;
+	rec.size = (uint8_t)sizeof(rec);
+	rec.sequence = sequence;
+	rec.frames = frames;
+	rec.flags = (status.playing ? TELEMETRY_FLAG_PLAYING : 0U) | (status.mute ? TELEMETRY_FLAG_MUTE : 0U) |
+				(status.starved ? TELEMETRY_FLAG_STARVED : 0U);
+	rec.latency = status.latency;
+	rec.fill = status.fill;
+	rec.fb_value = status.fb_value;
+	rec.freq = status.freq;
+	rec.bit_depth = status.alt_setting != 0U ? status.bit_depth : 0U;
+	rec.reserved = 0U;
+	rec.volume = status.volume;
+	rec.underruns = status.underruns;
+	rec.overruns = status.overruns;
+	rec.frames_missed = status.frames_missed;
+	rec.frames_concealed = status.frames_concealed;
+	rec.fifo_overflows = status.fifo_overflows;
+	rec.otg_cycles_max = TELEMETRY_CyclesMax(&telemetry_otg_cycles);
+	rec.conv_cycles_max = TELEMETRY_CyclesMax(&telemetry_conv_cycles);
+	rec.otg_load = otg_load < 65535.0f ? (uint16_t)otg_load : 65535U;
+	rec.conv_load = conv_load < 65535.0f ? (uint16_t)conv_load : 65535U;
+
+	if (USBD_CDC_ACM_Transmit(pdev, (const uint8_t*)&rec, sizeof(rec)) == USBD_BUSY) {
+		return;
+		}
+	sequence++;
+	snapshot = 0U;
+	frames = 0U;
+	otg_total_last = otg_total;
+	conv_total_last = conv_total;
+	TELEMETRY_CyclesClear(&telemetry_otg_cycles);
+	TELEMETRY_CyclesClear(&telemetry_conv_cycles);
+	}
+
+
+/**
+ * @brief  Build and queue a verify record
+ * @param  pdev: device instance
+ * @retval 0 if it was queued, 1 if the host has not read the last record yet
+ */
+static uint8_t Telemetry_SendVerify(USBD_HandleTypeDef* pdev){
+	TELEMETRY_VerifyRecordTypeDef rec;
+	USBD_AUDIO_StatusTypeDef status;
+
+	USBD_AUDIO_GetStatus(pdev, &status);
+
+	rec.sync[0] = TELEMETRY_SYNC0;
+	rec.sync[1] = TELEMETRY_SYNC1;
+	rec.version = TELEMETRY_VERSION;
+	rec.size = (uint8_t)sizeof(rec);
+	rec.sequence = sequence;
+	rec.flags = (status.playing ? TELEMETRY_FLAG_PLAYING : 0U) | (status.mute ? TELEMETRY_FLAG_MUTE : 0U) |
+				(status.starved ? TELEMETRY_FLAG_STARVED : 0U);
+#ifdef USE_AUDIO_VERIFY
+	rec.flags |= TELEMETRY_FLAG_VERIFY;
+#endif
+	rec.bit_depth = status.alt_setting != 0U ? status.bit_depth : 0U;
+	rec.volume = status.volume;
+	rec.freq = status.freq;
+	rec.crc = status.crc;
+	rec.crc_samples = status.crc_samples;
+
+	if (USBD_CDC_ACM_Transmit(pdev, (const uint8_t*)&rec, sizeof(rec)) == USBD_BUSY) {
+		return 1U;
+		}
+	sequence++;
+	return 0U;
+	}
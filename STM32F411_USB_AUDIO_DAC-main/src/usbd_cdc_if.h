@@ -0,0 +1,119 @@
+#ifndef __USBD_CDC_IF_H
+#define __USBD_CDC_IF_H
+
+#include "usbd_cdc_acm.h"
+
+// Telemetry and control over the CDC-ACM port of the composite device (USE_USB_CDC_TELEMETRY, see Makefile C_DEFS).
+//
+// While a terminal holds the port open (DTR set), a binary TELEMETRY_RecordTypeDef is sent every
+// TELEMETRY_PERIOD_DEFAULT USB frames, each record in its own bulk transfer. All fields are little-endian.
+// The host sends commands of 3 bytes : command, 16bit argument LSbyte first. A packet may hold several commands.
+// TELEMETRY_CMD_VERIFY also sends a TELEMETRY_VerifyRecordTypeDef, told from the periodic records by its size byte.
+// A record is a single packet, shorter than CDC_ACM_DATA_PACKET, see USBD_CDC_ACM_Transmit().
+
+#define TELEMETRY_SYNC0                 0xA5U
+#define TELEMETRY_SYNC1                 0x5AU
+#define TELEMETRY_VERSION               1U
+
+// USB frames between records, 100ms
+#define TELEMETRY_PERIOD_DEFAULT        100U
+// The cycle counter totals wrap after 42s at 100MHz
+#define TELEMETRY_PERIOD_MAX            10000U
+
+#define TELEMETRY_CMD_PERIOD            0x01U // argument : USB frames between records, 0 stops the stream
+#define TELEMETRY_CMD_SNAPSHOT          0x02U // send one record at the next SOF
+#define TELEMETRY_CMD_CLEAR             0x03U // clear the concealment counters
+#define TELEMETRY_CMD_LATENCY           0x04U // argument : AUDIO_LatencyTypeDef, restarts playback if streaming
+#define TELEMETRY_CMD_PROFILE           0x05U // argument : 1 clears the statistics after, write the profile to the UART log (USE_IRQ_PROFILE)
+#define TELEMETRY_CMD_VERIFY            0x06U // argument : TELEMETRY_VERIFY_xxx, bit-perfect verification CRC (USE_AUDIO_VERIFY)
+
+// TELEMETRY_CMD_VERIFY arguments
+#define TELEMETRY_VERIFY_RESTART        0x00U // restart the CRC from the next sample that is not silence
+#define TELEMETRY_VERIFY_REPORT         0x01U // send a TELEMETRY_VerifyRecordTypeDef at the next SOF
+
+// TELEMETRY_RecordTypeDef flags
+#define TELEMETRY_FLAG_PLAYING          0x01U
+#define TELEMETRY_FLAG_MUTE             0x02U
+#define TELEMETRY_FLAG_STARVED          0x04U
+#define TELEMETRY_FLAG_VERIFY           0x08U // TELEMETRY_VerifyRecordTypeDef : the CRC is computed, USE_AUDIO_VERIFY
+
+typedef struct {
+	uint8_t  sync[2];          // TELEMETRY_SYNC0, TELEMETRY_SYNC1
+	uint8_t  version;          // TELEMETRY_VERSION
+	uint8_t  size;             // bytes in the record
+	uint32_t sequence;         // incremented for each record
+	uint16_t frames;           // USB frames since the last record
+	uint8_t  flags;            // TELEMETRY_FLAG_xxx
+	uint8_t  latency;          // AUDIO_LatencyTypeDef
+	int32_t  fill;             // audio buffer fill at the last SOF, 1/256 stereo samples
+	uint32_t fb_value;         // feedback, 10.22 samples per frame
+	uint32_t freq;             // sampling frequency [Hz]
+	uint8_t  bit_depth;        // 24 or 16, 0 when the streaming interface is idle
+	uint8_t  reserved;
+	int16_t  volume;           // 1/256 dB
+	uint32_t underruns;        // see USBD_AUDIO_StatusTypeDef
+	uint32_t overruns;
+	uint32_t frames_missed;
+	uint32_t frames_concealed;
+	uint32_t fifo_overflows;
+	uint32_t otg_cycles_max;   // longest OTG interrupt since the last record [cycles]
+	uint32_t conv_cycles_max;  // longest conversion run (PendSV) since the last record [cycles], including preemption
+	uint16_t otg_load;         // CPU time in the OTG interrupt since the last record, 1/65536
+	uint16_t conv_load;        // CPU time in the conversion since the last record, 1/65536, including preemption
+} TELEMETRY_RecordTypeDef;
+
+_Static_assert(sizeof(TELEMETRY_RecordTypeDef) == 60U, "telemetry record layout");
+
+// CRC of the samples written to the I2S buffer since the first sample that is not silence, see audio_verify.h
+typedef struct {
+	uint8_t  sync[2];          // TELEMETRY_SYNC0, TELEMETRY_SYNC1
+	uint8_t  version;          // TELEMETRY_VERSION
+	uint8_t  size;             // bytes in the record
+	uint32_t sequence;         // incremented for each record, of both types
+	uint8_t  flags;            // TELEMETRY_FLAG_xxx
+	uint8_t  bit_depth;        // 24 or 16, 0 when the streaming interface is idle
+	int16_t  volume;           // 1/256 dB, bit-perfect at 0dB only
+	uint32_t freq;             // sampling frequency [Hz]
+	uint32_t crc;              // CRC-32/MPEG-2, 0xFFFFFFFF until the first sample
+	uint32_t crc_samples;      // stereo samples in crc
+} TELEMETRY_VerifyRecordTypeDef;
+
+_Static_assert(sizeof(TELEMETRY_VerifyRecordTypeDef) == 24U, "telemetry verify record layout");
+
+// Cycles spent in an interrupt handler, measured with the DWT cycle counter.
+// The OTG interrupt preempts the conversion (PendSV), so it does not clear max itself : it increments clear, and
+// the next TELEMETRY_Cycles() of the handler restarts max, like the volume fade (see audio_volume.h).
+typedef struct {
+	volatile uint32_t max;     // longest run since the last record
+	volatile uint32_t total;   // all the runs, wraps
+	volatile uint32_t clear;   // incremented by the record sender to restart max
+	volatile uint32_t clear_seen; // handler copy of clear
+} TELEMETRY_CyclesTypeDef;
+
+extern TELEMETRY_CyclesTypeDef telemetry_otg_cycles;
+extern TELEMETRY_CyclesTypeDef telemetry_conv_cycles;
+
+static inline void TELEMETRY_Cycles(TELEMETRY_CyclesTypeDef* c, uint32_t cycles){
+	uint32_t clear = c->clear;
+	c->total += cycles;
+	if (clear != c->clear_seen) {
+		c->max = 0U;
+		c->clear_seen = clear;
+		}
+	if (cycles > c->max) {
+		c->max = cycles;
+		}
+	}
+
+// Longest run since the last TELEMETRY_CyclesClear(), 0 if the handler has not run since
+static inline uint32_t TELEMETRY_CyclesMax(const TELEMETRY_CyclesTypeDef* c){
+	return c->clear != c->clear_seen ? 0U : c->max;
+	}
+
+static inline void TELEMETRY_CyclesClear(TELEMETRY_CyclesTypeDef* c){
+	c->clear++;
+	}
+
+extern USBD_CDC_ACM_ItfTypeDef USBD_CDC_fops;
+
+#endif /* __USBD_CDC_IF_H */
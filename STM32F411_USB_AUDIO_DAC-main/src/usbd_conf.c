@@ -263,11 +263,28 @@ USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
   HAL_PCD_Init(&hpcd);
   
   // USB fifos share 1.25kB memory = 0x140 words
+#ifdef USE_USB_CDC_TELEMETRY
+  // the RX FIFO still holds a 96kHz 24bit packet (146 words) with the setup and status entries
+  HAL_PCDEx_SetRxFiFo(&hpcd, 0x100);
+#elif defined(USE_AUDIO_CAPTURE)
+  // 146 words for a 96kHz 24bit packet, 13 for the setup packets and 5 for the status entries
+  HAL_PCDEx_SetRxFiFo(&hpcd, 0xB0);
+#else
   HAL_PCDEx_SetRxFiFo(&hpcd, 0x120);
+#endif
   /* Set Tx0 FIFO (for EP0 IN) */
   HAL_PCDEx_SetTxFiFo(&hpcd, 0, 0x10);
   /* Set Tx1 FIFO (for EP1 IN) */
   HAL_PCDEx_SetTxFiFo(&hpcd, 1, 0x10);
+#ifdef USE_USB_CDC_TELEMETRY
+  /* Set Tx2 FIFO (for the CDC bulk IN, 64 bytes) and Tx3 FIFO (for the CDC notification) */
+  HAL_PCDEx_SetTxFiFo(&hpcd, 2, 0x10);
+  HAL_PCDEx_SetTxFiFo(&hpcd, 3, 0x10);
+#endif
+#ifdef USE_AUDIO_CAPTURE
+  /* Set Tx2 FIFO (for the capture EP2 IN), a 96kHz 16bit packet is 97 words */
+  HAL_PCDEx_SetTxFiFo(&hpcd, 2, 0x70);
+#endif
   
   return USBD_OK;
 }
@@ -440,6 +457,31 @@ USBD_StatusTypeDef USBD_LL_PrepareReceive(USBD_HandleTypeDef *pdev,
   return USBD_OK;
 }
 
+/**
+  * @brief  Prepares an endpoint for reception into a circular buffer.
+  *         The RX FIFO is drained directly into the buffer, see USB_ReadPacketRing().
+  * @param  pdev: Device handle
+  * @param  ep_addr: Endpoint Number
+  * @param  pring: Pointer to the circular buffer
+  * @param  ring_size: Circular buffer size in bytes
+  * @param  ring_pos: Write position in the circular buffer
+  * @param  size: Data size
+  * @retval USBD Status
+  */
+USBD_StatusTypeDef USBD_LL_PrepareReceiveRing(USBD_HandleTypeDef *pdev,
+                                              uint8_t ep_addr,
+                                              uint8_t *pring,
+                                              uint32_t ring_size,
+                                              uint32_t ring_pos,
+                                              uint16_t size)
+{
+  if (HAL_PCD_EP_ReceiveRing(pdev->pData, ep_addr, pring, ring_size, ring_pos, size) != HAL_OK)
+  {
+    return USBD_FAIL;
+  }
+  return USBD_OK;
+}
+
 /**
   * @brief  Returns the last transferred packet size.
   * @param  pdev: Device handle
@@ -451,6 +493,60 @@ uint32_t USBD_LL_GetRxDataSize(USBD_HandleTypeDef *pdev, uint8_t ep_addr)
   return HAL_PCD_EP_GetRxCount(pdev->pData, ep_addr);
 }
 
+/**
+  * @brief  Returns the frame number of the last received SOF.
+  * @param  pdev: Device handle
+  * @retval FNSOF field of the device status register
+  */
+uint32_t USBD_LL_GetFrameNumber(USBD_HandleTypeDef *pdev)
+{
+  USB_OTG_GlobalTypeDef *USBx = ((PCD_HandleTypeDef *)pdev->pData)->Instance;
+  uint32_t USBx_BASE = (uint32_t)USBx;
+
+  return (USBx_DEVICE->DSTS & USB_OTG_DSTS_FNSOF) >> 8;
+}
+
+/*******************************************************************************
+                       Class data arena
+*******************************************************************************/
+
+// The class data is the only allocation of the USB device library : USBD_AUDIO_Init() allocates it on each
+// SET_CONFIGURATION and USBD_AUDIO_DeInit() frees it on each reset, disconnection or configuration change.
+// A static block sized for it replaces the heap, so it cannot fragment or run out after any number of
+// re-enumerations. The CDC-ACM function of USE_USB_CDC_TELEMETRY has no class data.
+#define USBD_ARENA_SIZE   ((sizeof(USBD_AUDIO_HandleTypeDef) + USBD_AUDIO_RAM_ALIGN - 1U) & ~(USBD_AUDIO_RAM_ALIGN - 1U))
+
+USBD_AUDIO_RAM static uint8_t usbd_arena[USBD_ARENA_SIZE];
+
+_Static_assert((USBD_AUDIO_RAM_ALIGN & (USBD_AUDIO_RAM_ALIGN - 1U)) == 0U, "USBD_AUDIO_RAM_ALIGN is not a power of 2");
+_Static_assert(USBD_ARENA_SIZE + AUDIO_TOTAL_BUF_SIZE * sizeof(uint16_t) <= USBD_AUDIO_RAM_SIZE,
+	"the class data and the audio transfer buffer do not fit in USBD_AUDIO_RAM_SIZE");
+
+/**
+  * @brief  Allocate the class data from the arena, stands in for malloc()
+  * @param  size: bytes
+  * @retval the arena, cleared, or NULL if the class data does not fit
+  */
+// A class that is initialized again without a DeInit gets the same block back instead of leaking the first one.
+void* USBD_static_malloc(uint32_t size)
+{
+  if (size > sizeof(usbd_arena)) {
+    return NULL;
+  }
+  memset(usbd_arena, 0, sizeof(usbd_arena));
+  return usbd_arena;
+}
+
+/**
+  * @brief  Free the class data, the arena is kept for the next USBD_static_malloc()
+  * @param  p: class data
+  * @retval None
+  */
+void USBD_static_free(void* p)
+{
+  (void)p;
+}
+
 /**
   * @brief  Delays routine for the USB Device Library.
   * @param  Delay: Delay in ms
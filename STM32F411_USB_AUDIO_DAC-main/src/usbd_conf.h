@@ -51,7 +51,13 @@
 #include <string.h>
 
 /* Common Config */
+#ifdef USE_USB_CDC_TELEMETRY
+#define USBD_MAX_NUM_INTERFACES               4 // audio control, audio streaming, CDC communication, CDC data
+#elif defined(USE_AUDIO_CAPTURE)
+#define USBD_MAX_NUM_INTERFACES               3 // audio control, playback streaming, capture streaming
+#else
 #define USBD_MAX_NUM_INTERFACES               2 // Isn't interface different from alt_setting ?
+#endif
 #define USBD_MAX_NUM_CONFIGURATION            1
 #define USBD_MAX_STR_DESC_SIZ                 0x100
 #define USBD_SUPPORT_USER_STRING              0 
@@ -63,11 +69,25 @@
 #define USBD_AUDIO_FREQ_MAX                   96000
 #define USBD_AUDIO_BIT_DEPTH_DEFAULT 			24
 
-/* Memory management macros */   
-#define USBD_malloc               malloc
-#define USBD_free                 free
+/* Memory management macros. There is no heap, the class data is allocated from a static arena, see usbd_conf.c */
+#define USBD_malloc               USBD_static_malloc
+#define USBD_free                 USBD_static_free
 #define USBD_memset               memset
 #define USBD_memcpy               memcpy
+
+// The class data arena and the audio transfer buffer are placed in the .audio_ram section at the start of the RAM
+// (see the linker scripts), aligned for 4 word DMA bursts. Their total size is checked against USBD_AUDIO_RAM_SIZE
+// at compile time, the rest of the RAM is left to the other buffers and the stack.
+#define USBD_AUDIO_RAM_ALIGN      16U
+#define USBD_AUDIO_RAM            __attribute__((section(".audio_ram"), aligned(USBD_AUDIO_RAM_ALIGN)))
+#if defined(STM32F411xE)
+#define USBD_AUDIO_RAM_SIZE       (96U*1024U)
+#else
+#define USBD_AUDIO_RAM_SIZE       (40U*1024U)
+#endif
+
+void* USBD_static_malloc(uint32_t size);
+void  USBD_static_free(void* p);
     
 /* DEBUG macros */  
 #if (USBD_DEBUG_LEVEL > 0)
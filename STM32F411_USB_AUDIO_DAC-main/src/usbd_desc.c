@@ -93,9 +93,15 @@ __ALIGN_BEGIN   uint8_t USBD_DeviceDesc[USB_LEN_DEV_DESC] __ALIGN_END = {
   USB_DESC_TYPE_DEVICE,       /* bDescriptorType */
   0x00,                       /* bcdUSB version (2.00) minor and subminor .00 */
   0x02,                       /* bcdUSB version major number 2 */
+#ifdef USE_USB_CDC_TELEMETRY
+  0xEF,                       /* bDeviceClass : miscellaneous, composite device with interface associations */
+  0x02,                       /* bDeviceSubClass */
+  0x01,                       /* bDeviceProtocol */
+#else
   0x00,                       /* bDeviceClass */
   0x00,                       /* bDeviceSubClass */
   0x00,                       /* bDeviceProtocol */
+#endif
   USB_MAX_EP0_SIZE,           /* bMaxPacketSize */
   LOBYTE(USBD_VID),           /* idVendor */
   HIBYTE(USBD_VID),           /* idVendor */
@@ -0,0 +1,204 @@
+// Host benchmark of the 2x oversampling filters, drivers/dsp/audio_upsample.c compiled unmodified for the host
+//
+// For each filter and stream rate, a sine is written to an I2S circular buffer like USBD_AUDIO_Process() does, and
+// interpolated one I2S DMA period at a time like AUDIO_OUT_CopyPeriod(). Reported :
+//  - THD+N : residual after a least squares fit of the sine, 20Hz to 20kHz at the output rate, unweighted
+//  - the delay of the sine through the filter
+//  - the level of a 20kHz sine, the passband edge, and of its image at the stream rate minus 20kHz
+//  - the host time per output sample, the target cycles are measured by the PROFILE_UPSAMPLE point
+//
+// Usage : make bench, or ./build/upsamplebench [-f tone_hz] [-a amplitude_dbfs]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+#include "audio_upsample.h"
+
+#define BUF_SAMPLES         1024U       // stereo samples of the circular buffer
+#define PERIOD_SAMPLES      48U         // AUDIO_OUT_PERIOD_SAMPLES, output samples
+#define RUN_SECONDS         1U
+// output samples analyzed at the end of the run, sets the resolution of the band limits
+#define FIT_SAMPLES         16384U
+
+static const uint32_t Freq[] = {44100, 48000};
+#define FREQ_NUM            (sizeof(Freq)/sizeof(Freq[0]))
+
+static const char* const FilterName[AUDIO_UPSAMPLE_NUM] = {"off", "linear", "minimum"};
+
+static uint16_t Buffer[BUF_SAMPLES*4U];
+static uint16_t Period[PERIOD_SAMPLES*4U];
+static AUDIO_UPSAMPLE_TypeDef Up;
+
+
+/**
+ * @brief  Write a 24bit stereo sample in the I2S format of the buffer, {hi:mid},{lo:00} per channel
+ */
+static void put_sample(uint16_t* p, int32_t l, int32_t r){
+	uint32_t ul = (uint32_t)l << 8, ur = (uint32_t)r << 8;
+	p[0] = (uint16_t)(ul >> 16);
+	p[1] = (uint16_t)ul;
+	p[2] = (uint16_t)(ur >> 16);
+	p[3] = (uint16_t)ur;
+	}
+
+
+static int32_t get_sample(const uint16_t* p){
+	return (int32_t)(((uint32_t)p[0] << 16) | p[1]) >> 8;
+	}
+
+
+/**
+ * @brief  Interpolate a sine
+ * @param  out: left channel of the output, num_out samples at twice freq_in
+ * @retval host nanoseconds per output sample
+ */
+static double run(uint32_t filter, uint32_t freq_in, double tone, double amp, double* out, uint32_t num_out){
+	AUDIO_Upsample_Init(&Up, filter);
+	uint32_t wr = 0U, rd = 0U, n_in = 0U;
+	double ns = 0.0;
+	for (uint32_t n = 0; n < num_out; n += PERIOD_SAMPLES) {
+		while ((wr + BUF_SAMPLES*4U - rd) % (BUF_SAMPLES*4U) < 4U*PERIOD_SAMPLES) {
+			double x = amp*sin(2.0*M_PI*tone*n_in/freq_in);
+			int32_t s = (int32_t)lround(x*8388607.0);
+			put_sample(&Buffer[wr], s, -s);
+			wr = (wr + 4U) % (BUF_SAMPLES*4U);
+			n_in++;
+			}
+		struct timespec t0, t1;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		rd = AUDIO_Upsample_Process(&Up, Period, PERIOD_SAMPLES, Buffer, rd, BUF_SAMPLES*4U);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		ns += (t1.tv_sec - t0.tv_sec)*1.0e9 + (t1.tv_nsec - t0.tv_nsec);
+		for (uint32_t k = 0; k < PERIOD_SAMPLES && n + k < num_out; k++) {
+			out[n + k] = get_sample(&Period[4U*k])/8388608.0;
+			if (get_sample(&Period[4U*k + 2U]) != -get_sample(&Period[4U*k]) &&
+				get_sample(&Period[4U*k + 2U]) != -get_sample(&Period[4U*k]) - 1) {
+				fprintf(stderr, "channel mismatch at %u\n", n + k);
+				}
+			}
+		}
+	return ns/num_out;
+	}
+
+
+/**
+ * @brief  Least squares fit of a sine of known frequency and DC
+ * @param  x0: index of x[0] in the output, the phase is referenced to output sample 0
+ * @param  w: angular frequency, radians per sample
+ * @param  res: set to the residual, NULL if not needed
+ * @param  phase: set to the phase of the sine
+ * @retval amplitude of the sine
+ */
+static double fit(const double* x, uint32_t x0, uint32_t num, double w, double* res, double* phase){
+	// normal equations of [cos sin 1]
+	double a[3][4] = {{0}};
+	for (uint32_t n = 0; n < num; n++) {
+		double v[3] = {cos(w*(x0 + n)), sin(w*(x0 + n)), 1.0};
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				a[i][j] += v[i]*v[j];
+				}
+			a[i][3] += v[i]*x[n];
+			}
+		}
+	for (int i = 0; i < 3; i++) {
+		for (int r = 0; r < 3; r++) {
+			if (r != i) {
+				double f = a[r][i]/a[i][i];
+				for (int c = i; c < 4; c++) {
+					a[r][c] -= f*a[i][c];
+					}
+				}
+			}
+		}
+	double c = a[0][3]/a[0][0], s = a[1][3]/a[1][1], dc = a[2][3]/a[2][2];
+	if (res != NULL) {
+		for (uint32_t n = 0; n < num; n++) {
+			res[n] = x[n] - (c*cos(w*(x0 + n)) + s*sin(w*(x0 + n)) + dc);
+			}
+		}
+	// c cos + s sin = A sin(wn + phase)
+	*phase = atan2(c, s);
+	return sqrt(c*c + s*s);
+	}
+
+
+/**
+ * @brief  RMS of the residual from 20Hz to 20kHz, DFT power over the bins of the band
+ */
+static double band_rms(const double* x, uint32_t num, double fs){
+	// Hann window, the leakage of the fitted sine is already removed
+	uint32_t k_lo = (uint32_t)ceil(20.0*num/fs), k_hi = (uint32_t)floor(20000.0*num/fs);
+	double* xw = malloc(num*sizeof(double));
+	double wsum = 0.0;
+	for (uint32_t n = 0; n < num; n++) {
+		double w = 0.5 - 0.5*cos(2.0*M_PI*n/num);
+		xw[n] = x[n]*w;
+		wsum += w*w;
+		}
+	double power = 0.0;
+	for (uint32_t k = k_lo; k <= k_hi; k++) {
+		// Goertzel
+		double coeff = 2.0*cos(2.0*M_PI*k/num), s1 = 0.0, s2 = 0.0;
+		for (uint32_t n = 0; n < num; n++) {
+			double s0 = xw[n] + coeff*s1 - s2;
+			s2 = s1;
+			s1 = s0;
+			}
+		power += s1*s1 + s2*s2 - coeff*s1*s2;
+		}
+	free(xw);
+	// Parseval with the window power, one sided
+	return sqrt(2.0*power/(num*wsum));
+	}
+
+
+int main(int argc, char** argv){
+	double tone = 997.0, amp_db = -1.0;
+	int opt;
+	while ((opt = getopt(argc, argv, "f:a:h")) != -1) {
+		switch (opt) {
+			case 'f': tone = atof(optarg); break;
+			case 'a': amp_db = atof(optarg); break;
+			default:
+				fprintf(stderr, "usage : %s [-f tone_hz] [-a amplitude_dbfs]\n", argv[0]);
+				return opt == 'h' ? 0 : 1;
+			}
+		}
+	double amp = pow(10.0, amp_db/20.0);
+	double* res = malloc(FIT_SAMPLES*sizeof(double));
+
+	printf("2x upsampler, %.0f Hz sine at %.1f dBFS\n", tone, amp_db);
+	printf("filter    input Hz   THD+N dB  THD+N %%    delay us   20kHz dB  image dB  host ns/sample\n");
+	for (uint32_t f = AUDIO_UPSAMPLE_LINEAR; f < AUDIO_UPSAMPLE_NUM; f++) {
+		for (uint32_t i = 0; i < FREQ_NUM; i++) {
+			uint32_t fs = 2U*Freq[i];
+			uint32_t num = fs*RUN_SECONDS;
+			double* out = malloc(num*sizeof(double));
+			double phase;
+
+			double ns = run(f, Freq[i], tone, amp, out, num);
+			// from the end of the run, long after the history filled
+			double w = 2.0*M_PI*tone/fs;
+			fit(&out[num - FIT_SAMPLES], num - FIT_SAMPLES, FIT_SAMPLES, w, res, &phase);
+			double thdn = band_rms(res, FIT_SAMPLES, fs)/(amp/sqrt(2.0));
+			// the input sine is sin(w*n) at output sample n, the first output is the first input sample
+			double delay = fmod(2.0*M_PI - phase, 2.0*M_PI)/w/fs*1.0e6;
+
+			run(f, Freq[i], 20000.0, amp, out, num);
+			double w20 = 2.0*M_PI*20000.0/fs, wi = 2.0*M_PI*(Freq[i] - 20000.0)/fs;
+			double level = 20.0*log10(fit(&out[num - FIT_SAMPLES], num - FIT_SAMPLES, FIT_SAMPLES, w20, res, &phase)/amp);
+			// on the residual, the leakage of the 20kHz sine would hide the image
+			double image = 20.0*log10(fit(res, num - FIT_SAMPLES, FIT_SAMPLES, wi, NULL, &phase)/amp);
+			printf("%-8s  %8u   %7.1f   %.5f   %7.1f    %7.2f   %7.1f   %6.1f\n", FilterName[f], Freq[i],
+				20.0*log10(thdn), 100.0*thdn, delay, level, image, ns);
+			free(out);
+			}
+		}
+	free(res);
+	return 0;
+	}
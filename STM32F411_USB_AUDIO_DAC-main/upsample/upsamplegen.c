@@ -0,0 +1,202 @@
+// Host-side generator of the 2x oversampling filters, generates drivers/dsp/audio_upsample_coef.c
+//
+// Linear phase : half-band Kaiser windowed sinc of 2*TAPS-1 taps at the output rate, cut at the input Nyquist
+// frequency. Every other tap is zero except the centre one, so the polyphase branch through the centre is a delay.
+// Minimum phase : the same magnitude by the cepstrum method (the log magnitude of the linear phase filter folded
+// onto positive quefrencies), truncated to 2*MIN_TAPS taps.
+// Each branch is normalized to unity DC gain, so the two output samples of a constant input are equal. Q30.
+// The passband ripple and the stopband attenuation of the quantized filters are written in the generated file.
+//
+// Usage : make, or ./build/upsamplegen > ../drivers/dsp/audio_upsample_coef.c
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <complex.h>
+#include <math.h>
+
+// Must match AUDIO_UPSAMPLE_TAPS and AUDIO_UPSAMPLE_MIN_TAPS in audio_upsample.h
+#define TAPS            64
+#define MIN_TAPS        56
+
+// Stopband attenuation ~100dB with a transition band of 0.1 input rate
+#define KAISER_BETA     9.9
+
+// Band edges relative to the input rate
+#define PASS_EDGE       0.45
+#define STOP_EDGE       0.55
+
+#define FFT_SIZE        8192
+// floor of the log magnitude, below the quantization
+#define LOG_FLOOR       1.0e-8
+
+static double complex Spec[FFT_SIZE];
+
+
+/**
+ * @brief  Modified Bessel function of the first kind, order 0
+ */
+static double bessel_i0(double x){
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 50; k++) {
+		term *= (x/(2.0*k))*(x/(2.0*k));
+		sum += term;
+		if (term < 1.0e-12*sum) {
+			break;
+			}
+		}
+	return sum;
+	}
+
+
+/**
+ * @brief  In-place radix 2 FFT of Spec
+ * @param  dir: -1 forward, +1 inverse (not scaled)
+ */
+static void fft(int dir){
+	for (int i = 1, j = 0; i < FFT_SIZE; i++) {
+		int bit = FFT_SIZE >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+			}
+		j ^= bit;
+		if (i < j) {
+			double complex t = Spec[i];
+			Spec[i] = Spec[j];
+			Spec[j] = t;
+			}
+		}
+	for (int len = 2; len <= FFT_SIZE; len <<= 1) {
+		double complex w = cexp(dir*2.0*M_PI*I/len);
+		for (int i = 0; i < FFT_SIZE; i += len) {
+			double complex wk = 1.0;
+			for (int k = 0; k < len/2; k++) {
+				double complex a = Spec[i + k], b = Spec[i + k + len/2]*wk;
+				Spec[i + k] = a + b;
+				Spec[i + k + len/2] = a - b;
+				wk *= w;
+				}
+			}
+		}
+	}
+
+
+/**
+ * @brief  Magnitude response of a quantized filter at the output rate
+ * @param  ripple: set to the peak to peak passband ripple [dB]
+ * @retval stopband attenuation [dB]
+ */
+static double response(const int32_t* h, int num, double* ripple){
+	double pass_min = 1e9, pass_max = -1e9, stop_max = -1e9;
+	for (int i = 0; i <= 2000; i++) {
+		// 0 to the output Nyquist frequency, the input rate is 0.5
+		double f = 0.5*i/2000;
+		double complex s = 0.0;
+		for (int n = 0; n < num; n++) {
+			s += h[n]*cexp(-2.0*M_PI*I*f*n);
+			}
+		double db = 20.0*log10(cabs(s)/(double)(1 << 30)/2.0 + 1.0e-20);
+		if (f <= 0.5*PASS_EDGE) {
+			pass_min = fmin(pass_min, db);
+			pass_max = fmax(pass_max, db);
+			}
+		if (f >= 0.5*STOP_EDGE) {
+			stop_max = fmax(stop_max, db);
+			}
+		}
+	*ripple = pass_max - pass_min;
+	return -stop_max;
+	}
+
+
+/**
+ * @brief  Quantize the two polyphase branches of h to Q30 with unity DC gain each
+ * @param  num: taps of h, even
+ * @param  q: set to the quantized filter, num taps
+ */
+static void quantize(const double* h, int num, int32_t* q){
+	for (int b = 0; b < 2; b++) {
+		double sum = 0.0;
+		for (int n = b; n < num; n += 2) {
+			sum += h[n];
+			}
+		for (int n = b; n < num; n += 2) {
+			q[n] = (int32_t)lround(h[n]/sum*(double)(1 << 30));
+			}
+		}
+	}
+
+
+int main(void){
+	// linear phase, the centre tap is TAPS-1, one zero tap at the end so that both branches have TAPS taps
+	double lin[2*TAPS] = {0};
+	for (int n = 0; n < 2*TAPS - 1; n++) {
+		double u = n - (TAPS - 1);
+		double x = M_PI*0.5*u;
+		double r = u/TAPS;
+		lin[n] = (u == 0.0 ? 1.0 : sin(x)/x)*bessel_i0(KAISER_BETA*sqrt(1.0 - r*r))/bessel_i0(KAISER_BETA);
+		}
+	int32_t lin_q[2*TAPS];
+	quantize(lin, 2*TAPS, lin_q);
+
+	// minimum phase, real cepstrum of the log magnitude folded to the causal part
+	memset(Spec, 0, sizeof(Spec));
+	for (int n = 0; n < 2*TAPS; n++) {
+		Spec[n] = lin[n];
+		}
+	fft(-1);
+	for (int k = 0; k < FFT_SIZE; k++) {
+		Spec[k] = log(fmax(cabs(Spec[k]), LOG_FLOOR));
+		}
+	fft(1);
+	for (int n = 0; n < FFT_SIZE; n++) {
+		double c = creal(Spec[n])/FFT_SIZE;
+		Spec[n] = (n == 0 || n == FFT_SIZE/2) ? c : (n < FFT_SIZE/2 ? 2.0*c : 0.0);
+		}
+	fft(-1);
+	for (int k = 0; k < FFT_SIZE; k++) {
+		Spec[k] = cexp(Spec[k]);
+		}
+	fft(1);
+	double min[2*MIN_TAPS];
+	for (int n = 0; n < 2*MIN_TAPS; n++) {
+		// truncated without a taper, the tail is already small and a taper costs more stopband than it saves
+		min[n] = creal(Spec[n])/FFT_SIZE;
+		}
+	int32_t min_q[2*MIN_TAPS];
+	quantize(min, 2*MIN_TAPS, min_q);
+
+	double lin_ripple, min_ripple;
+	double lin_stop = response(lin_q, 2*TAPS, &lin_ripple);
+	double min_stop = response(min_q, 2*MIN_TAPS, &min_ripple);
+
+	printf("// Generated by upsample/upsamplegen.c, do not edit : run make -C upsample to regenerate.\n");
+	printf("// 2x oversampling filters, see audio_upsample.h. Passband to %.2f, stopband from %.2f of the input rate.\n",
+		PASS_EDGE, STOP_EDGE);
+	printf("// linear phase  : %d taps, Kaiser beta %.1f, passband ripple %.4fdB, stopband %.1fdB\n",
+		2*TAPS - 1, KAISER_BETA, lin_ripple, lin_stop);
+	printf("// minimum phase : %d taps, passband ripple %.4fdB, stopband %.1fdB\n\n", 2*MIN_TAPS, min_ripple, min_stop);
+	printf("#include \"audio_upsample.h\"\n\n");
+	printf("#if AUDIO_UPSAMPLE_TAPS != %d || AUDIO_UPSAMPLE_MIN_TAPS != %d\n", TAPS, MIN_TAPS);
+	printf("#error \"the upsampling filters do not match audio_upsample.h, run make -C upsample\"\n");
+	printf("#endif\n\n");
+
+	// the window is the last TAPS input samples, newest last : tap k of a branch is h[2*(TAPS-1-k) + branch]
+	printf("// first half of the symmetric branch, the other branch is the input sample AUDIO_UPSAMPLE_TAPS/2\n");
+	printf("const int32_t AUDIO_Upsample_CoefLinear[AUDIO_UPSAMPLE_TAPS/2U] = {\n");
+	for (int k = 0; k < TAPS/2; k++) {
+		printf("%d%s", lin_q[2*(TAPS - 1 - k)], k + 1 < TAPS/2 ? ", " : "\n");
+		}
+	printf("};\n\n");
+	printf("// first and second output sample of each input sample\n");
+	printf("const int32_t AUDIO_Upsample_CoefMinimum[2][AUDIO_UPSAMPLE_MIN_TAPS] = {\n");
+	for (int b = 0; b < 2; b++) {
+		printf("{");
+		for (int k = 0; k < MIN_TAPS; k++) {
+			printf("%d%s", min_q[2*(MIN_TAPS - 1 - k) + b], k + 1 < MIN_TAPS ? ", " : "");
+			}
+		printf("}%s\n", b == 0 ? "," : "");
+		}
+	printf("};\n");
+	return 0;
+	}
@@ -0,0 +1,452 @@
+// Host-side bit-perfect check : plays a test file through the host audio stack and compares its CRC with the CRC
+// of the samples written to the I2S buffer, reported in the telemetry (USE_AUDIO_VERIFY and USE_USB_CDC_TELEMETRY),
+// see drivers/dsp/audio_verify.h.
+//
+// The device CRC starts at the first sample that is not silence, and goes on over the silence sent after the file
+// until the report. The expected CRC is that of the file from its first sample that is not silence, padded with
+// silence to the device sample count, which must cover the last sample of the file that is not silence.
+// Each stereo sample is two words, left then right : 24bit sample << 8, 16bit sample << 16. A 16bit file played
+// on the 24bit alt setting gives the same words.
+// CRC-32/MPEG-2 (the F4 CRC unit) : polynomial 0x04C11DB7, initial value 0xFFFFFFFF, words MSB first, no reflection,
+// no final XOR, computed here with a table independently of the firmware.
+//
+// The test file starts and ends with silence, longer than the fade-in of the stream start and the pre-roll. It holds
+// a -20dBFS sine with TPDF noise of a few LSBs, so that every bit of the samples changes.
+// The device volume must be 0dB, not muted, with the EQ flat and the crossfeed off.
+//
+// Usage : make, then
+//   ./build/verify -g test.wav [-f 48000] [-w 24] [-t 10]              generate a test file
+//   ./build/verify [-P "aplay -D hw:CARD=DAC test.wav"] test.wav /dev/ttyACM0
+// The second form restarts the device CRC, runs the player command (or waits for Enter while the file is played by
+// hand), requests a verify record and compares the CRCs. The exit status is 0 if they match.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/select.h>
+#include <math.h>
+
+// see src/usbd_cdc_if.h
+#define TELEMETRY_SYNC0             0xA5U
+#define TELEMETRY_SYNC1             0x5AU
+#define TELEMETRY_CMD_PERIOD        0x01U
+#define TELEMETRY_CMD_VERIFY        0x06U
+#define TELEMETRY_VERIFY_RESTART    0x00U
+#define TELEMETRY_VERIFY_REPORT     0x01U
+#define TELEMETRY_FLAG_PLAYING      0x01U
+#define TELEMETRY_FLAG_MUTE         0x02U
+#define TELEMETRY_FLAG_VERIFY       0x08U
+#define TELEMETRY_VERIFY_SIZE       24U
+
+#define CRC_POLY                    0x04C11DB7U
+#define CRC_INIT                    0xFFFFFFFFU
+
+// silence before and after the test signal
+#define GEN_SILENCE_MS              500U
+// the device drains its buffer before the report
+#define REPORT_DELAY_MS             500U
+#define REPORT_TIMEOUT_MS           2000U
+
+typedef struct {
+	uint32_t  freq;
+	uint32_t  bits;         // 16 or 24
+	uint32_t  num_samples;  // stereo samples
+	uint32_t* words;        // left-aligned, 2 per stereo sample
+} WAV_FILE;
+
+typedef struct {
+	uint32_t sequence;
+	uint8_t  flags;
+	uint8_t  bit_depth;
+	int16_t  volume;
+	uint32_t freq;
+	uint32_t crc;
+	uint32_t crc_samples;
+} VERIFY_RECORD;
+
+static uint32_t crc_table[256];
+
+
+static void crc_init(void){
+	for (uint32_t i = 0; i < 256U; i++) {
+		uint32_t c = i << 24;
+		for (int k = 0; k < 8; k++) {
+			c = (c & 0x80000000U) ? (c << 1) ^ CRC_POLY : c << 1;
+			}
+		crc_table[i] = c;
+		}
+	}
+
+
+static uint32_t crc_word(uint32_t crc, uint32_t word){
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		crc = (crc << 8) ^ crc_table[((crc >> 24) ^ (word >> shift)) & 0xFFU];
+		}
+	return crc;
+	}
+
+
+static uint32_t get_le(const uint8_t* p, int bytes){
+	uint32_t v = 0;
+	for (int i = bytes - 1; i >= 0; i--) {
+		v = (v << 8) | p[i];
+		}
+	return v;
+	}
+
+
+static void put_le(uint8_t* p, uint32_t v, int bytes){
+	for (int i = 0; i < bytes; i++) {
+		p[i] = (uint8_t)(v >> (8*i));
+		}
+	}
+
+
+/**
+ * @brief  Read a stereo 16bit or 24bit PCM WAV file
+ */
+static int wav_read(const char* path, WAV_FILE* wav){
+	FILE* f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return -1;
+		}
+	uint8_t hdr[12], chunk[8], fmt[40];
+	uint32_t channels = 0;
+	memset(wav, 0, sizeof(*wav));
+	if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) {
+		fprintf(stderr, "%s : not a WAV file\n", path);
+		fclose(f);
+		return -1;
+		}
+	while (fread(chunk, 1, 8, f) == 8) {
+		uint32_t size = get_le(chunk + 4, 4);
+		if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16U && size <= sizeof(fmt)) {
+			if (fread(fmt, 1, size, f) != size) {
+				break;
+				}
+			uint32_t format = get_le(fmt, 2);
+			// WAVE_FORMAT_EXTENSIBLE, the sub-format GUID starts with the format tag
+			if (format == 0xFFFEU && size >= 26U) {
+				format = get_le(fmt + 24, 2);
+				}
+			channels = get_le(fmt + 2, 2);
+			wav->freq = get_le(fmt + 4, 4);
+			wav->bits = get_le(fmt + 14, 2);
+			if (format != 1U || channels != 2U || (wav->bits != 16U && wav->bits != 24U)) {
+				fprintf(stderr, "%s : not a stereo 16bit or 24bit PCM file\n", path);
+				fclose(f);
+				return -1;
+				}
+			if (size & 1U) {
+				fseek(f, 1, SEEK_CUR);
+				}
+			}
+		else if (memcmp(chunk, "data", 4) == 0 && channels != 0U) {
+			uint32_t bytes = wav->bits/8U;
+			wav->num_samples = size/(2U*bytes);
+			wav->words = malloc((size_t)wav->num_samples*2U*sizeof(uint32_t) + 1U);
+			uint8_t* data = malloc((size_t)wav->num_samples*2U*bytes + 1U);
+			if (wav->words == NULL || data == NULL ||
+				fread(data, 2U*bytes, wav->num_samples, f) != wav->num_samples) {
+				fprintf(stderr, "%s : truncated data\n", path);
+				free(data);
+				fclose(f);
+				return -1;
+				}
+			for (uint32_t i = 0; i < 2U*wav->num_samples; i++) {
+				wav->words[i] = get_le(&data[i*bytes], (int)bytes) << (32U - wav->bits);
+				}
+			free(data);
+			fclose(f);
+			return 0;
+			}
+		else {
+			fseek(f, (long)(size + (size & 1U)), SEEK_CUR);
+			}
+		}
+	fprintf(stderr, "%s : no PCM data\n", path);
+	fclose(f);
+	return -1;
+	}
+
+
+/**
+ * @brief  Write the test file : silence, a -20dBFS 997Hz sine with TPDF noise of +/-4 LSB, silence
+ */
+static int wav_generate(const char* path, uint32_t freq, uint32_t bits, double seconds){
+	uint32_t bytes = bits/8U;
+	uint32_t silence = freq*GEN_SILENCE_MS/1000U;
+	uint32_t signal = (uint32_t)(seconds*freq);
+	uint32_t num = 2U*silence + signal;
+	uint32_t data_size = num*2U*bytes;
+	uint8_t hdr[44];
+	memcpy(hdr, "RIFF", 4);
+	put_le(hdr + 4, 36U + data_size, 4);
+	memcpy(hdr + 8, "WAVEfmt ", 8);
+	put_le(hdr + 16, 16U, 4);
+	put_le(hdr + 20, 1U, 2);
+	put_le(hdr + 22, 2U, 2);
+	put_le(hdr + 24, freq, 4);
+	put_le(hdr + 28, freq*2U*bytes, 4);
+	put_le(hdr + 32, 2U*bytes, 2);
+	put_le(hdr + 34, bits, 2);
+	memcpy(hdr + 36, "data", 4);
+	put_le(hdr + 40, data_size, 4);
+
+	uint8_t* data = calloc(num, 2U*bytes);
+	if (data == NULL) {
+		return -1;
+		}
+	uint32_t rng = 1U;
+	double full_scale = (double)(1U << (bits - 1U)) - 1.0;
+	for (uint32_t n = 0; n < signal; n++) {
+		for (uint32_t ch = 0; ch < 2U; ch++) {
+			int32_t noise = 0;
+			for (int k = 0; k < 2; k++) {
+				// xorshift32
+				rng ^= rng << 13;
+				rng ^= rng >> 17;
+				rng ^= rng << 5;
+				noise += (int32_t)(rng & 7U) - 4;
+				}
+			double x = 0.1*full_scale*sin(2.0*M_PI*997.0*n/freq + (ch ? M_PI/2.0 : 0.0));
+			int32_t s = (int32_t)lround(x) + noise;
+			// the first sample of the signal is not silence
+			if (n == 0U && s == 0) {
+				s = 1;
+				}
+			put_le(&data[((silence + n)*2U + ch)*bytes], (uint32_t)s, (int)bytes);
+			}
+		}
+
+	FILE* f = fopen(path, "wb");
+	if (f == NULL) {
+		perror(path);
+		free(data);
+		return -1;
+		}
+	int ok = fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr) && fwrite(data, 2U*bytes, num, f) == num;
+	ok &= fclose(f) == 0;
+	free(data);
+	if (!ok) {
+		fprintf(stderr, "%s : write error\n", path);
+		return -1;
+		}
+	printf("%s : %u Hz %u bit, %.1f s of signal between %u ms of silence\n", path, freq, bits, seconds, GEN_SILENCE_MS);
+	return 0;
+	}
+
+
+static int port_open(const char* path){
+	int fd = open(path, O_RDWR | O_NOCTTY);
+	if (fd < 0) {
+		perror(path);
+		return -1;
+		}
+	struct termios tio;
+	if (tcgetattr(fd, &tio) == 0) {
+		cfmakeraw(&tio);
+		tio.c_cc[VMIN] = 0;
+		tio.c_cc[VTIME] = 0;
+		tcsetattr(fd, TCSANOW, &tio);
+		}
+	return fd;
+	}
+
+
+static int port_command(int fd, uint8_t cmd, uint16_t arg){
+	uint8_t buf[3] = {cmd, (uint8_t)arg, (uint8_t)(arg >> 8)};
+	return write(fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf) ? 0 : -1;
+	}
+
+
+/**
+ * @brief  Read bytes until the timeout
+ * @retval bytes read, 0 on timeout
+ */
+static int port_read(int fd, uint8_t* buf, int len, int timeout_ms){
+	int got = 0;
+	while (got < len) {
+		fd_set set;
+		FD_ZERO(&set);
+		FD_SET(fd, &set);
+		struct timeval tv = {timeout_ms/1000, (timeout_ms%1000)*1000};
+		if (select(fd + 1, &set, NULL, NULL, &tv) <= 0) {
+			break;
+			}
+		ssize_t n = read(fd, buf + got, (size_t)(len - got));
+		if (n <= 0) {
+			break;
+			}
+		got += (int)n;
+		}
+	return got;
+	}
+
+
+/**
+ * @brief  Request a verify record and read it, the periodic records received before are skipped
+ */
+static int read_report(int fd, VERIFY_RECORD* rec){
+	if (port_command(fd, TELEMETRY_CMD_VERIFY, TELEMETRY_VERIFY_REPORT) != 0) {
+		return -1;
+		}
+	uint8_t b[256];
+	for (;;) {
+		// sync bytes, version, size
+		if (port_read(fd, b, 1, REPORT_TIMEOUT_MS) != 1) {
+			return -1;
+			}
+		if (b[0] != TELEMETRY_SYNC0) {
+			continue;
+			}
+		if (port_read(fd, b + 1, 3, REPORT_TIMEOUT_MS) != 3) {
+			return -1;
+			}
+		if (b[1] != TELEMETRY_SYNC1 || b[3] < 4U) {
+			continue;
+			}
+		if (port_read(fd, b + 4, b[3] - 4, REPORT_TIMEOUT_MS) != b[3] - 4) {
+			return -1;
+			}
+		if (b[3] == TELEMETRY_VERIFY_SIZE) {
+			rec->sequence = get_le(b + 4, 4);
+			rec->flags = b[8];
+			rec->bit_depth = b[9];
+			rec->volume = (int16_t)get_le(b + 10, 2);
+			rec->freq = get_le(b + 12, 4);
+			rec->crc = get_le(b + 16, 4);
+			rec->crc_samples = get_le(b + 20, 4);
+			return 0;
+			}
+		}
+	}
+
+
+static void usage(void){
+	printf("usage: verify -g <file.wav> [-f <Hz>] [-w <bits>] [-t <s>]   generate a test file (default 48000 Hz, 24 bit, 10 s)\n"
+		"       verify [-P <command>] <file.wav> <port>              play the file and check the device CRC\n"
+		"  -P <command>  player command, e.g. \"aplay -D hw:CARD=DAC test.wav\", else the file is played by hand\n");
+	}
+
+
+int main(int argc, char** argv){
+	const char* gen = NULL;
+	const char* player = NULL;
+	uint32_t freq = 48000U, bits = 24U;
+	double seconds = 10.0;
+	int opt;
+	while ((opt = getopt(argc, argv, "g:f:w:t:P:h")) != -1) {
+		switch (opt) {
+			case 'g': gen = optarg; break;
+			case 'f': freq = (uint32_t)strtoul(optarg, NULL, 10); break;
+			case 'w': bits = (uint32_t)strtoul(optarg, NULL, 10); break;
+			case 't': seconds = atof(optarg); break;
+			case 'P': player = optarg; break;
+			default:
+				usage();
+				return opt == 'h' ? 0 : 2;
+			}
+		}
+	if (gen != NULL) {
+		if ((bits != 16U && bits != 24U) || freq == 0U || seconds <= 0.0) {
+			usage();
+			return 2;
+			}
+		return wav_generate(gen, freq, bits, seconds) == 0 ? 0 : 2;
+		}
+	if (argc - optind != 2) {
+		usage();
+		return 2;
+		}
+
+	WAV_FILE wav;
+	if (wav_read(argv[optind], &wav) != 0) {
+		return 2;
+		}
+	// samples from the first to the last one that is not silence
+	uint32_t first = 0, last = 0;
+	while (first < wav.num_samples && (wav.words[2U*first] | wav.words[2U*first + 1U]) == 0U) {
+		first++;
+		}
+	for (uint32_t n = first; n < wav.num_samples; n++) {
+		if ((wav.words[2U*n] | wav.words[2U*n + 1U]) != 0U) {
+			last = n + 1U;
+			}
+		}
+	if (first == wav.num_samples) {
+		fprintf(stderr, "%s : only silence\n", argv[optind]);
+		return 2;
+		}
+
+	int fd = port_open(argv[optind + 1]);
+	if (fd < 0) {
+		return 2;
+		}
+	// no periodic records, then a new CRC
+	if (port_command(fd, TELEMETRY_CMD_PERIOD, 0U) != 0 || port_command(fd, TELEMETRY_CMD_VERIFY, TELEMETRY_VERIFY_RESTART) != 0) {
+		perror(argv[optind + 1]);
+		return 2;
+		}
+	if (player != NULL) {
+		printf("playing : %s\n", player);
+		fflush(stdout);
+		if (system(player) != 0) {
+			fprintf(stderr, "the player command failed\n");
+			return 2;
+			}
+		}
+	else {
+		printf("play %s now, press Enter when it has ended\n", argv[optind]);
+		fflush(stdout);
+		while (getchar() != '\n' && !feof(stdin)) {
+			}
+		}
+	usleep(REPORT_DELAY_MS*1000U);
+	tcflush(fd, TCIFLUSH);
+
+	VERIFY_RECORD rec;
+	if (read_report(fd, &rec) != 0) {
+		fprintf(stderr, "%s : no verify record, is the firmware built with USE_USB_CDC_TELEMETRY ?\n", argv[optind + 1]);
+		return 2;
+		}
+	close(fd);
+	if ((rec.flags & TELEMETRY_FLAG_VERIFY) == 0U) {
+		fprintf(stderr, "the firmware is not built with USE_AUDIO_VERIFY\n");
+		return 2;
+		}
+
+	printf("file   : %u Hz %u bit, %u samples from sample %u\n", wav.freq, wav.bits, last - first, first);
+	printf("device : %u Hz %u bit, volume %.1f dB%s, CRC 0x%08X of %u samples\n", rec.freq, rec.bit_depth,
+		rec.volume/256.0, (rec.flags & TELEMETRY_FLAG_MUTE) ? " muted" : "", rec.crc, rec.crc_samples);
+	if (rec.volume != 0 || (rec.flags & TELEMETRY_FLAG_MUTE)) {
+		printf("warning : the device volume is not 0 dB\n");
+		}
+	if (rec.freq != wav.freq) {
+		printf("warning : the host plays the file at %u Hz, it is resampled\n", rec.freq);
+		}
+	if (rec.crc_samples < last - first) {
+		printf("FAIL : the device received %u samples, the file has %u\n", rec.crc_samples, last - first);
+		return 1;
+		}
+
+	crc_init();
+	uint32_t crc = CRC_INIT;
+	for (uint32_t n = 0; n < rec.crc_samples; n++) {
+		uint32_t i = first + n;
+		crc = crc_word(crc, i < wav.num_samples ? wav.words[2U*i] : 0U);
+		crc = crc_word(crc, i < wav.num_samples ? wav.words[2U*i + 1U] : 0U);
+		}
+	free(wav.words);
+	if (crc != rec.crc) {
+		printf("FAIL : expected CRC 0x%08X\n", crc);
+		return 1;
+		}
+	printf("PASS : bit-perfect\n");
+	return 0;
+	}